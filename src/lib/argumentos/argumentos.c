@@ -8,6 +8,10 @@
 #include <string.h>
 #include "argumentos.h"
 
+/* Maior valor aceito em -j e -jq: os lotes e as arenas são dimensionados
+ * por ele */
+#define MAX_THREADS 256
+
 /* ============================================================================
  * Estrutura Interna (Ponteiro Opaco)
  * ============================================================================ */
@@ -21,6 +25,12 @@ typedef struct argumentos_internal
     char *arquivo_qry;        /* -q: nome do arquivo .qry (opcional) */
     char *tipo_ord;           /* -to: tipo de ordenação (opcional) */
     int limiar_insertion;     /* -in: limiar insertion sort (opcional, default 10) */
+    char *motor_vis;          /* -vis: motor de visibilidade (opcional) */
+    double tolerancia_simp;   /* -simp: tolerância da simplificação (opcional, default 0) */
+    int num_threads;          /* -j: threads das bombas em lote (opcional, default 1) */
+    char *arquivo_compilado;  /* --compile: cena compilada a gerar (opcional) */
+    char *lista_qry;          /* -lq: arquivo com a lista de .qry (opcional) */
+    int consultas_paralelas;  /* -jq: consultas da lista ao mesmo tempo (default 1) */
 } ArgumentosInternal;
 
 /* ============================================================================
@@ -73,6 +83,12 @@ Argumentos criar_argumentos(int argc, char *argv[])
     args->arquivo_qry = NULL;
     args->tipo_ord = NULL;
     args->limiar_insertion = 10; /* Default */
+    args->motor_vis = NULL;
+    args->tolerancia_simp = 0.0; /* Default: sem simplificação */
+    args->num_threads = 1;       /* Default: execução serial */
+    args->arquivo_compilado = NULL;
+    args->lista_qry = NULL;
+    args->consultas_paralelas = 1;
 
     /* Processa os argumentos */
     for (int i = 1; i < argc; i++)
@@ -101,6 +117,50 @@ Argumentos criar_argumentos(int argc, char *argv[])
         {
             args->limiar_insertion = atoi(argv[++i]);
         }
+        else if (strcmp(argv[i], "-vis") == 0 && i + 1 < argc)
+        {
+            args->motor_vis = duplicar_string(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-simp") == 0 && i + 1 < argc)
+        {
+            args->tolerancia_simp = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            args->num_threads = atoi(argv[++i]);
+            if (args->num_threads < 1)
+            {
+                fprintf(stderr, "Aviso: -j inválido, usando 1 thread.\n");
+                args->num_threads = 1;
+            }
+            else if (args->num_threads > MAX_THREADS)
+            {
+                fprintf(stderr, "Aviso: -j acima de %d, usando %d threads.\n", MAX_THREADS, MAX_THREADS);
+                args->num_threads = MAX_THREADS;
+            }
+        }
+        else if (strcmp(argv[i], "-lq") == 0 && i + 1 < argc)
+        {
+            args->lista_qry = duplicar_string(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-jq") == 0 && i + 1 < argc)
+        {
+            args->consultas_paralelas = atoi(argv[++i]);
+            if (args->consultas_paralelas < 1)
+            {
+                fprintf(stderr, "Aviso: -jq inválido, usando 1 consulta por vez.\n");
+                args->consultas_paralelas = 1;
+            }
+            else if (args->consultas_paralelas > MAX_THREADS)
+            {
+                fprintf(stderr, "Aviso: -jq acima de %d, usando %d consultas por vez.\n", MAX_THREADS, MAX_THREADS);
+                args->consultas_paralelas = MAX_THREADS;
+            }
+        }
+        else if (strcmp(argv[i], "--compile") == 0 && i + 1 < argc)
+        {
+            args->arquivo_compilado = duplicar_string(argv[++i]);
+        }
         else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
         {
             exibir_uso(argv[0]);
@@ -125,6 +185,9 @@ void destruir_argumentos(Argumentos argumentos)
     free(args->diretorio_saida);
     free(args->arquivo_qry);
     free(args->tipo_ord);
+    free(args->motor_vis);
+    free(args->arquivo_compilado);
+    free(args->lista_qry);
     free(args);
 }
 
@@ -169,6 +232,47 @@ int obter_limiar_insertion(Argumentos argumentos)
     return args ? args->limiar_insertion : 10;
 }
 
+const char* obter_motor_visibilidade(Argumentos argumentos)
+{
+    ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
+    /* Default para "varredura" se não especificado */
+    if (args && args->motor_vis)
+    {
+        return args->motor_vis;
+    }
+    return "varredura";
+}
+
+double obter_tolerancia_simplificacao(Argumentos argumentos)
+{
+    ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
+    return args ? args->tolerancia_simp : 0.0;
+}
+
+int obter_num_threads(Argumentos argumentos)
+{
+    ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
+    return args ? args->num_threads : 1;
+}
+
+const char* obter_arquivo_compilado(Argumentos argumentos)
+{
+    ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
+    return args ? args->arquivo_compilado : NULL;
+}
+
+const char* obter_lista_qry(Argumentos argumentos)
+{
+    ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
+    return args ? args->lista_qry : NULL;
+}
+
+int obter_consultas_paralelas(Argumentos argumentos)
+{
+    ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
+    return args ? args->consultas_paralelas : 1;
+}
+
 int argumentos_validos(Argumentos argumentos)
 {
     ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
@@ -178,13 +282,13 @@ int argumentos_validos(Argumentos argumentos)
     }
 
     /* Verifica se os argumentos obrigatórios foram fornecidos */
-    /* Apenas -f e -o são obrigatórios */
+    /* Apenas -f e -o são obrigatórios (-o dispensado com --compile) */
     if (args->arquivo_geo == NULL)
     {
         fprintf(stderr, "Erro: arquivo .geo (-f) não especificado.\n");
         return 0;
     }
-    if (args->diretorio_saida == NULL)
+    if (args->diretorio_saida == NULL && args->arquivo_compilado == NULL)
     {
         fprintf(stderr, "Erro: diretório de saída (-o) não especificado.\n");
         return 0;
@@ -202,82 +306,99 @@ void exibir_uso(const char *nome_programa)
     printf("  -o <diretório>   Diretório de saída (arquivos .svg e .txt) [OBRIGATÓRIO]\n");
     printf("  -e <diretório>   Diretório base de entrada [opcional]\n");
     printf("  -q <arquivo>     Caminho do arquivo de consultas (.qry) [opcional]\n");
-    printf("  -to <algoritmo>  Tipo de ordenação: qsort ou mergesort [opcional]\n");
+    printf("  -to <algoritmo>  Tipo de ordenação: qsort (q), mergesort (m) ou radixsort (r) [opcional]\n");
     printf("  -in <valor>      Limiar para Insertion Sort (para mergesort) [opcional, def: 10]\n");
+    printf("  -vis <motor>     Motor de visibilidade: varredura (v) ou expansao (e) [opcional, def: v]\n");
+    printf("                   (expansao triangula os anteparos uma vez; melhor com muitas bombas)\n");
+    printf("  -simp <tol>      Simplifica os polígonos de visibilidade com essa tolerância [opcional, def: 0]\n");
+    printf("  -j <threads>     Threads para bombas consecutivas em lote, até %d [opcional, def: 1]\n", MAX_THREADS);
+    printf("  -lq <arquivo>    Lista de .qry (um por linha) processados com a cena lida uma vez [opcional]\n");
+    printf("  -jq <consultas>  Consultas da lista processadas em paralelo, até %d [opcional, def: 1]\n", MAX_THREADS);
+    printf("  --compile <arq>  Grava a cena do .geo em formato binário e termina [opcional]\n");
+    printf("                   (o arquivo gerado pode ser passado em -f no lugar do .geo)\n");
     printf("  -h, --help       Exibe esta mensagem de ajuda\n\n");
     printf("Exemplos:\n");
     printf("  %s -f ./dados/mapa.geo -o ./saida\n",
            nome_programa ? nome_programa : "t2");
     printf("  %s -f mapa.geo -o ./saida -e ./dados -q consulta.qry\n",
            nome_programa ? nome_programa : "t2");
+    printf("  %s -f mapa.geo -o ./saida -e ./dados -lq consultas.txt -jq 4\n",
+           nome_programa ? nome_programa : "t2");
+    printf("  %s -f mapa.geo -e ./dados --compile ./dados/mapa.geob\n",
+           nome_programa ? nome_programa : "t2");
 }
 
-int construir_caminho_geo(Argumentos argumentos, char *buffer, int tamanho_buffer)
+/**
+ * Concatena o diretório de entrada (se houver) com o nome do arquivo.
+ */
+static int construir_caminho(ArgumentosInternal *args, const char *arquivo,
+                             char *buffer, int tamanho_buffer, const char *descricao)
 {
-    ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
-    if (args == NULL || buffer == NULL || tamanho_buffer <= 0)
-    {
-        return 0;
-    }
-    if (args->arquivo_geo == NULL)
-    {
-        return 0;
-    }
-
     int necessario;
     if (args->diretorio_entrada != NULL)
     {
         /* Se tem diretório de entrada, concatena */
         necessario = snprintf(buffer, tamanho_buffer, "%s/%s", 
-                              args->diretorio_entrada, args->arquivo_geo);
+                              args->diretorio_entrada, arquivo);
     }
     else
     {
         /* Se não tem, usa o caminho do arquivo diretamente */
-        necessario = snprintf(buffer, tamanho_buffer, "%s", args->arquivo_geo);
+        necessario = snprintf(buffer, tamanho_buffer, "%s", arquivo);
     }
     
     if (necessario >= tamanho_buffer)
     {
-        fprintf(stderr, "Erro: buffer muito pequeno para o caminho do arquivo .geo\n");
+        fprintf(stderr, "Erro: buffer muito pequeno para o caminho do %s\n", descricao);
         return 0;
     }
 
     return 1;
 }
 
-int construir_caminho_qry(Argumentos argumentos, char *buffer, int tamanho_buffer)
+int construir_caminho_geo(Argumentos argumentos, char *buffer, int tamanho_buffer)
 {
     ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
     if (args == NULL || buffer == NULL || tamanho_buffer <= 0)
     {
         return 0;
     }
-    if (args->arquivo_qry == NULL)
+    if (args->arquivo_geo == NULL)
     {
         return 0;
     }
 
-    int necessario;
-    if (args->diretorio_entrada != NULL)
+    return construir_caminho(args, args->arquivo_geo, buffer, tamanho_buffer, "arquivo .geo");
+}
+
+int construir_caminho_qry(Argumentos argumentos, char *buffer, int tamanho_buffer)
+{
+    ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
+    if (args == NULL || buffer == NULL || tamanho_buffer <= 0)
     {
-        /* Se tem diretório de entrada, concatena */
-        necessario = snprintf(buffer, tamanho_buffer, "%s/%s", 
-                              args->diretorio_entrada, args->arquivo_qry);
+        return 0;
     }
-    else
+    if (args->arquivo_qry == NULL)
     {
-        /* Se não tem, usa o caminho do arquivo diretamente */
-        necessario = snprintf(buffer, tamanho_buffer, "%s", args->arquivo_qry);
+        return 0;
     }
-    
-    if (necessario >= tamanho_buffer)
+
+    return construir_caminho(args, args->arquivo_qry, buffer, tamanho_buffer, "arquivo .qry");
+}
+
+int construir_caminho_lista_qry(Argumentos argumentos, char *buffer, int tamanho_buffer)
+{
+    ArgumentosInternal *args = (ArgumentosInternal*)argumentos;
+    if (args == NULL || buffer == NULL || tamanho_buffer <= 0)
+    {
+        return 0;
+    }
+    if (args->lista_qry == NULL)
     {
-        fprintf(stderr, "Erro: buffer muito pequeno para o caminho do arquivo .qry\n");
         return 0;
     }
 
-    return 1;
+    return construir_caminho(args, args->lista_qry, buffer, tamanho_buffer, "arquivo de lista de .qry");
 }
 
 /* ============================================================================
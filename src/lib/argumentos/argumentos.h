@@ -31,6 +31,9 @@ typedef void* Argumentos;
  *   -o <diretório>   Diretório de saída (onde serão gerados os .svg e .txt)
  *   -q <arquivo>     Nome do arquivo .qry (opcional, sem o diretório)
  *   -oa <algoritmo>  Algoritmo de ordenação: qsort ou mergesort (opcional)
+ *   -lq <arquivo>    Lista de .qry processados com a mesma cena (opcional)
+ *   -jq <n>          Consultas da lista processadas em paralelo (opcional)
+ *   --compile <arq>  Grava a cena compilada do .geo e termina (opcional)
  * 
  * @param argc Número de argumentos (recebido do main)
  * @param argv Vetor de strings com os argumentos (recebido do main)
@@ -100,13 +103,53 @@ const char* obter_tipo_ordenacao(Argumentos argumentos);
  */
 int obter_limiar_insertion(Argumentos argumentos);
 
+/**
+ * Obtém o motor de visibilidade (-vis).
+ * Default: "varredura".
+ */
+const char* obter_motor_visibilidade(Argumentos argumentos);
+
+/**
+ * Obtém a tolerância da simplificação dos polígonos de visibilidade (-simp).
+ * Default: 0 (sem simplificação).
+ */
+double obter_tolerancia_simplificacao(Argumentos argumentos);
+
+/**
+ * Obtém o número de threads para o cálculo das bombas em lote (-j).
+ * Default: 1 (execução serial).
+ */
+int obter_num_threads(Argumentos argumentos);
+
+/**
+ * Obtém o caminho da cena compilada a gerar (--compile).
+ * 
+ * @param args Ponteiro para a estrutura Argumentos
+ * @return Caminho do arquivo, ou NULL se o modo não foi pedido
+ */
+const char* obter_arquivo_compilado(Argumentos argumentos);
+
+/**
+ * Obtém o arquivo com a lista de .qry do modo em lote (-lq).
+ * 
+ * @param args Ponteiro para a estrutura Argumentos
+ * @return Nome do arquivo, ou NULL se o modo não foi pedido
+ */
+const char* obter_lista_qry(Argumentos argumentos);
+
+/**
+ * Obtém quantas consultas da lista rodam ao mesmo tempo (-jq).
+ * Default: 1 (uma consulta por vez).
+ */
+int obter_consultas_paralelas(Argumentos argumentos);
+
 /* ============================================================================
  * Funções Auxiliares
  * ============================================================================ */
 
 /**
  * Verifica se os argumentos obrigatórios foram fornecidos.
- * Os argumentos obrigatórios são: -e, -f, -o
+ * Os argumentos obrigatórios são: -f e -o (-o não é exigido com --compile)
  * 
  * @param args Ponteiro para a estrutura Argumentos
  * @return 1 se todos os obrigatórios estão presentes, 0 caso contrário
@@ -143,4 +186,15 @@ int construir_caminho_geo(Argumentos args, char *buffer, int tamanho_buffer);
  */
 int construir_caminho_qry(Argumentos args, char *buffer, int tamanho_buffer);
 
+/**
+ * Constrói o caminho completo do arquivo com a lista de .qry (-lq).
+ * Concatena o diretório de entrada com o nome do arquivo.
+ * 
+ * @param args Ponteiro para a estrutura Argumentos
+ * @param buffer Buffer onde o caminho será escrito
+ * @param tamanho_buffer Tamanho máximo do buffer
+ * @return 1 se sucesso, 0 se erro (sem lista, buffer pequeno ou args inválido)
+ */
+int construir_caminho_lista_qry(Argumentos args, char *buffer, int tamanho_buffer);
+
 #endif /* ARGUMENTOS_H */
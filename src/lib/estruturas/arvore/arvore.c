@@ -1,10 +1,22 @@
 /* arvore.c
  *
  * Implementação da Árvore de Segmentos Ativos
- * Usa uma árvore binária de busca simples.
- * 
+ * Usa uma árvore rubro-negra (red-black), garantindo altura O(log n)
+ * mesmo quando os segmentos chegam em ordem angular (caso que degenerava
+ * a BST simples em uma lista).
+ *
  * A ordenação é dinâmica: segmentos são comparados pela distância
  * ao ponto de vista no ângulo atual da varredura.
+ *
+ * Cada nó guarda os coeficientes do seu segmento relativos à origem
+ * (calculados uma vez na inserção) e a árvore guarda o vetor direção do
+ * raio atual, de modo que a descida não chama cos/sin nem os getters.
+ *
+ * Segmentos são identificados pelo índice (0..max_segmentos-1) no vetor
+ * de trabalho da varredura. Cada índice tem seu nó pré-alocado, de modo
+ * que inserir/remover não alocam memória e localizar o nó de um segmento
+ * (sem depender da comparação, que pode empatar no ponto onde o segmento
+ * termina) é acesso direto.
  */
 
 #include <stdio.h>
@@ -17,63 +29,150 @@
  * Estruturas Internas
  * ============================================================================ */
 
+typedef enum {
+    COR_VERMELHO,
+    COR_PRETO
+} CorNo;
+
+/* Coeficientes de um segmento relativos à origem.
+ * Interseção com o raio o + t*d:  t = num / (d x e),  u = (a x d) / (d x e) */
+typedef struct coef_segmento
+{
+    double ax, ay;      /* p1 - origem */
+    double ex, ey;      /* p2 - p1 */
+    double num;         /* a x e (não depende do raio) */
+} CoefSegmento;
+
 /* Nó da árvore */
 typedef struct no_arvore
 {
-    Segmento segmento;
+    int segmento;       /* Índice do segmento */
+    int presente;       /* 1 se o segmento está na árvore */
+    CoefSegmento coef;
     struct no_arvore *esquerda;
     struct no_arvore *direita;
     struct no_arvore *pai;
+    CorNo cor;
 } NoArvore;
 
 /* Estrutura principal da árvore */
 typedef struct arvore_internal
 {
     NoArvore *raiz;
-    Ponto origem;       /* Ponto de vista */
-    double angulo;      /* Ângulo atual da varredura */
+    NoArvore nil_no;    /* Sentinela (folhas e pai da raiz) */
+    NoArvore *nil;      /* Aponta para nil_no */
+    NoArvore *minimo;   /* Cache do nó mais à esquerda (o biombo) */
+    double ox, oy;      /* Ponto de vista */
+    double dx, dy;      /* Direção (unitária) do raio atual */
     int tamanho;
+
+    NoArvore *nos;      /* Um nó por índice de segmento */
+    int max_segmentos;
+    int na_arena;       /* Memória pertence a uma arena (não liberar) */
 } ArvoreInternal;
 
 /* ============================================================================
- * Funções Auxiliares
+ * Funções Auxiliares - Árvore
  * ============================================================================ */
 
 /**
- * Cria um novo nó.
+ * Calcula os coeficientes do segmento relativos à origem da árvore.
  */
-static NoArvore* criar_no(Segmento seg)
+static void calcular_coeficientes(ArvoreInternal *arv, double x1, double y1,
+                                  double x2, double y2, CoefSegmento *c)
 {
-    NoArvore *no = (NoArvore*)malloc(sizeof(NoArvore));
-    if (no == NULL) return NULL;
-    
-    no->segmento = seg;
-    no->esquerda = NULL;
-    no->direita = NULL;
-    no->pai = NULL;
-    
-    return no;
+    c->ax = x1 - arv->ox;
+    c->ay = y1 - arv->oy;
+    c->ex = x2 - x1;
+    c->ey = y2 - y1;
+    c->num = c->ax * c->ey - c->ay * c->ex;
+}
+
+/**
+ * Distância da origem ao segmento ao longo do raio atual.
+ * Mesma semântica de distancia_raio_segmento (INFINITY se não intercepta).
+ */
+static double distancia_coef(ArvoreInternal *arv, const CoefSegmento *c)
+{
+    double denom = arv->dx * c->ey - arv->dy * c->ex;
+
+    if (fabs(denom) < GEO_EPSILON)
+    {
+        return INFINITY;
+    }
+
+    double t = c->num / denom;
+    double u = (c->ax * arv->dy - c->ay * arv->dx) / denom;
+
+    if (t >= -GEO_EPSILON && u >= -GEO_EPSILON && u <= 1.0 + GEO_EPSILON)
+    {
+        return t;
+    }
+
+    return INFINITY;
+}
+
+/**
+ * Compara duas distâncias com a tolerância de comparar_segmentos_raio.
+ * @return < 0 se d1 mais perto, > 0 se d2 mais perto, 0 se empatam
+ */
+static int comparar_distancias(double d1, double d2)
+{
+    if (fabs(d1 - d2) < GEO_EPSILON)
+    {
+        return 0;
+    }
+
+    return (d1 < d2) ? -1 : 1;
 }
 
 /**
- * Compara dois segmentos pela distância no ângulo atual.
- * @return < 0 se seg1 mais perto, > 0 se seg2 mais perto
+ * Desempata dois segmentos que o raio atual atinge à mesma distância
+ * (em geral um extremo comum, como o canto de um retângulo): vale a
+ * ordem logo depois do raio, no sentido anti-horário da varredura. Cada
+ * segmento segue do ponto comum para o seu extremo mais à frente; o que
+ * se volta mais para a origem fica mais perto.
+ * @param dist Distância comum ao longo do raio
+ * @return < 0 se c1 fica mais perto, > 0 se c2, 0 se continuam empatados
  */
-static int comparar_segmentos(ArvoreInternal *arv, Segmento seg1, Segmento seg2)
+static int desempatar(ArvoreInternal *arv, const CoefSegmento *c1,
+                      const CoefSegmento *c2, double dist)
 {
-    if (seg1 == seg2) return 0;
-    
-    return comparar_segmentos_raio(arv->origem, arv->angulo, seg1, seg2);
+    double wx[2], wy[2];
+    const CoefSegmento *c[2] = { c1, c2 };
+
+    for (int i = 0; i < 2; i++)
+    {
+        /* Extremo mais à frente (maior produto vetorial com o raio) */
+        double fx = c[i]->ax, fy = c[i]->ay;
+        double gx = fx + c[i]->ex, gy = fy + c[i]->ey;
+        if (arv->dx * gy - arv->dy * gx > arv->dx * fy - arv->dy * fx)
+        {
+            fx = gx;
+            fy = gy;
+        }
+
+        wx[i] = fx - dist * arv->dx;
+        wy[i] = fy - dist * arv->dy;
+
+        /* Segmento que termina no raio: não há ordem depois dele */
+        if (fabs(wx[i]) + fabs(wy[i]) < GEO_EPSILON) return 0;
+    }
+
+    double cruz = wx[0] * wy[1] - wy[0] * wx[1];
+    double escala = (fabs(wx[0]) + fabs(wy[0])) * (fabs(wx[1]) + fabs(wy[1]));
+    if (fabs(cruz) <= GEO_EPSILON * escala) return 0;
+    return (cruz < 0.0) ? -1 : 1;
 }
 
 /**
  * Encontra o nó com menor valor (mais à esquerda).
  */
-static NoArvore* encontrar_minimo(NoArvore *no)
+static NoArvore* encontrar_minimo(ArvoreInternal *arv, NoArvore *no)
 {
-    if (no == NULL) return NULL;
-    
-    while (no->esquerda != NULL)
+    if (no == arv->nil) return arv->nil;
+
+    while (no->esquerda != arv->nil)
     {
         no = no->esquerda;
     }
@@ -83,19 +182,19 @@ static NoArvore* encontrar_minimo(NoArvore *no)
 /**
  * Encontra o nó sucessor (próximo na ordem).
  */
-static NoArvore* encontrar_sucessor(NoArvore *no)
+static NoArvore* encontrar_sucessor(ArvoreInternal *arv, NoArvore *no)
 {
-    if (no == NULL) return NULL;
-    
+    if (no == arv->nil) return arv->nil;
+
     /* Se tem filho direito, é o mínimo do filho direito */
-    if (no->direita != NULL)
+    if (no->direita != arv->nil)
     {
-        return encontrar_minimo(no->direita);
+        return encontrar_minimo(arv, no->direita);
     }
-    
+
     /* Senão, sobe até encontrar onde viemos da esquerda */
     NoArvore *pai = no->pai;
-    while (pai != NULL && no == pai->direita)
+    while (pai != arv->nil && no == pai->direita)
     {
         no = pai;
         pai = pai->pai;
@@ -103,14 +202,125 @@ static NoArvore* encontrar_sucessor(NoArvore *no)
     return pai;
 }
 
+static void rotacionar_esquerda(ArvoreInternal *arv, NoArvore *x)
+{
+    NoArvore *y = x->direita;
+
+    x->direita = y->esquerda;
+    if (y->esquerda != arv->nil)
+    {
+        y->esquerda->pai = x;
+    }
+
+    y->pai = x->pai;
+    if (x->pai == arv->nil)
+    {
+        arv->raiz = y;
+    }
+    else if (x == x->pai->esquerda)
+    {
+        x->pai->esquerda = y;
+    }
+    else
+    {
+        x->pai->direita = y;
+    }
+
+    y->esquerda = x;
+    x->pai = y;
+}
+
+static void rotacionar_direita(ArvoreInternal *arv, NoArvore *x)
+{
+    NoArvore *y = x->esquerda;
+
+    x->esquerda = y->direita;
+    if (y->direita != arv->nil)
+    {
+        y->direita->pai = x;
+    }
+
+    y->pai = x->pai;
+    if (x->pai == arv->nil)
+    {
+        arv->raiz = y;
+    }
+    else if (x == x->pai->direita)
+    {
+        x->pai->direita = y;
+    }
+    else
+    {
+        x->pai->esquerda = y;
+    }
+
+    y->direita = x;
+    x->pai = y;
+}
+
+/**
+ * Restaura as propriedades rubro-negras após inserção.
+ */
+static void corrigir_insercao(ArvoreInternal *arv, NoArvore *z)
+{
+    while (z->pai->cor == COR_VERMELHO)
+    {
+        NoArvore *avo = z->pai->pai;
 
+        if (z->pai == avo->esquerda)
+        {
+            NoArvore *tio = avo->direita;
+            if (tio->cor == COR_VERMELHO)
+            {
+                z->pai->cor = COR_PRETO;
+                tio->cor = COR_PRETO;
+                avo->cor = COR_VERMELHO;
+                z = avo;
+            }
+            else
+            {
+                if (z == z->pai->direita)
+                {
+                    z = z->pai;
+                    rotacionar_esquerda(arv, z);
+                }
+                z->pai->cor = COR_PRETO;
+                z->pai->pai->cor = COR_VERMELHO;
+                rotacionar_direita(arv, z->pai->pai);
+            }
+        }
+        else
+        {
+            NoArvore *tio = avo->esquerda;
+            if (tio->cor == COR_VERMELHO)
+            {
+                z->pai->cor = COR_PRETO;
+                tio->cor = COR_PRETO;
+                avo->cor = COR_VERMELHO;
+                z = avo;
+            }
+            else
+            {
+                if (z == z->pai->esquerda)
+                {
+                    z = z->pai;
+                    rotacionar_direita(arv, z);
+                }
+                z->pai->cor = COR_PRETO;
+                z->pai->pai->cor = COR_VERMELHO;
+                rotacionar_esquerda(arv, z->pai->pai);
+            }
+        }
+    }
+    arv->raiz->cor = COR_PRETO;
+}
 
 /**
  * Transplanta uma subárvore (usada na remoção).
  */
 static void transplantar(ArvoreInternal *arv, NoArvore *u, NoArvore *v)
 {
-    if (u->pai == NULL)
+    if (u->pai == arv->nil)
     {
         arv->raiz = v;
     }
@@ -122,54 +332,166 @@ static void transplantar(ArvoreInternal *arv, NoArvore *u, NoArvore *v)
     {
         u->pai->direita = v;
     }
-    
-    if (v != NULL)
-    {
-        v->pai = u->pai;
-    }
+
+    /* Mesmo quando v é a sentinela: corrigir_remocao depende de x->pai */
+    v->pai = u->pai;
 }
 
 /**
- * Destroi recursivamente os nós da árvore.
+ * Restaura as propriedades rubro-negras após remoção.
  */
-static void destruir_nos(NoArvore *no)
+static void corrigir_remocao(ArvoreInternal *arv, NoArvore *x)
 {
-    if (no == NULL) return;
-    
-    destruir_nos(no->esquerda);
-    destruir_nos(no->direita);
-    free(no);
+    while (x != arv->raiz && x->cor == COR_PRETO)
+    {
+        if (x == x->pai->esquerda)
+        {
+            NoArvore *w = x->pai->direita;
+            if (w->cor == COR_VERMELHO)
+            {
+                w->cor = COR_PRETO;
+                x->pai->cor = COR_VERMELHO;
+                rotacionar_esquerda(arv, x->pai);
+                w = x->pai->direita;
+            }
+            if (w->esquerda->cor == COR_PRETO && w->direita->cor == COR_PRETO)
+            {
+                w->cor = COR_VERMELHO;
+                x = x->pai;
+            }
+            else
+            {
+                if (w->direita->cor == COR_PRETO)
+                {
+                    w->esquerda->cor = COR_PRETO;
+                    w->cor = COR_VERMELHO;
+                    rotacionar_direita(arv, w);
+                    w = x->pai->direita;
+                }
+                w->cor = x->pai->cor;
+                x->pai->cor = COR_PRETO;
+                w->direita->cor = COR_PRETO;
+                rotacionar_esquerda(arv, x->pai);
+                x = arv->raiz;
+            }
+        }
+        else
+        {
+            NoArvore *w = x->pai->esquerda;
+            if (w->cor == COR_VERMELHO)
+            {
+                w->cor = COR_PRETO;
+                x->pai->cor = COR_VERMELHO;
+                rotacionar_direita(arv, x->pai);
+                w = x->pai->esquerda;
+            }
+            if (w->direita->cor == COR_PRETO && w->esquerda->cor == COR_PRETO)
+            {
+                w->cor = COR_VERMELHO;
+                x = x->pai;
+            }
+            else
+            {
+                if (w->esquerda->cor == COR_PRETO)
+                {
+                    w->direita->cor = COR_PRETO;
+                    w->cor = COR_VERMELHO;
+                    rotacionar_esquerda(arv, w);
+                    w = x->pai->esquerda;
+                }
+                w->cor = x->pai->cor;
+                x->pai->cor = COR_PRETO;
+                w->esquerda->cor = COR_PRETO;
+                rotacionar_direita(arv, x->pai);
+                x = arv->raiz;
+            }
+        }
+    }
+    x->cor = COR_PRETO;
 }
 
 /* ============================================================================
  * Implementação das Funções Públicas
  * ============================================================================ */
 
-ArvoreSegmentos arvore_criar(Ponto origem)
+/**
+ * Inicializa os campos da árvore (memória já alocada).
+ */
+static void inicializar_arvore(ArvoreInternal *arv, Ponto origem, int max_segmentos)
+{
+    arv->max_segmentos = max_segmentos;
+
+    for (int i = 0; i < max_segmentos; i++)
+    {
+        arv->nos[i].segmento = i;
+        arv->nos[i].presente = 0;
+    }
+
+    arv->nil = &arv->nil_no;
+    arv->nil->segmento = -1;
+    arv->nil->presente = 0;
+    arv->nil->esquerda = arv->nil;
+    arv->nil->direita = arv->nil;
+    arv->nil->pai = arv->nil;
+    arv->nil->cor = COR_PRETO;
+
+    arv->raiz = arv->nil;
+    arv->minimo = arv->nil;
+    arv->ox = get_ponto_x(origem);
+    arv->oy = get_ponto_y(origem);
+    arv->dx = 1.0;
+    arv->dy = 0.0;
+    arv->tamanho = 0;
+}
+
+ArvoreSegmentos arvore_criar(Ponto origem, int max_segmentos)
 {
-    if (origem == NULL) return NULL;
-    
+    if (origem == NULL || max_segmentos < 0) return NULL;
+
     ArvoreInternal *arv = (ArvoreInternal*)malloc(sizeof(ArvoreInternal));
     if (arv == NULL)
     {
         fprintf(stderr, "Erro: falha ao alocar árvore de segmentos.\n");
         return NULL;
     }
-    
-    arv->raiz = NULL;
-    arv->origem = origem;
-    arv->angulo = 0.0;
-    arv->tamanho = 0;
-    
+
+    arv->nos = (NoArvore*)malloc((max_segmentos > 0 ? max_segmentos : 1) * sizeof(NoArvore));
+    if (arv->nos == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar nós da árvore de segmentos.\n");
+        free(arv);
+        return NULL;
+    }
+
+    arv->na_arena = 0;
+    inicializar_arvore(arv, origem, max_segmentos);
+
+    return (ArvoreSegmentos)arv;
+}
+
+ArvoreSegmentos arvore_criar_na_arena(Ponto origem, int max_segmentos, Arena arena)
+{
+    if (arena == NULL) return arvore_criar(origem, max_segmentos);
+    if (origem == NULL || max_segmentos < 0) return NULL;
+
+    ArvoreInternal *arv = (ArvoreInternal*)arena_alocar(arena, sizeof(ArvoreInternal));
+    if (arv == NULL) return NULL;
+
+    arv->nos = (NoArvore*)arena_alocar(arena, (max_segmentos > 0 ? max_segmentos : 1) * sizeof(NoArvore));
+    if (arv->nos == NULL) return NULL;
+
+    arv->na_arena = 1;
+    inicializar_arvore(arv, origem, max_segmentos);
+
     return (ArvoreSegmentos)arv;
 }
 
 void arvore_destruir(ArvoreSegmentos arvore)
 {
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
-    if (arv == NULL) return;
-    
-    destruir_nos(arv->raiz);
+    if (arv == NULL || arv->na_arena) return;
+
+    free(arv->nos);
     free(arv);
 }
 
@@ -178,27 +500,53 @@ void arvore_definir_angulo(ArvoreSegmentos arvore, double angulo)
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
     if (arv != NULL)
     {
-        arv->angulo = angulo;
+        arv->dx = cos(angulo);
+        arv->dy = sin(angulo);
     }
 }
 
-int arvore_inserir(ArvoreSegmentos arvore, Segmento seg)
+void arvore_definir_direcao(ArvoreSegmentos arvore, double dx, double dy)
 {
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
-    if (arv == NULL || seg == NULL) return 0;
-    
-    NoArvore *novo = criar_no(seg);
-    if (novo == NULL) return 0;
-    
-    /* Inserção padrão da BST */
-    NoArvore *pai = NULL;
+    if (arv == NULL) return;
+
+    double norma = sqrt(dx * dx + dy * dy);
+    if (norma < GEO_EPSILON) return;
+
+    arv->dx = dx / norma;
+    arv->dy = dy / norma;
+}
+
+int arvore_inserir(ArvoreSegmentos arvore, int seg,
+                   double x1, double y1, double x2, double y2)
+{
+    ArvoreInternal *arv = (ArvoreInternal*)arvore;
+    if (arv == NULL || seg < 0 || seg >= arv->max_segmentos) return 0;
+
+    /* Um segmento só pode estar ativo uma vez */
+    NoArvore *novo = &arv->nos[seg];
+    if (novo->presente) return 0;
+
+    calcular_coeficientes(arv, x1, y1, x2, y2, &novo->coef);
+    novo->presente = 1;
+    novo->esquerda = arv->nil;
+    novo->direita = arv->nil;
+    novo->cor = COR_VERMELHO;
+
+    /* Descida padrão da BST; empates de distância são desfeitos pela
+     * ordem logo depois do raio, e os que restam vão para a direita */
+    NoArvore *pai = arv->nil;
     NoArvore *atual = arv->raiz;
-    
-    while (atual != NULL)
+    int cmp = 0;
+    int sempre_esquerda = 1;
+    double dist = distancia_coef(arv, &novo->coef);
+
+    while (atual != arv->nil)
     {
         pai = atual;
-        int cmp = comparar_segmentos(arv, seg, atual->segmento);
-        
+        cmp = comparar_distancias(dist, distancia_coef(arv, &atual->coef));
+        if (cmp == 0) cmp = desempatar(arv, &novo->coef, &atual->coef, dist);
+
         if (cmp < 0)
         {
             atual = atual->esquerda;
@@ -206,16 +554,17 @@ int arvore_inserir(ArvoreSegmentos arvore, Segmento seg)
         else
         {
             atual = atual->direita;
+            sempre_esquerda = 0;
         }
     }
-    
+
     novo->pai = pai;
-    
-    if (pai == NULL)
+
+    if (pai == arv->nil)
     {
         arv->raiz = novo;
     }
-    else if (comparar_segmentos(arv, seg, pai->segmento) < 0)
+    else if (cmp < 0)
     {
         pai->esquerda = novo;
     }
@@ -223,120 +572,104 @@ int arvore_inserir(ArvoreSegmentos arvore, Segmento seg)
     {
         pai->direita = novo;
     }
-    
+
+    /* Só desceu para a esquerda: é o novo mínimo */
+    if (sempre_esquerda)
+    {
+        arv->minimo = novo;
+    }
+
+    corrigir_insercao(arv, novo);
+
     arv->tamanho++;
     return 1;
 }
 
-int arvore_remover(ArvoreSegmentos arvore, Segmento seg)
+int arvore_remover(ArvoreSegmentos arvore, int seg)
 {
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
-    if (arv == NULL || seg == NULL) return 0;
-    
-    /* Busca linear para encontrar o nó (por ponteiro do segmento) */
-    NoArvore *no = NULL;
-    NoArvore *stack[1000];
-    int stack_top = 0;
-    
-    if (arv->raiz != NULL)
-    {
-        stack[stack_top++] = arv->raiz;
-    }
-    
-    while (stack_top > 0)
-    {
-        NoArvore *atual = stack[--stack_top];
-        
-        if (atual->segmento == seg)
-        {
-            no = atual;
-            break;
-        }
-        
-        if (atual->direita != NULL) stack[stack_top++] = atual->direita;
-        if (atual->esquerda != NULL) stack[stack_top++] = atual->esquerda;
+    if (arv == NULL || seg < 0 || seg >= arv->max_segmentos) return 0;
+
+    NoArvore *z = &arv->nos[seg];
+    if (!z->presente) return 0;
+
+    if (z == arv->minimo)
+    {
+        arv->minimo = encontrar_sucessor(arv, z);
     }
-    
-    if (no == NULL) return 0;
-    
-    /* Remoção padrão da BST */
-    if (no->esquerda == NULL)
+
+    /* Remoção rubro-negra (CLRS) */
+    NoArvore *y = z;
+    NoArvore *x;
+    CorNo cor_original = y->cor;
+
+    if (z->esquerda == arv->nil)
     {
-        transplantar(arv, no, no->direita);
+        x = z->direita;
+        transplantar(arv, z, z->direita);
     }
-    else if (no->direita == NULL)
+    else if (z->direita == arv->nil)
     {
-        transplantar(arv, no, no->esquerda);
+        x = z->esquerda;
+        transplantar(arv, z, z->esquerda);
     }
     else
     {
-        NoArvore *sucessor = encontrar_minimo(no->direita);
-        
-        if (sucessor->pai != no)
+        y = encontrar_minimo(arv, z->direita);
+        cor_original = y->cor;
+        x = y->direita;
+
+        if (y->pai == z)
+        {
+            x->pai = y;
+        }
+        else
         {
-            transplantar(arv, sucessor, sucessor->direita);
-            sucessor->direita = no->direita;
-            sucessor->direita->pai = sucessor;
+            transplantar(arv, y, y->direita);
+            y->direita = z->direita;
+            y->direita->pai = y;
         }
-        
-        transplantar(arv, no, sucessor);
-        sucessor->esquerda = no->esquerda;
-        sucessor->esquerda->pai = sucessor;
+
+        transplantar(arv, z, y);
+        y->esquerda = z->esquerda;
+        y->esquerda->pai = y;
+        y->cor = z->cor;
     }
-    
-    free(no);
+
+    if (cor_original == COR_PRETO)
+    {
+        corrigir_remocao(arv, x);
+    }
+
+    z->presente = 0;
     arv->tamanho--;
     return 1;
 }
 
-Segmento arvore_obter_primeiro(ArvoreSegmentos arvore)
+int arvore_obter_primeiro(ArvoreSegmentos arvore)
 {
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
-    if (arv == NULL || arv->raiz == NULL) return NULL;
-    
-    NoArvore *minimo = encontrar_minimo(arv->raiz);
-    return minimo ? minimo->segmento : NULL;
+    if (arv == NULL || arv->raiz == arv->nil) return -1;
+
+    return arv->minimo->segmento;
 }
 
-Segmento arvore_obter_proximo(ArvoreSegmentos arvore, Segmento seg)
+int arvore_obter_proximo(ArvoreSegmentos arvore, int seg)
 {
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
-    if (arv == NULL || seg == NULL) return NULL;
-    
-    /* Busca linear para encontrar o nó */
-    NoArvore *no = NULL;
-    NoArvore *stack[1000];
-    int stack_top = 0;
-    
-    if (arv->raiz != NULL)
-    {
-        stack[stack_top++] = arv->raiz;
-    }
-    
-    while (stack_top > 0)
-    {
-        NoArvore *atual = stack[--stack_top];
-        
-        if (atual->segmento == seg)
-        {
-            no = atual;
-            break;
-        }
-        
-        if (atual->direita != NULL) stack[stack_top++] = atual->direita;
-        if (atual->esquerda != NULL) stack[stack_top++] = atual->esquerda;
-    }
-    
-    if (no == NULL) return NULL;
-    
-    NoArvore *sucessor = encontrar_sucessor(no);
-    return sucessor ? sucessor->segmento : NULL;
+    if (arv == NULL || seg < 0 || seg >= arv->max_segmentos) return -1;
+
+    NoArvore *no = &arv->nos[seg];
+    if (!no->presente) return -1;
+
+    NoArvore *sucessor = encontrar_sucessor(arv, no);
+    return (sucessor != arv->nil) ? sucessor->segmento : -1;
 }
 
 int arvore_vazia(ArvoreSegmentos arvore)
 {
     ArvoreInternal *arv = (ArvoreInternal*)arvore;
-    return (arv == NULL || arv->raiz == NULL);
+    return (arv == NULL || arv->raiz == arv->nil);
 }
 
 int arvore_tamanho(ArvoreSegmentos arvore)
@@ -1,15 +1,19 @@
 /* arvore.h
  *
  * TAD Árvore de Segmentos Ativos
- * Árvore binária de busca para o algoritmo de varredura angular.
+ * Árvore rubro-negra para o algoritmo de varredura angular.
  * Ordena segmentos pela distância ao ponto de vista.
+ * Inserção, remoção e obtenção do primeiro são O(log n) no pior caso.
+ *
+ * Segmentos são identificados por índices 0..max_segmentos-1 (posições
+ * no vetor de trabalho da varredura); -1 indica "nenhum".
  */
 
 #ifndef ARVORE_H
 #define ARVORE_H
 
-#include "segmento.h"
 #include "ponto.h"
+#include "arena.h"
 
 /* Tipo opaco para Árvore de Segmentos */
 typedef void* ArvoreSegmentos;
@@ -21,18 +25,28 @@ typedef void* ArvoreSegmentos;
 /**
  * Cria uma nova árvore de segmentos.
  * @param origem Ponto de vista (origem dos raios)
+ * @param max_segmentos Quantidade de índices de segmento possíveis
  * @return Nova árvore, ou NULL em caso de erro
  * 
- * @note A árvore mantém referência à origem para comparações.
+ * @note A árvore copia as coordenadas da origem para as comparações.
  */
-ArvoreSegmentos arvore_criar(Ponto origem);
+ArvoreSegmentos arvore_criar(Ponto origem, int max_segmentos);
+
+/**
+ * Cria uma árvore cuja memória (estrutura e nós) vem de uma arena.
+ * @param origem Ponto de vista (origem dos raios)
+ * @param max_segmentos Quantidade de índices de segmento possíveis
+ * @param arena Arena de origem (NULL equivale a arvore_criar)
+ * @return Nova árvore, ou NULL em caso de erro
+ *
+ * @note A memória é devolvida pelo reset da arena; arvore_destruir não a libera.
+ */
+ArvoreSegmentos arvore_criar_na_arena(Ponto origem, int max_segmentos, Arena arena);
 
 /**
  * Destroi a árvore de segmentos.
  * @param arvore Árvore a ser destruída
  * 
- * @note NÃO destrói os segmentos armazenados!
- *       O chamador é responsável pela memória dos segmentos.
  */
 void arvore_destruir(ArvoreSegmentos arvore);
 
@@ -48,21 +62,36 @@ void arvore_destruir(ArvoreSegmentos arvore);
  */
 void arvore_definir_angulo(ArvoreSegmentos arvore, double angulo);
 
+/**
+ * Atualiza a direção do raio da varredura sem passar por ângulo.
+ * Equivalente a arvore_definir_angulo com atan2(dy, dx), mas sem
+ * funções trigonométricas.
+ * @param arvore Árvore de segmentos
+ * @param dx Componente x da direção (não precisa ser unitária)
+ * @param dy Componente y da direção
+ */
+void arvore_definir_direcao(ArvoreSegmentos arvore, double dx, double dy);
+
 /**
  * Insere um segmento na árvore.
  * @param arvore Árvore de segmentos
- * @param seg Segmento a inserir
- * @return 1 se inseriu com sucesso, 0 caso contrário
+ * @param seg Índice do segmento a inserir
+ * @param x1 Coordenada X do primeiro extremo
+ * @param y1 Coordenada Y do primeiro extremo
+ * @param x2 Coordenada X do segundo extremo
+ * @param y2 Coordenada Y do segundo extremo
+ * @return 1 se inseriu com sucesso, 0 caso contrário (inclusive se já presente)
  */
-int arvore_inserir(ArvoreSegmentos arvore, Segmento seg);
+int arvore_inserir(ArvoreSegmentos arvore, int seg,
+                   double x1, double y1, double x2, double y2);
 
 /**
  * Remove um segmento da árvore.
  * @param arvore Árvore de segmentos
- * @param seg Segmento a remover
+ * @param seg Índice do segmento a remover
  * @return 1 se removeu com sucesso, 0 se não encontrou
  */
-int arvore_remover(ArvoreSegmentos arvore, Segmento seg);
+int arvore_remover(ArvoreSegmentos arvore, int seg);
 
 /* ============================================================================
  * Funções de Consulta
@@ -71,17 +100,17 @@ int arvore_remover(ArvoreSegmentos arvore, Segmento seg);
 /**
  * Obtém o segmento mais próximo da origem (o "biombo").
  * @param arvore Árvore de segmentos
- * @return Segmento mais próximo, ou NULL se árvore vazia
+ * @return Índice do segmento mais próximo, ou -1 se árvore vazia
  */
-Segmento arvore_obter_primeiro(ArvoreSegmentos arvore);
+int arvore_obter_primeiro(ArvoreSegmentos arvore);
 
 /**
  * Obtém o próximo segmento após um dado segmento (logo atrás dele).
  * @param arvore Árvore de segmentos
- * @param seg Segmento de referência
- * @return Próximo segmento, ou NULL se não existe
+ * @param seg Índice do segmento de referência
+ * @return Índice do próximo segmento, ou -1 se não existe
  */
-Segmento arvore_obter_proximo(ArvoreSegmentos arvore, Segmento seg);
+int arvore_obter_proximo(ArvoreSegmentos arvore, int seg);
 
 /**
  * Verifica se a árvore está vazia.
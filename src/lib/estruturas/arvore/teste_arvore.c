@@ -7,17 +7,17 @@
 #include <assert.h>
 #include "arvore.h"
 #include "ponto.h"
-#include "segmento.h"
 
 void teste_basico() {
     printf("Teste Básico: ");
     Ponto origem = criar_ponto(0, 0);
-    ArvoreSegmentos arv = arvore_criar(origem);
-    
+    ArvoreSegmentos arv = arvore_criar(origem, 4);
+
     assert(arv != NULL);
     assert(arvore_vazia(arv));
     assert(arvore_tamanho(arv) == 0);
-    
+    assert(arvore_obter_primeiro(arv) == -1);
+
     arvore_destruir(arv);
     destruir_ponto(origem);
     printf("OK\n");
@@ -26,38 +26,140 @@ void teste_basico() {
 void teste_insercao_remocao() {
     printf("Teste Inserção e Remoção: ");
     Ponto origem = criar_ponto(0, 0);
-    ArvoreSegmentos arv = arvore_criar(origem);
-    
+    ArvoreSegmentos arv = arvore_criar(origem, 2);
+
     /* Segmentos fictícios */
-    /* s1: y=2 */
-    Segmento s1 = criar_segmento(1, 1, -10, 2, 10, 2, "red");
-    /* s2: y=4 (mais longe) */
-    Segmento s2 = criar_segmento(2, 2, -10, 4, 10, 4, "blue");
-    
-    arvore_inserir(arv, s1);
+    /* 0: y=2 */
+    /* 1: y=4 (mais longe) */
+    arvore_inserir(arv, 0, -10, 2, 10, 2);
     assert(arvore_tamanho(arv) == 1);
     assert(!arvore_vazia(arv));
-    assert(arvore_obter_primeiro(arv) == s1); /* Mais perto */
-    
-    arvore_inserir(arv, s2);
+    assert(arvore_obter_primeiro(arv) == 0); /* Mais perto */
+
+    arvore_inserir(arv, 1, -10, 4, 10, 4);
     assert(arvore_tamanho(arv) == 2);
-    assert(arvore_obter_primeiro(arv) == s1); /* s1 ainda é mais perto */
-    
+    assert(arvore_obter_primeiro(arv) == 0); /* 0 ainda é mais perto */
+
     /* Teste próximo */
-    assert(arvore_obter_proximo(arv, s1) == s2);
-    
+    assert(arvore_obter_proximo(arv, 0) == 1);
+
+    /* Índice fora do intervalo é rejeitado */
+    assert(!arvore_inserir(arv, 2, -10, 6, 10, 6));
+
     /* Remoção */
-    arvore_remover(arv, s1);
+    arvore_remover(arv, 0);
     assert(arvore_tamanho(arv) == 1);
-    assert(arvore_obter_primeiro(arv) == s2);
-    
-    arvore_remover(arv, s2);
+    assert(arvore_obter_primeiro(arv) == 1);
+
+    arvore_remover(arv, 1);
+    assert(arvore_vazia(arv));
+
+    arvore_destruir(arv);
+    destruir_ponto(origem);
+    printf("OK\n");
+}
+
+void teste_direcao() {
+    printf("Teste Direção sem Ângulo: ");
+    Ponto origem = criar_ponto(0, 0);
+    /* 0: x=2 (vertical), 1: y=3 (horizontal) */
+
+    /* Raio para cima (direção não unitária): só o 1 é atingido */
+    ArvoreSegmentos arv = arvore_criar(origem, 2);
+    arvore_definir_direcao(arv, 0, 5);
+    arvore_inserir(arv, 0, 2, -10, 2, 10);
+    arvore_inserir(arv, 1, -10, 3, 10, 3);
+    assert(arvore_obter_primeiro(arv) == 1);
+    arvore_destruir(arv);
+
+    /* Diagonal: 0 em (2,2) vem antes de 1 em (3,3) */
+    arv = arvore_criar(origem, 2);
+    arvore_definir_direcao(arv, 1, 1);
+    arvore_inserir(arv, 1, -10, 3, 10, 3);
+    arvore_inserir(arv, 0, 2, -10, 2, 10);
+    assert(arvore_obter_primeiro(arv) == 0);
+    assert(arvore_obter_proximo(arv, 0) == 1);
+    arvore_destruir(arv);
+
+    destruir_ponto(origem);
+    printf("OK\n");
+}
+
+void teste_extremo_comum() {
+    printf("Teste Extremo Comum no Raio: ");
+    Ponto origem = criar_ponto(0, 0);
+
+    /* Raio pelo canto (10,10): 0 segue para a esquerda, voltado à origem;
+     * 1 sobe, atrás dele. As distâncias empatam no canto; logo depois do
+     * raio (sentido anti-horário) o 0 é o mais perto, em qualquer ordem
+     * de inserção e com qualquer forma da árvore. */
+    for (int ordem = 0; ordem < 2; ordem++) {
+        for (int extras = 0; extras <= 6; extras += 3) {
+            ArvoreSegmentos arv = arvore_criar(origem, 2 + extras);
+            arvore_definir_direcao(arv, 1, 1);
+
+            /* Segmentos mais longe, para variar a forma da árvore */
+            for (int k = 0; k < extras; k++) {
+                assert(arvore_inserir(arv, 2 + k, 30 + k, -100, 30 + k, 100));
+            }
+
+            if (ordem == 0) {
+                assert(arvore_inserir(arv, 1, 10, 10, 10, 20));
+                assert(arvore_inserir(arv, 0, 10, 10, 0, 10));
+            } else {
+                assert(arvore_inserir(arv, 0, 0, 10, 10, 10));
+                assert(arvore_inserir(arv, 1, 10, 20, 10, 10));
+            }
+            assert(arvore_obter_primeiro(arv) == 0);
+            assert(arvore_obter_proximo(arv, 0) == 1);
+
+            arvore_destruir(arv);
+        }
+    }
+
+    destruir_ponto(origem);
+    printf("OK\n");
+}
+
+void teste_muitos_segmentos() {
+    printf("Teste Muitos Segmentos (ordem crescente): ");
+    const int n = 5000;
+    Ponto origem = criar_ponto(0, 0);
+    ArvoreSegmentos arv = arvore_criar(origem, n);
+    arvore_definir_angulo(arv, 1.5707963267948966); /* raio para cima */
+
+    /* Segmentos horizontais y = 1..n, inseridos do mais perto ao mais longe
+     * (pior caso para a BST simples) */
+    for (int i = 0; i < n; i++) {
+        assert(arvore_inserir(arv, i, -10, i + 1, 10, i + 1));
+    }
+    assert(arvore_tamanho(arv) == n);
+    assert(arvore_obter_primeiro(arv) == 0);
+
+    /* Inserção repetida é rejeitada */
+    assert(!arvore_inserir(arv, 0, -10, 1, 10, 1));
+    assert(arvore_tamanho(arv) == n);
+
+    /* Percurso em ordem */
+    int s = arvore_obter_primeiro(arv);
+    for (int i = 1; i < n; i++) {
+        s = arvore_obter_proximo(arv, s);
+        assert(s == i);
+    }
+    assert(arvore_obter_proximo(arv, s) == -1);
+
+    /* Remove os pares, depois os ímpares */
+    for (int i = 0; i < n; i += 2) assert(arvore_remover(arv, i));
+    assert(arvore_obter_primeiro(arv) == 1);
+    assert(!arvore_remover(arv, 0));
+    for (int i = 1; i < n; i += 2) assert(arvore_remover(arv, i));
     assert(arvore_vazia(arv));
-    
+
+    /* Os nós podem ser reutilizados */
+    assert(arvore_inserir(arv, 7, -10, 8, 10, 8));
+    assert(arvore_obter_primeiro(arv) == 7);
+
     arvore_destruir(arv);
-    
-    destruir_segmento(s1);
-    destruir_segmento(s2);
     destruir_ponto(origem);
     printf("OK\n");
 }
@@ -66,6 +168,9 @@ int main() {
     printf("=== Testes Unitários: Árvore ===\n");
     teste_basico();
     teste_insercao_remocao();
+    teste_direcao();
+    teste_extremo_comum();
+    teste_muitos_segmentos();
     printf("Todos os testes passaram!\n");
     return 0;
 }
@@ -0,0 +1,384 @@
+/* grade.c
+ *
+ * Implementação do TAD Grade Uniforme de Formas
+ * As formas ficam em um vetor de entradas (o índice da entrada é a ordem
+ * de inserção) e cada célula guarda os índices das entradas que a cobrem.
+ * A consulta marca as entradas já vistas para não repeti-las e ordena os
+ * índices encontrados, recuperando a ordem da lista de formas.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "grade.h"
+
+#define LADO_MAXIMO 1024        /* Limite de células por eixo */
+#define CAPACIDADE_CELULA 4
+#define FOLGA_CONSULTA 1e-6     /* Expande a consulta contra erros de arredondamento */
+
+/* ============================================================================
+ * Estrutura Interna
+ * ============================================================================ */
+
+typedef struct entrada
+{
+    Forma forma;
+    double min_x, min_y, max_x, max_y;
+    unsigned marca;             /* Última consulta que visitou a entrada */
+} Entrada;
+
+typedef struct celula
+{
+    int *itens;                 /* Índices de entradas */
+    int tamanho;
+    int capacidade;
+} Celula;
+
+typedef struct grade_internal
+{
+    double min_x, min_y;
+    double largura_celula, altura_celula;
+    int nx, ny;
+    Celula *celulas;
+
+    Entrada *entradas;
+    int num_entradas;
+    int capacidade_entradas;
+    int num_vivas;
+
+    unsigned marca_atual;
+    int *indices;               /* Resultado da consulta (índices de entradas) */
+    Forma *resultado;           /* Resultado da consulta (formas) */
+    int capacidade_resultado;
+} GradeInternal;
+
+/* ============================================================================
+ * Funções Auxiliares
+ * ============================================================================ */
+
+static int coluna(GradeInternal *g, double x)
+{
+    double c = floor((x - g->min_x) / g->largura_celula);
+    if (c < 0) return 0;
+    if (c >= g->nx) return g->nx - 1;
+    return (int)c;
+}
+
+static int linha(GradeInternal *g, double y)
+{
+    double l = floor((y - g->min_y) / g->altura_celula);
+    if (l < 0) return 0;
+    if (l >= g->ny) return g->ny - 1;
+    return (int)l;
+}
+
+static int celula_adicionar(Celula *c, int item)
+{
+    if (c->tamanho == c->capacidade)
+    {
+        int nova = c->capacidade > 0 ? c->capacidade * 2 : CAPACIDADE_CELULA;
+        int *itens = (int*)realloc(c->itens, nova * sizeof(int));
+        if (itens == NULL)
+        {
+            fprintf(stderr, "Erro: falha ao expandir célula da grade.\n");
+            return 0;
+        }
+        c->itens = itens;
+        c->capacidade = nova;
+    }
+
+    c->itens[c->tamanho++] = item;
+    return 1;
+}
+
+static void celula_remover(Celula *c, int item)
+{
+    for (int i = 0; i < c->tamanho; i++)
+    {
+        if (c->itens[i] == item)
+        {
+            c->itens[i] = c->itens[--c->tamanho];
+            return;
+        }
+    }
+}
+
+static int comparar_indices(const void *a, const void *b)
+{
+    int i1 = *(const int*)a;
+    int i2 = *(const int*)b;
+    return (i1 > i2) - (i1 < i2);
+}
+
+/* ============================================================================
+ * Implementação das Funções de Criação e Destruição
+ * ============================================================================ */
+
+Grade grade_criar(double min_x, double min_y, double max_x, double max_y,
+                  int num_formas)
+{
+    GradeInternal *g = (GradeInternal*)calloc(1, sizeof(GradeInternal));
+    if (g == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar grade.\n");
+        return NULL;
+    }
+
+    double largura = max_x - min_x;
+    double altura = max_y - min_y;
+    if (num_formas < 1) num_formas = 1;
+
+    /* Células aproximadamente quadradas, em torno de uma forma por célula */
+    double lado = sqrt((largura * altura) / num_formas);
+    if (!(lado > 0))
+    {
+        double maior = largura > altura ? largura : altura;
+        lado = maior > 0 ? maior / sqrt((double)num_formas) : 1.0;
+    }
+
+    g->nx = (int)ceil(largura / lado);
+    g->ny = (int)ceil(altura / lado);
+    if (g->nx < 1) g->nx = 1;
+    if (g->ny < 1) g->ny = 1;
+    if (g->nx > LADO_MAXIMO) g->nx = LADO_MAXIMO;
+    if (g->ny > LADO_MAXIMO) g->ny = LADO_MAXIMO;
+
+    g->min_x = min_x;
+    g->min_y = min_y;
+    g->largura_celula = largura > 0 ? largura / g->nx : 1.0;
+    g->altura_celula = altura > 0 ? altura / g->ny : 1.0;
+
+    g->celulas = (Celula*)calloc((size_t)g->nx * g->ny, sizeof(Celula));
+    if (g->celulas == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar células da grade.\n");
+        free(g);
+        return NULL;
+    }
+
+    return (Grade)g;
+}
+
+Grade grade_criar_de_lista(Lista formas)
+{
+    if (formas == NULL) return NULL;
+
+    int primeira = 1, num_formas = 0;
+    double min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+
+    No atual = obter_primeiro(formas);
+    while (atual != NULL)
+    {
+        Forma forma = (Forma)obter_elemento(atual);
+        double fx1, fy1, fx2, fy2;
+
+        if (getFormaAtiva(forma) && getFormaLimites(forma, &fx1, &fy1, &fx2, &fy2))
+        {
+            if (primeira)
+            {
+                min_x = fx1; min_y = fy1; max_x = fx2; max_y = fy2;
+                primeira = 0;
+            }
+            else
+            {
+                if (fx1 < min_x) min_x = fx1;
+                if (fy1 < min_y) min_y = fy1;
+                if (fx2 > max_x) max_x = fx2;
+                if (fy2 > max_y) max_y = fy2;
+            }
+            num_formas++;
+        }
+
+        atual = obter_proximo(atual);
+    }
+
+    Grade grade = grade_criar(min_x, min_y, max_x, max_y, num_formas);
+    if (grade == NULL) return NULL;
+
+    atual = obter_primeiro(formas);
+    while (atual != NULL)
+    {
+        Forma forma = (Forma)obter_elemento(atual);
+        if (getFormaAtiva(forma))
+        {
+            grade_inserir(grade, forma);
+        }
+        atual = obter_proximo(atual);
+    }
+
+    return grade;
+}
+
+void grade_destruir(Grade grade)
+{
+    GradeInternal *g = (GradeInternal*)grade;
+    if (g == NULL) return;
+
+    for (int i = 0; i < g->nx * g->ny; i++)
+    {
+        free(g->celulas[i].itens);
+    }
+
+    free(g->celulas);
+    free(g->entradas);
+    free(g->indices);
+    free(g->resultado);
+    free(g);
+}
+
+/* ============================================================================
+ * Implementação das Funções de Operação
+ * ============================================================================ */
+
+int grade_inserir(Grade grade, Forma forma)
+{
+    GradeInternal *g = (GradeInternal*)grade;
+    if (g == NULL || forma == NULL) return 0;
+
+    double min_x, min_y, max_x, max_y;
+    if (!getFormaLimites(forma, &min_x, &min_y, &max_x, &max_y)) return 0;
+
+    if (g->num_entradas == g->capacidade_entradas)
+    {
+        int nova = g->capacidade_entradas > 0 ? g->capacidade_entradas * 2 : 64;
+        Entrada *entradas = (Entrada*)realloc(g->entradas, nova * sizeof(Entrada));
+        if (entradas == NULL)
+        {
+            fprintf(stderr, "Erro: falha ao expandir entradas da grade.\n");
+            return 0;
+        }
+        g->entradas = entradas;
+        g->capacidade_entradas = nova;
+    }
+
+    int k = g->num_entradas++;
+    Entrada *e = &g->entradas[k];
+    e->forma = forma;
+    e->min_x = min_x;
+    e->min_y = min_y;
+    e->max_x = max_x;
+    e->max_y = max_y;
+    e->marca = 0;
+
+    int c0 = coluna(g, min_x), c1 = coluna(g, max_x);
+    int l0 = linha(g, min_y), l1 = linha(g, max_y);
+    for (int l = l0; l <= l1; l++)
+    {
+        for (int c = c0; c <= c1; c++)
+        {
+            if (!celula_adicionar(&g->celulas[l * g->nx + c], k)) return 0;
+        }
+    }
+
+    g->num_vivas++;
+    return 1;
+}
+
+int grade_remover(Grade grade, Forma forma)
+{
+    GradeInternal *g = (GradeInternal*)grade;
+    if (g == NULL || forma == NULL) return 0;
+
+    double min_x, min_y, max_x, max_y;
+    if (!getFormaLimites(forma, &min_x, &min_y, &max_x, &max_y)) return 0;
+
+    /* A entrada está em todas as células da sua caixa; procura na primeira */
+    int c0 = coluna(g, min_x), c1 = coluna(g, max_x);
+    int l0 = linha(g, min_y), l1 = linha(g, max_y);
+    Celula *primeira = &g->celulas[l0 * g->nx + c0];
+
+    int k = -1;
+    for (int i = 0; i < primeira->tamanho; i++)
+    {
+        if (g->entradas[primeira->itens[i]].forma == forma)
+        {
+            k = primeira->itens[i];
+            break;
+        }
+    }
+    if (k < 0) return 0;
+
+    for (int l = l0; l <= l1; l++)
+    {
+        for (int c = c0; c <= c1; c++)
+        {
+            celula_remover(&g->celulas[l * g->nx + c], k);
+        }
+    }
+
+    g->entradas[k].forma = NULL;
+    g->num_vivas--;
+    return 1;
+}
+
+Forma* grade_consultar(Grade grade, double min_x, double min_y,
+                       double max_x, double max_y, int *num_formas)
+{
+    GradeInternal *g = (GradeInternal*)grade;
+    *num_formas = 0;
+    if (g == NULL) return NULL;
+
+    min_x -= FOLGA_CONSULTA;
+    min_y -= FOLGA_CONSULTA;
+    max_x += FOLGA_CONSULTA;
+    max_y += FOLGA_CONSULTA;
+
+    if (g->capacidade_resultado < g->num_vivas)
+    {
+        int nova = g->num_vivas;
+        int *indices = (int*)realloc(g->indices, nova * sizeof(int));
+        if (indices != NULL) g->indices = indices;
+        Forma *resultado = (Forma*)realloc(g->resultado, nova * sizeof(Forma));
+        if (resultado != NULL) g->resultado = resultado;
+        if (indices == NULL || resultado == NULL)
+        {
+            fprintf(stderr, "Erro: falha ao alocar resultado da grade.\n");
+            return NULL;
+        }
+        g->capacidade_resultado = nova;
+    }
+
+    /* Nova marca; ao dar a volta no contador, zera as marcas antigas */
+    if (++g->marca_atual == 0)
+    {
+        for (int i = 0; i < g->num_entradas; i++) g->entradas[i].marca = 0;
+        g->marca_atual = 1;
+    }
+
+    int n = 0;
+    int c0 = coluna(g, min_x), c1 = coluna(g, max_x);
+    int l0 = linha(g, min_y), l1 = linha(g, max_y);
+    for (int l = l0; l <= l1; l++)
+    {
+        for (int c = c0; c <= c1; c++)
+        {
+            Celula *cel = &g->celulas[l * g->nx + c];
+            for (int i = 0; i < cel->tamanho; i++)
+            {
+                Entrada *e = &g->entradas[cel->itens[i]];
+                if (e->marca == g->marca_atual) continue;
+                e->marca = g->marca_atual;
+
+                if (e->max_x < min_x || e->min_x > max_x ||
+                    e->max_y < min_y || e->min_y > max_y) continue;
+
+                g->indices[n++] = cel->itens[i];
+            }
+        }
+    }
+
+    if (n > 1) qsort(g->indices, n, sizeof(int), comparar_indices);
+    for (int i = 0; i < n; i++)
+    {
+        g->resultado[i] = g->entradas[g->indices[i]].forma;
+    }
+
+    *num_formas = n;
+    return g->resultado;
+}
+
+int grade_tamanho(Grade grade)
+{
+    GradeInternal *g = (GradeInternal*)grade;
+    return g ? g->num_vivas : 0;
+}
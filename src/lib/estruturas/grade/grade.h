@@ -0,0 +1,86 @@
+/* grade.h
+ *
+ * TAD Grade Uniforme de Formas
+ * Índice espacial das caixas envolventes das formas do cenário. Cada
+ * forma é registrada em todas as células que sua caixa cobre; a consulta
+ * por retângulo devolve as formas candidatas na ordem de inserção, que é
+ * a mesma ordem da lista de formas.
+ *
+ * Formas fora dos limites da grade (clones deslocados, por exemplo) caem
+ * nas células da borda, então a consulta continua correta.
+ */
+
+#ifndef GRADE_H
+#define GRADE_H
+
+#include "lista.h"
+#include "formas.h"
+
+/* Tipo opaco para Grade */
+typedef void* Grade;
+
+/* ============================================================================
+ * Funções de Criação e Destruição
+ * ============================================================================ */
+
+/**
+ * Cria uma grade vazia cobrindo o retângulo dado.
+ * @param min_x, min_y, max_x, max_y Limites da região indexada
+ * @param num_formas Número esperado de formas (define o tamanho das células)
+ * @return Nova grade, ou NULL em caso de erro
+ */
+Grade grade_criar(double min_x, double min_y, double max_x, double max_y,
+                  int num_formas);
+
+/**
+ * Cria uma grade com todas as formas ativas da lista, na ordem da lista.
+ * Os limites são os das próprias formas.
+ * @param formas Lista de formas
+ * @return Nova grade, ou NULL em caso de erro
+ */
+Grade grade_criar_de_lista(Lista formas);
+
+/**
+ * Destroi a grade (as formas não são destruídas).
+ * @param grade Grade a ser destruída
+ */
+void grade_destruir(Grade grade);
+
+/* ============================================================================
+ * Funções de Operação
+ * ============================================================================ */
+
+/**
+ * Insere uma forma na grade. Deve ser chamada na mesma ordem em que as
+ * formas entram na lista, para que as consultas preservem essa ordem.
+ * @param grade Grade de destino
+ * @param forma Forma a ser indexada
+ * @return 1 em caso de sucesso, 0 em caso de erro
+ */
+int grade_inserir(Grade grade, Forma forma);
+
+/**
+ * Remove uma forma da grade (forma destruída ou convertida em anteparo).
+ * @param grade Grade
+ * @param forma Forma a ser removida
+ * @return 1 se a forma foi encontrada e removida, 0 caso contrário
+ */
+int grade_remover(Grade grade, Forma forma);
+
+/**
+ * Obtém as formas cuja caixa envolvente intercepta o retângulo dado,
+ * sem repetição e na ordem de inserção.
+ * @param grade Grade
+ * @param min_x, min_y, max_x, max_y Retângulo de consulta
+ * @param num_formas OUT: quantidade de formas devolvidas
+ * @return Vetor interno de formas, válido até a próxima consulta (NÃO DAR FREE)
+ */
+Forma* grade_consultar(Grade grade, double min_x, double min_y,
+                       double max_x, double max_y, int *num_formas);
+
+/**
+ * Obtém o número de formas indexadas.
+ */
+int grade_tamanho(Grade grade);
+
+#endif /* GRADE_H */
@@ -0,0 +1,246 @@
+/* grade_segmentos.c
+ *
+ * Implementação do TAD Grade Uniforme de Segmentos
+ * As células ficam em formato compacto: inicio[c] .. inicio[c + 1] é o
+ * trecho de itens da célula c. Sem marcas de visita, a consulta devolve
+ * cada segmento só na primeira célula (em linha e coluna) comum à caixa
+ * do segmento e ao retângulo consultado.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "grade_segmentos.h"
+
+#define LADO_MAXIMO 1024        /* Limite de células por eixo */
+#define FOLGA_CONSULTA 1e-6     /* Expande a consulta contra erros de arredondamento */
+
+/* ============================================================================
+ * Estrutura Interna
+ * ============================================================================ */
+
+typedef struct grade_segmentos_internal
+{
+    VetorSegmentos segmentos;   /* Vetor indexado (NULL: grade vazia) */
+    unsigned versao;            /* Versão do vetor quando a grade foi montada */
+
+    double min_x, min_y;
+    double largura_celula, altura_celula;
+    int nx, ny;
+
+    int *inicio;                /* nx * ny + 1 posições em itens */
+    int *itens;                 /* Índices de segmentos, célula a célula */
+} GradeSegmentosInternal;
+
+/* ============================================================================
+ * Funções Auxiliares
+ * ============================================================================ */
+
+static int coluna(GradeSegmentosInternal *g, double x)
+{
+    double c = floor((x - g->min_x) / g->largura_celula);
+    if (c < 0) return 0;
+    if (c >= g->nx) return g->nx - 1;
+    return (int)c;
+}
+
+static int linha(GradeSegmentosInternal *g, double y)
+{
+    double l = floor((y - g->min_y) / g->altura_celula);
+    if (l < 0) return 0;
+    if (l >= g->ny) return g->ny - 1;
+    return (int)l;
+}
+
+static int comparar_indices(const void *a, const void *b)
+{
+    int i1 = *(const int*)a;
+    int i2 = *(const int*)b;
+    return (i1 > i2) - (i1 < i2);
+}
+
+static void liberar_celulas(GradeSegmentosInternal *g)
+{
+    free(g->inicio);
+    free(g->itens);
+    g->inicio = NULL;
+    g->itens = NULL;
+    g->segmentos = NULL;
+}
+
+/**
+ * Define os limites e o tamanho das células: aproximadamente quadradas,
+ * em torno de um segmento por célula.
+ */
+static void dimensionar(GradeSegmentosInternal *g, const double *x1, const double *y1,
+                        const double *x2, const double *y2, int n)
+{
+    double min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+    for (int i = 0; i < n; i++)
+    {
+        double ax = fmin(x1[i], x2[i]), bx = fmax(x1[i], x2[i]);
+        double ay = fmin(y1[i], y2[i]), by = fmax(y1[i], y2[i]);
+        if (i == 0 || ax < min_x) min_x = ax;
+        if (i == 0 || ay < min_y) min_y = ay;
+        if (i == 0 || bx > max_x) max_x = bx;
+        if (i == 0 || by > max_y) max_y = by;
+    }
+
+    double largura = max_x - min_x;
+    double altura = max_y - min_y;
+    int num = n > 0 ? n : 1;
+
+    double lado = sqrt((largura * altura) / num);
+    if (!(lado > 0))
+    {
+        double maior = largura > altura ? largura : altura;
+        lado = maior > 0 ? maior / sqrt((double)num) : 1.0;
+    }
+
+    g->nx = (int)ceil(largura / lado);
+    g->ny = (int)ceil(altura / lado);
+    if (g->nx < 1) g->nx = 1;
+    if (g->ny < 1) g->ny = 1;
+    if (g->nx > LADO_MAXIMO) g->nx = LADO_MAXIMO;
+    if (g->ny > LADO_MAXIMO) g->ny = LADO_MAXIMO;
+
+    g->min_x = min_x;
+    g->min_y = min_y;
+    g->largura_celula = largura > 0 ? largura / g->nx : 1.0;
+    g->altura_celula = altura > 0 ? altura / g->ny : 1.0;
+}
+
+/* ============================================================================
+ * Implementação das Funções de Criação e Destruição
+ * ============================================================================ */
+
+GradeSegmentos grade_segmentos_criar(void)
+{
+    GradeSegmentosInternal *g = (GradeSegmentosInternal*)calloc(1, sizeof(GradeSegmentosInternal));
+    if (g == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar grade de segmentos.\n");
+        return NULL;
+    }
+    return (GradeSegmentos)g;
+}
+
+void grade_segmentos_destruir(GradeSegmentos grade)
+{
+    GradeSegmentosInternal *g = (GradeSegmentosInternal*)grade;
+    if (g == NULL) return;
+
+    liberar_celulas(g);
+    free(g);
+}
+
+/* ============================================================================
+ * Implementação das Funções de Operação
+ * ============================================================================ */
+
+int grade_segmentos_preparar(GradeSegmentos grade, VetorSegmentos segmentos)
+{
+    GradeSegmentosInternal *g = (GradeSegmentosInternal*)grade;
+    if (g == NULL || segmentos == NULL) return 0;
+
+    unsigned versao = vetor_segmentos_versao(segmentos);
+    if (g->segmentos == segmentos && g->versao == versao) return 1;
+
+    liberar_celulas(g);
+
+    const double *x1, *y1, *x2, *y2;
+    int n = vetor_segmentos_coordenadas(segmentos, &x1, &y1, &x2, &y2);
+    dimensionar(g, x1, y1, x2, y2, n);
+
+    int num_celulas = g->nx * g->ny;
+    g->inicio = (int*)calloc((size_t)num_celulas + 1, sizeof(int));
+    if (g->inicio == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar células da grade de segmentos.\n");
+        return 0;
+    }
+
+    /* Primeira passada: quantos itens cada célula recebe */
+    size_t total = 0;
+    for (int i = 0; i < n; i++)
+    {
+        int c0 = coluna(g, fmin(x1[i], x2[i])), c1 = coluna(g, fmax(x1[i], x2[i]));
+        int l0 = linha(g, fmin(y1[i], y2[i])), l1 = linha(g, fmax(y1[i], y2[i]));
+        for (int l = l0; l <= l1; l++)
+        {
+            for (int c = c0; c <= c1; c++) g->inicio[l * g->nx + c + 1]++;
+        }
+        total += (size_t)(c1 - c0 + 1) * (l1 - l0 + 1);
+    }
+    for (int c = 0; c < num_celulas; c++) g->inicio[c + 1] += g->inicio[c];
+
+    g->itens = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    int *livre = (int*)malloc((size_t)num_celulas * sizeof(int));
+    if (g->itens == NULL || livre == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar itens da grade de segmentos.\n");
+        free(livre);
+        liberar_celulas(g);
+        return 0;
+    }
+
+    /* Segunda passada: cada célula em ordem crescente de segmento */
+    for (int c = 0; c < num_celulas; c++) livre[c] = g->inicio[c];
+    for (int i = 0; i < n; i++)
+    {
+        int c0 = coluna(g, fmin(x1[i], x2[i])), c1 = coluna(g, fmax(x1[i], x2[i]));
+        int l0 = linha(g, fmin(y1[i], y2[i])), l1 = linha(g, fmax(y1[i], y2[i]));
+        for (int l = l0; l <= l1; l++)
+        {
+            for (int c = c0; c <= c1; c++) g->itens[livre[l * g->nx + c]++] = i;
+        }
+    }
+    free(livre);
+
+    g->segmentos = segmentos;
+    g->versao = versao;
+    return 1;
+}
+
+int grade_segmentos_consultar(GradeSegmentos grade, double min_x, double min_y,
+                              double max_x, double max_y, int *indices)
+{
+    GradeSegmentosInternal *g = (GradeSegmentosInternal*)grade;
+    if (g == NULL || g->segmentos == NULL || indices == NULL) return 0;
+
+    min_x -= FOLGA_CONSULTA;
+    min_y -= FOLGA_CONSULTA;
+    max_x += FOLGA_CONSULTA;
+    max_y += FOLGA_CONSULTA;
+
+    const double *x1, *y1, *x2, *y2;
+    vetor_segmentos_coordenadas(g->segmentos, &x1, &y1, &x2, &y2);
+
+    int c0 = coluna(g, min_x), c1 = coluna(g, max_x);
+    int l0 = linha(g, min_y), l1 = linha(g, max_y);
+    int quantidade = 0;
+
+    for (int l = l0; l <= l1; l++)
+    {
+        for (int c = c0; c <= c1; c++)
+        {
+            int celula = l * g->nx + c;
+            for (int k = g->inicio[celula]; k < g->inicio[celula + 1]; k++)
+            {
+                int i = g->itens[k];
+                double ax = fmin(x1[i], x2[i]), bx = fmax(x1[i], x2[i]);
+                double ay = fmin(y1[i], y2[i]), by = fmax(y1[i], y2[i]);
+                if (bx < min_x || ax > max_x || by < min_y || ay > max_y) continue;
+
+                /* Só na primeira célula comum à caixa e à consulta */
+                int cs = coluna(g, ax), ls = linha(g, ay);
+                if (c != (cs > c0 ? cs : c0) || l != (ls > l0 ? ls : l0)) continue;
+
+                indices[quantidade++] = i;
+            }
+        }
+    }
+
+    qsort(indices, quantidade, sizeof(int), comparar_indices);
+    return quantidade;
+}
@@ -0,0 +1,63 @@
+/* grade_segmentos.h
+ *
+ * TAD Grade Uniforme de Segmentos
+ * Índice espacial dos anteparos (vetor de segmentos) para consultas por
+ * retângulo, usado pelas bombas com raio: só os segmentos perto da bomba
+ * entram na varredura. Cada segmento é registrado nas células que a sua
+ * caixa envolvente cobre.
+ *
+ * A grade é montada a partir do vetor inteiro e refeita quando a versão
+ * do vetor muda. As consultas só leem a grade (cada segmento é devolvido
+ * uma vez sem marcas), então várias threads podem consultar ao mesmo
+ * tempo.
+ */
+
+#ifndef GRADE_SEGMENTOS_H
+#define GRADE_SEGMENTOS_H
+
+#include "vetor_segmentos.h"
+
+/* Tipo opaco para Grade de Segmentos */
+typedef void* GradeSegmentos;
+
+/* ============================================================================
+ * Funções de Criação e Destruição
+ * ============================================================================ */
+
+/**
+ * Cria uma grade vazia (montada em grade_segmentos_preparar).
+ * @return Nova grade, ou NULL em caso de erro
+ */
+GradeSegmentos grade_segmentos_criar(void);
+
+/**
+ * Destroi a grade (o vetor de segmentos não é destruído).
+ * @param grade Grade a ser destruída
+ */
+void grade_segmentos_destruir(GradeSegmentos grade);
+
+/* ============================================================================
+ * Funções de Operação
+ * ============================================================================ */
+
+/**
+ * Monta a grade para o vetor, se ela não corresponde a ele ou à sua
+ * versão atual. Deve ser chamada fora das threads de consulta.
+ * @param grade Grade
+ * @param segmentos Vetor de segmentos indexado
+ * @return 1 em caso de sucesso, 0 em caso de erro
+ */
+int grade_segmentos_preparar(GradeSegmentos grade, VetorSegmentos segmentos);
+
+/**
+ * Obtém os segmentos cuja caixa envolvente intercepta o retângulo dado,
+ * sem repetição e em ordem crescente de índice.
+ * @param grade Grade preparada
+ * @param min_x, min_y, max_x, max_y Retângulo de consulta
+ * @param indices OUT: índices no vetor (espaço para vetor_segmentos_tamanho)
+ * @return Quantidade de índices escritos
+ */
+int grade_segmentos_consultar(GradeSegmentos grade, double min_x, double min_y,
+                              double max_x, double max_y, int *indices);
+
+#endif /* GRADE_SEGMENTOS_H */
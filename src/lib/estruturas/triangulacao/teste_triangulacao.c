@@ -0,0 +1,207 @@
+/* teste_triangulacao.c
+ * Teste unitário para Triangulação Restrita
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include "triangulacao.h"
+
+/* Confere orientação, simetria dos vizinhos e a contagem de Euler */
+static void verificar(Triangulacao tri) {
+    const double *x, *y;
+    const int *v, *viz, *rest;
+    int nt = triangulacao_dados(tri, &x, &y, &v, &viz, &rest);
+    int nv = triangulacao_num_vertices(tri);
+    int borda = 0;
+
+    for (int t = 0; t < nt; t++) {
+        int a = v[3 * t], b = v[3 * t + 1], c = v[3 * t + 2];
+        assert((x[b] - x[a]) * (y[c] - y[a]) - (y[b] - y[a]) * (x[c] - x[a]) > 0);
+
+        for (int i = 0; i < 3; i++) {
+            int u = viz[3 * t + i];
+            if (u < 0) {
+                borda++;
+                continue;
+            }
+            int p = v[3 * t + (i + 1) % 3], q = v[3 * t + (i + 2) % 3];
+            int achou = 0;
+            for (int k = 0; k < 3; k++) {
+                if (v[3 * u + (k + 1) % 3] == q && v[3 * u + (k + 2) % 3] == p) {
+                    assert(viz[3 * u + k] == t);
+                    assert(rest[3 * u + k] == rest[3 * t + i]);
+                    achou = 1;
+                }
+            }
+            assert(achou);
+        }
+    }
+
+    assert(nt == 2 * nv - 2 - borda);
+}
+
+/* Soma o comprimento das arestas com a restrição dada (cada aresta uma vez) */
+static double comprimento_restrito(Triangulacao tri, int id) {
+    const double *x, *y;
+    const int *v, *viz, *rest;
+    int nt = triangulacao_dados(tri, &x, &y, &v, &viz, &rest);
+    double soma = 0;
+
+    for (int t = 0; t < nt; t++) {
+        for (int i = 0; i < 3; i++) {
+            if (rest[3 * t + i] != id || (viz[3 * t + i] >= 0 && viz[3 * t + i] < t)) continue;
+            int p = v[3 * t + (i + 1) % 3], q = v[3 * t + (i + 2) % 3];
+            soma += hypot(x[q] - x[p], y[q] - y[p]);
+        }
+    }
+    return soma;
+}
+
+void teste_basico() {
+    printf("Teste Básico: ");
+    Triangulacao tri = triangulacao_criar(0, 0, 10, 10, 0);
+
+    assert(tri != NULL);
+    assert(triangulacao_num_vertices(tri) == 4);
+    assert(triangulacao_num_triangulos(tri) == 2);
+    verificar(tri);
+
+    /* Retângulo degenerado é rejeitado */
+    assert(triangulacao_criar(0, 0, 0, 10, 0) == NULL);
+
+    triangulacao_destruir(tri);
+    printf("OK\n");
+}
+
+void teste_pontos() {
+    printf("Teste Inserção de Pontos: ");
+    Triangulacao tri = triangulacao_criar(0, 0, 100, 100, 0);
+
+    int p = triangulacao_inserir_ponto(tri, 50, 50);
+    assert(p == 4);
+    assert(triangulacao_inserir_ponto(tri, 50, 50) == p);   /* Repetido */
+    assert(triangulacao_inserir_ponto(tri, 150, 50) == -1); /* Fora */
+    assert(triangulacao_inserir_ponto(tri, 0, 0) == 0);     /* Canto */
+
+    /* Sobre a borda e sobre uma aresta interna */
+    assert(triangulacao_inserir_ponto(tri, 50, 0) == 5);
+    assert(triangulacao_inserir_ponto(tri, 25, 25) == 6);
+    verificar(tri);
+
+    srand(7);
+    for (int i = 0; i < 2000; i++) {
+        double x = rand() % 10001 / 100.0, y = rand() % 10001 / 100.0;
+        int v = triangulacao_inserir_ponto(tri, x, y);
+        assert(v >= 0);
+        int t = triangulacao_localizar(tri, x, y, 0);
+        assert(t >= 0);
+    }
+    verificar(tri);
+    assert(triangulacao_localizar(tri, -1, 50, 0) == -1);
+
+    triangulacao_destruir(tri);
+    printf("OK\n");
+}
+
+void teste_restricoes() {
+    printf("Teste Restrições: ");
+    Triangulacao tri = triangulacao_criar(0, 0, 100, 100, 0);
+
+    /* Duas restrições que se cruzam em (50, 50) */
+    int a = triangulacao_inserir_ponto(tri, 10, 10);
+    int b = triangulacao_inserir_ponto(tri, 90, 90);
+    int c = triangulacao_inserir_ponto(tri, 10, 90);
+    int d = triangulacao_inserir_ponto(tri, 90, 10);
+    assert(triangulacao_inserir_restricao(tri, a, b, 0));
+    assert(triangulacao_inserir_restricao(tri, c, d, 1));
+    verificar(tri);
+    assert(fabs(comprimento_restrito(tri, 0) - 80 * sqrt(2)) < 1e-9);
+    assert(fabs(comprimento_restrito(tri, 1) - 80 * sqrt(2)) < 1e-9);
+    assert(triangulacao_num_vertices(tri) == 9);
+
+    /* Restrição que passa por um vértice no meio do caminho */
+    int e = triangulacao_inserir_ponto(tri, 30, 70);
+    int f = triangulacao_inserir_ponto(tri, 30, 20);
+    assert(triangulacao_inserir_ponto(tri, 30, 40) >= 0);
+    assert(triangulacao_inserir_restricao(tri, e, f, 2));
+    verificar(tri);
+    assert(fabs(comprimento_restrito(tri, 2) - 50) < 1e-9);
+
+    triangulacao_destruir(tri);
+    printf("OK\n");
+}
+
+void teste_muitas_restricoes() {
+    printf("Teste Muitas Restrições: ");
+    Triangulacao tri = triangulacao_criar(0, 0, 1000, 1000, 0);
+    const int n = 300;
+    double comprimento[300];
+
+    srand(11);
+    for (int i = 0; i < n; i++) {
+        double x1 = rand() % 100000 / 100.0, y1 = rand() % 100000 / 100.0;
+        double x2 = x1 + (rand() % 20000 - 10000) / 100.0;
+        double y2 = y1 + (rand() % 20000 - 10000) / 100.0;
+        x2 = fmin(fmax(x2, 0), 1000);
+        y2 = fmin(fmax(y2, 0), 1000);
+
+        int a = triangulacao_inserir_ponto(tri, x1, y1);
+        int b = triangulacao_inserir_ponto(tri, x2, y2);
+        assert(a >= 0 && b >= 0);
+        assert(triangulacao_inserir_restricao(tri, a, b, i));
+        comprimento[i] = hypot(x2 - x1, y2 - y1);
+    }
+    verificar(tri);
+
+    for (int i = 0; i < n; i++) {
+        assert(fabs(comprimento_restrito(tri, i) - comprimento[i]) < 1e-6);
+    }
+
+    triangulacao_destruir(tri);
+    printf("OK\n");
+}
+
+void teste_grade_de_retangulos() {
+    printf("Teste Retângulos Encostados: ");
+    Triangulacao tri = triangulacao_criar(-1, -1, 101, 101, 0);
+    int id = 0;
+
+    /* Retângulos 10x10 lado a lado: arestas colineares e repetidas */
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 10; j++) {
+            double x0 = 10 * i, y0 = 10 * j;
+            double cx[4] = {x0, x0 + 10, x0 + 10, x0};
+            double cy[4] = {y0, y0, y0 + 10, y0 + 10};
+            for (int k = 0; k < 4; k++) {
+                int a = triangulacao_inserir_ponto(tri, cx[k], cy[k]);
+                int b = triangulacao_inserir_ponto(tri, cx[(k + 1) % 4], cy[(k + 1) % 4]);
+                assert(triangulacao_inserir_restricao(tri, a, b, id++));
+            }
+        }
+    }
+    verificar(tri);
+
+    /* Uma linha longa por cima de toda a grade */
+    int a = triangulacao_inserir_ponto(tri, 0, 0);
+    int b = triangulacao_inserir_ponto(tri, 100, 100);
+    assert(triangulacao_inserir_restricao(tri, a, b, id));
+    verificar(tri);
+    assert(fabs(comprimento_restrito(tri, id) - 100 * sqrt(2)) < 1e-9);
+    assert(triangulacao_num_vertices(tri) == 4 + 121);
+
+    triangulacao_destruir(tri);
+    printf("OK\n");
+}
+
+int main() {
+    printf("=== Testes Unitários: Triangulação ===\n");
+    teste_basico();
+    teste_pontos();
+    teste_restricoes();
+    teste_muitas_restricoes();
+    teste_grade_de_retangulos();
+    printf("Todos os testes passaram!\n");
+    return 0;
+}
@@ -0,0 +1,883 @@
+/* triangulacao.c
+ *
+ * Implementação do TAD Triangulação Restrita
+ * Inserção incremental com busca por caminhada e legalização de Lawson
+ * (viradas de aresta que não viram restrições). As restrições são
+ * forçadas pelo método de Sloan: as arestas livres cruzadas pelo
+ * segmento são viradas até que nenhuma o cruze mais.
+ *
+ * Os triângulos ficam em arrays paralelos (v, viz, rest, 3 entradas por
+ * triângulo) que só crescem: uma divisão reaproveita o índice do
+ * triângulo dividido e acrescenta os novos no fim.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "triangulacao.h"
+
+#define CAPACIDADE_PADRAO 64
+#define TOLERANCIA_RELATIVA 1e-10
+#define TOLERANCIA_INCIRCULO 1e-12
+
+/* Acesso à entrada i do triângulo t */
+#define V(t, i)    (tri->v[3 * (t) + (i)])
+#define VIZ(t, i)  (tri->viz[3 * (t) + (i)])
+#define REST(t, i) (tri->rest[3 * (t) + (i)])
+
+/* ============================================================================
+ * Estrutura Interna
+ * ============================================================================ */
+
+typedef struct triangulacao_internal
+{
+    double *x, *y;          /* Coordenadas dos vértices */
+    int *tri_do_vertice;    /* Um triângulo que contém cada vértice */
+    int num_vertices;
+    int cap_vertices;
+
+    int *v;                 /* Vértices, anti-horário */
+    int *viz;               /* viz[3t+i]: vizinho pela aresta oposta ao vértice i */
+    int *rest;              /* rest[3t+i]: restrição da aresta oposta ao vértice i */
+    int num_triangulos;
+    int cap_triangulos;
+
+    int ultimo;             /* Partida da próxima localização */
+    double tolerancia;      /* Distância abaixo da qual pontos coincidem */
+
+    int *pilha;             /* Triângulos a legalizar */
+    int tam_pilha, cap_pilha;
+
+    int *estrela;           /* Triângulos ao redor de um vértice */
+    int cap_estrela;
+
+    int *fila;              /* Pares de vértices das arestas cruzadas */
+    int tam_fila, cap_fila;
+} TriangulacaoInternal;
+
+/* ============================================================================
+ * Funções Auxiliares
+ * ============================================================================ */
+
+/**
+ * Dobro da área com sinal de (a, b, c): positivo se c está à esquerda de a->b.
+ */
+static inline double orientacao(double ax, double ay, double bx, double by,
+                                double cx, double cy)
+{
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+static inline double orient_v(const TriangulacaoInternal *tri, int a, int b, int c)
+{
+    return orientacao(tri->x[a], tri->y[a], tri->x[b], tri->y[b], tri->x[c], tri->y[c]);
+}
+
+/**
+ * Lado do ponto em relação à aresta a->b, calculado sempre na ordem dos
+ * índices: os dois triângulos da aresta obtêm exatamente o sinal oposto.
+ */
+static inline double lado_aresta(const TriangulacaoInternal *tri, int a, int b,
+                                 double px, double py)
+{
+    if (a < b) return orientacao(tri->x[a], tri->y[a], tri->x[b], tri->y[b], px, py);
+    return -orientacao(tri->x[b], tri->y[b], tri->x[a], tri->y[a], px, py);
+}
+
+/**
+ * Distância do vértice c à reta que passa por a e b.
+ */
+static double distancia_reta(const TriangulacaoInternal *tri, int a, int b, double cx, double cy)
+{
+    double dx = tri->x[b] - tri->x[a], dy = tri->y[b] - tri->y[a];
+    double comprimento = sqrt(dx * dx + dy * dy);
+    if (comprimento == 0.0) return INFINITY;
+    return fabs(orientacao(tri->x[a], tri->y[a], tri->x[b], tri->y[b], cx, cy)) / comprimento;
+}
+
+/**
+ * Testa se d está dentro do círculo de (a, b, c), anti-horário, com uma
+ * margem proporcional à grandeza dos termos (evita viradas em pontos
+ * cocirculares, que poderiam se repetir para sempre).
+ */
+static int dentro_do_circulo(const TriangulacaoInternal *tri, int a, int b, int c, int d)
+{
+    double adx = tri->x[a] - tri->x[d], ady = tri->y[a] - tri->y[d];
+    double bdx = tri->x[b] - tri->x[d], bdy = tri->y[b] - tri->y[d];
+    double cdx = tri->x[c] - tri->x[d], cdy = tri->y[c] - tri->y[d];
+
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdx * cdy - cdx * bdy)
+               + blift * (cdx * ady - adx * cdy)
+               + clift * (adx * bdy - bdx * ady);
+    double escala = alift * (fabs(bdx * cdy) + fabs(cdx * bdy))
+                  + blift * (fabs(cdx * ady) + fabs(adx * cdy))
+                  + clift * (fabs(adx * bdy) + fabs(bdx * ady));
+
+    return det > TOLERANCIA_INCIRCULO * escala;
+}
+
+static int indice_no_triangulo(const TriangulacaoInternal *tri, int t, int vertice)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        if (V(t, i) == vertice) return i;
+    }
+    return -1;
+}
+
+/**
+ * Índice da aresta (a, b), nesse sentido, no triângulo t (-1 se não há).
+ */
+static int aresta_em(const TriangulacaoInternal *tri, int t, int a, int b)
+{
+    for (int k = 0; k < 3; k++)
+    {
+        if (V(t, (k + 1) % 3) == a && V(t, (k + 2) % 3) == b) return k;
+    }
+    return -1;
+}
+
+/**
+ * Garante espaço para mais vértices, triângulos e entradas da fila.
+ * @return 1 em caso de sucesso, 0 em caso de erro
+ */
+static int garantir_capacidade(TriangulacaoInternal *tri, int vertices, int triangulos)
+{
+    if (tri->num_vertices + vertices > tri->cap_vertices)
+    {
+        int cap = tri->cap_vertices * 2;
+        while (cap < tri->num_vertices + vertices) cap *= 2;
+
+        double *x = (double*)realloc(tri->x, cap * sizeof(double));
+        if (x != NULL) tri->x = x;
+        double *y = (double*)realloc(tri->y, cap * sizeof(double));
+        if (y != NULL) tri->y = y;
+        int *tv = (int*)realloc(tri->tri_do_vertice, cap * sizeof(int));
+        if (tv != NULL) tri->tri_do_vertice = tv;
+        if (x == NULL || y == NULL || tv == NULL)
+        {
+            fprintf(stderr, "Erro: falha ao expandir triangulação\n");
+            return 0;
+        }
+        tri->cap_vertices = cap;
+    }
+
+    if (tri->num_triangulos + triangulos > tri->cap_triangulos)
+    {
+        int cap = tri->cap_triangulos * 2;
+        while (cap < tri->num_triangulos + triangulos) cap *= 2;
+
+        int *v = (int*)realloc(tri->v, 3 * cap * sizeof(int));
+        if (v != NULL) tri->v = v;
+        int *viz = (int*)realloc(tri->viz, 3 * cap * sizeof(int));
+        if (viz != NULL) tri->viz = viz;
+        int *rest = (int*)realloc(tri->rest, 3 * cap * sizeof(int));
+        if (rest != NULL) tri->rest = rest;
+        if (v == NULL || viz == NULL || rest == NULL)
+        {
+            fprintf(stderr, "Erro: falha ao expandir triangulação\n");
+            return 0;
+        }
+        tri->cap_triangulos = cap;
+    }
+
+    return 1;
+}
+
+/**
+ * Acrescenta n inteiros em um vetor que cresce (pilha, fila, estrela).
+ */
+static int reservar(int **vetor, int *capacidade, int necessario)
+{
+    if (necessario <= *capacidade) return 1;
+
+    int cap = *capacidade > 0 ? *capacidade * 2 : 64;
+    while (cap < necessario) cap *= 2;
+
+    int *novo = (int*)realloc(*vetor, cap * sizeof(int));
+    if (novo == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao expandir triangulação\n");
+        return 0;
+    }
+    *vetor = novo;
+    *capacidade = cap;
+    return 1;
+}
+
+static void empilhar(TriangulacaoInternal *tri, int t)
+{
+    if (reservar(&tri->pilha, &tri->cap_pilha, tri->tam_pilha + 1))
+    {
+        tri->pilha[tri->tam_pilha++] = t;
+    }
+}
+
+static int enfileirar(TriangulacaoInternal *tri, int a, int b)
+{
+    if (!reservar(&tri->fila, &tri->cap_fila, tri->tam_fila + 2)) return 0;
+    tri->fila[tri->tam_fila++] = a;
+    tri->fila[tri->tam_fila++] = b;
+    return 1;
+}
+
+/**
+ * Define os vértices do triângulo t (vizinhos e restrições vêm de ligar).
+ */
+static void definir(TriangulacaoInternal *tri, int t, int a, int b, int c)
+{
+    V(t, 0) = a;
+    V(t, 1) = b;
+    V(t, 2) = c;
+    tri->tri_do_vertice[a] = t;
+    tri->tri_do_vertice[b] = t;
+    tri->tri_do_vertice[c] = t;
+}
+
+/**
+ * Liga a aresta i de t ao triângulo u (que já tem a aresta no sentido
+ * oposto), dos dois lados, com a restrição dada.
+ */
+static void ligar(TriangulacaoInternal *tri, int t, int i, int u, int restricao)
+{
+    VIZ(t, i) = u;
+    REST(t, i) = restricao;
+    if (u < 0) return;
+
+    int k = aresta_em(tri, u, V(t, (i + 2) % 3), V(t, (i + 1) % 3));
+    VIZ(u, k) = t;
+    REST(u, k) = restricao;
+}
+
+/**
+ * Caminha de triângulo em triângulo na direção do ponto.
+ */
+static int localizar(const TriangulacaoInternal *tri, double px, double py, int inicio)
+{
+    int atual = (inicio >= 0 && inicio < tri->num_triangulos) ? inicio : 0;
+    int limite = tri->num_triangulos + 16;
+
+    for (int passo = 0; passo < limite; passo++)
+    {
+        int saida = -1;
+        for (int e = 0; e < 3 && saida < 0; e++)
+        {
+            /* Começar por arestas diferentes a cada passo evita ciclos */
+            int i = (e + passo) % 3;
+            if (lado_aresta(tri, V(atual, (i + 1) % 3), V(atual, (i + 2) % 3), px, py) < 0) saida = i;
+        }
+
+        if (saida < 0) return atual;
+        if (VIZ(atual, saida) < 0) return -1;
+        atual = VIZ(atual, saida);
+    }
+
+    /* Caminhada não convergiu (coordenadas degeneradas): busca exaustiva */
+    for (int t = 0; t < tri->num_triangulos; t++)
+    {
+        int dentro = 1;
+        for (int i = 0; i < 3 && dentro; i++)
+        {
+            dentro = lado_aresta(tri, V(t, (i + 1) % 3), V(t, (i + 2) % 3), px, py) >= 0;
+        }
+        if (dentro) return t;
+    }
+    return -1;
+}
+
+/**
+ * Junta em tri->estrela os triângulos ao redor do vértice.
+ * @return Quantidade de triângulos
+ */
+static int coletar_estrela(TriangulacaoInternal *tri, int vertice)
+{
+    int inicio = tri->tri_do_vertice[vertice];
+    int n = 0;
+
+    /* Sentido anti-horário: vizinho pela aresta (q, vértice), oposta a p */
+    int t = inicio;
+    do
+    {
+        if (!reservar(&tri->estrela, &tri->cap_estrela, n + 1)) return n;
+        tri->estrela[n++] = t;
+        int i = indice_no_triangulo(tri, t, vertice);
+        t = VIZ(t, (i + 1) % 3);
+    } while (t >= 0 && t != inicio && n <= tri->num_triangulos);
+
+    if (t >= 0) return n;
+
+    /* Chegou à borda: completa no sentido horário a partir do início */
+    int i = indice_no_triangulo(tri, inicio, vertice);
+    t = VIZ(inicio, (i + 2) % 3);
+    while (t >= 0 && n <= tri->num_triangulos)
+    {
+        if (!reservar(&tri->estrela, &tri->cap_estrela, n + 1)) return n;
+        tri->estrela[n++] = t;
+        i = indice_no_triangulo(tri, t, vertice);
+        t = VIZ(t, (i + 2) % 3);
+    }
+    return n;
+}
+
+/**
+ * Procura a aresta entre a e b.
+ * @return 1 se existe (t e k recebem o triângulo e o índice da aresta)
+ */
+static int encontrar_aresta(TriangulacaoInternal *tri, int a, int b, int *t, int *k)
+{
+    int n = coletar_estrela(tri, a);
+    for (int e = 0; e < n; e++)
+    {
+        int u = tri->estrela[e];
+        int i = indice_no_triangulo(tri, u, a);
+        if (V(u, (i + 1) % 3) == b)
+        {
+            *t = u;
+            *k = (i + 2) % 3;
+            return 1;
+        }
+        if (V(u, (i + 2) % 3) == b)
+        {
+            *t = u;
+            *k = (i + 1) % 3;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Vira a aresta k do triângulo t: (p, a, b) + (d, b, a) viram
+ * (p, a, d) + (p, d, b). O vizinho passa a ser o segundo triângulo.
+ */
+static void virar(TriangulacaoInternal *tri, int t, int k)
+{
+    int p = V(t, k), a = V(t, (k + 1) % 3), b = V(t, (k + 2) % 3);
+    int u = VIZ(t, k);
+    int j = aresta_em(tri, u, b, a);
+    int d = V(u, j);
+
+    int n_pa = VIZ(t, (k + 2) % 3), r_pa = REST(t, (k + 2) % 3);
+    int n_bp = VIZ(t, (k + 1) % 3), r_bp = REST(t, (k + 1) % 3);
+    int n_ad = VIZ(u, (j + 1) % 3), r_ad = REST(u, (j + 1) % 3);
+    int n_db = VIZ(u, (j + 2) % 3), r_db = REST(u, (j + 2) % 3);
+
+    definir(tri, t, p, a, d);
+    definir(tri, u, p, d, b);
+
+    ligar(tri, t, 0, n_ad, r_ad);
+    ligar(tri, t, 2, n_pa, r_pa);
+    ligar(tri, u, 0, n_db, r_db);
+    ligar(tri, u, 1, n_bp, r_bp);
+    ligar(tri, t, 1, u, -1);
+}
+
+/**
+ * Restaura a propriedade de Delaunay ao redor do vértice p recém-inserido
+ * (os triângulos com p estão na pilha).
+ */
+static void legalizar(TriangulacaoInternal *tri, int p)
+{
+    while (tri->tam_pilha > 0)
+    {
+        int t = tri->pilha[--tri->tam_pilha];
+        int k = indice_no_triangulo(tri, t, p);
+        if (k < 0 || VIZ(t, k) < 0 || REST(t, k) >= 0) continue;
+
+        int a = V(t, (k + 1) % 3), b = V(t, (k + 2) % 3);
+        int u = VIZ(t, k);
+        int d = V(u, aresta_em(tri, u, b, a));
+
+        if (!dentro_do_circulo(tri, p, a, b, d)) continue;
+        if (orient_v(tri, p, a, d) <= 0 || orient_v(tri, p, d, b) <= 0) continue;
+
+        virar(tri, t, k);
+        empilhar(tri, t);
+        empilhar(tri, u);
+    }
+}
+
+/**
+ * Divide o triângulo t em três, ligando seus vértices ao vértice p.
+ */
+static void dividir_triangulo(TriangulacaoInternal *tri, int t, int p)
+{
+    int a = V(t, 0), b = V(t, 1), c = V(t, 2);
+    int n_bc = VIZ(t, 0), r_bc = REST(t, 0);
+    int n_ca = VIZ(t, 1), r_ca = REST(t, 1);
+    int n_ab = VIZ(t, 2), r_ab = REST(t, 2);
+
+    int t1 = tri->num_triangulos++;
+    int t2 = tri->num_triangulos++;
+    definir(tri, t, a, b, p);
+    definir(tri, t1, b, c, p);
+    definir(tri, t2, c, a, p);
+
+    ligar(tri, t, 2, n_ab, r_ab);
+    ligar(tri, t1, 2, n_bc, r_bc);
+    ligar(tri, t2, 2, n_ca, r_ca);
+    ligar(tri, t, 0, t1, -1);
+    ligar(tri, t1, 0, t2, -1);
+    ligar(tri, t2, 0, t, -1);
+
+    empilhar(tri, t);
+    empilhar(tri, t1);
+    empilhar(tri, t2);
+}
+
+/**
+ * Divide a aresta i do triângulo t (e o vizinho, se houver) no vértice p.
+ * Os dois pedaços herdam a restrição da aresta.
+ */
+static void dividir_aresta(TriangulacaoInternal *tri, int t, int i, int p)
+{
+    int c = V(t, i), a = V(t, (i + 1) % 3), b = V(t, (i + 2) % 3);
+    int u = VIZ(t, i), r = REST(t, i);
+    int n_bc = VIZ(t, (i + 1) % 3), r_bc = REST(t, (i + 1) % 3);
+    int n_ca = VIZ(t, (i + 2) % 3), r_ca = REST(t, (i + 2) % 3);
+
+    int d = -1, n_ad = -1, r_ad = -1, n_db = -1, r_db = -1;
+    if (u >= 0)
+    {
+        int j = aresta_em(tri, u, b, a);
+        d = V(u, j);
+        n_ad = VIZ(u, (j + 1) % 3);
+        r_ad = REST(u, (j + 1) % 3);
+        n_db = VIZ(u, (j + 2) % 3);
+        r_db = REST(u, (j + 2) % 3);
+    }
+
+    int t2 = tri->num_triangulos++;
+    definir(tri, t, c, a, p);
+    definir(tri, t2, c, p, b);
+    ligar(tri, t, 2, n_ca, r_ca);
+    ligar(tri, t2, 1, n_bc, r_bc);
+    ligar(tri, t, 1, t2, -1);
+    empilhar(tri, t);
+    empilhar(tri, t2);
+
+    if (u < 0)
+    {
+        ligar(tri, t, 0, -1, r);
+        ligar(tri, t2, 0, -1, r);
+        return;
+    }
+
+    int u2 = tri->num_triangulos++;
+    definir(tri, u, d, b, p);
+    definir(tri, u2, d, p, a);
+    ligar(tri, u, 2, n_db, r_db);
+    ligar(tri, u2, 1, n_ad, r_ad);
+    ligar(tri, u, 1, u2, -1);
+    ligar(tri, t, 0, u2, r);
+    ligar(tri, t2, 0, u, r);
+    empilhar(tri, u);
+    empilhar(tri, u2);
+}
+
+/**
+ * Marca a aresta (a, b), que já existe, com a restrição (se ainda livre).
+ */
+static int marcar_restricao(TriangulacaoInternal *tri, int a, int b, int id)
+{
+    int t, k;
+    if (!encontrar_aresta(tri, a, b, &t, &k)) return 0;
+    if (REST(t, k) < 0) ligar(tri, t, k, VIZ(t, k), id);
+    return 1;
+}
+
+/**
+ * Faz a restrição da aresta k do triângulo t passar pelo vértice oposto
+ * (que está quase sobre ela): vira a aresta e restringe os dois lados
+ * do triângulo que tocam o vértice.
+ * @return 1 em caso de sucesso, 0 se o quadrilátero não é convexo
+ */
+static int desviar_restricao(TriangulacaoInternal *tri, int t, int k)
+{
+    int w = V(t, k), p = V(t, (k + 1) % 3), q = V(t, (k + 2) % 3);
+    int u = VIZ(t, k), id = REST(t, k);
+    if (u < 0) return 0;
+
+    int d = V(u, aresta_em(tri, u, q, p));
+    if (orient_v(tri, w, p, d) <= 0 || orient_v(tri, w, d, q) <= 0) return 0;
+
+    virar(tri, t, k);
+    return marcar_restricao(tri, w, p, id) && marcar_restricao(tri, w, q, id);
+}
+
+/**
+ * Procura, ao redor de a, o primeiro passo em direção a b.
+ * @param colinear OUT: vértice vizinho de a sobre o segmento (ou -1)
+ * @param p, q OUT: extremos da primeira aresta cruzada (p à direita de a->b)
+ * @return Triângulo (a, p, q) cruzado pelo segmento, ou -1 se houve
+ *         vértice colinear ou erro
+ */
+static int primeira_travessia(TriangulacaoInternal *tri, int a, int b,
+                              int *colinear, int *p, int *q)
+{
+    *colinear = -1;
+    int n = coletar_estrela(tri, a);
+    double dx = tri->x[b] - tri->x[a], dy = tri->y[b] - tri->y[a];
+
+    for (int e = 0; e < n; e++)
+    {
+        int t = tri->estrela[e];
+        int i = indice_no_triangulo(tri, t, a);
+        for (int lado = 1; lado <= 2; lado++)
+        {
+            int w = V(t, (i + lado) % 3);
+            double wx = tri->x[w] - tri->x[a], wy = tri->y[w] - tri->y[a];
+            if (wx * dx + wy * dy > 0 &&
+                distancia_reta(tri, a, b, tri->x[w], tri->y[w]) <= tri->tolerancia)
+            {
+                *colinear = w;
+                return -1;
+            }
+        }
+    }
+
+    for (int e = 0; e < n; e++)
+    {
+        int t = tri->estrela[e];
+        int i = indice_no_triangulo(tri, t, a);
+        int vp = V(t, (i + 1) % 3), vq = V(t, (i + 2) % 3);
+        if (orient_v(tri, a, vp, b) > 0 && orient_v(tri, a, vq, b) < 0)
+        {
+            *p = vp;
+            *q = vq;
+            return t;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Vira as arestas da fila (todas cruzam a->b) até a aresta aparecer.
+ * @return 1 em caso de sucesso, 0 se o limite de viradas foi atingido
+ */
+static int remover_cruzamentos(TriangulacaoInternal *tri, int a, int b)
+{
+    int cabeca = 0;
+    long limite = 64L * (tri->tam_fila / 2) * (tri->tam_fila / 2) + 1024;
+
+    while (cabeca < tri->tam_fila)
+    {
+        if (limite-- <= 0) return 0;
+
+        int e1 = tri->fila[cabeca], e2 = tri->fila[cabeca + 1];
+        cabeca += 2;
+
+        int t, k;
+        if (!encontrar_aresta(tri, e1, e2, &t, &k)) continue;
+
+        int w = V(t, k);
+        int u = VIZ(t, k);
+        int z = V(u, aresta_em(tri, u, V(t, (k + 2) % 3), V(t, (k + 1) % 3)));
+        int s = V(t, (k + 1) % 3), f = V(t, (k + 2) % 3);
+
+        /* Só um quadrilátero estritamente convexo pode ter a diagonal virada */
+        if (orient_v(tri, w, s, z) <= 0 || orient_v(tri, w, z, f) <= 0)
+        {
+            if (!enfileirar(tri, e1, e2)) return 0;
+            continue;
+        }
+
+        virar(tri, t, k);
+
+        if (w != a && w != b && z != a && z != b &&
+            (orient_v(tri, a, b, w) > 0) != (orient_v(tri, a, b, z) > 0))
+        {
+            if (!enfileirar(tri, w, z)) return 0;
+        }
+    }
+    return 1;
+}
+
+/* ============================================================================
+ * Implementação das Funções de Criação e Destruição
+ * ============================================================================ */
+
+Triangulacao triangulacao_criar(double min_x, double min_y,
+                                double max_x, double max_y, int capacidade)
+{
+    if (!(max_x > min_x && max_y > min_y))
+    {
+        fprintf(stderr, "Erro: retângulo inválido para triangulação\n");
+        return NULL;
+    }
+    if (capacidade < CAPACIDADE_PADRAO) capacidade = CAPACIDADE_PADRAO;
+
+    TriangulacaoInternal *tri = (TriangulacaoInternal*)calloc(1, sizeof(TriangulacaoInternal));
+    if (tri == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar triangulação\n");
+        return NULL;
+    }
+
+    tri->cap_vertices = capacidade;
+    tri->cap_triangulos = 2 * capacidade;
+    tri->x = (double*)malloc(capacidade * sizeof(double));
+    tri->y = (double*)malloc(capacidade * sizeof(double));
+    tri->tri_do_vertice = (int*)malloc(capacidade * sizeof(int));
+    tri->v = (int*)malloc(3 * tri->cap_triangulos * sizeof(int));
+    tri->viz = (int*)malloc(3 * tri->cap_triangulos * sizeof(int));
+    tri->rest = (int*)malloc(3 * tri->cap_triangulos * sizeof(int));
+    if (tri->x == NULL || tri->y == NULL || tri->tri_do_vertice == NULL ||
+        tri->v == NULL || tri->viz == NULL || tri->rest == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar triangulação\n");
+        triangulacao_destruir(tri);
+        return NULL;
+    }
+
+    double escala = fmax(max_x - min_x, max_y - min_y);
+    tri->tolerancia = TOLERANCIA_RELATIVA * fmax(escala, 1.0);
+
+    double cx[4] = {min_x, max_x, max_x, min_x};
+    double cy[4] = {min_y, min_y, max_y, max_y};
+    for (int i = 0; i < 4; i++)
+    {
+        tri->x[i] = cx[i];
+        tri->y[i] = cy[i];
+    }
+    tri->num_vertices = 4;
+    tri->num_triangulos = 2;
+
+    for (int i = 0; i < 6; i++)
+    {
+        tri->viz[i] = -1;
+        tri->rest[i] = -1;
+    }
+    definir(tri, 0, 0, 1, 2);
+    definir(tri, 1, 0, 2, 3);
+    ligar(tri, 0, 1, 1, -1);
+
+    return (Triangulacao)tri;
+}
+
+void triangulacao_destruir(Triangulacao t)
+{
+    TriangulacaoInternal *tri = (TriangulacaoInternal*)t;
+    if (tri == NULL) return;
+
+    free(tri->x);
+    free(tri->y);
+    free(tri->tri_do_vertice);
+    free(tri->v);
+    free(tri->viz);
+    free(tri->rest);
+    free(tri->pilha);
+    free(tri->estrela);
+    free(tri->fila);
+    free(tri);
+}
+
+/* ============================================================================
+ * Implementação das Funções de Operação
+ * ============================================================================ */
+
+int triangulacao_inserir_ponto(Triangulacao t, double px, double py)
+{
+    TriangulacaoInternal *tri = (TriangulacaoInternal*)t;
+    if (tri == NULL) return -1;
+
+    /* Pontos rente à borda vão para ela: a borda segue reta */
+    if (fabs(px - tri->x[0]) <= tri->tolerancia) px = tri->x[0];
+    if (fabs(px - tri->x[1]) <= tri->tolerancia) px = tri->x[1];
+    if (fabs(py - tri->y[0]) <= tri->tolerancia) py = tri->y[0];
+    if (fabs(py - tri->y[2]) <= tri->tolerancia) py = tri->y[2];
+
+    int alvo = localizar(tri, px, py, tri->ultimo);
+    if (alvo < 0) return -1;
+    tri->ultimo = alvo;
+
+    /* Ponto coincidente com um vértice do triângulo ou dos vizinhos */
+    for (int n = -1; n < 3; n++)
+    {
+        int u = n < 0 ? alvo : VIZ(alvo, n);
+        if (u < 0) continue;
+        for (int i = 0; i < 3; i++)
+        {
+            int w = V(u, i);
+            if (fabs(tri->x[w] - px) <= tri->tolerancia && fabs(tri->y[w] - py) <= tri->tolerancia)
+            {
+                return w;
+            }
+        }
+    }
+
+    int aresta = -1;
+    for (int i = 0; i < 3 && aresta < 0; i++)
+    {
+        if (distancia_reta(tri, V(alvo, (i + 1) % 3), V(alvo, (i + 2) % 3), px, py) <= tri->tolerancia)
+        {
+            aresta = i;
+        }
+    }
+
+    if (!garantir_capacidade(tri, 1, 2)) return -1;
+
+    int p = tri->num_vertices++;
+    tri->x[p] = px;
+    tri->y[p] = py;
+
+    tri->tam_pilha = 0;
+    if (aresta >= 0)
+    {
+        dividir_aresta(tri, alvo, aresta, p);
+    }
+    else
+    {
+        dividir_triangulo(tri, alvo, p);
+    }
+    legalizar(tri, p);
+
+    tri->ultimo = tri->tri_do_vertice[p];
+    return p;
+}
+
+int triangulacao_inserir_restricao(Triangulacao t, int a, int b, int id)
+{
+    TriangulacaoInternal *tri = (TriangulacaoInternal*)t;
+    if (tri == NULL || id < 0 || a < 0 || b < 0 ||
+        a >= tri->num_vertices || b >= tri->num_vertices)
+    {
+        return 0;
+    }
+
+    int limite = tri->num_vertices + 16;
+    while (a != b)
+    {
+        if (limite-- <= 0) return 0;
+
+        int tr, k;
+        if (encontrar_aresta(tri, a, b, &tr, &k))
+        {
+            return marcar_restricao(tri, a, b, id);
+        }
+
+        int colinear, p, q;
+        int atual = primeira_travessia(tri, a, b, &colinear, &p, &q);
+        if (colinear >= 0)
+        {
+            if (!marcar_restricao(tri, a, colinear, id)) return 0;
+            a = colinear;
+            continue;
+        }
+        if (atual < 0) return 0;
+
+        /* Caminha pelos triângulos cruzados, guardando as arestas */
+        tri->tam_fila = 0;
+        k = indice_no_triangulo(tri, atual, a);
+        int parada = -1;        /* Vértice onde o pedaço termina */
+        int passos = tri->num_triangulos;
+        while (passos-- > 0)
+        {
+            if (REST(atual, k) >= 0)
+            {
+                /* Cruza outra restrição: o cruzamento vira vértice */
+                double ax = tri->x[a], ay = tri->y[a];
+                double px = tri->x[p], py = tri->y[p];
+                double qx = tri->x[q], qy = tri->y[q];
+                double d1 = orientacao(ax, ay, tri->x[b], tri->y[b], px, py);
+                double d2 = orientacao(ax, ay, tri->x[b], tri->y[b], qx, qy);
+                double s = d1 / (d1 - d2);
+
+                parada = triangulacao_inserir_ponto(tri, px + s * (qx - px), py + s * (qy - py));
+                if (parada < 0) return 0;
+                if (parada == a)
+                {
+                    /* a está sobre a outra restrição (dentro da tolerância):
+                     * ela passa a usar a como vértice, e a caminhada recomeça */
+                    if (V(atual, k) != a || !desviar_restricao(tri, atual, k)) return 0;
+                }
+                break;
+            }
+
+            if (!enfileirar(tri, p, q)) return 0;
+
+            int u = VIZ(atual, k);
+            if (u < 0) return 0;
+            int j = aresta_em(tri, u, q, p);
+            int r = V(u, j);
+
+            if (r == b ||
+                distancia_reta(tri, a, b, tri->x[r], tri->y[r]) <= tri->tolerancia)
+            {
+                parada = r;
+                break;
+            }
+
+            if (orient_v(tri, a, b, r) > 0)
+            {
+                q = r;
+                k = (j + 1) % 3;
+            }
+            else
+            {
+                p = r;
+                k = (j + 2) % 3;
+            }
+            atual = u;
+        }
+        if (parada < 0) return 0;
+        if (parada == a) continue;
+
+        if (parada != b)
+        {
+            /* Pedaço até a parada (vértice colinear ou cruzamento); a
+             * fila é refeita para ele, e o resto segue a partir dela */
+            if (!triangulacao_inserir_restricao(tri, a, parada, id)) return 0;
+            a = parada;
+            continue;
+        }
+
+        if (!remover_cruzamentos(tri, a, b)) return 0;
+        return marcar_restricao(tri, a, b, id);
+    }
+
+    return 1;
+}
+
+int triangulacao_localizar(Triangulacao t, double x, double y, int inicio)
+{
+    const TriangulacaoInternal *tri = (const TriangulacaoInternal*)t;
+    if (tri == NULL) return -1;
+    return localizar(tri, x, y, inicio);
+}
+
+/* ============================================================================
+ * Implementação das Funções de Acesso
+ * ============================================================================ */
+
+int triangulacao_dados(Triangulacao t, const double **xs, const double **ys,
+                       const int **vertices, const int **vizinhos,
+                       const int **restricoes)
+{
+    const TriangulacaoInternal *tri = (const TriangulacaoInternal*)t;
+    if (tri == NULL) return 0;
+
+    if (xs) *xs = tri->x;
+    if (ys) *ys = tri->y;
+    if (vertices) *vertices = tri->v;
+    if (vizinhos) *vizinhos = tri->viz;
+    if (restricoes) *restricoes = tri->rest;
+    return tri->num_triangulos;
+}
+
+int triangulacao_num_vertices(Triangulacao t)
+{
+    const TriangulacaoInternal *tri = (const TriangulacaoInternal*)t;
+    return tri ? tri->num_vertices : 0;
+}
+
+int triangulacao_num_triangulos(Triangulacao t)
+{
+    const TriangulacaoInternal *tri = (const TriangulacaoInternal*)t;
+    return tri ? tri->num_triangulos : 0;
+}
@@ -0,0 +1,110 @@
+/* triangulacao.h
+ *
+ * TAD Triangulação Restrita
+ * Triangulação de Delaunay incremental de um retângulo, com arestas
+ * obrigatórias (restrições). Cada triângulo guarda os três vértices em
+ * sentido anti-horário, o vizinho e a restrição de cada aresta.
+ *
+ * Convenção: a aresta i do triângulo t é a oposta ao vértice i, isto é,
+ * liga os vértices (i+1)%3 e (i+2)%3. Vizinho -1 indica a borda do
+ * retângulo; restrição -1 indica aresta livre.
+ *
+ * Pontos mais próximos que a tolerância de um vértice existente são
+ * fundidos com ele; uma restrição que cruza outra é dividida no ponto
+ * de cruzamento, que vira vértice. A consulta aos arrays
+ * (triangulacao_dados) não modifica a estrutura e pode ser feita por
+ * várias threads ao mesmo tempo.
+ */
+
+#ifndef TRIANGULACAO_H
+#define TRIANGULACAO_H
+
+/* Tipo opaco para Triangulação */
+typedef void* Triangulacao;
+
+/* ============================================================================
+ * Funções de Criação e Destruição
+ * ============================================================================ */
+
+/**
+ * Cria a triangulação de um retângulo (4 vértices, 2 triângulos).
+ * @param min_x, min_y, max_x, max_y Limites do retângulo
+ * @param capacidade Número esperado de vértices (<= 0 usa o padrão)
+ * @return Nova triangulação, ou NULL em caso de erro
+ */
+Triangulacao triangulacao_criar(double min_x, double min_y,
+                                double max_x, double max_y, int capacidade);
+
+/**
+ * Destroi a triangulação.
+ * @param tri Triangulação a ser destruída
+ */
+void triangulacao_destruir(Triangulacao tri);
+
+/* ============================================================================
+ * Funções de Operação
+ * ============================================================================ */
+
+/**
+ * Insere um ponto, mantendo a propriedade de Delaunay nas arestas livres.
+ * Pontos próximos de um ponto de inserção anterior são inseridos mais
+ * depressa (a busca parte do último triângulo usado). Pontos a menos da
+ * tolerância da borda do retângulo são levados para a borda.
+ * @param tri Triangulação
+ * @param x, y Coordenadas do ponto
+ * @return Índice do vértice (novo ou fundido), ou -1 se o ponto está
+ *         fora do retângulo ou em caso de erro
+ */
+int triangulacao_inserir_ponto(Triangulacao tri, double x, double y);
+
+/**
+ * Força a aresta entre dois vértices, virando as arestas livres que a
+ * cruzam. Se passar por outros vértices ou cruzar outra restrição, a
+ * aresta é dividida e cada pedaço recebe o mesmo id.
+ * @param tri Triangulação
+ * @param a, b Índices dos vértices
+ * @param id Identificador da restrição (>= 0); uma aresta já restrita
+ *           mantém o id que tinha
+ * @return 1 em caso de sucesso, 0 se a aresta não pôde ser forçada
+ */
+int triangulacao_inserir_restricao(Triangulacao tri, int a, int b, int id);
+
+/**
+ * Localiza o triângulo que contém o ponto, caminhando a partir de um
+ * triângulo dado. Não modifica a triangulação.
+ * @param tri Triangulação
+ * @param x, y Coordenadas do ponto
+ * @param inicio Triângulo de partida (fora do intervalo: o primeiro)
+ * @return Índice do triângulo, ou -1 se o ponto está fora do retângulo
+ */
+int triangulacao_localizar(Triangulacao tri, double x, double y, int inicio);
+
+/* ============================================================================
+ * Funções de Acesso
+ * ============================================================================ */
+
+/**
+ * Expõe os arrays internos, para percursos rápidos (somente leitura).
+ * Os ponteiros valem até a próxima inserção.
+ * @param tri Triangulação
+ * @param xs, ys OUT: coordenadas dos vértices
+ * @param vertices OUT: 3 índices de vértice por triângulo
+ * @param vizinhos OUT: 3 vizinhos por triângulo (aresta i oposta ao vértice i)
+ * @param restricoes OUT: 3 ids de restrição por triângulo (-1: livre)
+ * @return Número de triângulos
+ */
+int triangulacao_dados(Triangulacao tri, const double **xs, const double **ys,
+                       const int **vertices, const int **vizinhos,
+                       const int **restricoes);
+
+/**
+ * Obtém o número de vértices.
+ */
+int triangulacao_num_vertices(Triangulacao tri);
+
+/**
+ * Obtém o número de triângulos.
+ */
+int triangulacao_num_triangulos(Triangulacao tri);
+
+#endif /* TRIANGULACAO_H */
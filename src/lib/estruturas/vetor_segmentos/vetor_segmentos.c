@@ -0,0 +1,383 @@
+/* vetor_segmentos.c
+ *
+ * Implementação do TAD Vetor de Segmentos
+ * Vetores paralelos que crescem por duplicação; cores internadas em
+ * uma tabela hash (endereçamento aberto) de índices para as strings.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vetor_segmentos.h"
+
+#define CAPACIDADE_PADRAO 64
+#define CAPACIDADE_TABELA_CORES 32
+
+/* ============================================================================
+ * Estrutura Interna
+ * ============================================================================ */
+
+typedef struct vetor_segmentos_internal
+{
+    double *x1, *y1, *x2, *y2;
+    int *id;
+    int *id_original;
+    int *cor;               /* Índice em cores */
+    unsigned char *removido;/* Marca de remoção pendente (ver compactar) */
+    int num_removidos;
+    unsigned versao;        /* Incrementada a cada modificação */
+    int tamanho;
+    int capacidade;
+
+    char **cores;           /* Strings internadas */
+    int num_cores;
+    int capacidade_cores;
+    int *tabela_cores;      /* Hash: índice em cores, -1 = livre */
+    int capacidade_tabela;  /* Potência de 2 */
+} VetorSegmentosInternal;
+
+/* ============================================================================
+ * Funções Auxiliares - Cores
+ * ============================================================================ */
+
+static unsigned int hash_cor(const char *cor)
+{
+    unsigned int h = 5381;
+    while (*cor)
+    {
+        h = h * 33u + (unsigned char)*cor++;
+    }
+    return h;
+}
+
+static int tabela_redimensionar(VetorSegmentosInternal *v, int nova_capacidade)
+{
+    int *nova = (int*)malloc(nova_capacidade * sizeof(int));
+    if (nova == NULL) return 0;
+
+    for (int i = 0; i < nova_capacidade; i++) nova[i] = -1;
+
+    unsigned int mascara = (unsigned int)(nova_capacidade - 1);
+    for (int c = 0; c < v->num_cores; c++)
+    {
+        unsigned int pos = hash_cor(v->cores[c]) & mascara;
+        while (nova[pos] != -1) pos = (pos + 1) & mascara;
+        nova[pos] = c;
+    }
+
+    free(v->tabela_cores);
+    v->tabela_cores = nova;
+    v->capacidade_tabela = nova_capacidade;
+    return 1;
+}
+
+/**
+ * Retorna o índice da cor, internando-a se ainda não existe.
+ */
+static int internar_cor(VetorSegmentosInternal *v, const char *cor)
+{
+    if (cor == NULL) cor = "black";
+
+    unsigned int mascara = (unsigned int)(v->capacidade_tabela - 1);
+    unsigned int pos = hash_cor(cor) & mascara;
+    while (v->tabela_cores[pos] != -1)
+    {
+        if (strcmp(v->cores[v->tabela_cores[pos]], cor) == 0)
+        {
+            return v->tabela_cores[pos];
+        }
+        pos = (pos + 1) & mascara;
+    }
+
+    /* Nova cor */
+    if (v->num_cores == v->capacidade_cores)
+    {
+        int nova_cap = v->capacidade_cores ? v->capacidade_cores * 2 : 8;
+        char **novas = (char**)realloc(v->cores, nova_cap * sizeof(char*));
+        if (novas == NULL) return -1;
+        v->cores = novas;
+        v->capacidade_cores = nova_cap;
+    }
+
+    char *copia = (char*)malloc(strlen(cor) + 1);
+    if (copia == NULL) return -1;
+    strcpy(copia, cor);
+
+    int indice = v->num_cores++;
+    v->cores[indice] = copia;
+    v->tabela_cores[pos] = indice;
+
+    /* Mantém fator de carga <= 1/2 */
+    if (2 * v->num_cores > v->capacidade_tabela)
+    {
+        tabela_redimensionar(v, v->capacidade_tabela * 2);
+    }
+
+    return indice;
+}
+
+/* ============================================================================
+ * Funções Auxiliares - Vetores
+ * ============================================================================ */
+
+static int redimensionar_double(double **vetor, int capacidade)
+{
+    double *novo = (double*)realloc(*vetor, capacidade * sizeof(double));
+    if (novo == NULL) return 0;
+    *vetor = novo;
+    return 1;
+}
+
+static int redimensionar_int(int **vetor, int capacidade)
+{
+    int *novo = (int*)realloc(*vetor, capacidade * sizeof(int));
+    if (novo == NULL) return 0;
+    *vetor = novo;
+    return 1;
+}
+
+static int redimensionar_marcas(unsigned char **vetor, int capacidade)
+{
+    unsigned char *novo = (unsigned char*)realloc(*vetor, capacidade * sizeof(unsigned char));
+    if (novo == NULL) return 0;
+    *vetor = novo;
+    return 1;
+}
+
+static int garantir_capacidade(VetorSegmentosInternal *v, int minimo)
+{
+    if (minimo <= v->capacidade) return 1;
+
+    int nova = v->capacidade * 2;
+    if (nova < minimo) nova = minimo;
+
+    if (!redimensionar_double(&v->x1, nova) || !redimensionar_double(&v->y1, nova) ||
+        !redimensionar_double(&v->x2, nova) || !redimensionar_double(&v->y2, nova) ||
+        !redimensionar_int(&v->id, nova) || !redimensionar_int(&v->id_original, nova) ||
+        !redimensionar_int(&v->cor, nova) || !redimensionar_marcas(&v->removido, nova))
+    {
+        fprintf(stderr, "Erro: falha ao expandir vetor de segmentos.\n");
+        return 0;
+    }
+
+    v->capacidade = nova;
+    return 1;
+}
+
+/* ============================================================================
+ * Implementação das Funções de Criação e Destruição
+ * ============================================================================ */
+
+VetorSegmentos vetor_segmentos_criar(int capacidade_inicial)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)calloc(1, sizeof(VetorSegmentosInternal));
+    if (v == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar vetor de segmentos.\n");
+        return NULL;
+    }
+
+    if (capacidade_inicial <= 0) capacidade_inicial = CAPACIDADE_PADRAO;
+
+    if (!garantir_capacidade(v, capacidade_inicial) ||
+        !tabela_redimensionar(v, CAPACIDADE_TABELA_CORES))
+    {
+        vetor_segmentos_destruir(v);
+        return NULL;
+    }
+
+    return (VetorSegmentos)v;
+}
+
+void vetor_segmentos_destruir(VetorSegmentos vs)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    if (v == NULL) return;
+
+    free(v->x1);
+    free(v->y1);
+    free(v->x2);
+    free(v->y2);
+    free(v->id);
+    free(v->id_original);
+    free(v->cor);
+    free(v->removido);
+
+    for (int i = 0; i < v->num_cores; i++)
+    {
+        free(v->cores[i]);
+    }
+    free(v->cores);
+    free(v->tabela_cores);
+    free(v);
+}
+
+/* ============================================================================
+ * Implementação das Funções de Modificação
+ * ============================================================================ */
+
+int vetor_segmentos_adicionar(VetorSegmentos vs, int id, int id_original,
+                              double x1, double y1, double x2, double y2,
+                              const char *cor)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    if (v == NULL) return -1;
+
+    int indice_cor = internar_cor(v, cor);
+    if (indice_cor < 0 || !garantir_capacidade(v, v->tamanho + 1)) return -1;
+
+    int i = v->tamanho++;
+    v->x1[i] = x1;
+    v->y1[i] = y1;
+    v->x2[i] = x2;
+    v->y2[i] = y2;
+    v->id[i] = id;
+    v->id_original[i] = id_original;
+    v->cor[i] = indice_cor;
+    v->removido[i] = 0;
+    v->versao++;
+
+    return i;
+}
+
+int vetor_segmentos_clonar(VetorSegmentos vs, int indice, int novo_id,
+                           double dx, double dy)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    if (v == NULL || indice < 0 || indice >= v->tamanho) return -1;
+
+    if (!garantir_capacidade(v, v->tamanho + 1)) return -1;
+
+    int i = v->tamanho++;
+    v->x1[i] = v->x1[indice] + dx;
+    v->y1[i] = v->y1[indice] + dy;
+    v->x2[i] = v->x2[indice] + dx;
+    v->y2[i] = v->y2[indice] + dy;
+    v->id[i] = novo_id;
+    v->id_original[i] = v->id_original[indice];
+    v->cor[i] = v->cor[indice];
+    v->removido[i] = 0;
+    v->versao++;
+
+    return i;
+}
+
+void vetor_segmentos_marcar_remocao(VetorSegmentos vs, int indice)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    if (v == NULL || indice < 0 || indice >= v->tamanho) return;
+
+    if (!v->removido[indice])
+    {
+        v->removido[indice] = 1;
+        v->num_removidos++;
+    }
+}
+
+int vetor_segmentos_compactar(VetorSegmentos vs)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    if (v == NULL || v->num_removidos == 0) return 0;
+
+    /* Uma passada estável: cada sobrevivente desce para a próxima posição livre */
+    int destino = 0;
+    for (int i = 0; i < v->tamanho; i++)
+    {
+        if (v->removido[i]) continue;
+
+        if (destino != i)
+        {
+            v->x1[destino] = v->x1[i];
+            v->y1[destino] = v->y1[i];
+            v->x2[destino] = v->x2[i];
+            v->y2[destino] = v->y2[i];
+            v->id[destino] = v->id[i];
+            v->id_original[destino] = v->id_original[i];
+            v->cor[destino] = v->cor[i];
+            v->removido[destino] = 0;
+        }
+        destino++;
+    }
+
+    int removidos = v->tamanho - destino;
+    v->tamanho = destino;
+    v->num_removidos = 0;
+    v->versao++;
+    return removidos;
+}
+
+/* ============================================================================
+ * Implementação das Funções de Consulta
+ * ============================================================================ */
+
+int vetor_segmentos_tamanho(VetorSegmentos vs)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    return v ? v->tamanho : 0;
+}
+
+unsigned vetor_segmentos_versao(VetorSegmentos vs)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    return v ? v->versao : 0;
+}
+
+int vetor_segmentos_id(VetorSegmentos vs, int indice)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    return v ? v->id[indice] : -1;
+}
+
+int vetor_segmentos_id_original(VetorSegmentos vs, int indice)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    return v ? v->id_original[indice] : -1;
+}
+
+const char* vetor_segmentos_cor(VetorSegmentos vs, int indice)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    return v ? v->cores[v->cor[indice]] : "none";
+}
+
+double vetor_segmentos_x1(VetorSegmentos vs, int indice)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    return v ? v->x1[indice] : 0.0;
+}
+
+double vetor_segmentos_y1(VetorSegmentos vs, int indice)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    return v ? v->y1[indice] : 0.0;
+}
+
+double vetor_segmentos_x2(VetorSegmentos vs, int indice)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    return v ? v->x2[indice] : 0.0;
+}
+
+double vetor_segmentos_y2(VetorSegmentos vs, int indice)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    return v ? v->y2[indice] : 0.0;
+}
+
+int vetor_segmentos_coordenadas(VetorSegmentos vs,
+                                const double **x1, const double **y1,
+                                const double **x2, const double **y2)
+{
+    VetorSegmentosInternal *v = (VetorSegmentosInternal*)vs;
+    if (v == NULL)
+    {
+        *x1 = *y1 = *x2 = *y2 = NULL;
+        return 0;
+    }
+
+    *x1 = v->x1;
+    *y1 = v->y1;
+    *x2 = v->x2;
+    *y2 = v->y2;
+    return v->tamanho;
+}
@@ -0,0 +1,132 @@
+/* vetor_segmentos.h
+ *
+ * TAD Vetor de Segmentos
+ * Armazena segmentos de forma contígua (estrutura de arrays): as
+ * coordenadas, ids e cores de todos os segmentos ficam em vetores
+ * paralelos, indexados de 0 a tamanho-1. As cores são internadas
+ * (cada string distinta é guardada uma única vez).
+ *
+ * É o armazenamento dos anteparos: a varredura, os comandos do .qry
+ * e o SVG leem os segmentos diretamente por índice, e a varredura lê
+ * as coordenadas no lugar, sem cópia.
+ */
+
+#ifndef VETOR_SEGMENTOS_H
+#define VETOR_SEGMENTOS_H
+
+/* Tipo opaco para Vetor de Segmentos */
+typedef void* VetorSegmentos;
+
+/* ============================================================================
+ * Funções de Criação e Destruição
+ * ============================================================================ */
+
+/**
+ * Cria um vetor de segmentos vazio.
+ * @param capacidade_inicial Capacidade inicial (0 usa um valor padrão)
+ * @return Novo vetor, ou NULL em caso de erro
+ */
+VetorSegmentos vetor_segmentos_criar(int capacidade_inicial);
+
+/**
+ * Destroi o vetor e todas as cores internadas.
+ * @param vs Vetor a ser destruído
+ */
+void vetor_segmentos_destruir(VetorSegmentos vs);
+
+/* ============================================================================
+ * Funções de Modificação
+ * ============================================================================ */
+
+/**
+ * Adiciona um segmento ao final do vetor.
+ * @param vs Vetor de segmentos
+ * @param id Identificador único do segmento
+ * @param id_original Identificador da forma original
+ * @param x1 Coordenada X do ponto inicial
+ * @param y1 Coordenada Y do ponto inicial
+ * @param x2 Coordenada X do ponto final
+ * @param y2 Coordenada Y do ponto final
+ * @param cor Cor do segmento (NULL = "black")
+ * @return Índice do novo segmento, ou -1 em caso de erro
+ */
+int vetor_segmentos_adicionar(VetorSegmentos vs, int id, int id_original,
+                              double x1, double y1, double x2, double y2,
+                              const char *cor);
+
+/**
+ * Adiciona ao final uma cópia deslocada de um segmento existente.
+ * Mantém o id_original e a cor (sem reinternar a string).
+ * @param vs Vetor de segmentos
+ * @param indice Índice do segmento a copiar
+ * @param novo_id Identificador da cópia
+ * @param dx Deslocamento X
+ * @param dy Deslocamento Y
+ * @return Índice da cópia, ou -1 em caso de erro
+ */
+int vetor_segmentos_clonar(VetorSegmentos vs, int indice, int novo_id,
+                           double dx, double dy);
+
+/**
+ * Marca o segmento no índice dado para remoção, em O(1). Os índices não
+ * mudam até vetor_segmentos_compactar; marcar duas vezes não tem efeito.
+ * @param vs Vetor de segmentos
+ * @param indice Índice a marcar
+ */
+void vetor_segmentos_marcar_remocao(VetorSegmentos vs, int indice);
+
+/**
+ * Remove de uma vez todos os segmentos marcados, preservando a ordem dos
+ * demais. O(n), independente do número de marcados.
+ * @param vs Vetor de segmentos
+ * @return Número de segmentos removidos
+ */
+int vetor_segmentos_compactar(VetorSegmentos vs);
+
+/* ============================================================================
+ * Funções de Consulta
+ * ============================================================================ */
+
+/**
+ * Obtém o número de segmentos.
+ */
+int vetor_segmentos_tamanho(VetorSegmentos vs);
+
+/**
+ * Obtém a versão do vetor: muda a cada inserção, cópia ou remoção, então
+ * dois valores iguais garantem o mesmo conteúdo.
+ */
+unsigned vetor_segmentos_versao(VetorSegmentos vs);
+
+/**
+ * Obtém o ID do segmento no índice dado.
+ */
+int vetor_segmentos_id(VetorSegmentos vs, int indice);
+
+/**
+ * Obtém o ID original (forma de origem) do segmento no índice dado.
+ */
+int vetor_segmentos_id_original(VetorSegmentos vs, int indice);
+
+/**
+ * Obtém a cor do segmento no índice dado.
+ * @note A string pertence ao vetor; não modifique nem libere.
+ */
+const char* vetor_segmentos_cor(VetorSegmentos vs, int indice);
+
+double vetor_segmentos_x1(VetorSegmentos vs, int indice);
+double vetor_segmentos_y1(VetorSegmentos vs, int indice);
+double vetor_segmentos_x2(VetorSegmentos vs, int indice);
+double vetor_segmentos_y2(VetorSegmentos vs, int indice);
+
+/**
+ * Obtém vistas somente leitura dos vetores de coordenadas, válidas até a
+ * próxima modificação do vetor. Várias threads podem lê-las ao mesmo tempo.
+ * @param x1, y1, x2, y2 OUT: vetores com vetor_segmentos_tamanho(vs) valores
+ * @return Número de segmentos (0 e vetores NULL se vs for NULL)
+ */
+int vetor_segmentos_coordenadas(VetorSegmentos vs,
+                                const double **x1, const double **y1,
+                                const double **x2, const double **y2);
+
+#endif /* VETOR_SEGMENTOS_H */
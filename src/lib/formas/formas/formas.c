@@ -96,6 +96,59 @@ void setFormaAtiva(Forma forma, int ativa)
     }
 }
 
+int getFormaLimites(Forma forma, double *min_x, double *min_y,
+                    double *max_x, double *max_y)
+{
+    FormaInternal *f = (FormaInternal*)forma;
+    if (f == NULL || f->dados == NULL)
+    {
+        return 0;
+    }
+
+    switch (f->tipo)
+    {
+        case TIPO_CIRCULO:
+        {
+            Circulo c = (Circulo)f->dados;
+            double r = getCirculoRaio(c);
+            *min_x = getCirculoX(c) - r;
+            *min_y = getCirculoY(c) - r;
+            *max_x = getCirculoX(c) + r;
+            *max_y = getCirculoY(c) + r;
+            return 1;
+        }
+        case TIPO_RETANGULO:
+        {
+            Retangulo r = (Retangulo)f->dados;
+            *min_x = getRetanguloX(r);
+            *min_y = getRetanguloY(r);
+            *max_x = *min_x + getRetanguloLargura(r);
+            *max_y = *min_y + getRetanguloAltura(r);
+            return 1;
+        }
+        case TIPO_LINHA:
+        {
+            Linha l = (Linha)f->dados;
+            double x1 = getLinhaX1(l), y1 = getLinhaY1(l);
+            double x2 = getLinhaX2(l), y2 = getLinhaY2(l);
+            *min_x = x1 < x2 ? x1 : x2;
+            *max_x = x1 < x2 ? x2 : x1;
+            *min_y = y1 < y2 ? y1 : y2;
+            *max_y = y1 < y2 ? y2 : y1;
+            return 1;
+        }
+        case TIPO_TEXTO:
+        {
+            Texto t = (Texto)f->dados;
+            *min_x = *max_x = getTextoX(t);
+            *min_y = *max_y = getTextoY(t);
+            return 1;
+        }
+        default:
+            return 0;
+    }
+}
+
 void destroiForma(Forma forma)
 {
     FormaInternal *f = (FormaInternal*)forma;
@@ -87,4 +87,14 @@ int getFormaAtiva(Forma forma);
  */
 void setFormaAtiva(Forma forma, int ativa);
 
+/**
+ * Obtém a caixa envolvente da forma, como considerada nos testes de
+ * visibilidade (o texto é tratado pela âncora).
+ * @param forma Ponteiro para a forma
+ * @param min_x, min_y, max_x, max_y Ponteiros para receber os limites
+ * @return 1 em caso de sucesso, 0 se a forma for inválida
+ */
+int getFormaLimites(Forma forma, double *min_x, double *min_y,
+                    double *max_x, double *max_y);
+
 #endif /* FORMAS_H */
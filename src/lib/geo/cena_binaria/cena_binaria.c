@@ -0,0 +1,668 @@
+/* cena_binaria.c
+ *
+ * Implementação da cena compilada.
+ *
+ * Layout (todas as seções alinhadas em 8 bytes):
+ *   Cabecalho
+ *   ordem      uint8_t[num_formas]          tipo de cada forma, na ordem da lista
+ *   circulos   RegistroCirculo[n]
+ *   retangulos RegistroRetangulo[n]
+ *   linhas     RegistroLinha[n]
+ *   textos     RegistroTexto[n]
+ *   indices    uint32_t[num_strings]        deslocamento de cada string
+ *   strings    char[tamanho_strings]        strings terminadas em '\0'
+ *
+ * Os registros referenciam strings pelo índice na tabela. A leitura mapeia
+ * o arquivo e valida todos os deslocamentos e índices antes de usá-los.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "cena_binaria.h"
+#include "parser_geo.h"
+#include "formas.h"
+#include "circulo.h"
+#include "retangulo.h"
+#include "linha.h"
+#include "texto.h"
+
+#define ASSINATURA "TEDCENA"        /* 7 caracteres + '\0' */
+#define VERSAO_CENA 1
+#define MARCA_ENDIAN 0x01020304u
+#define ALINHAMENTO 8
+#define CAPACIDADE_TABELA_STRINGS 256
+#define STRING_VAZIA 0xFFFFFFFFu    /* Posição livre na tabela de internação */
+
+/* ============================================================================
+ * Formato do Arquivo
+ * ============================================================================ */
+
+enum
+{
+    CODIGO_CIRCULO,
+    CODIGO_RETANGULO,
+    CODIGO_LINHA,
+    CODIGO_TEXTO,
+    NUM_CODIGOS
+};
+
+typedef struct cabecalho
+{
+    char assinatura[8];
+    uint32_t versao;
+    uint32_t marca_endian;
+    uint32_t num_formas;
+    uint32_t num_por_tipo[NUM_CODIGOS];
+    uint32_t num_strings;
+    uint32_t dimensoes_validas;
+    uint32_t reservado;
+    double dimensoes[4];
+    uint64_t secao_ordem;
+    uint64_t secao_tipo[NUM_CODIGOS];
+    uint64_t secao_indices;
+    uint64_t secao_strings;
+    uint64_t tamanho_strings;
+    uint64_t tamanho_total;
+} Cabecalho;
+
+typedef struct registro_circulo
+{
+    double x, y, raio;
+    int32_t id;
+    uint32_t cor_borda, cor_preenchimento;
+    uint32_t reservado;
+} RegistroCirculo;
+
+typedef struct registro_retangulo
+{
+    double x, y, largura, altura;
+    int32_t id;
+    uint32_t cor_borda, cor_preenchimento;
+    uint32_t reservado;
+} RegistroRetangulo;
+
+typedef struct registro_linha
+{
+    double x1, y1, x2, y2;
+    int32_t id;
+    uint32_t cor;
+} RegistroLinha;
+
+typedef struct registro_texto
+{
+    double x, y, font_size;
+    int32_t id;
+    uint32_t cor_borda, cor_preenchimento, ancora, conteudo;
+    uint32_t font_family, font_weight;
+    uint32_t reservado;
+} RegistroTexto;
+
+static const size_t tamanho_registro[NUM_CODIGOS] = {
+    sizeof(RegistroCirculo), sizeof(RegistroRetangulo),
+    sizeof(RegistroLinha), sizeof(RegistroTexto)
+};
+
+/* ============================================================================
+ * Tabela de Strings (gravação)
+ * ============================================================================ */
+
+typedef struct tabela_strings
+{
+    char *dados;                /* Strings concatenadas, com '\0' */
+    size_t tamanho;
+    size_t capacidade;
+
+    uint32_t *deslocamentos;    /* Deslocamento da i-ésima string */
+    uint32_t num_strings;
+    uint32_t capacidade_deslocamentos;
+
+    uint32_t *hash;             /* Índices das strings (STRING_VAZIA: livre) */
+    uint32_t capacidade_hash;   /* Potência de 2 */
+} TabelaStrings;
+
+static uint32_t hash_string(const char *s)
+{
+    uint32_t h = 2166136261u;   /* FNV-1a */
+    while (*s) h = (h ^ (unsigned char)*s++) * 16777619u;
+    return h;
+}
+
+static int tabela_iniciar(TabelaStrings *t)
+{
+    memset(t, 0, sizeof(*t));
+    t->capacidade_hash = CAPACIDADE_TABELA_STRINGS;
+    t->hash = (uint32_t*)malloc(t->capacidade_hash * sizeof(uint32_t));
+    if (t->hash == NULL) return 0;
+    memset(t->hash, 0xFF, t->capacidade_hash * sizeof(uint32_t));
+    return 1;
+}
+
+static void tabela_liberar(TabelaStrings *t)
+{
+    free(t->dados);
+    free(t->deslocamentos);
+    free(t->hash);
+}
+
+static int tabela_redimensionar_hash(TabelaStrings *t)
+{
+    uint32_t nova = t->capacidade_hash * 2;
+    uint32_t *hash = (uint32_t*)malloc(nova * sizeof(uint32_t));
+    if (hash == NULL) return 0;
+    memset(hash, 0xFF, nova * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < t->num_strings; i++)
+    {
+        uint32_t p = hash_string(t->dados + t->deslocamentos[i]) & (nova - 1);
+        while (hash[p] != STRING_VAZIA) p = (p + 1) & (nova - 1);
+        hash[p] = i;
+    }
+
+    free(t->hash);
+    t->hash = hash;
+    t->capacidade_hash = nova;
+    return 1;
+}
+
+/**
+ * Devolve o índice da string na tabela, inserindo-a se for nova.
+ * @return Índice, ou STRING_VAZIA em caso de erro
+ */
+static uint32_t tabela_internar(TabelaStrings *t, const char *s)
+{
+    if (s == NULL) s = "";
+
+    uint32_t p = hash_string(s) & (t->capacidade_hash - 1);
+    while (t->hash[p] != STRING_VAZIA)
+    {
+        if (strcmp(t->dados + t->deslocamentos[t->hash[p]], s) == 0) return t->hash[p];
+        p = (p + 1) & (t->capacidade_hash - 1);
+    }
+
+    size_t n = strlen(s) + 1;
+    if (t->tamanho + n > UINT32_MAX) return STRING_VAZIA;
+    if (t->tamanho + n > t->capacidade)
+    {
+        size_t nova = t->capacidade > 0 ? t->capacidade * 2 : 4096;
+        while (nova < t->tamanho + n) nova *= 2;
+        char *dados = (char*)realloc(t->dados, nova);
+        if (dados == NULL) return STRING_VAZIA;
+        t->dados = dados;
+        t->capacidade = nova;
+    }
+    if (t->num_strings == t->capacidade_deslocamentos)
+    {
+        uint32_t nova = t->capacidade_deslocamentos > 0 ? t->capacidade_deslocamentos * 2 : 64;
+        uint32_t *deslocamentos = (uint32_t*)realloc(t->deslocamentos, nova * sizeof(uint32_t));
+        if (deslocamentos == NULL) return STRING_VAZIA;
+        t->deslocamentos = deslocamentos;
+        t->capacidade_deslocamentos = nova;
+    }
+
+    uint32_t indice = t->num_strings++;
+    t->deslocamentos[indice] = (uint32_t)t->tamanho;
+    memcpy(t->dados + t->tamanho, s, n);
+    t->tamanho += n;
+    t->hash[p] = indice;
+
+    /* Mantém a ocupação abaixo de 1/2 */
+    if (t->num_strings * 2 > t->capacidade_hash && !tabela_redimensionar_hash(t))
+    {
+        return STRING_VAZIA;
+    }
+    return indice;
+}
+
+/* ============================================================================
+ * Funções Auxiliares
+ * ============================================================================ */
+
+static uint64_t alinhar(uint64_t deslocamento)
+{
+    return (deslocamento + ALINHAMENTO - 1) & ~(uint64_t)(ALINHAMENTO - 1);
+}
+
+/**
+ * Grava uma seção e completa com zeros até o próximo alinhamento.
+ */
+static int gravar_secao(FILE *arquivo, const void *dados, size_t tamanho)
+{
+    static const char zeros[ALINHAMENTO] = {0};
+
+    if (tamanho > 0 && fwrite(dados, 1, tamanho, arquivo) != tamanho) return 0;
+    size_t folga = (size_t)(alinhar(tamanho) - tamanho);
+    return folga == 0 || fwrite(zeros, 1, folga, arquivo) == folga;
+}
+
+static int codigo_da_forma(Forma forma)
+{
+    switch (getFormaTipo(forma))
+    {
+        case TIPO_CIRCULO:   return CODIGO_CIRCULO;
+        case TIPO_RETANGULO: return CODIGO_RETANGULO;
+        case TIPO_LINHA:     return CODIGO_LINHA;
+        case TIPO_TEXTO:     return CODIGO_TEXTO;
+        default:             return -1;
+    }
+}
+
+/* ============================================================================
+ * Gravação
+ * ============================================================================ */
+
+int salvar_cena_binaria(const char *caminho_arquivo, Lista lista_formas)
+{
+    if (caminho_arquivo == NULL || lista_formas == NULL)
+    {
+        fprintf(stderr, "Erro: parâmetros inválidos para salvar a cena compilada\n");
+        return -1;
+    }
+
+    int num_formas = obter_tamanho(lista_formas);
+    uint32_t num_por_tipo[NUM_CODIGOS] = {0};
+    No atual;
+
+    for (atual = obter_primeiro(lista_formas); atual != NULL; atual = obter_proximo(atual))
+    {
+        int codigo = codigo_da_forma((Forma)obter_elemento(atual));
+        if (codigo < 0)
+        {
+            fprintf(stderr, "Erro: forma de tipo desconhecido na cena\n");
+            return -1;
+        }
+        num_por_tipo[codigo]++;
+    }
+
+    uint8_t *ordem = (uint8_t*)malloc(num_formas > 0 ? num_formas : 1);
+    void *registros[NUM_CODIGOS];
+    for (int k = 0; k < NUM_CODIGOS; k++)
+    {
+        registros[k] = calloc(num_por_tipo[k] > 0 ? num_por_tipo[k] : 1, tamanho_registro[k]);
+    }
+
+    TabelaStrings strings;
+    int ok = tabela_iniciar(&strings) && ordem != NULL;
+    for (int k = 0; k < NUM_CODIGOS; k++) ok = ok && registros[k] != NULL;
+
+    /* Preenche os registros de cada tipo e a tabela de strings */
+    uint32_t contador[NUM_CODIGOS] = {0};
+    int i = 0;
+    for (atual = obter_primeiro(lista_formas); ok && atual != NULL; atual = obter_proximo(atual), i++)
+    {
+        Forma forma = (Forma)obter_elemento(atual);
+        void *d = getFormaDados(forma);
+        int codigo = codigo_da_forma(forma);
+        uint32_t j = contador[codigo]++;
+        ordem[i] = (uint8_t)codigo;
+
+        switch (codigo)
+        {
+            case CODIGO_CIRCULO:
+            {
+                RegistroCirculo *r = &((RegistroCirculo*)registros[codigo])[j];
+                r->x = getCirculoX(d);
+                r->y = getCirculoY(d);
+                r->raio = getCirculoRaio(d);
+                r->id = getCirculoId(d);
+                r->cor_borda = tabela_internar(&strings, getCirculoCorBorda(d));
+                r->cor_preenchimento = tabela_internar(&strings, getCirculoCorPreenchimento(d));
+                ok = r->cor_borda != STRING_VAZIA && r->cor_preenchimento != STRING_VAZIA;
+                break;
+            }
+            case CODIGO_RETANGULO:
+            {
+                RegistroRetangulo *r = &((RegistroRetangulo*)registros[codigo])[j];
+                r->x = getRetanguloX(d);
+                r->y = getRetanguloY(d);
+                r->largura = getRetanguloLargura(d);
+                r->altura = getRetanguloAltura(d);
+                r->id = getRetanguloId(d);
+                r->cor_borda = tabela_internar(&strings, getRetanguloCorBorda(d));
+                r->cor_preenchimento = tabela_internar(&strings, getRetanguloCorPreenchimento(d));
+                ok = r->cor_borda != STRING_VAZIA && r->cor_preenchimento != STRING_VAZIA;
+                break;
+            }
+            case CODIGO_LINHA:
+            {
+                RegistroLinha *r = &((RegistroLinha*)registros[codigo])[j];
+                r->x1 = getLinhaX1(d);
+                r->y1 = getLinhaY1(d);
+                r->x2 = getLinhaX2(d);
+                r->y2 = getLinhaY2(d);
+                r->id = getLinhaId(d);
+                r->cor = tabela_internar(&strings, getLinhaCor(d));
+                ok = r->cor != STRING_VAZIA;
+                break;
+            }
+            default:
+            {
+                RegistroTexto *r = &((RegistroTexto*)registros[codigo])[j];
+                r->x = getTextoX(d);
+                r->y = getTextoY(d);
+                r->font_size = getTextoFontSize(d);
+                r->id = getTextoId(d);
+                r->cor_borda = tabela_internar(&strings, getTextoCorBorda(d));
+                r->cor_preenchimento = tabela_internar(&strings, getTextoCorPreenchimento(d));
+                r->ancora = tabela_internar(&strings, getTextoAncora(d));
+                r->conteudo = tabela_internar(&strings, getTextoConteudo(d));
+                r->font_family = tabela_internar(&strings, getTextoFontFamily(d));
+                r->font_weight = tabela_internar(&strings, getTextoFontWeight(d));
+                ok = r->cor_borda != STRING_VAZIA && r->cor_preenchimento != STRING_VAZIA &&
+                     r->ancora != STRING_VAZIA && r->conteudo != STRING_VAZIA &&
+                     r->font_family != STRING_VAZIA && r->font_weight != STRING_VAZIA;
+                break;
+            }
+        }
+    }
+
+    if (!ok)
+    {
+        fprintf(stderr, "Erro: falha ao montar a cena compilada\n");
+    }
+
+    /* Cabeçalho: deslocamentos das seções e caixa do cenário */
+    Cabecalho cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.assinatura, ASSINATURA, sizeof(cab.assinatura));
+    cab.versao = VERSAO_CENA;
+    cab.marca_endian = MARCA_ENDIAN;
+    cab.num_formas = (uint32_t)num_formas;
+    cab.num_strings = strings.num_strings;
+    cab.tamanho_strings = strings.tamanho;
+    cab.dimensoes_validas = (uint32_t)obter_dimensoes_cenario(lista_formas,
+                                                              &cab.dimensoes[0], &cab.dimensoes[1],
+                                                              &cab.dimensoes[2], &cab.dimensoes[3]);
+
+    uint64_t pos = alinhar(sizeof(Cabecalho));
+    cab.secao_ordem = pos;
+    pos = alinhar(pos + (uint64_t)num_formas);
+    for (int k = 0; k < NUM_CODIGOS; k++)
+    {
+        cab.num_por_tipo[k] = num_por_tipo[k];
+        cab.secao_tipo[k] = pos;
+        pos = alinhar(pos + (uint64_t)num_por_tipo[k] * tamanho_registro[k]);
+    }
+    cab.secao_indices = pos;
+    pos = alinhar(pos + (uint64_t)strings.num_strings * sizeof(uint32_t));
+    cab.secao_strings = pos;
+    cab.tamanho_total = alinhar(pos + strings.tamanho);
+
+    FILE *arquivo = NULL;
+    if (ok)
+    {
+        arquivo = fopen(caminho_arquivo, "wb");
+        if (arquivo == NULL)
+        {
+            fprintf(stderr, "Erro: não foi possível criar %s\n", caminho_arquivo);
+            ok = 0;
+        }
+    }
+
+    if (ok)
+    {
+        ok = gravar_secao(arquivo, &cab, sizeof(cab)) &&
+             gravar_secao(arquivo, ordem, (size_t)num_formas);
+        for (int k = 0; ok && k < NUM_CODIGOS; k++)
+        {
+            ok = gravar_secao(arquivo, registros[k], num_por_tipo[k] * tamanho_registro[k]);
+        }
+        ok = ok && gravar_secao(arquivo, strings.deslocamentos, strings.num_strings * sizeof(uint32_t)) &&
+             gravar_secao(arquivo, strings.dados, strings.tamanho);
+
+        if (fclose(arquivo) != 0) ok = 0;
+        if (!ok)
+        {
+            fprintf(stderr, "Erro: falha ao gravar %s\n", caminho_arquivo);
+            remove(caminho_arquivo);
+        }
+    }
+
+    tabela_liberar(&strings);
+    for (int k = 0; k < NUM_CODIGOS; k++) free(registros[k]);
+    free(ordem);
+
+    return ok ? num_formas : -1;
+}
+
+/* ============================================================================
+ * Leitura
+ * ============================================================================ */
+
+/* Cena mapeada, com as seções já localizadas */
+typedef struct cena_mapeada
+{
+    const Cabecalho *cab;
+    const uint8_t *ordem;
+    const void *registros[NUM_CODIGOS];
+    const uint32_t *indices;
+    const char *strings;
+} CenaMapeada;
+
+/**
+ * Verifica se a seção [inicio, inicio + tamanho) cabe no arquivo.
+ */
+static int secao_valida(uint64_t inicio, uint64_t num, uint64_t tamanho_item, uint64_t total)
+{
+    if (inicio % ALINHAMENTO != 0 || inicio > total) return 0;
+    if (tamanho_item > 0 && num > (total - inicio) / tamanho_item) return 0;
+    return 1;
+}
+
+/**
+ * Valida o cabeçalho e a tabela de strings e localiza as seções.
+ */
+static int localizar_secoes(const char *dados, size_t tamanho, CenaMapeada *cena)
+{
+    if (tamanho < sizeof(Cabecalho)) return 0;
+
+    const Cabecalho *cab = (const Cabecalho*)dados;
+    if (memcmp(cab->assinatura, ASSINATURA, sizeof(cab->assinatura)) != 0 ||
+        cab->versao != VERSAO_CENA || cab->marca_endian != MARCA_ENDIAN ||
+        cab->tamanho_total != tamanho)
+    {
+        return 0;
+    }
+
+    uint64_t soma = 0;
+    for (int k = 0; k < NUM_CODIGOS; k++)
+    {
+        if (!secao_valida(cab->secao_tipo[k], cab->num_por_tipo[k], tamanho_registro[k], tamanho)) return 0;
+        soma += cab->num_por_tipo[k];
+    }
+    if (soma != cab->num_formas ||
+        !secao_valida(cab->secao_ordem, cab->num_formas, 1, tamanho) ||
+        !secao_valida(cab->secao_indices, cab->num_strings, sizeof(uint32_t), tamanho) ||
+        !secao_valida(cab->secao_strings, cab->tamanho_strings, 1, tamanho))
+    {
+        return 0;
+    }
+
+    /* Toda string precisa começar dentro do bloco, que termina em '\0' */
+    const uint32_t *indices = (const uint32_t*)(dados + cab->secao_indices);
+    const char *strings = dados + cab->secao_strings;
+    if (cab->num_strings > 0 &&
+        (cab->tamanho_strings == 0 || strings[cab->tamanho_strings - 1] != '\0'))
+    {
+        return 0;
+    }
+    for (uint32_t i = 0; i < cab->num_strings; i++)
+    {
+        if (indices[i] >= cab->tamanho_strings) return 0;
+    }
+
+    cena->cab = cab;
+    cena->ordem = (const uint8_t*)(dados + cab->secao_ordem);
+    for (int k = 0; k < NUM_CODIGOS; k++)
+    {
+        cena->registros[k] = dados + cab->secao_tipo[k];
+    }
+    cena->indices = indices;
+    cena->strings = strings;
+    return 1;
+}
+
+/**
+ * Obtém a string de índice i (NULL se o índice é inválido).
+ */
+static const char* string_da_cena(const CenaMapeada *cena, uint32_t i)
+{
+    if (i >= cena->cab->num_strings) return NULL;
+    return cena->strings + cena->indices[i];
+}
+
+/**
+ * Cria a forma do j-ésimo registro do tipo dado.
+ * @return Forma criada, ou NULL se o registro é inválido
+ */
+static Forma criar_forma_do_registro(const CenaMapeada *cena, int codigo, uint32_t j)
+{
+    switch (codigo)
+    {
+        case CODIGO_CIRCULO:
+        {
+            const RegistroCirculo *r = &((const RegistroCirculo*)cena->registros[codigo])[j];
+            const char *borda = string_da_cena(cena, r->cor_borda);
+            const char *preenchimento = string_da_cena(cena, r->cor_preenchimento);
+            if (borda == NULL || preenchimento == NULL) return NULL;
+
+            Circulo c = criaCirculo(r->id, r->x, r->y, r->raio, borda, preenchimento);
+            return c != NULL ? criaForma(TIPO_CIRCULO, c) : NULL;
+        }
+        case CODIGO_RETANGULO:
+        {
+            const RegistroRetangulo *r = &((const RegistroRetangulo*)cena->registros[codigo])[j];
+            const char *borda = string_da_cena(cena, r->cor_borda);
+            const char *preenchimento = string_da_cena(cena, r->cor_preenchimento);
+            if (borda == NULL || preenchimento == NULL) return NULL;
+
+            Retangulo ret = criaRetangulo(r->id, r->x, r->y, r->largura, r->altura,
+                                          borda, preenchimento);
+            return ret != NULL ? criaForma(TIPO_RETANGULO, ret) : NULL;
+        }
+        case CODIGO_LINHA:
+        {
+            const RegistroLinha *r = &((const RegistroLinha*)cena->registros[codigo])[j];
+            const char *cor = string_da_cena(cena, r->cor);
+            if (cor == NULL) return NULL;
+
+            Linha l = criaLinha(r->id, r->x1, r->y1, r->x2, r->y2, cor);
+            return l != NULL ? criaForma(TIPO_LINHA, l) : NULL;
+        }
+        case CODIGO_TEXTO:
+        {
+            const RegistroTexto *r = &((const RegistroTexto*)cena->registros[codigo])[j];
+            const char *borda = string_da_cena(cena, r->cor_borda);
+            const char *preenchimento = string_da_cena(cena, r->cor_preenchimento);
+            const char *ancora = string_da_cena(cena, r->ancora);
+            const char *conteudo = string_da_cena(cena, r->conteudo);
+            const char *family = string_da_cena(cena, r->font_family);
+            const char *weight = string_da_cena(cena, r->font_weight);
+            if (borda == NULL || preenchimento == NULL || ancora == NULL ||
+                conteudo == NULL || family == NULL || weight == NULL)
+            {
+                return NULL;
+            }
+
+            Texto t = criaTexto(r->id, r->x, r->y, borda, preenchimento, ancora, conteudo,
+                                family, weight, r->font_size);
+            return t != NULL ? criaForma(TIPO_TEXTO, t) : NULL;
+        }
+        default:
+            return NULL;
+    }
+}
+
+int eh_cena_binaria(const char *caminho_arquivo)
+{
+    if (caminho_arquivo == NULL) return 0;
+
+    FILE *arquivo = fopen(caminho_arquivo, "rb");
+    if (arquivo == NULL) return 0;
+
+    char assinatura[8];
+    int ok = fread(assinatura, 1, sizeof(assinatura), arquivo) == sizeof(assinatura) &&
+             memcmp(assinatura, ASSINATURA, sizeof(assinatura)) == 0;
+    fclose(arquivo);
+    return ok;
+}
+
+int ler_cena_binaria(const char *caminho_arquivo, Lista lista_formas,
+                     double dimensoes[4], int *dimensoes_validas)
+{
+    if (caminho_arquivo == NULL || lista_formas == NULL)
+    {
+        fprintf(stderr, "Erro: parâmetros inválidos para ler a cena compilada\n");
+        return -1;
+    }
+
+    int fd = open(caminho_arquivo, O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Erro: não foi possível abrir %s\n", caminho_arquivo);
+        return -1;
+    }
+
+    struct stat info;
+    void *mapa = MAP_FAILED;
+    size_t tamanho = 0;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        tamanho = (size_t)info.st_size;
+        mapa = mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    CenaMapeada cena;
+    if (mapa == MAP_FAILED || !localizar_secoes((const char*)mapa, tamanho, &cena))
+    {
+        fprintf(stderr, "Erro: %s não é uma cena compilada válida (versão %d)\n",
+                caminho_arquivo, VERSAO_CENA);
+        if (mapa != MAP_FAILED) munmap(mapa, tamanho);
+        return -1;
+    }
+    posix_madvise(mapa, tamanho, POSIX_MADV_SEQUENTIAL);
+
+    /* Recria as formas na ordem original, avançando em cada vetor de registros */
+    uint32_t contador[NUM_CODIGOS] = {0};
+    int formas_lidas = 0;
+    for (uint32_t i = 0; i < cena.cab->num_formas; i++)
+    {
+        int codigo = cena.ordem[i];
+        if (codigo >= NUM_CODIGOS || contador[codigo] >= cena.cab->num_por_tipo[codigo])
+        {
+            fprintf(stderr, "Erro: ordem das formas inválida em %s\n", caminho_arquivo);
+            break;
+        }
+
+        Forma forma = criar_forma_do_registro(&cena, codigo, contador[codigo]++);
+        if (forma == NULL)
+        {
+            fprintf(stderr, "Erro: registro inválido em %s\n", caminho_arquivo);
+            break;
+        }
+        inserir_fim(lista_formas, forma);
+        formas_lidas++;
+    }
+    int completa = formas_lidas == (int)cena.cab->num_formas;
+
+    if (dimensoes != NULL)
+    {
+        for (int k = 0; k < 4; k++) dimensoes[k] = cena.cab->dimensoes[k];
+    }
+    if (dimensoes_validas != NULL) *dimensoes_validas = cena.cab->dimensoes_validas != 0;
+
+    munmap(mapa, tamanho);
+    if (!completa) return -1;
+
+    printf("    Cena compilada carregada: %d formas lidas.\n", formas_lidas);
+    return formas_lidas;
+}
@@ -0,0 +1,49 @@
+/* cena_binaria.h
+ *
+ * Cena compilada: cópia binária de um .geo já lido, para recarregar o
+ * mesmo mapa sem refazer o parsing (ted --compile).
+ *
+ * O arquivo é versionado e pode ser mapeado em memória: as formas ficam
+ * em vetores de registros de tamanho fixo (um por tipo), as cores, fontes
+ * e textos em uma tabela de strings sem repetição, e a caixa envolvente
+ * do cenário já vem calculada. Os números são gravados na representação
+ * nativa da máquina; um arquivo de outra arquitetura é recusado.
+ */
+
+#ifndef CENA_BINARIA_H
+#define CENA_BINARIA_H
+
+#include "lista.h"
+
+/**
+ * Grava as formas da lista (na ordem da lista) em uma cena compilada.
+ *
+ * @param caminho_arquivo Caminho do arquivo a ser criado
+ * @param lista_formas Lista de formas lidas do .geo
+ * @return Número de formas gravadas, ou -1 em caso de erro
+ */
+int salvar_cena_binaria(const char *caminho_arquivo, Lista lista_formas);
+
+/**
+ * Verifica se o arquivo começa com a assinatura de uma cena compilada.
+ *
+ * @param caminho_arquivo Caminho do arquivo
+ * @return 1 se é uma cena compilada, 0 caso contrário
+ */
+int eh_cena_binaria(const char *caminho_arquivo);
+
+/**
+ * Carrega uma cena compilada, inserindo as formas no fim da lista na
+ * mesma ordem do .geo original.
+ *
+ * @param caminho_arquivo Caminho da cena compilada
+ * @param lista_formas Lista onde as formas serão inseridas
+ * @param dimensoes OUT: caixa do cenário [min_x, min_y, max_x, max_y],
+ *                  igual à de obter_dimensoes_cenario
+ * @param dimensoes_validas OUT: 0 se a cena não tinha formas com caixa
+ * @return Número de formas lidas, ou -1 se o arquivo é inválido
+ */
+int ler_cena_binaria(const char *caminho_arquivo, Lista lista_formas,
+                     double dimensoes[4], int *dimensoes_validas);
+
+#endif /* CENA_BINARIA_H */
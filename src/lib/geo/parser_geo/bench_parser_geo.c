@@ -0,0 +1,210 @@
+/* bench_parser_geo.c
+ * Benchmark do parser de .geo: leitura mapeada em memória (ler_arquivo_geo)
+ * contra a leitura com fgets + sscanf (ler_arquivo_geo_fluxo) e contra a
+ * carga da cena compilada (ted --compile).
+ *
+ * Gera um .geo sintético com círculos, retângulos, linhas, textos, estilos,
+ * comentários e algumas linhas em formatos incomuns (expoentes, muitos
+ * dígitos, tabulações, CRLF, cores longas), mede as duas leituras e
+ * confere que as listas resultantes são idênticas campo a campo.
+ *
+ * Uso: make bench && ./obj/bench_parser_geo [num_linhas] [arquivo.geo]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lista.h"
+#include "formas.h"
+#include "circulo.h"
+#include "retangulo.h"
+#include "linha.h"
+#include "texto.h"
+#include "parser_geo.h"
+#include "cena_binaria.h"
+
+#define LINHAS_PADRAO 2000000
+#define ARQUIVO_PADRAO "obj/bench_parser.geo"
+#define MAX_ASSINATURA 2048
+#define MAX_CAMINHO 1024
+
+static double aleatorio(double max)
+{
+    return (rand() / (double)RAND_MAX) * max;
+}
+
+static void gerar_arquivo(const char *caminho, int num_linhas)
+{
+    FILE *f = fopen(caminho, "w");
+    if (f == NULL)
+    {
+        fprintf(stderr, "Erro: não foi possível criar %s\n", caminho);
+        exit(1);
+    }
+
+    srand(7);
+    for (int i = 0; i < num_linhas; i++)
+    {
+        switch (i % 1000)
+        {
+            case 0:  fprintf(f, "# comentário %d\n", i); break;
+            case 1:  fprintf(f, "ts sans b %d\n", 8 + i % 10); break;
+            case 2:  fprintf(f, "\n"); break;
+            case 3:  fprintf(f, "c %d 1.5e2 -3E-1 +.25 red blue\n", i); break;
+            case 4:  fprintf(f, "r %d 123456789012345678901234.5 0.1000000000000000055511151231257827 4 5 black none\r\n", i); break;
+            case 5:  fprintf(f, "\tl %d\t1\t2\t3\t4\tgreen  \n", i); break;
+            case 6:  fprintf(f, "t  %d 1 2 red blue m texto com espaços extras\n", i); break;
+            case 7:  fprintf(f, "c %d 0x10 2 3 red blue\n", i); break;
+            case 8:  fprintf(f, "l %d 1 2 3 4 cor_com_mais_de_trinta_e_um_caracteres_aqui\n", i); break;
+            case 9:  fprintf(f, "t %d 5 6 #000 #fff iTexto colado na âncora\n", i); break;
+            case 10: fprintf(f, "c %d 1e400 -0 7 red blue\n", i); break;
+            default:
+                switch (i % 4)
+                {
+                    case 0:
+                        fprintf(f, "c %d %.3f %.3f %.2f #%06X #%06X\n", i,
+                                aleatorio(10000), aleatorio(10000), 1 + aleatorio(20),
+                                rand() & 0xFFFFFF, rand() & 0xFFFFFF);
+                        break;
+                    case 1:
+                        fprintf(f, "r %d %.4f %.4f %.1f %.1f black yellow\n", i,
+                                aleatorio(10000), aleatorio(10000), aleatorio(50), aleatorio(50));
+                        break;
+                    case 2:
+                        fprintf(f, "l %d %.6f %.6f %.6f %.6f purple\n", i,
+                                aleatorio(10000), aleatorio(10000), aleatorio(10000), aleatorio(10000));
+                        break;
+                    default:
+                        fprintf(f, "t %d %.2f %.2f red blue %c rótulo %d\n", i,
+                                aleatorio(10000), aleatorio(10000), "imf"[i % 3], i);
+                        break;
+                }
+                break;
+        }
+    }
+
+    fclose(f);
+}
+
+/**
+ * Descreve todos os campos da forma (doubles em %a, exatos).
+ */
+static void assinatura(Forma forma, char *saida)
+{
+    void *d = getFormaDados(forma);
+    switch (getFormaTipo(forma))
+    {
+        case TIPO_CIRCULO:
+            snprintf(saida, MAX_ASSINATURA, "c %d %a %a %a %s %s", getCirculoId(d),
+                     getCirculoX(d), getCirculoY(d), getCirculoRaio(d),
+                     getCirculoCorBorda(d), getCirculoCorPreenchimento(d));
+            break;
+        case TIPO_RETANGULO:
+            snprintf(saida, MAX_ASSINATURA, "r %d %a %a %a %a %s %s", getRetanguloId(d),
+                     getRetanguloX(d), getRetanguloY(d), getRetanguloLargura(d),
+                     getRetanguloAltura(d), getRetanguloCorBorda(d),
+                     getRetanguloCorPreenchimento(d));
+            break;
+        case TIPO_LINHA:
+            snprintf(saida, MAX_ASSINATURA, "l %d %a %a %a %a %s", getLinhaId(d),
+                     getLinhaX1(d), getLinhaY1(d), getLinhaX2(d), getLinhaY2(d),
+                     getLinhaCor(d));
+            break;
+        case TIPO_TEXTO:
+            snprintf(saida, MAX_ASSINATURA, "t %d %a %a %s %s %s [%s] %s %s %a", getTextoId(d),
+                     getTextoX(d), getTextoY(d), getTextoCorBorda(d),
+                     getTextoCorPreenchimento(d), getTextoAncora(d), getTextoConteudo(d),
+                     getTextoFontFamily(d), getTextoFontWeight(d), getTextoFontSize(d));
+            break;
+        default:
+            snprintf(saida, MAX_ASSINATURA, "?");
+            break;
+    }
+}
+
+static int comparar_listas(Lista a, Lista b)
+{
+    char sa[MAX_ASSINATURA], sb[MAX_ASSINATURA];
+    No na = obter_primeiro(a);
+    No nb = obter_primeiro(b);
+    int diferencas = 0;
+
+    while (na != NULL && nb != NULL)
+    {
+        assinatura((Forma)obter_elemento(na), sa);
+        assinatura((Forma)obter_elemento(nb), sb);
+        if (strcmp(sa, sb) != 0 && diferencas++ < 5)
+        {
+            printf("  diferença:\n    fluxo: %s\n    mmap:  %s\n", sa, sb);
+        }
+        na = obter_proximo(na);
+        nb = obter_proximo(nb);
+    }
+
+    if (na != NULL || nb != NULL) diferencas++;
+    return diferencas;
+}
+
+static double medir(int (*ler)(const char*, Lista), const char *caminho, Lista lista, int *n)
+{
+    clock_t ini = clock();
+    *n = ler(caminho, lista);
+    return (double)(clock() - ini) / CLOCKS_PER_SEC;
+}
+
+static int ler_cena(const char *caminho, Lista lista)
+{
+    double dimensoes[4];
+    int validas;
+    return ler_cena_binaria(caminho, lista, dimensoes, &validas);
+}
+
+int main(int argc, char *argv[])
+{
+    int num_linhas = (argc > 1) ? atoi(argv[1]) : LINHAS_PADRAO;
+    const char *caminho = (argc > 2) ? argv[2] : ARQUIVO_PADRAO;
+    if (num_linhas < 1) num_linhas = LINHAS_PADRAO;
+
+    printf("Gerando %s com %d linhas...\n", caminho, num_linhas);
+    gerar_arquivo(caminho, num_linhas);
+
+    /* Os avisos das linhas inválidas (propositais) seriam repetidos aos milhares */
+    if (freopen("/dev/null", "w", stderr) == NULL) return 1;
+
+    Lista fluxo = criar_lista();
+    Lista mapeado = criar_lista();
+    int n_fluxo, n_mapeado;
+
+    double t_fluxo = medir(ler_arquivo_geo_fluxo, caminho, fluxo, &n_fluxo);
+    double t_mapeado = medir(ler_arquivo_geo, caminho, mapeado, &n_mapeado);
+
+    /* Cena compilada a partir da lista lida, recarregada em outra lista */
+    char caminho_cena[MAX_CAMINHO];
+    snprintf(caminho_cena, sizeof(caminho_cena), "%sb", caminho);
+    Lista compilada = criar_lista();
+    int n_compilada = -1;
+    double t_compilada = 0;
+    if (salvar_cena_binaria(caminho_cena, mapeado) >= 0)
+    {
+        t_compilada = medir(ler_cena, caminho_cena, compilada, &n_compilada);
+    }
+
+    printf("\n%-22s %10s %10s\n", "leitura", "formas", "tempo(s)");
+    printf("%-22s %10d %10.3f\n", "fgets + sscanf", n_fluxo, t_fluxo);
+    printf("%-22s %10d %10.3f\n", "mmap + scanner", n_mapeado, t_mapeado);
+    printf("%-22s %10d %10.3f\n", "cena compilada", n_compilada, t_compilada);
+    if (t_mapeado > 0) printf("aceleração do mmap: %.2fx\n", t_fluxo / t_mapeado);
+    if (t_compilada > 0) printf("aceleração da cena compilada: %.2fx\n", t_fluxo / t_compilada);
+
+    int diferencas = comparar_listas(fluxo, mapeado) + comparar_listas(fluxo, compilada);
+    printf("listas %s\n", diferencas == 0 ? "idênticas" : "DIFERENTES");
+
+    destruir_lista(fluxo, destroiForma);
+    destruir_lista(mapeado, destroiForma);
+    destruir_lista(compilada, destroiForma);
+    remove(caminho);
+    remove(caminho_cena);
+
+    return diferencas == 0 ? 0 : 1;
+}
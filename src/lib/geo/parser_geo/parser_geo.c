@@ -1,12 +1,27 @@
 /* parser_geo.c
  *
  * Implementação do parser de arquivos .geo
+ *
+ * O arquivo é mapeado em memória (mmap) e percorrido no lugar. As linhas
+ * comuns (c, r, l, t) são lidas por um scanner próprio, sem sscanf e sem
+ * copiar a linha; qualquer linha fora do padrão esperado (ts, comandos
+ * desconhecidos, números em notação incomum, cores longas...) é copiada
+ * e entregue ao caminho original com sscanf, de modo que o resultado é
+ * sempre o mesmo da leitura com fgets. Se o mapeamento não for possível,
+ * o arquivo é lido com fgets.
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "parser_geo.h"
 #include "lista.h"
@@ -19,6 +34,15 @@
 /* Tamanho máximo de uma linha do arquivo */
 #define MAX_LINHA 1024
 
+/* Tamanho máximo de uma cor (como o %31s do sscanf) */
+#define MAX_COR 31
+
+/* Maior número que o scanner trata sozinho (demais vão para o strtod) */
+#define MAX_TOKEN_NUMERO 64
+#define MAX_DIGITOS_EXATOS 19
+#define MAX_MANTISSA_EXATA (1ULL << 53)
+#define MAX_EXPOENTE_EXATO 22
+
 /* ============================================================================
  * Estado Global de Estilo de Texto
  * ============================================================================ */
@@ -222,6 +246,377 @@ static void processar_estilo_texto(char *linha)
     }
 }
 
+/**
+ * Processa uma linha já terminada em '\0' (caminho com sscanf).
+ * @return Forma criada, ou NULL (linha sem forma ou com erro)
+ */
+static Forma processar_comando(char *linha, int numero_linha)
+{
+    char *linha_limpa = trim(linha);
+    
+    /* Ignora linhas vazias e comentários */
+    if (linha_limpa[0] == '\0' || linha_limpa[0] == '#')
+    {
+        return NULL;
+    }
+    
+    Forma forma = NULL;
+    char comando = linha_limpa[0];
+    
+    switch (comando)
+    {
+        case 'c':
+            forma = processar_circulo(linha_limpa);
+            break;
+            
+        case 'r':
+            forma = processar_retangulo(linha_limpa);
+            break;
+            
+        case 'l':
+            forma = processar_linha(linha_limpa);
+            break;
+            
+        case 't':
+            if (linha_limpa[1] == 's')
+            {
+                /* Comando ts (estilo de texto) */
+                processar_estilo_texto(linha_limpa);
+            }
+            else
+            {
+                /* Comando t (texto) */
+                forma = processar_texto(linha_limpa);
+            }
+            break;
+            
+        default:
+            fprintf(stderr, "Aviso: comando desconhecido na linha %d: %c\n", 
+                    numero_linha, comando);
+            break;
+    }
+    
+    return forma;
+}
+
+/* ============================================================================
+ * Scanner no Lugar (arquivo mapeado)
+ * ============================================================================ */
+
+/* Cursor sobre uma linha do arquivo mapeado: [p, fim), sem '\0' final */
+typedef struct cursor
+{
+    const char *p;
+    const char *fim;
+} Cursor;
+
+static const double potencias_10[MAX_EXPOENTE_EXATO + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline int eh_espaco(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static inline int eh_digito(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static inline void pular_espacos(Cursor *c)
+{
+    while (c->p < c->fim && eh_espaco(*c->p)) c->p++;
+}
+
+/**
+ * O token terminou onde devia (espaço ou fim da linha)?
+ */
+static inline int fim_de_token(const Cursor *c)
+{
+    return c->p >= c->fim || eh_espaco(*c->p);
+}
+
+/**
+ * Lê um inteiro no formato do %d.
+ * @return 1 se leu, 0 se o token não é um inteiro simples
+ */
+static int ler_inteiro(Cursor *c, int *valor)
+{
+    pular_espacos(c);
+    
+    int negativo = 0;
+    if (c->p < c->fim && (*c->p == '-' || *c->p == '+'))
+    {
+        negativo = (*c->p == '-');
+        c->p++;
+    }
+    
+    long long v = 0;
+    int digitos = 0;
+    while (c->p < c->fim && eh_digito(*c->p))
+    {
+        v = v * 10 + (*c->p - '0');
+        c->p++;
+        if (++digitos > 9) return 0;   /* Fora do alcance seguro de int */
+    }
+    
+    if (digitos == 0 || !fim_de_token(c)) return 0;
+    
+    *valor = (int)(negativo ? -v : v);
+    return 1;
+}
+
+/**
+ * Lê um double com o mesmo resultado do %lf (strtod).
+ * Mantissas de até 2^53 com expoente decimal de até 22 são exatas em
+ * double, então uma única multiplicação ou divisão já arredonda
+ * corretamente; os demais casos vão para o strtod.
+ * @return 1 se leu, 0 se o token não é um número
+ */
+static int ler_double(Cursor *c, double *valor)
+{
+    pular_espacos(c);
+    const char *inicio = c->p;
+    
+    int negativo = 0;
+    if (c->p < c->fim && (*c->p == '-' || *c->p == '+'))
+    {
+        negativo = (*c->p == '-');
+        c->p++;
+    }
+    
+    uint64_t mantissa = 0;
+    int digitos = 0, significativos = 0, expoente = 0;
+    
+    while (c->p < c->fim && eh_digito(*c->p))
+    {
+        if (mantissa != 0 || *c->p != '0') significativos++;
+        if (significativos <= MAX_DIGITOS_EXATOS) mantissa = mantissa * 10 + (uint64_t)(*c->p - '0');
+        else expoente++;
+        digitos++;
+        c->p++;
+    }
+    if (c->p < c->fim && *c->p == '.')
+    {
+        c->p++;
+        while (c->p < c->fim && eh_digito(*c->p))
+        {
+            if (mantissa != 0 || *c->p != '0') significativos++;
+            if (significativos <= MAX_DIGITOS_EXATOS)
+            {
+                mantissa = mantissa * 10 + (uint64_t)(*c->p - '0');
+                expoente--;
+            }
+            digitos++;
+            c->p++;
+        }
+    }
+    if (digitos == 0) return 0;
+    
+    if (c->p < c->fim && (*c->p == 'e' || *c->p == 'E'))
+    {
+        c->p++;
+        int negativo_exp = 0;
+        if (c->p < c->fim && (*c->p == '-' || *c->p == '+'))
+        {
+            negativo_exp = (*c->p == '-');
+            c->p++;
+        }
+        int e = 0, digitos_exp = 0;
+        while (c->p < c->fim && eh_digito(*c->p))
+        {
+            if (e < 10000) e = e * 10 + (*c->p - '0');
+            digitos_exp++;
+            c->p++;
+        }
+        if (digitos_exp == 0) return 0;
+        expoente += negativo_exp ? -e : e;
+    }
+    
+    if (!fim_de_token(c)) return 0;
+    
+    double v;
+    if (significativos <= MAX_DIGITOS_EXATOS && mantissa <= MAX_MANTISSA_EXATA &&
+        expoente >= -MAX_EXPOENTE_EXATO && expoente <= MAX_EXPOENTE_EXATO)
+    {
+        v = (double)mantissa;
+        if (expoente < 0) v /= potencias_10[-expoente];
+        else v *= potencias_10[expoente];
+        if (negativo) v = -v;
+    }
+    else
+    {
+        /* Caso geral: strtod sobre uma cópia terminada em '\0' */
+        size_t tamanho = (size_t)(c->p - inicio);
+        if (tamanho >= MAX_TOKEN_NUMERO) return 0;
+        char token[MAX_TOKEN_NUMERO];
+        memcpy(token, inicio, tamanho);
+        token[tamanho] = '\0';
+        v = strtod(token, NULL);
+    }
+    
+    *valor = v;
+    return 1;
+}
+
+/**
+ * Lê uma palavra (cor) para buffer de MAX_COR + 1 bytes.
+ * @return 1 se leu, 0 se vazia ou maior que MAX_COR
+ */
+static int ler_palavra(Cursor *c, char *destino)
+{
+    pular_espacos(c);
+    const char *inicio = c->p;
+    while (c->p < c->fim && !eh_espaco(*c->p)) c->p++;
+    
+    size_t tamanho = (size_t)(c->p - inicio);
+    if (tamanho == 0 || tamanho > MAX_COR) return 0;
+    
+    memcpy(destino, inicio, tamanho);
+    destino[tamanho] = '\0';
+    return 1;
+}
+
+/**
+ * Tenta ler uma linha c/r/l/t direto do arquivo mapeado.
+ * @param forma OUT: forma criada (NULL para linha vazia ou comentário)
+ * @return 1 se a linha foi tratada, 0 se deve ir para o caminho com sscanf
+ */
+static int processar_linha_rapida(const char *ini, const char *fim, Forma *forma)
+{
+    Cursor c = {ini, fim};
+    *forma = NULL;
+    
+    /* Um '\0' no meio da linha muda o que o caminho com strings enxerga */
+    if (memchr(ini, '\0', (size_t)(fim - ini)) != NULL) return 0;
+    
+    pular_espacos(&c);
+    if (c.p >= c.fim || *c.p == '#') return 1;
+    
+    char comando = *c.p++;
+    if (c.p >= c.fim || !eh_espaco(*c.p)) return 0;
+    
+    /* processar_texto localiza o texto a partir de "t " + 1 espaço;
+     * outros espaçamentos ficam com ele */
+    if (comando == 't' && (c.p + 1 >= c.fim || eh_espaco(c.p[1]))) return 0;
+    
+    int id;
+    if (!ler_inteiro(&c, &id)) return 0;
+    
+    switch (comando)
+    {
+        case 'c':
+        {
+            double x, y, raio;
+            char borda[MAX_COR + 1], preenchimento[MAX_COR + 1];
+            if (!ler_double(&c, &x) || !ler_double(&c, &y) || !ler_double(&c, &raio) ||
+                !ler_palavra(&c, borda) || !ler_palavra(&c, preenchimento)) return 0;
+            
+            Circulo circ = criaCirculo(id, x, y, raio, borda, preenchimento);
+            if (circ != NULL) *forma = criaForma(TIPO_CIRCULO, circ);
+            return 1;
+        }
+        
+        case 'r':
+        {
+            double x, y, largura, altura;
+            char borda[MAX_COR + 1], preenchimento[MAX_COR + 1];
+            if (!ler_double(&c, &x) || !ler_double(&c, &y) ||
+                !ler_double(&c, &largura) || !ler_double(&c, &altura) ||
+                !ler_palavra(&c, borda) || !ler_palavra(&c, preenchimento)) return 0;
+            
+            Retangulo r = criaRetangulo(id, x, y, largura, altura, borda, preenchimento);
+            if (r != NULL) *forma = criaForma(TIPO_RETANGULO, r);
+            return 1;
+        }
+        
+        case 'l':
+        {
+            double x1, y1, x2, y2;
+            char cor[MAX_COR + 1];
+            if (!ler_double(&c, &x1) || !ler_double(&c, &y1) ||
+                !ler_double(&c, &x2) || !ler_double(&c, &y2) ||
+                !ler_palavra(&c, cor)) return 0;
+            
+            Linha l = criaLinha(id, x1, y1, x2, y2, cor);
+            if (l != NULL) *forma = criaForma(TIPO_LINHA, l);
+            return 1;
+        }
+        
+        case 't':
+        {
+            double x, y;
+            char borda[MAX_COR + 1], preenchimento[MAX_COR + 1];
+            if (!ler_double(&c, &x) || !ler_double(&c, &y) ||
+                !ler_palavra(&c, borda) || !ler_palavra(&c, preenchimento)) return 0;
+            
+            /* Âncora: um caractere; o texto começa depois dela */
+            pular_espacos(&c);
+            if (c.p >= c.fim) return 0;
+            char ancora_str[2] = {*c.p++, '\0'};
+            pular_espacos(&c);
+            
+            const char *fim_texto = c.fim;
+            while (fim_texto > c.p && eh_espaco(fim_texto[-1])) fim_texto--;
+            
+            char texto[MAX_LINHA];
+            size_t tamanho = (size_t)(fim_texto - c.p);
+            memcpy(texto, c.p, tamanho);
+            texto[tamanho] = '\0';
+            
+            Texto t = criaTexto(id, x, y, borda, preenchimento, ancora_str, texto,
+                                estilo_font_family, estilo_font_weight, estilo_font_size);
+            if (t != NULL) *forma = criaForma(TIPO_TEXTO, t);
+            return 1;
+        }
+        
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Lê um buffer inteiro em memória, linha a linha como o fgets faria
+ * (linhas com mais de MAX_LINHA - 1 bytes são partidas do mesmo jeito).
+ */
+static int ler_buffer_geo(const char *dados, size_t tamanho, Lista lista_formas)
+{
+    const char *p = dados;
+    const char *fim_dados = dados + tamanho;
+    int formas_lidas = 0;
+    int numero_linha = 0;
+    
+    while (p < fim_dados)
+    {
+        size_t resto = (size_t)(fim_dados - p);
+        size_t limite = resto < MAX_LINHA - 1 ? resto : MAX_LINHA - 1;
+        const char *quebra = (const char*)memchr(p, '\n', limite);
+        const char *fim = quebra ? quebra + 1 : p + limite;
+        numero_linha++;
+        
+        Forma forma = NULL;
+        if (!processar_linha_rapida(p, fim, &forma))
+        {
+            char linha[MAX_LINHA];
+            memcpy(linha, p, (size_t)(fim - p));
+            linha[fim - p] = '\0';
+            forma = processar_comando(linha, numero_linha);
+        }
+        
+        if (forma != NULL)
+        {
+            inserir_fim(lista_formas, forma);
+            formas_lidas++;
+        }
+        
+        p = fim;
+    }
+    
+    return formas_lidas;
+}
+
 /* ============================================================================
  * Implementação das Funções Públicas
  * ============================================================================ */
@@ -234,6 +629,45 @@ int ler_arquivo_geo(const char *caminho_arquivo, Lista lista_formas)
         return -1;
     }
     
+    int fd = open(caminho_arquivo, O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Erro: não foi possível abrir arquivo: %s\n", caminho_arquivo);
+        return -1;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0)
+    {
+        /* Arquivo vazio ou não mapeável (pipe, dispositivo): lê com fgets */
+        close(fd);
+        return ler_arquivo_geo_fluxo(caminho_arquivo, lista_formas);
+    }
+    
+    size_t tamanho = (size_t)info.st_size;
+    void *dados = mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (dados == MAP_FAILED)
+    {
+        return ler_arquivo_geo_fluxo(caminho_arquivo, lista_formas);
+    }
+    posix_madvise(dados, tamanho, POSIX_MADV_SEQUENTIAL);
+    
+    int formas_lidas = ler_buffer_geo((const char*)dados, tamanho, lista_formas);
+    munmap(dados, tamanho);
+    
+    printf("    Arquivo .geo processado: %d formas lidas.\n", formas_lidas);
+    return formas_lidas;
+}
+
+int ler_arquivo_geo_fluxo(const char *caminho_arquivo, Lista lista_formas)
+{
+    if (caminho_arquivo == NULL || lista_formas == NULL)
+    {
+        fprintf(stderr, "Erro: parâmetros inválidos em ler_arquivo_geo\n");
+        return -1;
+    }
+    
     FILE *arquivo = fopen(caminho_arquivo, "r");
     if (arquivo == NULL)
     {
@@ -248,49 +682,7 @@ int ler_arquivo_geo(const char *caminho_arquivo, Lista lista_formas)
     while (fgets(linha, MAX_LINHA, arquivo) != NULL)
     {
         numero_linha++;
-        char *linha_limpa = trim(linha);
-        
-        /* Ignora linhas vazias e comentários */
-        if (linha_limpa[0] == '\0' || linha_limpa[0] == '#')
-        {
-            continue;
-        }
-        
-        Forma forma = NULL;
-        char comando = linha_limpa[0];
-        
-        switch (comando)
-        {
-            case 'c':
-                forma = processar_circulo(linha_limpa);
-                break;
-                
-            case 'r':
-                forma = processar_retangulo(linha_limpa);
-                break;
-                
-            case 'l':
-                forma = processar_linha(linha_limpa);
-                break;
-                
-            case 't':
-                if (linha_limpa[1] == 's')
-                {
-                    /* Comando ts (estilo de texto) */
-                    processar_estilo_texto(linha_limpa);
-                }
-                else
-                {
-                    /* Comando t (texto) */
-                    forma = processar_texto(linha_limpa);
-                }
-                break;
-                
-            default:
-                fprintf(stderr, "Aviso: comando desconhecido na linha %d: %c\n", 
-                        numero_linha, comando);
-                break;
-        }
+        Forma forma = processar_comando(linha, numero_linha);
         
         if (forma != NULL)
         {
@@ -15,6 +15,8 @@
 
 /**
  * Lê um arquivo .geo e popula a lista com as formas geométricas.
+ * O arquivo é mapeado em memória e lido no lugar; o resultado é o mesmo
+ * de ler_arquivo_geo_fluxo.
  * 
  * Comandos reconhecidos:
  *   c  - Círculo:    c id x y raio corBorda corPreenchimento
@@ -38,6 +40,17 @@
  */
 int ler_arquivo_geo(const char *caminho_arquivo, Lista lista_formas);
 
+/**
+ * Igual a ler_arquivo_geo, mas lendo linha a linha com fgets e sscanf.
+ * É o caminho usado quando o arquivo não pode ser mapeado em memória
+ * (pipes, dispositivos) e a referência do benchmark do parser.
+ * 
+ * @param caminho_arquivo Caminho completo para o arquivo .geo
+ * @param lista_formas Lista onde as formas serão inseridas
+ * @return Número de formas lidas com sucesso, ou -1 em caso de erro
+ */
+int ler_arquivo_geo_fluxo(const char *caminho_arquivo, Lista lista_formas);
+
 /**
  * Obtém as dimensões do cenário (bounding box de todas as formas).
  * Útil para definir o viewBox do SVG.
@@ -1,11 +1,26 @@
 /* svg.c
  *
  * Implementação do gerador de arquivos SVG.
+ * A saída é montada em um buffer próprio e gravada com fwrite em blocos
+ * grandes. Os números saem por um formatador de ponto fixo que reproduz
+ * exatamente o "%.2f" / "%.1f" do printf; valores cujo arredondamento
+ * fica ambíguo (ou muito grandes) são delegados ao snprintf.
+ *
+ * Um fragmento é um contexto sem cabeçalho gravado em arquivo temporário;
+ * acumula elementos cujo SVG de destino só pode ser aberto no fim (o
+ * viewBox depende do estado final) sem mantê-los em memória.
+ *
+ * O cache de cena guarda os bytes já serializados de cada forma e do
+ * bloco de anteparos; os SVGs por comando copiam esses fragmentos em vez
+ * de formatar o cenário inteiro de novo.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <stdint.h>
 
 #include "svg.h"
 #include "lista.h"
@@ -15,22 +30,223 @@
 #include "texto.h"
 #include "formas.h"
 #include "ponto.h"
-#include "segmento.h"
 #include "visibilidade.h"
 
 /* ============================================================================
  * Estrutura Interna
  * ============================================================================ */
 
+#define TAMANHO_BUFFER (256 * 1024)
+#define TAMANHO_BUFFER_MEMORIA 1024 /* Inicial, para contextos em memória */
+#define CAPACIDADE_TABELA_CACHE 1024
+#define MAX_NUMERO 64               /* Maior número formatado (com folga) */
+#define LIMITE_PONTO_FIXO 1e9       /* Acima disso, usa snprintf */
+#define FOLGA_ARREDONDAMENTO 1e-4   /* Distância mínima do meio para decidir sozinho */
+
 typedef struct svg_contexto_internal
 {
-    FILE *arquivo;
+    FILE *arquivo;              /* NULL: contexto em memória (o buffer cresce) */
+    int fragmento;              /* Arquivo temporário sem cabeçalho nem </svg> */
+    char *buffer;
+    size_t usado;
+    size_t capacidade;
     double min_x;
     double min_y;
     double largura;
     double altura;
 } SvgContextoInternal;
 
+/* Fragmento serializado de uma forma */
+typedef struct fragmento
+{
+    Forma forma;                /* Chave (NULL: posição livre) */
+    char *dados;                /* NULL: ainda não serializado ou invalidado */
+    size_t tamanho;
+} Fragmento;
+
+typedef struct svg_cache_internal
+{
+    Fragmento *tabela;          /* Hash por endereço da forma */
+    int capacidade;             /* Potência de 2 */
+    int ocupadas;
+
+    char *segmentos;            /* Bloco de anteparos serializado */
+    size_t tamanho_segmentos;
+    VetorSegmentos vetor_segmentos;
+    unsigned versao_segmentos;
+
+    SvgContextoInternal rascunho;   /* Contexto em memória para serializar */
+} SvgCacheInternal;
+
+/* ============================================================================
+ * Funções Auxiliares - Buffer de Saída
+ * ============================================================================ */
+
+/**
+ * Grava o conteúdo do buffer no arquivo.
+ */
+static void buffer_descarregar(SvgContextoInternal *ctx)
+{
+    if (ctx->arquivo == NULL) return;
+
+    if (ctx->usado > 0)
+    {
+        if (fwrite(ctx->buffer, 1, ctx->usado, ctx->arquivo) != ctx->usado)
+        {
+            fprintf(stderr, "Erro: falha ao gravar arquivo SVG\n");
+        }
+        ctx->usado = 0;
+    }
+}
+
+/**
+ * Garante espaço para mais bytes no buffer.
+ */
+static int buffer_crescer(SvgContextoInternal *ctx, size_t minimo)
+{
+    size_t nova = ctx->capacidade * 2;
+    if (nova < minimo) nova = minimo;
+
+    char *buffer = (char*)realloc(ctx->buffer, nova);
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao expandir buffer SVG\n");
+        return 0;
+    }
+    ctx->buffer = buffer;
+    ctx->capacidade = nova;
+    return 1;
+}
+
+/**
+ * Garante espaço para mais bytes no buffer: descarrega no arquivo ou,
+ * em memória, cresce o buffer.
+ */
+static inline int buffer_reservar(SvgContextoInternal *ctx, size_t bytes)
+{
+    if (ctx->usado + bytes <= ctx->capacidade) return 1;
+
+    if (ctx->arquivo == NULL) return buffer_crescer(ctx, ctx->usado + bytes);
+
+    buffer_descarregar(ctx);
+    return 1;
+}
+
+static void buffer_escrever(SvgContextoInternal *ctx, const char *dados, size_t bytes)
+{
+    if (ctx->arquivo != NULL && bytes > ctx->capacidade)
+    {
+        buffer_descarregar(ctx);
+        fwrite(dados, 1, bytes, ctx->arquivo);
+        return;
+    }
+
+    if (!buffer_reservar(ctx, bytes)) return;
+    memcpy(ctx->buffer + ctx->usado, dados, bytes);
+    ctx->usado += bytes;
+}
+
+static inline void buffer_texto(SvgContextoInternal *ctx, const char *texto)
+{
+    if (texto == NULL) texto = "(null)";    /* Como o printf da glibc */
+    buffer_escrever(ctx, texto, strlen(texto));
+}
+
+static inline void buffer_caractere(SvgContextoInternal *ctx, char c)
+{
+    if (!buffer_reservar(ctx, 1)) return;
+    ctx->buffer[ctx->usado++] = c;
+}
+
+/**
+ * Escreve com formato do printf (casos raros e campos de texto longos).
+ */
+static void buffer_formatado(SvgContextoInternal *ctx, const char *formato, ...)
+{
+    char local[512];
+    va_list args;
+
+    va_start(args, formato);
+    int n = vsnprintf(local, sizeof(local), formato, args);
+    va_end(args);
+    if (n < 0) return;
+
+    if ((size_t)n < sizeof(local))
+    {
+        buffer_escrever(ctx, local, (size_t)n);
+        return;
+    }
+
+    char *grande = (char*)malloc((size_t)n + 1);
+    if (grande == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao formatar saída SVG\n");
+        return;
+    }
+    va_start(args, formato);
+    vsnprintf(grande, (size_t)n + 1, formato, args);
+    va_end(args);
+    buffer_escrever(ctx, grande, (size_t)n);
+    free(grande);
+}
+
+/**
+ * Escreve v com 1 ou 2 casas decimais, idêntico a printf("%.Nf", v).
+ * O valor escalado é arredondado direto; se cair perto demais do meio
+ * entre dois inteiros, o erro da multiplicação poderia mudar o resultado
+ * e o snprintf decide (ele arredonda o valor binário exato).
+ */
+static void buffer_numero(SvgContextoInternal *ctx, double v, int casas)
+{
+    double escala = (casas == 1) ? 10.0 : 100.0;
+    double absoluto = fabs(v);
+
+    if (!(absoluto < LIMITE_PONTO_FIXO))
+    {
+        buffer_formatado(ctx, casas == 1 ? "%.1f" : "%.2f", v);
+        return;
+    }
+
+    double escalado = absoluto * escala;
+    double piso = floor(escalado);
+    double fracao = escalado - piso;
+    if (fabs(fracao - 0.5) < FOLGA_ARREDONDAMENTO)
+    {
+        buffer_formatado(ctx, casas == 1 ? "%.1f" : "%.2f", v);
+        return;
+    }
+
+    unsigned long long r = (unsigned long long)piso + (fracao > 0.5 ? 1u : 0u);
+    unsigned long long inteiro = r / (unsigned long long)escala;
+    unsigned frac = (unsigned)(r % (unsigned long long)escala);
+
+    char tmp[MAX_NUMERO];
+    int pos = MAX_NUMERO;
+
+    /* Casas decimais, de trás para frente */
+    for (int i = 0; i < casas; i++)
+    {
+        tmp[--pos] = (char)('0' + frac % 10);
+        frac /= 10;
+    }
+    tmp[--pos] = '.';
+    do
+    {
+        tmp[--pos] = (char)('0' + inteiro % 10);
+        inteiro /= 10;
+    } while (inteiro > 0);
+
+    /* printf mantém o sinal de negativos que arredondam para zero */
+    if (signbit(v)) tmp[--pos] = '-';
+
+    buffer_escrever(ctx, tmp + pos, (size_t)(MAX_NUMERO - pos));
+}
+
+static inline void buffer_numero2(SvgContextoInternal *ctx, double v)
+{
+    buffer_numero(ctx, v, 2);
+}
+
 /* ============================================================================
  * Funções Auxiliares
  * ============================================================================ */
@@ -40,11 +256,67 @@ typedef struct svg_contexto_internal
  */
 static void escrever_header(SvgContextoInternal *ctx)
 {
-    fprintf(ctx->arquivo, 
-            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
-            "<svg xmlns=\"http://www.w3.org/2000/svg\" "
-            "viewBox=\"%.2f %.2f %.2f %.2f\">\n",
-            ctx->min_x, ctx->min_y, ctx->largura, ctx->altura);
+    buffer_texto(ctx,
+                 "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                 "<svg xmlns=\"http://www.w3.org/2000/svg\" "
+                 "viewBox=\"");
+    buffer_numero2(ctx, ctx->min_x);
+    buffer_caractere(ctx, ' ');
+    buffer_numero2(ctx, ctx->min_y);
+    buffer_caractere(ctx, ' ');
+    buffer_numero2(ctx, ctx->largura);
+    buffer_caractere(ctx, ' ');
+    buffer_numero2(ctx, ctx->altura);
+    buffer_texto(ctx, "\">\n");
+}
+
+/**
+ * Escreve o início de um <line> com as quatro coordenadas (sem fechar a tag).
+ */
+static void escrever_linha(SvgContextoInternal *ctx, double x1, double y1,
+                           double x2, double y2)
+{
+    buffer_texto(ctx, "  <line x1=\"");
+    buffer_numero2(ctx, x1);
+    buffer_texto(ctx, "\" y1=\"");
+    buffer_numero2(ctx, y1);
+    buffer_texto(ctx, "\" x2=\"");
+    buffer_numero2(ctx, x2);
+    buffer_texto(ctx, "\" y2=\"");
+    buffer_numero2(ctx, y2);
+    buffer_caractere(ctx, '"');
+}
+
+/**
+ * Escreve a lista "x0,y0 x1,y1 ..." do atributo points.
+ */
+static void escrever_pontos(SvgContextoInternal *ctx, const double *pontos, int num_pontos)
+{
+    for (int i = 0; i < num_pontos; i++)
+    {
+        if (i > 0) buffer_caractere(ctx, ' ');
+        buffer_numero2(ctx, pontos[i * 2]);
+        buffer_caractere(ctx, ',');
+        buffer_numero2(ctx, pontos[i * 2 + 1]);
+    }
+}
+
+/**
+ * Fecha o atributo points e a tag <polygon>.
+ */
+static void escrever_fim_poligono(SvgContextoInternal *ctx, const char *cor_borda,
+                                  const char *cor_preenchimento, double opacidade,
+                                  const char *espessura)
+{
+    buffer_texto(ctx, "\" stroke=\"");
+    buffer_texto(ctx, cor_borda);
+    buffer_texto(ctx, "\" fill=\"");
+    buffer_texto(ctx, cor_preenchimento);
+    buffer_texto(ctx, "\" fill-opacity=\"");
+    buffer_numero2(ctx, opacidade);
+    buffer_texto(ctx, "\" stroke-width=\"");
+    buffer_texto(ctx, espessura);
+    buffer_texto(ctx, "\"/>\n");
 }
 
 /**
@@ -111,10 +383,22 @@ SvgContexto criar_svg_viewbox(const char *caminho_arquivo,
         return NULL;
     }
     
+    ctx->buffer = (char*)malloc(TAMANHO_BUFFER);
+    if (ctx->buffer == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar buffer SVG\n");
+        free(ctx);
+        return NULL;
+    }
+    ctx->usado = 0;
+    ctx->capacidade = TAMANHO_BUFFER;
+    ctx->fragmento = 0;
+    
     ctx->arquivo = fopen(caminho_arquivo, "w");
     if (ctx->arquivo == NULL)
     {
         fprintf(stderr, "Erro: não foi possível criar arquivo: %s\n", caminho_arquivo);
+        free(ctx->buffer);
         free(ctx);
         return NULL;
     }
@@ -129,17 +413,76 @@ SvgContexto criar_svg_viewbox(const char *caminho_arquivo,
     return (SvgContexto)ctx;
 }
 
+SvgContexto criar_svg_fragmento(void)
+{
+    SvgContextoInternal *ctx = (SvgContextoInternal*)calloc(1, sizeof(SvgContextoInternal));
+    if (ctx == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar fragmento SVG\n");
+        return NULL;
+    }
+    
+    ctx->buffer = (char*)malloc(TAMANHO_BUFFER);
+    ctx->arquivo = tmpfile();
+    if (ctx->buffer == NULL || ctx->arquivo == NULL)
+    {
+        fprintf(stderr, "Erro: não foi possível criar fragmento SVG temporário\n");
+        if (ctx->arquivo != NULL) fclose(ctx->arquivo);
+        free(ctx->buffer);
+        free(ctx);
+        return NULL;
+    }
+    ctx->capacidade = TAMANHO_BUFFER;
+    ctx->fragmento = 1;
+    
+    return (SvgContexto)ctx;
+}
+
+int svg_anexar_fragmento(SvgContexto destino, SvgContexto fragmento)
+{
+    SvgContextoInternal *ctx = (SvgContextoInternal*)destino;
+    SvgContextoInternal *frag = (SvgContextoInternal*)fragmento;
+    if (ctx == NULL || ctx->buffer == NULL || frag == NULL || !frag->fragmento) return 0;
+    
+    buffer_descarregar(frag);
+    if (fflush(frag->arquivo) != 0 || fseek(frag->arquivo, 0, SEEK_SET) != 0)
+    {
+        fprintf(stderr, "Erro: falha ao ler fragmento SVG temporário\n");
+        return 0;
+    }
+    
+    /* O buffer do fragmento (já vazio) serve de bloco de cópia */
+    size_t lidos;
+    while ((lidos = fread(frag->buffer, 1, frag->capacidade, frag->arquivo)) > 0)
+    {
+        buffer_escrever(ctx, frag->buffer, lidos);
+    }
+    
+    int ok = !ferror(frag->arquivo);
+    if (!ok) fprintf(stderr, "Erro: falha ao ler fragmento SVG temporário\n");
+    
+    /* Volta ao fim: o fragmento continua aceitando elementos */
+    fseek(frag->arquivo, 0, SEEK_END);
+    return ok;
+}
+
 void finalizar_svg(SvgContexto svg)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
     if (ctx == NULL) return;
     
-    if (ctx->arquivo != NULL)
+    if (ctx->fragmento)
+    {
+        fclose(ctx->arquivo);   /* tmpfile: removido ao fechar */
+    }
+    else if (ctx->arquivo != NULL)
     {
-        fprintf(ctx->arquivo, "</svg>\n");
+        buffer_texto(ctx, "</svg>\n");
+        buffer_descarregar(ctx);
         fclose(ctx->arquivo);
     }
     
+    free(ctx->buffer);
     free(ctx);
 }
 
@@ -150,53 +493,56 @@ void finalizar_svg(SvgContexto svg)
 void svg_desenhar_circulo(SvgContexto svg, Circulo c)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
-    if (ctx == NULL || ctx->arquivo == NULL || c == NULL) return;
-    
-    fprintf(ctx->arquivo,
-            "  <circle cx=\"%.2f\" cy=\"%.2f\" r=\"%.2f\" "
-            "stroke=\"%s\" fill=\"%s\" fill-opacity=\"0.6\" stroke-width=\"1\"/>\n",
-            getCirculoX(c),
-            getCirculoY(c),
-            getCirculoRaio(c),
-            getCirculoCorBorda(c),
-            getCirculoCorPreenchimento(c));
+    if (ctx == NULL || ctx->buffer == NULL || c == NULL) return;
+    
+    buffer_texto(ctx, "  <circle cx=\"");
+    buffer_numero2(ctx, getCirculoX(c));
+    buffer_texto(ctx, "\" cy=\"");
+    buffer_numero2(ctx, getCirculoY(c));
+    buffer_texto(ctx, "\" r=\"");
+    buffer_numero2(ctx, getCirculoRaio(c));
+    buffer_texto(ctx, "\" stroke=\"");
+    buffer_texto(ctx, getCirculoCorBorda(c));
+    buffer_texto(ctx, "\" fill=\"");
+    buffer_texto(ctx, getCirculoCorPreenchimento(c));
+    buffer_texto(ctx, "\" fill-opacity=\"0.6\" stroke-width=\"1\"/>\n");
 }
 
 void svg_desenhar_retangulo(SvgContexto svg, Retangulo r)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
-    if (ctx == NULL || ctx->arquivo == NULL || r == NULL) return;
-    
-    fprintf(ctx->arquivo,
-            "  <rect x=\"%.2f\" y=\"%.2f\" width=\"%.2f\" height=\"%.2f\" "
-            "stroke=\"%s\" fill=\"%s\" fill-opacity=\"0.6\" stroke-width=\"1\"/>\n",
-            getRetanguloX(r),
-            getRetanguloY(r),
-            getRetanguloLargura(r),
-            getRetanguloAltura(r),
-            getRetanguloCorBorda(r),
-            getRetanguloCorPreenchimento(r));
+    if (ctx == NULL || ctx->buffer == NULL || r == NULL) return;
+    
+    buffer_texto(ctx, "  <rect x=\"");
+    buffer_numero2(ctx, getRetanguloX(r));
+    buffer_texto(ctx, "\" y=\"");
+    buffer_numero2(ctx, getRetanguloY(r));
+    buffer_texto(ctx, "\" width=\"");
+    buffer_numero2(ctx, getRetanguloLargura(r));
+    buffer_texto(ctx, "\" height=\"");
+    buffer_numero2(ctx, getRetanguloAltura(r));
+    buffer_texto(ctx, "\" stroke=\"");
+    buffer_texto(ctx, getRetanguloCorBorda(r));
+    buffer_texto(ctx, "\" fill=\"");
+    buffer_texto(ctx, getRetanguloCorPreenchimento(r));
+    buffer_texto(ctx, "\" fill-opacity=\"0.6\" stroke-width=\"1\"/>\n");
 }
 
 void svg_desenhar_linha(SvgContexto svg, Linha l)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
-    if (ctx == NULL || ctx->arquivo == NULL || l == NULL) return;
+    if (ctx == NULL || ctx->buffer == NULL || l == NULL) return;
     
-    fprintf(ctx->arquivo,
-            "  <line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" "
-            "stroke=\"%s\" stroke-width=\"1\"/>\n",
-            getLinhaX1(l),
-            getLinhaY1(l),
-            getLinhaX2(l),
-            getLinhaY2(l),
-            getLinhaCor(l));
+    escrever_linha(ctx, getLinhaX1(l), getLinhaY1(l), getLinhaX2(l), getLinhaY2(l));
+    buffer_texto(ctx, " stroke=\"");
+    buffer_texto(ctx, getLinhaCor(l));
+    buffer_texto(ctx, "\" stroke-width=\"1\"/>\n");
 }
 
 void svg_desenhar_texto(SvgContexto svg, Texto t)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
-    if (ctx == NULL || ctx->arquivo == NULL || t == NULL) return;
+    if (ctx == NULL || ctx->buffer == NULL || t == NULL) return;
     
     const char *ancora_svg = converter_ancora(getTextoAncora(t));
     const char *weight_svg = converter_font_weight(getTextoFontWeight(t));
@@ -205,21 +551,25 @@ void svg_desenhar_texto(SvgContexto svg, Texto t)
     const char *family = getTextoFontFamily(t);
     if (strcmp(family, "sans") == 0) family = "sans-serif";
     
-    fprintf(ctx->arquivo,
-            "  <text x=\"%.2f\" y=\"%.2f\" "
-            "font-family=\"%s\" font-weight=\"%s\" font-size=\"%.2fpt\" "
-            "text-anchor=\"%s\" "
-            "stroke=\"%s\" fill=\"%s\">"
-            "<![CDATA[ %s ]]></text>\n",
-            getTextoX(t),
-            getTextoY(t),
-            family,
-            weight_svg,
-            getTextoFontSize(t),
-            ancora_svg,
-            getTextoCorBorda(t),
-            getTextoCorPreenchimento(t),
-            getTextoConteudo(t));
+    buffer_texto(ctx, "  <text x=\"");
+    buffer_numero2(ctx, getTextoX(t));
+    buffer_texto(ctx, "\" y=\"");
+    buffer_numero2(ctx, getTextoY(t));
+    buffer_texto(ctx, "\" font-family=\"");
+    buffer_texto(ctx, family);
+    buffer_texto(ctx, "\" font-weight=\"");
+    buffer_texto(ctx, weight_svg);
+    buffer_texto(ctx, "\" font-size=\"");
+    buffer_numero2(ctx, getTextoFontSize(t));
+    buffer_texto(ctx, "pt\" text-anchor=\"");
+    buffer_texto(ctx, ancora_svg);
+    buffer_texto(ctx, "\" stroke=\"");
+    buffer_texto(ctx, getTextoCorBorda(t));
+    buffer_texto(ctx, "\" fill=\"");
+    buffer_texto(ctx, getTextoCorPreenchimento(t));
+    buffer_texto(ctx, "\"><![CDATA[ ");
+    buffer_texto(ctx, getTextoConteudo(t));
+    buffer_texto(ctx, " ]]></text>\n");
 }
 
 void svg_desenhar_forma(SvgContexto svg, Forma forma)
@@ -257,7 +607,7 @@ void svg_desenhar_lista(SvgContexto svg, Lista lista)
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
     if (ctx == NULL || lista == NULL) return;
     
-    fprintf(ctx->arquivo, "  <!-- Formas do cenário -->\n");
+    buffer_texto(ctx, "  <!-- Formas do cenário -->\n");
     
     No atual = obter_primeiro(lista);
     while (atual != NULL)
@@ -267,7 +617,7 @@ void svg_desenhar_lista(SvgContexto svg, Lista lista)
         atual = obter_proximo(atual);
     }
     
-    fprintf(ctx->arquivo, "\n");
+    buffer_caractere(ctx, '\n');
 }
 
 void svg_desenhar_poligono(SvgContexto svg, double *pontos, int num_pontos,
@@ -275,104 +625,94 @@ void svg_desenhar_poligono(SvgContexto svg, double *pontos, int num_pontos,
                            double opacidade)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
-    if (ctx == NULL || ctx->arquivo == NULL || pontos == NULL || num_pontos < 3)
+    if (ctx == NULL || ctx->buffer == NULL || pontos == NULL || num_pontos < 3)
         return;
     
-    fprintf(ctx->arquivo, "  <polygon points=\"");
-    
-    for (int i = 0; i < num_pontos; i++)
-    {
-        fprintf(ctx->arquivo, "%.2f,%.2f", pontos[i * 2], pontos[i * 2 + 1]);
-        if (i < num_pontos - 1)
-        {
-            fprintf(ctx->arquivo, " ");
-        }
-    }
-    
-    fprintf(ctx->arquivo, "\" stroke=\"%s\" fill=\"%s\" fill-opacity=\"%.2f\" "
-            "stroke-width=\"1\"/>\n",
-            cor_borda ? cor_borda : "black",
-            cor_preenchimento ? cor_preenchimento : "none",
-            opacidade);
+    buffer_texto(ctx, "  <polygon points=\"");
+    escrever_pontos(ctx, pontos, num_pontos);
+    escrever_fim_poligono(ctx, cor_borda ? cor_borda : "black",
+                          cor_preenchimento ? cor_preenchimento : "none",
+                          opacidade, "1");
 }
 
 void svg_comentario(SvgContexto svg, const char *texto)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
-    if (ctx == NULL || ctx->arquivo == NULL || texto == NULL) return;
+    if (ctx == NULL || ctx->buffer == NULL || texto == NULL) return;
     
-    fprintf(ctx->arquivo, "  <!-- %s -->\n", texto);
+    buffer_texto(ctx, "  <!-- ");
+    buffer_texto(ctx, texto);
+    buffer_texto(ctx, " -->\n");
 }
 
 /* ============================================================================
  * Funções para Visibilidade
  * ============================================================================ */
 
-void svg_desenhar_segmento(SvgContexto svg, void *seg, 
+void svg_desenhar_segmento(SvgContexto svg, double x1, double y1,
+                           double x2, double y2,
                            const char *cor, double largura)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
-    if (ctx == NULL || ctx->arquivo == NULL || seg == NULL) return;
-    
-    Segmento s = (Segmento)seg;
-    const char *cor_seg = cor ? cor : get_segmento_cor(s);
-    
-    fprintf(ctx->arquivo,
-            "  <line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" "
-            "stroke=\"%s\" stroke-width=\"%.1f\"/>\n",
-            get_segmento_x1(s),
-            get_segmento_y1(s),
-            get_segmento_x2(s),
-            get_segmento_y2(s),
-            cor_seg,
-            largura);
+    if (ctx == NULL || ctx->buffer == NULL) return;
+    
+    escrever_linha(ctx, x1, y1, x2, y2);
+    buffer_texto(ctx, " stroke=\"");
+    buffer_texto(ctx, cor ? cor : "black");
+    buffer_texto(ctx, "\" stroke-width=\"");
+    buffer_numero(ctx, largura, 1);
+    buffer_texto(ctx, "\"/>\n");
 }
 
-void svg_desenhar_lista_segmentos(SvgContexto svg, Lista lista)
+void svg_desenhar_segmentos(SvgContexto svg, VetorSegmentos segmentos)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
-    if (ctx == NULL || lista == NULL) return;
+    if (ctx == NULL || segmentos == NULL) return;
     
-    fprintf(ctx->arquivo, "  <!-- Anteparos (segmentos bloqueantes) -->\n");
+    buffer_texto(ctx, "  <!-- Anteparos (segmentos bloqueantes) -->\n");
     
-    No atual = obter_primeiro(lista);
-    while (atual != NULL)
+    int n = vetor_segmentos_tamanho(segmentos);
+    for (int i = 0; i < n; i++)
     {
-        Segmento seg = (Segmento)obter_elemento(atual);
-        /* Usa NULL para forçar o uso da cor interna do segmento */
-        svg_desenhar_segmento(svg, seg, NULL, 2.0);
-        atual = obter_proximo(atual);
+        svg_desenhar_segmento(svg,
+                              vetor_segmentos_x1(segmentos, i),
+                              vetor_segmentos_y1(segmentos, i),
+                              vetor_segmentos_x2(segmentos, i),
+                              vetor_segmentos_y2(segmentos, i),
+                              vetor_segmentos_cor(segmentos, i),
+                              2.0);
     }
     
-    fprintf(ctx->arquivo, "\n");
+    buffer_caractere(ctx, '\n');
 }
 
 void svg_desenhar_bomba(SvgContexto svg, double x, double y, 
                         double raio, const char *cor)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
-    if (ctx == NULL || ctx->arquivo == NULL) return;
+    if (ctx == NULL || ctx->buffer == NULL) return;
     
     const char *cor_bomba = cor ? cor : "#FF0000";
     
-    fprintf(ctx->arquivo, "  <!-- Bomba (ponto de origem) -->\n");
+    buffer_texto(ctx, "  <!-- Bomba (ponto de origem) -->\n");
     
     /* Círculo principal */
-    fprintf(ctx->arquivo,
-            "  <circle cx=\"%.2f\" cy=\"%.2f\" r=\"%.2f\" "
-            "fill=\"%s\" fill-opacity=\"0.7\" stroke=\"black\" stroke-width=\"1\"/>\n",
-            x, y, raio, cor_bomba);
+    buffer_texto(ctx, "  <circle cx=\"");
+    buffer_numero2(ctx, x);
+    buffer_texto(ctx, "\" cy=\"");
+    buffer_numero2(ctx, y);
+    buffer_texto(ctx, "\" r=\"");
+    buffer_numero2(ctx, raio);
+    buffer_texto(ctx, "\" fill=\"");
+    buffer_texto(ctx, cor_bomba);
+    buffer_texto(ctx, "\" fill-opacity=\"0.7\" stroke=\"black\" stroke-width=\"1\"/>\n");
     
     /* X no centro */
     double offset = raio * 0.6;
-    fprintf(ctx->arquivo,
-            "  <line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" "
-            "stroke=\"white\" stroke-width=\"2\"/>\n",
-            x - offset, y - offset, x + offset, y + offset);
-    fprintf(ctx->arquivo,
-            "  <line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" "
-            "stroke=\"white\" stroke-width=\"2\"/>\n",
-            x - offset, y + offset, x + offset, y - offset);
+    escrever_linha(ctx, x - offset, y - offset, x + offset, y + offset);
+    buffer_texto(ctx, " stroke=\"white\" stroke-width=\"2\"/>\n");
+    escrever_linha(ctx, x - offset, y + offset, x + offset, y - offset);
+    buffer_texto(ctx, " stroke=\"white\" stroke-width=\"2\"/>\n");
 }
 
 void svg_desenhar_poligono_visibilidade(SvgContexto svg, void *poligono,
@@ -381,37 +721,230 @@ void svg_desenhar_poligono_visibilidade(SvgContexto svg, void *poligono,
                                          double opacidade)
 {
     SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
-    if (ctx == NULL || ctx->arquivo == NULL || poligono == NULL) return;
+    if (ctx == NULL || ctx->buffer == NULL || poligono == NULL) return;
     
-    PoligonoVisibilidade poli = (PoligonoVisibilidade)poligono;
-    int num_vertices = poligono_num_vertices(poli);
+    /* Lê os vértices no próprio polígono, sem criar um Ponto por vértice */
+    int num_vertices = 0;
+    double *vertices = poligono_get_vertices_ref((Poligono)poligono, &num_vertices);
     
-    if (num_vertices < 3)
+    if (vertices == NULL || num_vertices < 3)
     {
-        fprintf(ctx->arquivo, "  <!-- Polígono de visibilidade vazio ou inválido -->\n");
+        buffer_texto(ctx, "  <!-- Polígono de visibilidade vazio ou inválido -->\n");
         return;
     }
     
-    fprintf(ctx->arquivo, "  <!-- Região de Visibilidade -->\n");
-    fprintf(ctx->arquivo, "  <polygon points=\"");
-    
-    for (int i = 0; i < num_vertices; i++)
+    buffer_texto(ctx, "  <!-- Região de Visibilidade -->\n");
+    buffer_texto(ctx, "  <polygon points=\"");
+    escrever_pontos(ctx, vertices, num_vertices);
+    escrever_fim_poligono(ctx, cor_borda ? cor_borda : "black",
+                          cor_preenchimento ? cor_preenchimento : "yellow",
+                          opacidade, "2");
+}
+
+/* ============================================================================
+ * Cache de Fragmentos da Cena
+ * ============================================================================ */
+
+static unsigned hash_forma(Forma forma)
+{
+    uintptr_t p = (uintptr_t)forma;
+    return (unsigned)((p >> 4) * 2654435761u);
+}
+
+/**
+ * Procura a posição da forma na tabela (ou a posição livre onde entraria).
+ */
+static Fragmento* cache_posicao(SvgCacheInternal *c, Forma forma)
+{
+    unsigned mascara = (unsigned)(c->capacidade - 1);
+    unsigned pos = hash_forma(forma) & mascara;
+
+    while (c->tabela[pos].forma != NULL && c->tabela[pos].forma != forma)
     {
-        Ponto v = poligono_obter_vertice(poli, i);
-        if (v != NULL)
+        pos = (pos + 1) & mascara;
+    }
+    return &c->tabela[pos];
+}
+
+static int cache_redimensionar(SvgCacheInternal *c, int nova_capacidade)
+{
+    Fragmento *nova = (Fragmento*)calloc(nova_capacidade, sizeof(Fragmento));
+    if (nova == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao expandir cache SVG\n");
+        return 0;
+    }
+
+    Fragmento *antiga = c->tabela;
+    int capacidade_antiga = c->capacidade;
+    c->tabela = nova;
+    c->capacidade = nova_capacidade;
+
+    for (int i = 0; i < capacidade_antiga; i++)
+    {
+        if (antiga[i].forma != NULL)
         {
-            fprintf(ctx->arquivo, "%.2f,%.2f", get_ponto_x(v), get_ponto_y(v));
-            if (i < num_vertices - 1)
+            *cache_posicao(c, antiga[i].forma) = antiga[i];
+        }
+    }
+
+    free(antiga);
+    return 1;
+}
+
+/**
+ * Obtém o fragmento da forma, serializando-o se necessário.
+ * @return Fragmento com dados, ou NULL em caso de erro
+ */
+static Fragmento* cache_fragmento(SvgCacheInternal *c, Forma forma)
+{
+    /* Mantém fator de carga <= 1/2 */
+    if (2 * (c->ocupadas + 1) > c->capacidade &&
+        !cache_redimensionar(c, c->capacidade * 2))
+    {
+        return NULL;
+    }
+
+    Fragmento *f = cache_posicao(c, forma);
+    if (f->forma == NULL)
+    {
+        f->forma = forma;
+        f->dados = NULL;
+        c->ocupadas++;
+    }
+
+    if (f->dados == NULL)
+    {
+        c->rascunho.usado = 0;
+        svg_desenhar_forma(&c->rascunho, forma);
+
+        f->dados = (char*)malloc(c->rascunho.usado + 1);
+        if (f->dados == NULL) return NULL;
+        memcpy(f->dados, c->rascunho.buffer, c->rascunho.usado);
+        f->tamanho = c->rascunho.usado;
+    }
+
+    return f;
+}
+
+SvgCache svg_cache_criar(void)
+{
+    SvgCacheInternal *c = (SvgCacheInternal*)calloc(1, sizeof(SvgCacheInternal));
+    if (c == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar cache SVG\n");
+        return NULL;
+    }
+
+    c->capacidade = CAPACIDADE_TABELA_CACHE;
+    c->tabela = (Fragmento*)calloc(c->capacidade, sizeof(Fragmento));
+    c->rascunho.buffer = (char*)malloc(TAMANHO_BUFFER_MEMORIA);
+    c->rascunho.capacidade = TAMANHO_BUFFER_MEMORIA;
+    if (c->tabela == NULL || c->rascunho.buffer == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar cache SVG\n");
+        free(c->tabela);
+        free(c->rascunho.buffer);
+        free(c);
+        return NULL;
+    }
+
+    return (SvgCache)c;
+}
+
+void svg_cache_destruir(SvgCache cache)
+{
+    SvgCacheInternal *c = (SvgCacheInternal*)cache;
+    if (c == NULL) return;
+
+    for (int i = 0; i < c->capacidade; i++)
+    {
+        free(c->tabela[i].dados);
+    }
+    free(c->tabela);
+    free(c->segmentos);
+    free(c->rascunho.buffer);
+    free(c);
+}
+
+void svg_cache_invalidar(SvgCache cache, Forma forma)
+{
+    SvgCacheInternal *c = (SvgCacheInternal*)cache;
+    if (c == NULL || forma == NULL) return;
+
+    Fragmento *f = cache_posicao(c, forma);
+    if (f->forma == forma && f->dados != NULL)
+    {
+        free(f->dados);
+        f->dados = NULL;
+    }
+}
+
+void svg_desenhar_lista_cache(SvgContexto svg, Lista lista, SvgCache cache)
+{
+    SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
+    SvgCacheInternal *c = (SvgCacheInternal*)cache;
+    if (c == NULL)
+    {
+        svg_desenhar_lista(svg, lista);
+        return;
+    }
+    if (ctx == NULL || lista == NULL) return;
+
+    buffer_texto(ctx, "  <!-- Formas do cenário -->\n");
+
+    No atual = obter_primeiro(lista);
+    while (atual != NULL)
+    {
+        Forma forma = (Forma)obter_elemento(atual);
+        if (forma != NULL && getFormaAtiva(forma))
+        {
+            Fragmento *f = cache_fragmento(c, forma);
+            if (f != NULL)
             {
-                fprintf(ctx->arquivo, " ");
+                buffer_escrever(ctx, f->dados, f->tamanho);
+            }
+            else
+            {
+                svg_desenhar_forma(svg, forma);
             }
-            destruir_ponto(v);  /* Libera o ponto criado por poligono_obter_vertice */
         }
+        atual = obter_proximo(atual);
     }
-    
-    fprintf(ctx->arquivo, "\" stroke=\"%s\" fill=\"%s\" fill-opacity=\"%.2f\" "
-            "stroke-width=\"2\"/>\n",
-            cor_borda ? cor_borda : "black",
-            cor_preenchimento ? cor_preenchimento : "yellow",
-            opacidade);
+
+    buffer_caractere(ctx, '\n');
+}
+
+void svg_desenhar_segmentos_cache(SvgContexto svg, VetorSegmentos segmentos, SvgCache cache)
+{
+    SvgContextoInternal *ctx = (SvgContextoInternal*)svg;
+    SvgCacheInternal *c = (SvgCacheInternal*)cache;
+    if (c == NULL)
+    {
+        svg_desenhar_segmentos(svg, segmentos);
+        return;
+    }
+    if (ctx == NULL || segmentos == NULL) return;
+
+    /* O bloco só é refeito quando o vetor muda */
+    if (c->segmentos == NULL || c->vetor_segmentos != segmentos ||
+        c->versao_segmentos != vetor_segmentos_versao(segmentos))
+    {
+        c->rascunho.usado = 0;
+        svg_desenhar_segmentos(&c->rascunho, segmentos);
+
+        free(c->segmentos);
+        c->segmentos = (char*)malloc(c->rascunho.usado + 1);
+        if (c->segmentos == NULL)
+        {
+            svg_desenhar_segmentos(svg, segmentos);
+            return;
+        }
+        memcpy(c->segmentos, c->rascunho.buffer, c->rascunho.usado);
+        c->tamanho_segmentos = c->rascunho.usado;
+        c->vetor_segmentos = segmentos;
+        c->versao_segmentos = vetor_segmentos_versao(segmentos);
+    }
+
+    buffer_escrever(ctx, c->segmentos, c->tamanho_segmentos);
 }
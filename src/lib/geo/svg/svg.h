@@ -14,6 +14,7 @@
 #include "linha.h"
 #include "texto.h"
 #include "formas.h"
+#include "vetor_segmentos.h"
 
 /* ============================================================================
  * Tipo Opaco
@@ -25,6 +26,14 @@
  */
 typedef void* SvgContexto;
 
+/**
+ * Tipo opaco para o cache de fragmentos da cena.
+ * Guarda o SVG já serializado de cada forma (pelo endereço da forma) e
+ * do bloco de anteparos, para reaproveitar entre os SVGs dos comandos.
+ * As formas não podem ser liberadas enquanto o cache estiver em uso.
+ */
+typedef void* SvgCache;
+
 /* ============================================================================
  * Funções de Criação e Destruição
  * ============================================================================ */
@@ -56,6 +65,26 @@ SvgContexto criar_svg_viewbox(const char *caminho_arquivo,
                                double min_x, double min_y,
                                double largura, double altura);
 
+/**
+ * Cria um fragmento: contexto sem cabeçalho, gravado em arquivo
+ * temporário, para acumular elementos em disco até que o SVG de destino
+ * possa ser criado. Aceita as mesmas funções de desenho.
+ * 
+ * @return Fragmento, ou NULL se não foi possível criar o temporário
+ * @post Liberar com finalizar_svg (o temporário é removido)
+ */
+SvgContexto criar_svg_fragmento(void);
+
+/**
+ * Copia tudo o que foi desenhado no fragmento para o SVG de destino,
+ * em blocos. O fragmento continua válido.
+ * 
+ * @param destino Contexto SVG que recebe os elementos
+ * @param fragmento Fragmento criado por criar_svg_fragmento
+ * @return 1 em caso de sucesso, 0 em caso de erro
+ */
+int svg_anexar_fragmento(SvgContexto destino, SvgContexto fragmento);
+
 /**
  * Finaliza o SVG e fecha o arquivo.
  * 
@@ -131,19 +160,24 @@ void svg_comentario(SvgContexto ctx, const char *texto);
 /**
  * Desenha um segmento (anteparo) no SVG.
  * @param ctx Contexto SVG
- * @param seg Segmento a desenhar
- * @param cor Cor do segmento
+ * @param x1 Coordenada X do ponto inicial
+ * @param y1 Coordenada Y do ponto inicial
+ * @param x2 Coordenada X do ponto final
+ * @param y2 Coordenada Y do ponto final
+ * @param cor Cor do segmento (NULL = "black")
  * @param largura Largura da linha
  */
-void svg_desenhar_segmento(SvgContexto ctx, void *seg, 
+void svg_desenhar_segmento(SvgContexto ctx, double x1, double y1,
+                           double x2, double y2,
                            const char *cor, double largura);
 
 /**
- * Desenha uma lista de segmentos (anteparos) no SVG.
+ * Desenha todos os segmentos (anteparos) de um vetor no SVG,
+ * cada um com a sua cor.
  * @param ctx Contexto SVG
- * @param lista Lista de segmentos
+ * @param segmentos Vetor de segmentos
  */
-void svg_desenhar_lista_segmentos(SvgContexto ctx, Lista lista);
+void svg_desenhar_segmentos(SvgContexto ctx, VetorSegmentos segmentos);
 
 /**
  * Desenha uma bomba (marcador de origem de visibilidade).
@@ -169,4 +203,38 @@ void svg_desenhar_poligono_visibilidade(SvgContexto ctx, void *poligono,
                                          const char *cor_preenchimento,
                                          double opacidade);
 
+/* ============================================================================
+ * Cache de Fragmentos da Cena
+ * ============================================================================ */
+
+/**
+ * Cria um cache vazio.
+ * @return Novo cache, ou NULL em caso de erro
+ */
+SvgCache svg_cache_criar(void);
+
+/**
+ * Destroi o cache (as formas não são destruídas).
+ */
+void svg_cache_destruir(SvgCache cache);
+
+/**
+ * Descarta o fragmento de uma forma alterada (pintada, destruída...).
+ * Ele é serializado de novo no próximo uso.
+ */
+void svg_cache_invalidar(SvgCache cache, Forma forma);
+
+/**
+ * Igual a svg_desenhar_lista, reaproveitando os fragmentos do cache.
+ * Com cache NULL, desenha sem cache.
+ */
+void svg_desenhar_lista_cache(SvgContexto ctx, Lista lista, SvgCache cache);
+
+/**
+ * Igual a svg_desenhar_segmentos; o bloco é refeito só quando a versão
+ * do vetor muda. Com cache NULL, desenha sem cache.
+ */
+void svg_desenhar_segmentos_cache(SvgContexto ctx, VetorSegmentos segmentos,
+                                  SvgCache cache);
+
 #endif /* SVG_H */
@@ -86,14 +86,25 @@ int intersecao_raio_segmento(Ponto origem, Ponto direcao, Segmento seg, Ponto *r
     
     double ox = get_ponto_x(origem);
     double oy = get_ponto_y(origem);
-    double dx = get_ponto_x(direcao) - ox;
-    double dy = get_ponto_y(direcao) - oy;
+    double ix, iy;
     
-    double sx1 = get_segmento_x1(seg);
-    double sy1 = get_segmento_y1(seg);
-    double sx2 = get_segmento_x2(seg);
-    double sy2 = get_segmento_y2(seg);
+    if (intersecao_raio_coords(ox, oy,
+                               get_ponto_x(direcao) - ox, get_ponto_y(direcao) - oy,
+                               get_segmento_x1(seg), get_segmento_y1(seg),
+                               get_segmento_x2(seg), get_segmento_y2(seg),
+                               &ix, &iy))
+    {
+        *resultado = criar_ponto(ix, iy);
+        return 1;
+    }
     
+    return 0;
+}
+
+int intersecao_raio_coords(double ox, double oy, double dx, double dy,
+                           double sx1, double sy1, double sx2, double sy2,
+                           double *ix, double *iy)
+{
     /* Vetor do segmento */
     double segx = sx2 - sx1;
     double segy = sy2 - sy1;
@@ -116,9 +127,8 @@ int intersecao_raio_segmento(Ponto origem, Ponto direcao, Segmento seg, Ponto *r
     /* Interseção válida: t >= 0 (na direção do raio) e 0 <= u <= 1 (dentro do segmento) */
     if (t >= -GEO_EPSILON && u >= -GEO_EPSILON && u <= 1.0 + GEO_EPSILON)
     {
-        double ix = ox + t * dx;
-        double iy = oy + t * dy;
-        *resultado = criar_ponto(ix, iy);
+        *ix = ox + t * dx;
+        *iy = oy + t * dy;
         return 1;
     }
     
@@ -422,3 +432,460 @@ int forma_no_poligono(void *forma_ptr, double *vertices, int num_vertices)
     }
 }
 
+
+/* ============================================================================
+ * Polígono Preparado
+ * ============================================================================ */
+
+/* Folga das faixas consultadas contra erros de arredondamento */
+#define FOLGA_FAIXAS 1e-6
+
+/* Número máximo de faixas horizontais */
+#define MAX_FAIXAS 4096
+
+/*
+ * As arestas do polígono são distribuídas em faixas horizontais de mesma
+ * altura (índices em formato CSR: inicio[f]..inicio[f+1]). Cada aresta
+ * aparece em todas as faixas que sua extensão em y cobre. A aresta k liga
+ * o vértice k ao vértice anterior (k - 1, ou o último para k = 0), a mesma
+ * convenção (i, j) dos laços de ponto_no_poligono e forma_no_poligono.
+ */
+typedef struct poligono_preparado_internal
+{
+    const double *vertices;     /* Referência (não é copiado) */
+    int num_vertices;
+    double min_x, min_y, max_x, max_y;
+
+    int num_faixas;
+    double altura_faixa;
+    int *inicio;                /* num_faixas + 1 deslocamentos */
+    int *arestas;               /* Índices das arestas por faixa */
+
+    /* Modo estrela (poligono_preparar_estrela) */
+    int estrela;                /* 1 se a consulta por cunha está ativa */
+    double ox, oy;              /* Origem em torno da qual o polígono é estrelado */
+    int primeiro;               /* Vértice de menor ângulo */
+    double *angulos;            /* Ângulos em [0, 2π), a partir de 'primeiro' */
+} PoligonoPreparadoInternal;
+
+static int faixa_de(const PoligonoPreparadoInternal *pp, double y)
+{
+    double f = floor((y - pp->min_y) / pp->altura_faixa);
+    if (f < 0) return 0;
+    if (f >= pp->num_faixas) return pp->num_faixas - 1;
+    return (int)f;
+}
+
+static void extremos_aresta(const PoligonoPreparadoInternal *pp, int k,
+                            double *xi, double *yi, double *xj, double *yj)
+{
+    int j = (k == 0) ? pp->num_vertices - 1 : k - 1;
+    *xi = pp->vertices[2 * k];
+    *yi = pp->vertices[2 * k + 1];
+    *xj = pp->vertices[2 * j];
+    *yj = pp->vertices[2 * j + 1];
+}
+
+PoligonoPreparado poligono_preparar(const double *vertices, int num_vertices)
+{
+    if (vertices == NULL || num_vertices < 3) return NULL;
+
+    PoligonoPreparadoInternal *pp = (PoligonoPreparadoInternal*)malloc(sizeof(PoligonoPreparadoInternal));
+    if (pp == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar polígono preparado.\n");
+        return NULL;
+    }
+
+    pp->vertices = vertices;
+    pp->num_vertices = num_vertices;
+    pp->estrela = 0;
+    pp->angulos = NULL;
+    pp->min_x = pp->max_x = vertices[0];
+    pp->min_y = pp->max_y = vertices[1];
+    for (int i = 1; i < num_vertices; i++)
+    {
+        double x = vertices[2 * i], y = vertices[2 * i + 1];
+        if (x < pp->min_x) pp->min_x = x;
+        if (x > pp->max_x) pp->max_x = x;
+        if (y < pp->min_y) pp->min_y = y;
+        if (y > pp->max_y) pp->max_y = y;
+    }
+
+    /* √V faixas equilibram o teste de ponto (arestas por faixa) e o das
+     * formas altas (faixas percorridas) */
+    pp->num_faixas = (int)sqrt((double)num_vertices);
+    if (pp->num_faixas < 1) pp->num_faixas = 1;
+    if (pp->num_faixas > MAX_FAIXAS) pp->num_faixas = MAX_FAIXAS;
+
+    double altura = pp->max_y - pp->min_y;
+    pp->altura_faixa = altura > 0 ? altura / pp->num_faixas : 1.0;
+
+    pp->inicio = (int*)calloc(pp->num_faixas + 1, sizeof(int));
+    if (pp->inicio == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar faixas do polígono.\n");
+        free(pp);
+        return NULL;
+    }
+
+    /* 1ª passada: conta as arestas de cada faixa */
+    for (int k = 0; k < num_vertices; k++)
+    {
+        double xi, yi, xj, yj;
+        extremos_aresta(pp, k, &xi, &yi, &xj, &yj);
+        int f0 = faixa_de(pp, fmin(yi, yj));
+        int f1 = faixa_de(pp, fmax(yi, yj));
+        for (int f = f0; f <= f1; f++) pp->inicio[f + 1]++;
+    }
+
+    for (int f = 0; f < pp->num_faixas; f++)
+    {
+        pp->inicio[f + 1] += pp->inicio[f];
+    }
+
+    pp->arestas = (int*)malloc((pp->inicio[pp->num_faixas] + 1) * sizeof(int));
+    int *cursor = (int*)malloc(pp->num_faixas * sizeof(int));
+    if (pp->arestas == NULL || cursor == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar faixas do polígono.\n");
+        free(cursor);
+        free(pp->arestas);
+        free(pp->inicio);
+        free(pp);
+        return NULL;
+    }
+
+    /* 2ª passada: preenche */
+    for (int f = 0; f < pp->num_faixas; f++) cursor[f] = pp->inicio[f];
+    for (int k = 0; k < num_vertices; k++)
+    {
+        double xi, yi, xj, yj;
+        extremos_aresta(pp, k, &xi, &yi, &xj, &yj);
+        int f0 = faixa_de(pp, fmin(yi, yj));
+        int f1 = faixa_de(pp, fmax(yi, yj));
+        for (int f = f0; f <= f1; f++) pp->arestas[cursor[f]++] = k;
+    }
+
+    free(cursor);
+    return (PoligonoPreparado)pp;
+}
+
+void poligono_preparado_destruir(PoligonoPreparado preparado)
+{
+    PoligonoPreparadoInternal *pp = (PoligonoPreparadoInternal*)preparado;
+    if (pp == NULL) return;
+
+    free(pp->angulos);
+    free(pp->arestas);
+    free(pp->inicio);
+    free(pp);
+}
+
+/* Tolerâncias da consulta por cunha: perto delas, decide o teste par/ímpar */
+#define ESTRELA_TOL_ANGULO 1e-10
+#define ESTRELA_TOL_DISTANCIA 1e-7
+
+static double angulo_em_torno(double ox, double oy, double x, double y)
+{
+    double a = atan2(y - oy, x - ox);
+    return (a < 0) ? a + 2.0 * M_PI : a;
+}
+
+PoligonoPreparado poligono_preparar_estrela(const double *vertices, int num_vertices,
+                                            double ox, double oy)
+{
+    PoligonoPreparadoInternal *pp = (PoligonoPreparadoInternal*)poligono_preparar(vertices, num_vertices);
+    if (pp == NULL) return NULL;
+
+    double *angulos = (double*)malloc(num_vertices * sizeof(double));
+    if (angulos == NULL) return (PoligonoPreparado)pp; /* Fica só com as faixas */
+
+    int primeiro = 0;
+    for (int i = 0; i < num_vertices; i++)
+    {
+        double dx = vertices[2 * i] - ox, dy = vertices[2 * i + 1] - oy;
+        if (dx * dx + dy * dy < ESTRELA_TOL_DISTANCIA * ESTRELA_TOL_DISTANCIA)
+        {
+            /* Origem sobre a fronteira: as cunhas não cobrem o plano */
+            free(angulos);
+            return (PoligonoPreparado)pp;
+        }
+        angulos[i] = angulo_em_torno(ox, oy, vertices[2 * i], vertices[2 * i + 1]);
+        if (angulos[i] < angulos[primeiro]) primeiro = i;
+    }
+
+    /* Reordena a partir do menor ângulo e confere a ordem crescente e que
+     * nenhuma cunha (inclusive a que fecha a volta) passa de meia volta.
+     * Um vértice final de volta ao ângulo inicial (polígono fechado com
+     * repetição do primeiro) conta como ângulo inicial + 2π. */
+    double *ordenados = (double*)malloc(num_vertices * sizeof(double));
+    if (ordenados == NULL)
+    {
+        free(angulos);
+        return (PoligonoPreparado)pp;
+    }
+
+    int valido = 1;
+    for (int k = 0; k < num_vertices && valido; k++)
+    {
+        double a = angulos[(primeiro + k) % num_vertices];
+        if (k > 0)
+        {
+            if (a < ordenados[k - 1] - ESTRELA_TOL_ANGULO &&
+                a + 2.0 * M_PI <= ordenados[0] + 2.0 * M_PI + ESTRELA_TOL_ANGULO)
+            {
+                a += 2.0 * M_PI;
+            }
+            if (a < ordenados[k - 1] - ESTRELA_TOL_ANGULO) valido = 0;
+            if (a - ordenados[k - 1] >= M_PI) valido = 0;
+            if (a < ordenados[k - 1]) a = ordenados[k - 1];
+        }
+        ordenados[k] = a;
+    }
+    if (valido && ordenados[num_vertices - 1] > ordenados[0] + 2.0 * M_PI + ESTRELA_TOL_ANGULO) valido = 0;
+    if (valido && ordenados[0] + 2.0 * M_PI - ordenados[num_vertices - 1] >= M_PI) valido = 0;
+
+    free(angulos);
+    if (!valido)
+    {
+        free(ordenados);
+        return (PoligonoPreparado)pp;
+    }
+
+    pp->estrela = 1;
+    pp->ox = ox;
+    pp->oy = oy;
+    pp->primeiro = primeiro;
+    pp->angulos = ordenados;
+    return (PoligonoPreparado)pp;
+}
+
+/**
+ * Consulta por cunha: busca binária do ângulo do ponto e um único teste
+ * de lado contra a aresta da cunha.
+ * @return 1 dentro, 0 fora, -1 se o ponto está perto demais de um raio
+ *         de vértice ou da aresta para decidir com segurança
+ */
+static int estrela_contem(const PoligonoPreparadoInternal *pp, double px, double py)
+{
+    double dx = px - pp->ox, dy = py - pp->oy;
+    if (dx * dx + dy * dy < ESTRELA_TOL_DISTANCIA * ESTRELA_TOL_DISTANCIA) return -1;
+
+    int n = pp->num_vertices;
+    const double *ang = pp->angulos;
+    double a = angulo_em_torno(pp->ox, pp->oy, px, py);
+
+    /* Cunha k: de ang[k] a ang[k + 1]; a última fecha a volta */
+    int k;
+    double inicio_cunha, fim_cunha;
+    if (a < ang[0]) a += 2.0 * M_PI;
+    if (a >= ang[n - 1])
+    {
+        k = n - 1;
+        inicio_cunha = ang[n - 1];
+        fim_cunha = ang[0] + 2.0 * M_PI;
+    }
+    else
+    {
+        int lo = 0, hi = n - 1;     /* ang[lo] <= a < ang[hi] */
+        while (hi - lo > 1)
+        {
+            int meio = (lo + hi) / 2;
+            if (ang[meio] <= a) lo = meio;
+            else hi = meio;
+        }
+        k = lo;
+        inicio_cunha = ang[lo];
+        fim_cunha = ang[hi];
+    }
+
+    if (a - inicio_cunha < ESTRELA_TOL_ANGULO || fim_cunha - a < ESTRELA_TOL_ANGULO) return -1;
+
+    int i = (pp->primeiro + k) % n;
+    int j = (i + 1) % n;
+    double x1 = pp->vertices[2 * i], y1 = pp->vertices[2 * i + 1];
+    double x2 = pp->vertices[2 * j], y2 = pp->vertices[2 * j + 1];
+
+    double comprimento = sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
+    if (comprimento < ESTRELA_TOL_DISTANCIA) return -1;
+
+    /* Vértices em sentido anti-horário: dentro fica à esquerda da aresta */
+    double cross = (x2 - x1) * (py - y1) - (y2 - y1) * (px - x1);
+    if (fabs(cross) < ESTRELA_TOL_DISTANCIA * comprimento) return -1;
+
+    return cross > 0;
+}
+
+int ponto_no_poligono_preparado(PoligonoPreparado preparado, double px, double py)
+{
+    PoligonoPreparadoInternal *pp = (PoligonoPreparadoInternal*)preparado;
+    if (pp == NULL) return 0;
+
+    /* Fora do intervalo [min_y, max_y) nenhuma aresta troca de lado */
+    if (py < pp->min_y || py >= pp->max_y) return 0;
+
+    if (pp->estrela)
+    {
+        int r = estrela_contem(pp, px, py);
+        if (r >= 0) return r;
+    }
+
+    /* Mesmo teste par/ímpar de ponto_no_poligono, só com as arestas da faixa */
+    int dentro = 0;
+    int f = faixa_de(pp, py);
+    for (int a = pp->inicio[f]; a < pp->inicio[f + 1]; a++)
+    {
+        double xi, yi, xj, yj;
+        extremos_aresta(pp, pp->arestas[a], &xi, &yi, &xj, &yj);
+
+        if (((yi > py) != (yj > py)) &&
+            (px < (xj - xi) * (py - yi) / (yj - yi) + xi))
+        {
+            dentro = !dentro;
+        }
+    }
+
+    return dentro;
+}
+
+/* Teste aplicado a uma aresta candidata (xi, yi)-(xj, yj) */
+typedef int (*TesteAresta)(double xi, double yi, double xj, double yj, const double *dados);
+
+/**
+ * Aplica o teste às arestas cuja faixa cruza [y_min, y_max], cada uma
+ * uma única vez (a aresta é testada só na primeira faixa em comum).
+ * @return 1 se alguma aresta satisfez o teste
+ */
+static int alguma_aresta(const PoligonoPreparadoInternal *pp, double y_min, double y_max,
+                         TesteAresta teste, const double *dados)
+{
+    y_min -= FOLGA_FAIXAS;
+    y_max += FOLGA_FAIXAS;
+    if (y_max < pp->min_y || y_min > pp->max_y) return 0;
+
+    int f0 = faixa_de(pp, y_min);
+    int f1 = faixa_de(pp, y_max);
+    for (int f = f0; f <= f1; f++)
+    {
+        for (int a = pp->inicio[f]; a < pp->inicio[f + 1]; a++)
+        {
+            double xi, yi, xj, yj;
+            extremos_aresta(pp, pp->arestas[a], &xi, &yi, &xj, &yj);
+
+            int primeira = faixa_de(pp, fmin(yi, yj));
+            if (primeira < f0) primeira = f0;
+            if (primeira != f) continue;
+
+            if (teste(xi, yi, xj, yj, dados)) return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* dados = {cx, cy, r²}: vértice dentro do círculo ou aresta a até r do centro */
+static int aresta_toca_circulo(double xi, double yi, double xj, double yj, const double *c)
+{
+    double d2 = (xi - c[0]) * (xi - c[0]) + (yi - c[1]) * (yi - c[1]);
+    if (d2 <= c[2]) return 1;
+    d2 = (xj - c[0]) * (xj - c[0]) + (yj - c[1]) * (yj - c[1]);
+    if (d2 <= c[2]) return 1;
+    return dist_sq_ponto_segmento(c[0], c[1], xi, yi, xj, yj) <= c[2];
+}
+
+/* dados = {rx, ry, w, h}: vértice dentro do retângulo ou aresta cruza um lado */
+static int aresta_toca_retangulo(double xi, double yi, double xj, double yj, const double *r)
+{
+    double rx = r[0], ry = r[1], w = r[2], h = r[3];
+    if (xi >= rx && xi <= rx + w && yi >= ry && yi <= ry + h) return 1;
+    if (xj >= rx && xj <= rx + w && yj >= ry && yj <= ry + h) return 1;
+
+    double rect_x[4] = {rx, rx + w, rx + w, rx};
+    double rect_y[4] = {ry, ry, ry + h, ry + h};
+    for (int k = 0; k < 4; k++)
+    {
+        int next_k = (k + 1) % 4;
+        if (seg_intersepta(xi, yi, xj, yj,
+                           rect_x[k], rect_y[k],
+                           rect_x[next_k], rect_y[next_k])) return 1;
+    }
+    return 0;
+}
+
+/* dados = {x1, y1, x2, y2}: aresta cruza o segmento */
+static int aresta_cruza_segmento(double xi, double yi, double xj, double yj, const double *s)
+{
+    return seg_intersepta(xi, yi, xj, yj, s[0], s[1], s[2], s[3]);
+}
+
+int forma_no_poligono_preparado(void *forma_ptr, PoligonoPreparado preparado)
+{
+    PoligonoPreparadoInternal *pp = (PoligonoPreparadoInternal*)preparado;
+    if (forma_ptr == NULL || pp == NULL) return 0;
+
+    Forma forma = (Forma)forma_ptr;
+    void *dados = getFormaDados(forma);
+
+    switch (getFormaTipo(forma))
+    {
+        case TIPO_CIRCULO:
+        {
+            Circulo c = (Circulo)dados;
+            double cx = getCirculoX(c);
+            double cy = getCirculoY(c);
+            double r = getCirculoRaio(c);
+
+            if (cx + r < pp->min_x - FOLGA_FAIXAS || cx - r > pp->max_x + FOLGA_FAIXAS) return 0;
+            if (ponto_no_poligono_preparado(preparado, cx, cy)) return 1;
+
+            double circulo[3] = {cx, cy, r * r};
+            return alguma_aresta(pp, cy - r, cy + r, aresta_toca_circulo, circulo);
+        }
+
+        case TIPO_RETANGULO:
+        {
+            Retangulo r = (Retangulo)dados;
+            double rx = getRetanguloX(r);
+            double ry = getRetanguloY(r);
+            double w = getRetanguloLargura(r);
+            double h = getRetanguloAltura(r);
+
+            if (rx + w < pp->min_x - FOLGA_FAIXAS || rx > pp->max_x + FOLGA_FAIXAS) return 0;
+
+            double rect_x[4] = {rx, rx + w, rx + w, rx};
+            double rect_y[4] = {ry, ry, ry + h, ry + h};
+            for (int k = 0; k < 4; k++)
+            {
+                if (ponto_no_poligono_preparado(preparado, rect_x[k], rect_y[k])) return 1;
+            }
+
+            double retangulo[4] = {rx, ry, w, h};
+            return alguma_aresta(pp, ry, ry + h, aresta_toca_retangulo, retangulo);
+        }
+
+        case TIPO_LINHA:
+        {
+            Linha l = (Linha)dados;
+            double segmento[4] = {getLinhaX1(l), getLinhaY1(l), getLinhaX2(l), getLinhaY2(l)};
+
+            if (fmax(segmento[0], segmento[2]) < pp->min_x - FOLGA_FAIXAS ||
+                fmin(segmento[0], segmento[2]) > pp->max_x + FOLGA_FAIXAS) return 0;
+
+            if (ponto_no_poligono_preparado(preparado, segmento[0], segmento[1])) return 1;
+            if (ponto_no_poligono_preparado(preparado, segmento[2], segmento[3])) return 1;
+
+            return alguma_aresta(pp, fmin(segmento[1], segmento[3]), fmax(segmento[1], segmento[3]),
+                                 aresta_cruza_segmento, segmento);
+        }
+
+        case TIPO_TEXTO:
+        {
+            Texto t = (Texto)dados;
+            return ponto_no_poligono_preparado(preparado, getTextoX(t), getTextoY(t));
+        }
+
+        default:
+            return 0;
+    }
+}
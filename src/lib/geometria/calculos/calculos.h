@@ -69,6 +69,18 @@ double produto_vetorial(Ponto p1, Ponto p2, Ponto p3);
  */
 int intersecao_raio_segmento(Ponto origem, Ponto direcao, Segmento seg, Ponto *resultado);
 
+/**
+ * Versão de intersecao_raio_segmento sobre coordenadas (sem alocação).
+ * O raio parte de (ox, oy) na direção (dx, dy).
+ * 
+ * @param ix Saída: X da interseção
+ * @param iy Saída: Y da interseção
+ * @return 1 se há interseção, 0 caso contrário
+ */
+int intersecao_raio_coords(double ox, double oy, double dx, double dy,
+                           double sx1, double sy1, double sx2, double sy2,
+                           double *ix, double *iy);
+
 /**
  * Verifica se um ponto está "à frente" de um segmento do ponto de vista da origem.
  * Usado para determinar se um segmento bloqueia a visão.
@@ -137,4 +149,53 @@ int ponto_no_poligono(double px, double py, double *vertices, int num_vertices);
  */
 int forma_no_poligono(void *forma, double *vertices, int num_vertices);
 
+/* ============================================================================
+ * Polígono Preparado
+ * ============================================================================ */
+
+/* Tipo opaco para Polígono Preparado */
+typedef void* PoligonoPreparado;
+
+/**
+ * Prepara um polígono para muitos testes seguidos: guarda a caixa
+ * envolvente e distribui as arestas em faixas horizontais, de modo que
+ * cada teste só examina as arestas das faixas que o interessam.
+ * 
+ * @param vertices Array de coordenadas do polígono [x0, y0, x1, y1, ...]
+ *                 (referenciado, deve viver enquanto o preparado existir)
+ * @param num_vertices Número de vértices
+ * @return Polígono preparado, ou NULL se houver menos de 3 vértices ou erro
+ */
+PoligonoPreparado poligono_preparar(const double *vertices, int num_vertices);
+
+/**
+ * Prepara um polígono estrelado em torno de (ox, oy), com os vértices em
+ * ordem angular (caso do polígono de visibilidade e da sua bomba). Além
+ * das faixas, guarda os ângulos dos vértices: o teste de ponto vira uma
+ * busca binária pela cunha e um único teste de lado, O(log V). Pontos
+ * muito perto de um raio de vértice ou da aresta usam o teste par/ímpar.
+ * 
+ * Se os vértices não estiverem em ordem angular, ou alguma cunha passar
+ * de meia volta, o resultado equivale a poligono_preparar.
+ */
+PoligonoPreparado poligono_preparar_estrela(const double *vertices, int num_vertices,
+                                            double ox, double oy);
+
+/**
+ * Destroi um polígono preparado (os vértices não são liberados).
+ */
+void poligono_preparado_destruir(PoligonoPreparado preparado);
+
+/**
+ * Versão de ponto_no_poligono sobre o polígono preparado (mesmo resultado).
+ */
+int ponto_no_poligono_preparado(PoligonoPreparado preparado, double px, double py);
+
+/**
+ * Versão de forma_no_poligono sobre o polígono preparado.
+ * Rejeita pela caixa envolvente e testa só as arestas das faixas
+ * cobertas pela forma.
+ */
+int forma_no_poligono_preparado(void *forma, PoligonoPreparado preparado);
+
 #endif /* CALCULOS_H */
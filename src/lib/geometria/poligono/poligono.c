@@ -1,17 +1,27 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include "poligono.h"
 #include "lista.h"
 #include "ponto.h"
 
 #define INITIAL_CAPACITY 16
+#define ARCOS_POR_VOLTA 128     /* Lados de um arco de volta inteira no recorte pelo círculo */
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 /* Definição concreta da struct baseada em Array Dinâmico */
 typedef struct poligono_st {
     double *coords;     /* [x0, y0, x1, y1, ...] */
     int num_vertices;
     int capacity;       /* Capacidade atual do array em número de vértices */
+    double min_x, min_y; /* Caixa envolvente, mantida a cada inserção */
+    double max_x, max_y;
+    int tem_origem;      /* 1 se o polígono é estrelado em torno de (origem_x, origem_y) */
+    double origem_x, origem_y;
     Lista lista_cache;  /* Cache para uso legado, invalidada ao alterar */
 } PoligonoStruct;
 
@@ -27,6 +37,9 @@ Poligono poligono_criar() {
 
     p->num_vertices = 0;
     p->capacity = INITIAL_CAPACITY;
+    p->min_x = p->min_y = p->max_x = p->max_y = 0.0;
+    p->tem_origem = 0;
+    p->origem_x = p->origem_y = 0.0;
     p->lista_cache = NULL;
     
     return (Poligono)p;
@@ -52,6 +65,26 @@ void poligono_destruir(Poligono p) {
     }
 }
 
+Poligono poligono_clonar(Poligono p) {
+    PoligonoStruct *ps = (PoligonoStruct*)p;
+    if (ps == NULL) return NULL;
+
+    PoligonoStruct *c = (PoligonoStruct*)malloc(sizeof(PoligonoStruct));
+    if (c == NULL) return NULL;
+
+    *c = *ps;
+    c->capacity = ps->num_vertices > 0 ? ps->num_vertices : 1;
+    c->coords = (double*)malloc(2 * c->capacity * sizeof(double));
+    if (c->coords == NULL) {
+        free(c);
+        return NULL;
+    }
+    memcpy(c->coords, ps->coords, 2 * ps->num_vertices * sizeof(double));
+    c->lista_cache = NULL;
+
+    return (Poligono)c;
+}
+
 void poligono_inserir_vertice(Poligono p, double x, double y) {
     PoligonoStruct *ps = (PoligonoStruct*)p;
     if (ps == NULL) return;
@@ -67,6 +100,16 @@ void poligono_inserir_vertice(Poligono p, double x, double y) {
 
     ps->coords[2 * ps->num_vertices] = x;
     ps->coords[2 * ps->num_vertices + 1] = y;
+
+    if (ps->num_vertices == 0) {
+        ps->min_x = ps->max_x = x;
+        ps->min_y = ps->max_y = y;
+    } else {
+        if (x < ps->min_x) ps->min_x = x;
+        if (x > ps->max_x) ps->max_x = x;
+        if (y < ps->min_y) ps->min_y = y;
+        if (y > ps->max_y) ps->max_y = y;
+    }
     ps->num_vertices++;
     
     limpar_cache(ps); /* Invalida cache legado */
@@ -86,6 +129,36 @@ Ponto poligono_get_vertice(Poligono p, int indice) {
     return criar_ponto(ps->coords[2*indice], ps->coords[2*indice+1]);
 }
 
+void poligono_definir_origem(Poligono p, double x, double y) {
+    PoligonoStruct *ps = (PoligonoStruct*)p;
+    if (ps == NULL) return;
+
+    ps->tem_origem = 1;
+    ps->origem_x = x;
+    ps->origem_y = y;
+}
+
+int poligono_obter_origem(Poligono p, double *x, double *y) {
+    PoligonoStruct *ps = (PoligonoStruct*)p;
+    if (ps == NULL || !ps->tem_origem) return 0;
+
+    *x = ps->origem_x;
+    *y = ps->origem_y;
+    return 1;
+}
+
+int poligono_obter_limites(Poligono p, double *min_x, double *min_y,
+                           double *max_x, double *max_y) {
+    PoligonoStruct *ps = (PoligonoStruct*)p;
+    if (ps == NULL || ps->num_vertices == 0) return 0;
+
+    *min_x = ps->min_x;
+    *min_y = ps->min_y;
+    *max_x = ps->max_x;
+    *max_y = ps->max_y;
+    return 1;
+}
+
 double* poligono_get_vertices_ref(Poligono p, int *num_vertices) {
     PoligonoStruct *ps = (PoligonoStruct*)p;
     if (ps == NULL) {
@@ -114,6 +187,234 @@ int poligono_obter_vertices_array(Poligono p, double **vertices_out) {
     return ps->num_vertices;
 }
 
+/* Distância do ponto p ao segmento ab */
+static double distancia_segmento(const double *a, const double *b, const double *p) {
+    double dx = b[0] - a[0], dy = b[1] - a[1];
+    double comp2 = dx * dx + dy * dy;
+    double t = 0.0;
+    if (comp2 > 0.0) {
+        t = ((p[0] - a[0]) * dx + (p[1] - a[1]) * dy) / comp2;
+        if (t < 0.0) t = 0.0;
+        if (t > 1.0) t = 1.0;
+    }
+    return hypot(p[0] - (a[0] + t * dx), p[1] - (a[1] + t * dy));
+}
+
+/* Maior desvio de uma curva no vértice i (distância à corda dos vizinhos) */
+static double desvio(const double *c, int n, int i) {
+    int ant = (i + n - 1) % n, prox = (i + 1) % n;
+    return distancia_segmento(&c[2 * ant], &c[2 * prox], &c[2 * i]);
+}
+
+int poligono_simplificar(Poligono p, double tolerancia) {
+    PoligonoStruct *ps = (PoligonoStruct*)p;
+    if (ps == NULL || tolerancia <= 0.0 || ps->num_vertices <= 3) return 0;
+
+    int n = ps->num_vertices;
+    double *c = ps->coords;
+    char *manter = (char*)calloc(n, 1);
+    if (manter == NULL) return 0;
+
+    /* Parte do vértice mais saliente, que certamente fica */
+    int inicio = 0;
+    double maior = -1.0;
+    for (int i = 0; i < n; i++) {
+        double d = desvio(c, n, i);
+        if (d > maior) {
+            maior = d;
+            inicio = i;
+        }
+    }
+
+    /* Trechos gulosos, numa passada: a partir da âncora, estende a corda
+     * enquanto ela passa a até a tolerância de todos os vértices pulados.
+     * Um vértice pulado a distância d > tolerância da âncora limita a
+     * direção da corda a um cone de meia abertura asin(tolerância / d) em
+     * torno da sua direção, e a corda tem de ser ao menos tão longa quanto
+     * ele está longe; basta guardar a interseção dos cones (ângulos
+     * relativos à direção do primeiro vértice que limitou) e o maior d. */
+    int ancora = inicio;
+    manter[ancora] = 1;
+    int limitado = 0;
+    double ref_x = 0.0, ref_y = 0.0, cone_min = 0.0, cone_max = 0.0, alcance = 0.0;
+    for (int passo = 1; passo <= n; passo++) {
+        int fim = (inicio + passo) % n;
+        double vx = c[2 * fim] - c[2 * ancora], vy = c[2 * fim + 1] - c[2 * ancora + 1];
+        double d = hypot(vx, vy);
+
+        int ok = 1;
+        if (limitado) {
+            double ang = atan2(ref_x * vy - ref_y * vx, ref_x * vx + ref_y * vy);
+            ok = d >= alcance && ang >= cone_min && ang <= cone_max;
+        }
+        if (!ok) {
+            /* O vértice anterior fica e vira a âncora */
+            ancora = (inicio + passo - 1) % n;
+            manter[ancora] = 1;
+            limitado = 0;
+            vx = c[2 * fim] - c[2 * ancora];
+            vy = c[2 * fim + 1] - c[2 * ancora + 1];
+            d = hypot(vx, vy);
+        }
+
+        /* fim passa a ser pulado pela próxima corda */
+        if (d <= tolerancia) continue;
+        double meia = asin(tolerancia / d);
+        if (!limitado) {
+            limitado = 1;
+            ref_x = vx / d;
+            ref_y = vy / d;
+            cone_min = -meia;
+            cone_max = meia;
+            alcance = d;
+        } else {
+            double ang = atan2(ref_x * vy - ref_y * vx, ref_x * vx + ref_y * vy);
+            if (ang - meia > cone_min) cone_min = ang - meia;
+            if (ang + meia < cone_max) cone_max = ang + meia;
+            if (d > alcance) alcance = d;
+        }
+    }
+
+    int m = 0;
+    for (int i = 0; i < n; i++) m += manter[i];
+    if (m < 3) {
+        free(manter);
+        return 0;
+    }
+
+    /* Compacta mantendo a ordem original e refaz a caixa */
+    int j = 0;
+    for (int i = 0; i < n; i++) {
+        if (!manter[i]) continue;
+        double x = c[2 * i], y = c[2 * i + 1];
+        c[2 * j] = x;
+        c[2 * j + 1] = y;
+        if (j == 0) {
+            ps->min_x = ps->max_x = x;
+            ps->min_y = ps->max_y = y;
+        } else {
+            if (x < ps->min_x) ps->min_x = x;
+            if (x > ps->max_x) ps->max_x = x;
+            if (y < ps->min_y) ps->min_y = y;
+            if (y > ps->max_y) ps->max_y = y;
+        }
+        j++;
+    }
+    ps->num_vertices = j;
+    free(manter);
+
+    limpar_cache(ps);
+    return n - j;
+}
+
+/* Vértices intermediários do arco de a1 até a2 (no sentido do polígono);
+ * ângulos iguais dão um arco vazio, e não uma volta inteira */
+static void inserir_arco(Poligono p, double cx, double cy, double raio,
+                         double a1, double a2, int sentido) {
+    double delta = remainder(a2 - a1, 2.0 * M_PI);
+    if (fabs(delta) < 1e-9) return;
+    if (sentido > 0) {
+        while (delta <= 0.0) delta += 2.0 * M_PI;
+        while (delta > 2.0 * M_PI) delta -= 2.0 * M_PI;
+    } else {
+        while (delta >= 0.0) delta -= 2.0 * M_PI;
+        while (delta < -2.0 * M_PI) delta += 2.0 * M_PI;
+    }
+
+    int passos = (int)ceil(fabs(delta) / (2.0 * M_PI / ARCOS_POR_VOLTA));
+    for (int k = 1; k < passos; k++) {
+        double a = a1 + delta * k / passos;
+        poligono_inserir_vertice(p, cx + raio * cos(a), cy + raio * sin(a));
+    }
+}
+
+Poligono poligono_recortar_circulo(Poligono p, double raio) {
+    PoligonoStruct *ps = (PoligonoStruct*)p;
+    if (ps == NULL || !ps->tem_origem || !(raio > 0.0)) return NULL;
+
+    double cx = ps->origem_x, cy = ps->origem_y;
+    int n = ps->num_vertices;
+    const double *c = ps->coords;
+    double limite = raio * (1.0 + 1e-9);
+
+    Poligono r = poligono_criar();
+    if (r == NULL) return NULL;
+    poligono_definir_origem(r, cx, cy);
+
+    /* Sentido do polígono, para os arcos seguirem a mesma ordem angular */
+    double area = 0.0;
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1) % n;
+        area += (c[2 * i] - cx) * (c[2 * j + 1] - cy) - (c[2 * j] - cx) * (c[2 * i + 1] - cy);
+    }
+    int sentido = area >= 0.0 ? 1 : -1;
+
+    int tem_saida = 0, entrada_inicial = 0;
+    double angulo_saida = 0.0, angulo_entrada = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1) % n;
+        double px = c[2 * i] - cx, py = c[2 * i + 1] - cy;
+        double qx = c[2 * j] - cx, qy = c[2 * j + 1] - cy;
+        int p_dentro = hypot(px, py) <= limite;
+        int q_dentro = hypot(qx, qy) <= limite;
+
+        if (p_dentro) poligono_inserir_vertice(r, c[2 * i], c[2 * i + 1]);
+        if (p_dentro && q_dentro) continue;
+
+        /* Raízes de |P + t(Q - P)| = raio */
+        double dx = qx - px, dy = qy - py;
+        double a = dx * dx + dy * dy;
+        double b = px * dx + py * dy;
+        double disc = b * b - a * (px * px + py * py - raio * raio);
+        if (a == 0.0) continue;
+        if (disc < 0.0) disc = 0.0;     /* Extremo sobre o círculo, arredondado */
+        double raiz = sqrt(disc);
+        double t0 = (-b - raiz) / a, t1 = (-b + raiz) / a;
+
+        /* Entrada (t0) e saída (t1) do círculo, conforme os extremos */
+        int entra = !p_dentro && (q_dentro || (t0 > 0.0 && t0 < 1.0 && t1 > t0));
+        int sai = !q_dentro && (p_dentro || entra);
+        if (t0 < 0.0) t0 = 0.0;
+        if (t1 > 1.0) t1 = 1.0;
+
+        if (entra) {
+            double ex = px + t0 * dx, ey = py + t0 * dy;
+            double ang = atan2(ey, ex);
+            if (tem_saida) {
+                inserir_arco(r, cx, cy, raio, angulo_saida, ang, sentido);
+            } else if (!entrada_inicial) {
+                entrada_inicial = 1;
+                angulo_entrada = ang;
+            }
+            if (!q_dentro || hypot(qx - ex, qy - ey) > raio * 1e-9) {
+                poligono_inserir_vertice(r, cx + ex, cy + ey);
+            }
+        }
+        if (sai) {
+            double sx = px + t1 * dx, sy = py + t1 * dy;
+            if (!p_dentro || entra || hypot(px - sx, py - sy) > raio * 1e-9) {
+                poligono_inserir_vertice(r, cx + sx, cy + sy);
+            }
+            angulo_saida = atan2(sy, sx);
+            tem_saida = 1;
+        }
+    }
+
+    if (poligono_qtd_vertices(r) == 0) {
+        /* Nenhum lado alcança o círculo: ele é todo visível */
+        for (int k = 0; k < ARCOS_POR_VOLTA; k++) {
+            double ang = sentido * 2.0 * M_PI * k / ARCOS_POR_VOLTA;
+            poligono_inserir_vertice(r, cx + raio * cos(ang), cy + raio * sin(ang));
+        }
+    } else if (entrada_inicial && tem_saida) {
+        /* O arco que fecha a volta vai da última saída à primeira entrada */
+        inserir_arco(r, cx, cy, raio, angulo_saida, angulo_entrada, sentido);
+    }
+
+    return r;
+}
+
 Lista poligono_obter_lista(Poligono p) {
     PoligonoStruct *ps = (PoligonoStruct*)p;
     if (ps == NULL) return NULL;
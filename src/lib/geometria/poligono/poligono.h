@@ -19,6 +19,13 @@ Poligono poligono_criar();
  */
 void poligono_destruir(Poligono p);
 
+/**
+ * Cria uma cópia independente do polígono (vértices, caixa e origem).
+ * @param p Polígono a ser copiado.
+ * @return Nova instância de Poligono ou NULL em caso de erro.
+ */
+Poligono poligono_clonar(Poligono p);
+
 /**
  * Insere um vértice no final da sequência do polígono.
  * @param p Polígono.
@@ -53,6 +60,32 @@ Ponto poligono_get_vertice(Poligono p, int indice);
  */
 int poligono_obter_vertices_array(Poligono p, double **vertices_out);
 
+/**
+ * Registra a origem em torno da qual o polígono é estrelado (a bomba,
+ * no polígono de visibilidade): os vértices estão em ordem angular e
+ * todo ponto do polígono é visto da origem.
+ * @param p Polígono.
+ * @param x, y Coordenadas da origem.
+ */
+void poligono_definir_origem(Poligono p, double x, double y);
+
+/**
+ * Obtém a origem registrada com poligono_definir_origem.
+ * @param p Polígono.
+ * @param x, y Ponteiros para receber a origem.
+ * @return 1 se o polígono tem origem, 0 caso contrário.
+ */
+int poligono_obter_origem(Poligono p, double *x, double *y);
+
+/**
+ * Obtém a caixa envolvente do polígono (mantida a cada inserção, O(1)).
+ * @param p Polígono.
+ * @param min_x, min_y, max_x, max_y Ponteiros para receber os limites.
+ * @return 1 se o polígono tem vértices, 0 caso contrário.
+ */
+int poligono_obter_limites(Poligono p, double *min_x, double *min_y,
+                           double *max_x, double *max_y);
+
 /**
  * Retorna ponteiro direto para o array interno de vértices [x0, y0, ...].
  * @param p Polígono.
@@ -61,6 +94,28 @@ int poligono_obter_vertices_array(Poligono p, double **vertices_out);
  */
 double* poligono_get_vertices_ref(Poligono p, int *num_vertices);
 
+/**
+ * Remove vértices redundantes: trechos colineares e vértices quase
+ * repetidos. Cada vértice removido fica a até a tolerância do lado que o
+ * substitui, então a região muda no máximo isso. A ordem dos vértices
+ * restantes e a origem são mantidas; o resultado tem ao menos 3 vértices.
+ * @param p Polígono.
+ * @param tolerancia Distância máxima de um vértice removido ao novo lado (<= 0: nada muda).
+ * @return Número de vértices removidos.
+ */
+int poligono_simplificar(Poligono p, double tolerancia);
+
+/**
+ * Recorta o polígono pelo círculo centrado na origem registrada. O
+ * polígono precisa ser estrelado em torno dela (como o de visibilidade):
+ * o resultado é o polígono até a distância raio, com os trechos de fora
+ * trocados por arcos do círculo aproximados por lados retos.
+ * @param p Polígono com origem.
+ * @param raio Raio do círculo (> 0).
+ * @return Novo polígono, com a mesma origem, ou NULL se p não tem origem.
+ */
+Poligono poligono_recortar_circulo(Poligono p, double raio);
+
 /**
  * Retorna a lista interna de pontos.
  * @param p Polígono.
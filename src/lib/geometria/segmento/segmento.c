@@ -19,8 +19,8 @@ typedef struct segmento_internal
 {
     int id;           /* ID único do segmento */
     int id_original;  /* ID da forma original */
-    Ponto p1;         /* Ponto inicial */
-    Ponto p2;         /* Ponto final */
+    double x1, y1;    /* Ponto inicial */
+    double x2, y2;    /* Ponto final */
     char cor[32];     /* Cor do segmento */
 } SegmentoInternal;
 
@@ -39,8 +39,10 @@ Segmento criar_segmento(int id, int id_original, double x1, double y1, double x2
     
     seg->id = id;
     seg->id_original = id_original;
-    seg->p1 = criar_ponto(x1, y1);
-    seg->p2 = criar_ponto(x2, y2);
+    seg->x1 = x1;
+    seg->y1 = y1;
+    seg->x2 = x2;
+    seg->y2 = y2;
     
     if (cor != NULL)
     {
@@ -52,14 +54,6 @@ Segmento criar_segmento(int id, int id_original, double x1, double y1, double x2
         strcpy(seg->cor, "black");
     }
     
-    if (seg->p1 == NULL || seg->p2 == NULL)
-    {
-        destruir_ponto(seg->p1);
-        destruir_ponto(seg->p2);
-        free(seg);
-        return NULL;
-    }
-    
     return (Segmento)seg;
 }
 
@@ -79,8 +73,7 @@ Segmento clonar_segmento(Segmento segmento)
     if (seg == NULL) return NULL;
     
     return criar_segmento(seg->id, seg->id_original,
-                          get_ponto_x(seg->p1), get_ponto_y(seg->p1),
-                          get_ponto_x(seg->p2), get_ponto_y(seg->p2),
+                          seg->x1, seg->y1, seg->x2, seg->y2,
                           seg->cor);
 }
 
@@ -89,8 +82,6 @@ void destruir_segmento(Segmento segmento)
     SegmentoInternal *seg = (SegmentoInternal*)segmento;
     if (seg == NULL) return;
     
-    destruir_ponto(seg->p1);
-    destruir_ponto(seg->p2);
     free(seg);
 }
 
@@ -116,40 +107,28 @@ const char* get_segmento_cor(Segmento segmento)
     return seg ? seg->cor : "none";
 }
 
-Ponto get_segmento_p1(Segmento segmento)
-{
-    SegmentoInternal *seg = (SegmentoInternal*)segmento;
-    return seg ? seg->p1 : NULL;
-}
-
-Ponto get_segmento_p2(Segmento segmento)
-{
-    SegmentoInternal *seg = (SegmentoInternal*)segmento;
-    return seg ? seg->p2 : NULL;
-}
-
 double get_segmento_x1(Segmento segmento)
 {
     SegmentoInternal *seg = (SegmentoInternal*)segmento;
-    return seg ? get_ponto_x(seg->p1) : 0.0;
+    return seg ? seg->x1 : 0.0;
 }
 
 double get_segmento_y1(Segmento segmento)
 {
     SegmentoInternal *seg = (SegmentoInternal*)segmento;
-    return seg ? get_ponto_y(seg->p1) : 0.0;
+    return seg ? seg->y1 : 0.0;
 }
 
 double get_segmento_x2(Segmento segmento)
 {
     SegmentoInternal *seg = (SegmentoInternal*)segmento;
-    return seg ? get_ponto_x(seg->p2) : 0.0;
+    return seg ? seg->x2 : 0.0;
 }
 
 double get_segmento_y2(Segmento segmento)
 {
     SegmentoInternal *seg = (SegmentoInternal*)segmento;
-    return seg ? get_ponto_y(seg->p2) : 0.0;
+    return seg ? seg->y2 : 0.0;
 }
 
 /* ============================================================================
@@ -161,7 +140,9 @@ double segmento_comprimento(Segmento segmento)
     SegmentoInternal *seg = (SegmentoInternal*)segmento;
     if (seg == NULL) return 0.0;
     
-    return ponto_distancia(seg->p1, seg->p2);
+    double dx = seg->x2 - seg->x1;
+    double dy = seg->y2 - seg->y1;
+    return sqrt(dx * dx + dy * dy);
 }
 
 int segmento_dividir(Segmento segmento, Ponto ponto, Segmento *seg1, Segmento *seg2)
@@ -174,14 +155,14 @@ int segmento_dividir(Segmento segmento, Ponto ponto, Segmento *seg1, Segmento *s
     
     /* Primeiro segmento: p1 até ponto de divisão */
     *seg1 = criar_segmento(seg->id, seg->id_original,
-                           get_ponto_x(seg->p1), get_ponto_y(seg->p1),
+                           seg->x1, seg->y1,
                            get_ponto_x(ponto), get_ponto_y(ponto),
                            seg->cor);
     
     /* Segundo segmento: ponto de divisão até p2 */
     *seg2 = criar_segmento(seg->id, seg->id_original,
                            get_ponto_x(ponto), get_ponto_y(ponto),
-                           get_ponto_x(seg->p2), get_ponto_y(seg->p2),
+                           seg->x2, seg->y2,
                            seg->cor);
     
     return (*seg1 != NULL && *seg2 != NULL);
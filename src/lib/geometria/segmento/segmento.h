@@ -78,18 +78,6 @@ int get_segmento_id_original(Segmento seg);
  */
 const char* get_segmento_cor(Segmento seg);
 
-/**
- * Obtém o ponto inicial do segmento.
- * @note NÃO modifique nem destrua o ponto retornado!
- */
-Ponto get_segmento_p1(Segmento seg);
-
-/**
- * Obtém o ponto final do segmento.
- * @note NÃO modifique nem destrua o ponto retornado!
- */
-Ponto get_segmento_p2(Segmento seg);
-
 /**
  * Obtém coordenada X1 do ponto inicial.
  */
@@ -9,12 +9,13 @@
 
 #include "cmd_a.h"
 #include "lista.h"
+#include "grade.h"
 #include "formas.h"
 #include "circulo.h"
 #include "retangulo.h"
 #include "linha.h"
 #include "texto.h"
-#include "segmento.h"
+#include "vetor_segmentos.h"
 
 /* ============================================================================
  * Funções Auxiliares - Conversão de Formas para Segmentos
@@ -30,7 +31,7 @@
  * Converte um retângulo em 4 segmentos.
  * Escreve log no arquivo se arquivo_log != NULL.
  */
-static int converter_retangulo(Retangulo r, int id_original, Lista lista_segmentos, int *proximo_id, FILE *arquivo_log)
+static int converter_retangulo(Retangulo r, int id_original, VetorSegmentos segmentos, int *proximo_id, FILE *arquivo_log)
 {
     double x = getRetanguloX(r);
     double y = getRetanguloY(r);
@@ -45,10 +46,10 @@ static int converter_retangulo(Retangulo r, int id_original, Lista lista_segment
     ids[3] = (*proximo_id)++;
     
     /* 4 lados do retângulo */
-    inserir_fim(lista_segmentos, criar_segmento(ids[0], id_original, x, y, x+w, y, cor));         /* baixo */
-    inserir_fim(lista_segmentos, criar_segmento(ids[1], id_original, x+w, y, x+w, y+h, cor));     /* direita */
-    inserir_fim(lista_segmentos, criar_segmento(ids[2], id_original, x+w, y+h, x, y+h, cor));     /* cima */
-    inserir_fim(lista_segmentos, criar_segmento(ids[3], id_original, x, y+h, x, y, cor));         /* esquerda */
+    vetor_segmentos_adicionar(segmentos, ids[0], id_original, x, y, x+w, y, cor);         /* baixo */
+    vetor_segmentos_adicionar(segmentos, ids[1], id_original, x+w, y, x+w, y+h, cor);     /* direita */
+    vetor_segmentos_adicionar(segmentos, ids[2], id_original, x+w, y+h, x, y+h, cor);     /* cima */
+    vetor_segmentos_adicionar(segmentos, ids[3], id_original, x, y+h, x, y, cor);         /* esquerda */
     
     if (arquivo_log)
     {
@@ -61,7 +62,7 @@ static int converter_retangulo(Retangulo r, int id_original, Lista lista_segment
 /**
  * Converte um círculo em 1 segmento diametral.
  */
-static int converter_circulo(Circulo c, int id_original, Lista lista_segmentos, char orientacao, int *proximo_id, FILE *arquivo_log)
+static int converter_circulo(Circulo c, int id_original, VetorSegmentos segmentos, char orientacao, int *proximo_id, FILE *arquivo_log)
 {
     double cx = getCirculoX(c);
     double cy = getCirculoY(c);
@@ -73,12 +74,12 @@ static int converter_circulo(Circulo c, int id_original, Lista lista_segmentos,
     if (orientacao == 'v')
     {
         /* Segmento vertical */
-        inserir_fim(lista_segmentos, criar_segmento(id_seg, id_original, cx, cy-r, cx, cy+r, cor));
+        vetor_segmentos_adicionar(segmentos, id_seg, id_original, cx, cy-r, cx, cy+r, cor);
     }
     else
     {
         /* Segmento horizontal (default) */
-        inserir_fim(lista_segmentos, criar_segmento(id_seg, id_original, cx-r, cy, cx+r, cy, cor));
+        vetor_segmentos_adicionar(segmentos, id_seg, id_original, cx-r, cy, cx+r, cy, cor);
     }
     
     if (arquivo_log)
@@ -92,7 +93,7 @@ static int converter_circulo(Circulo c, int id_original, Lista lista_segmentos,
 /**
  * Converte uma linha em 1 segmento.
  */
-static int converter_linha(Linha l, int id_original, Lista lista_segmentos, int *proximo_id, FILE *arquivo_log)
+static int converter_linha(Linha l, int id_original, VetorSegmentos segmentos, int *proximo_id, FILE *arquivo_log)
 {
     double x1 = getLinhaX1(l);
     double y1 = getLinhaY1(l);
@@ -102,7 +103,7 @@ static int converter_linha(Linha l, int id_original, Lista lista_segmentos, int
     
     int id_seg = (*proximo_id)++;
     
-    inserir_fim(lista_segmentos, criar_segmento(id_seg, id_original, x1, y1, x2, y2, cor));
+    vetor_segmentos_adicionar(segmentos, id_seg, id_original, x1, y1, x2, y2, cor);
     
     if (arquivo_log)
     {
@@ -115,7 +116,7 @@ static int converter_linha(Linha l, int id_original, Lista lista_segmentos, int
 /**
  * Converte um texto em 1 segmento horizontal.
  */
-static int converter_texto(Texto t, int id_original, Lista lista_segmentos, int *proximo_id, FILE *arquivo_log)
+static int converter_texto(Texto t, int id_original, VetorSegmentos segmentos, int *proximo_id, FILE *arquivo_log)
 {
     double x = getTextoX(t);
     double y = getTextoY(t);
@@ -144,7 +145,7 @@ static int converter_texto(Texto t, int id_original, Lista lista_segmentos, int
     
     int id_seg = (*proximo_id)++;
     
-    inserir_fim(lista_segmentos, criar_segmento(id_seg, id_original, x1, y, x2, y, cor));
+    vetor_segmentos_adicionar(segmentos, id_seg, id_original, x1, y, x2, y, cor);
     
     if (arquivo_log)
     {
@@ -159,7 +160,8 @@ static int converter_texto(Texto t, int id_original, Lista lista_segmentos, int
  * ============================================================================ */
 
 int executar_cmd_a(Lista lista_formas,
-                   Lista lista_anteparos,
+                   Grade grade,
+                   VetorSegmentos anteparos,
                    int id_inicio,
                    int id_fim,
                    char orientacao,
@@ -168,7 +170,7 @@ int executar_cmd_a(Lista lista_formas,
                    const char *nome_base,
                    const char *sufixo)
 {
-    if (lista_formas == NULL || lista_anteparos == NULL || proximo_id == NULL)
+    if (lista_formas == NULL || anteparos == NULL || proximo_id == NULL)
     {
         return 0;
     }
@@ -207,24 +209,25 @@ int executar_cmd_a(Lista lista_formas,
             switch (tipo)
             {
                 case TIPO_RETANGULO:
-                    contador += converter_retangulo((Retangulo)dados, id, lista_anteparos, proximo_id, arquivo_log);
+                    contador += converter_retangulo((Retangulo)dados, id, anteparos, proximo_id, arquivo_log);
                     break;
                     
                 case TIPO_CIRCULO:
-                    contador += converter_circulo((Circulo)dados, id, lista_anteparos, orientacao, proximo_id, arquivo_log);
+                    contador += converter_circulo((Circulo)dados, id, anteparos, orientacao, proximo_id, arquivo_log);
                     break;
                     
                 case TIPO_LINHA:
-                    contador += converter_linha((Linha)dados, id, lista_anteparos, proximo_id, arquivo_log);
+                    contador += converter_linha((Linha)dados, id, anteparos, proximo_id, arquivo_log);
                     break;
                     
                 case TIPO_TEXTO:
-                    contador += converter_texto((Texto)dados, id, lista_anteparos, proximo_id, arquivo_log);
+                    contador += converter_texto((Texto)dados, id, anteparos, proximo_id, arquivo_log);
                     break;
             }
             
             /* Marca forma como inativa (não será mais desenhada no SVG) */
             setFormaAtiva(forma, 0);
+            grade_remover(grade, forma);
         }
         
         atual = obter_proximo(atual);
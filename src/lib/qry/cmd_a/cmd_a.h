@@ -8,20 +8,24 @@
 #define CMD_A_H
 
 #include "lista.h"
+#include "grade.h"
+#include "vetor_segmentos.h"
 
 /**
  * Executa o comando 'a' (anteparo).
  * Transforma formas com ID de i até j em segmentos bloqueantes.
  * 
  * @param lista_formas Lista de formas do cenário
- * @param lista_anteparos Lista onde os segmentos serão inseridos
+ * @param grade Índice espacial das formas (as convertidas são removidas)
+ * @param anteparos Vetor onde os segmentos serão adicionados
  * @param id_inicio ID inicial (inclusive)
  * @param id_fim ID final (inclusive)
  * @param orientacao 'h' para horizontal, 'v' para vertical (para círculos)
  * @return Número de formas convertidas
  */
 int executar_cmd_a(Lista lista_formas,
-                   Lista lista_anteparos,
+                   Grade grade,
+                   VetorSegmentos anteparos,
                    int id_inicio,
                    int id_fim,
                    char orientacao,
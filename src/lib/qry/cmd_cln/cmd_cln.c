@@ -10,8 +10,9 @@
 
 #include "cmd_cln.h"
 #include "lista.h"
+#include "grade.h"
 #include "ponto.h"
-#include "segmento.h"
+#include "vetor_segmentos.h"
 #include "visibilidade.h"
 #include "formas.h"
 #include "circulo.h"
@@ -38,14 +39,14 @@ static double* poligono_para_array(PoligonoVisibilidade poligono, int *num_verti
 /**
  * Verifica se uma forma está dentro do polígono de visibilidade.
  */
-static int forma_visivel(Forma forma, double *vertices, int num_vertices)
+static int forma_visivel(Forma forma, PoligonoPreparado preparado)
 {
-    if (forma == NULL || vertices == NULL || num_vertices < 3)
+    if (forma == NULL || preparado == NULL)
     {
         return 0;
     }
     
-    int visivel = forma_no_poligono(forma, vertices, num_vertices);
+    int visivel = forma_no_poligono_preparado(forma, preparado);
     
     return visivel;
 }
@@ -124,7 +125,8 @@ static Forma clonar_forma_com_deslocamento(Forma forma, double dx, double dy, in
  * Gera o arquivo de relatório TXT.
  */
 static void gerar_relatorio_txt(const char *caminho, Lista formas_clonadas, 
-                                 Lista segmentos_clonados, double dx, double dy)
+                                 VetorSegmentos anteparos, int primeiro_clone,
+                                 double dx, double dy)
 {
     FILE *arquivo = fopen(caminho, "a");
     if (arquivo == NULL) return;
@@ -153,16 +155,13 @@ static void gerar_relatorio_txt(const char *caminho, Lista formas_clonadas,
         atual = obter_proximo(atual);
     }
     
-    /* Log segmentos (anteparos) clonados */
-    atual = obter_primeiro(segmentos_clonados);
-    while (atual != NULL)
+    /* Log segmentos (anteparos) clonados: índices [primeiro_clone, fim) */
+    for (int i = primeiro_clone; i < vetor_segmentos_tamanho(anteparos); i++)
     {
-        Segmento seg = (Segmento)obter_elemento(atual);
-        int id = get_segmento_id(seg);
-        int id_orig = get_segmento_id_original(seg);
+        int id = vetor_segmentos_id(anteparos, i);
+        int id_orig = vetor_segmentos_id_original(anteparos, i);
         
         fprintf(arquivo, "  %d segmento (clone de %d)\n", id, id_orig);
-        atual = obter_proximo(atual);
     }
     
     fclose(arquivo);
@@ -174,7 +173,9 @@ static void gerar_relatorio_txt(const char *caminho, Lista formas_clonadas,
 
 int executar_cmd_cln(Ponto origem,
                      Lista lista_formas,
-                     Lista lista_anteparos,
+                     Grade grade,
+                     SvgCache cache_svg,
+                     VetorSegmentos anteparos,
                      double dx,
                      double dy,
                      const char *dir_saida,
@@ -182,30 +183,21 @@ int executar_cmd_cln(Ponto origem,
                      const char *sufixo,
                      double bbox[4],
                      int *proximo_id,
-                     const char *tipo_ordenacao,
-                     int limiar_insertion,
+                     PoligonoVisibilidade poligono,
+                     const int *visiveis,
+                     int num_visiveis,
                      Lista acumulador_poligonos,
-                     Lista acumulador_bombas)
+                     Lista acumulador_bombas,
+                     FILE *log)
 {
     if (origem == NULL || lista_formas == NULL || proximo_id == NULL)
     {
+        if (poligono != NULL) destruir_poligono_visibilidade(poligono);
         return 0;
     }
     
-    /* Cria lista para rastrear segmentos visíveis */
-    Lista segmentos_visiveis = criar_lista();
-    
-    /* Calcula polígono de visibilidade COM rastreamento de segmentos */
-    PoligonoVisibilidade poligono = calcular_visibilidade_com_segmentos(
-        origem, lista_anteparos,
-        bbox[0], bbox[1], bbox[2], bbox[3],
-        tipo_ordenacao, limiar_insertion,
-        segmentos_visiveis
-    );
-    
     if (poligono == NULL)
     {
-        destruir_lista(segmentos_visiveis, NULL);
         fprintf(stderr, "Aviso: falha ao calcular visibilidade\n");
         return 0;
     }
@@ -216,7 +208,6 @@ int executar_cmd_cln(Ponto origem,
     
     if (vertices == NULL)
     {
-        destruir_lista(segmentos_visiveis, NULL);
         if (acumulador_poligonos == NULL) destruir_poligono_visibilidade(poligono);
         return 0;
     }
@@ -224,24 +215,38 @@ int executar_cmd_cln(Ponto origem,
     /* Primeiro, coleta formas visíveis (não modifica lista durante iteração) */
     Lista formas_para_clonar = criar_lista();
     
-    No atual = obter_primeiro(lista_formas);
-    while (atual != NULL)
+    /* Caixa, faixas de arestas e cunhas em torno da bomba, calculadas uma
+     * vez para todas as formas */
+    double ox, oy;
+    PoligonoPreparado preparado = poligono_obter_origem((Poligono)poligono, &ox, &oy)
+        ? poligono_preparar_estrela(vertices, num_vertices, ox, oy)
+        : poligono_preparar(vertices, num_vertices);
+    
+    /* Só as formas cuja caixa cruza a do polígono podem ser visíveis */
+    int num_candidatas = 0;
+    Forma *candidatas = NULL;
+    double pmin_x, pmin_y, pmax_x, pmax_y;
+    if (poligono_obter_limites((Poligono)poligono, &pmin_x, &pmin_y, &pmax_x, &pmax_y))
     {
-        Forma forma = (Forma)obter_elemento(atual);
+        candidatas = grade_consultar(grade, pmin_x, pmin_y, pmax_x, pmax_y, &num_candidatas);
+    }
+    
+    for (int i = 0; i < num_candidatas; i++)
+    {
+        Forma forma = candidatas[i];
         
-        if (getFormaAtiva(forma) && forma_visivel(forma, vertices, num_vertices))
+        if (getFormaAtiva(forma) && forma_visivel(forma, preparado))
         {
             inserir_fim(formas_para_clonar, forma);
         }
-        
-        atual = obter_proximo(atual);
     }
+    poligono_preparado_destruir(preparado);
     
     /* Clona formas e adiciona à lista principal */
     Lista clones = criar_lista();
     int contador = 0;
     
-    atual = obter_primeiro(formas_para_clonar);
+    No atual = obter_primeiro(formas_para_clonar);
     while (atual != NULL)
     {
         Forma forma = (Forma)obter_elemento(atual);
@@ -250,6 +255,7 @@ int executar_cmd_cln(Ponto origem,
         if (clone != NULL)
         {
             inserir_fim(lista_formas, clone);
+            grade_inserir(grade, clone);
             inserir_fim(clones, clone);
             (*proximo_id)++;
             contador++;
@@ -258,44 +264,20 @@ int executar_cmd_cln(Ponto origem,
         atual = obter_proximo(atual);
     }
     
-    /* Clona segmentos visíveis e adiciona à lista de anteparos */
-    Lista segmentos_clonados = criar_lista(); /* Lista para log */
-    No seg_atual = obter_primeiro(segmentos_visiveis);
-    while (seg_atual != NULL)
+    /* Clona segmentos visíveis e adiciona ao fim do vetor de anteparos */
+    int primeiro_clone = vetor_segmentos_tamanho(anteparos);
+    for (int i = 0; i < num_visiveis; i++)
     {
-        Segmento seg = (Segmento)obter_elemento(seg_atual);
-        
-        /* Clona segmento com deslocamento */
-        double x1 = get_segmento_x1(seg) + dx;
-        double y1 = get_segmento_y1(seg) + dy;
-        double x2 = get_segmento_x2(seg) + dx;
-        double y2 = get_segmento_y2(seg) + dy;
-        
-        Segmento clone = criar_segmento(
-            *proximo_id,
-            get_segmento_id_original(seg),
-            x1, y1, x2, y2,
-            get_segmento_cor(seg)
-        );
-        
-        if (clone != NULL)
+        if (vetor_segmentos_clonar(anteparos, visiveis[i], *proximo_id, dx, dy) >= 0)
         {
-            inserir_fim(lista_anteparos, clone);
-            inserir_fim(segmentos_clonados, clone); /* Para log */
             (*proximo_id)++;
         }
-        
-        seg_atual = obter_proximo(seg_atual);
     }
     
-    destruir_lista(segmentos_visiveis, NULL);
-    
     /* Gera relatório */
     char caminho_txt[MAX_CAMINHO];
     snprintf(caminho_txt, MAX_CAMINHO, "%s/%s.txt", dir_saida, nome_base);
-    gerar_relatorio_txt(caminho_txt, clones, segmentos_clonados, dx, dy);
-    
-    destruir_lista(segmentos_clonados, NULL); /* Não destrói segmentos, só a lista */
+    gerar_relatorio_txt(caminho_txt, clones, anteparos, primeiro_clone, dx, dy);
     
     /* Calcula viewbox dinâmica para incluir clones */
     double view_min_x = bbox[0];
@@ -346,12 +328,12 @@ int executar_cmd_cln(Ponto origem,
         {
             /* 1. Desenha as formas originais (com clones) */
             svg_comentario(svg, "Formas originais do cenário");
-            svg_desenhar_lista(svg, lista_formas);
+            svg_desenhar_lista_cache(svg, lista_formas, cache_svg);
             
             /* 2. Desenha os anteparos */
-            if (lista_anteparos != NULL && !lista_vazia(lista_anteparos))
+            if (vetor_segmentos_tamanho(anteparos) > 0)
             {
-                svg_desenhar_lista_segmentos(svg, lista_anteparos);
+                svg_desenhar_segmentos_cache(svg, anteparos, cache_svg);
             }
             
             /* 3. Desenha a região de visibilidade */
@@ -363,7 +345,7 @@ int executar_cmd_cln(Ponto origem,
                                5.0, "#FF0000");
             
             finalizar_svg(svg);
-            printf("          SVG gerado: %s\n", caminho_svg);
+            fprintf(log, "          SVG gerado: %s\n", caminho_svg);
         }
         /* Destroi poligono */
         destruir_poligono_visibilidade(poligono);
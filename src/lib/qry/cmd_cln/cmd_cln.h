@@ -7,16 +7,25 @@
 #ifndef CMD_CLN_H
 #define CMD_CLN_H
 
+#include <stdio.h>
+
 #include "lista.h"
+#include "grade.h"
+#include "svg.h"
 #include "ponto.h"
+#include "vetor_segmentos.h"
+#include "visibilidade.h"
 
 /**
  * Executa o comando 'cln' (clonagem).
- * Calcula visibilidade e clona formas visíveis com deslocamento.
+ * Recebe a região de visibilidade já calculada e clona as formas visíveis
+ * com deslocamento.
  * 
  * @param origem Ponto de vista (x, y)
  * @param lista_formas Lista de formas do cenário (clones serão adicionados)
- * @param lista_anteparos Lista de segmentos bloqueantes
+ * @param grade Índice espacial das formas (clones são inseridos)
+ * @param cache_svg Fragmentos SVG da cena (NULL: desenha sem cache)
+ * @param anteparos Vetor de segmentos bloqueantes (clones são adicionados)
  * @param dx Deslocamento X para os clones
  * @param dy Deslocamento Y para os clones
  * @param dir_saida Diretório de saída
@@ -24,12 +33,17 @@
  * @param sufixo Sufixo para o arquivo de saída
  * @param bbox Bounding box [min_x, min_y, max_x, max_y]
  * @param proximo_id Ponteiro para o próximo ID disponível
- * @param algoritmo_ordenacao Algoritmo de ordenação
+ * @param poligono Polígono de visibilidade da bomba (o comando passa a ser o dono)
+ * @param visiveis Índices dos anteparos que bloquearam luz (são clonados)
+ * @param num_visiveis Quantidade de índices em visiveis
+ * @param log Destino das mensagens de progresso
  * @return Número de formas clonadas
  */
 int executar_cmd_cln(Ponto origem,
                      Lista lista_formas,
-                     Lista lista_anteparos,
+                     Grade grade,
+                     SvgCache cache_svg,
+                     VetorSegmentos anteparos,
                      double dx,
                      double dy,
                      const char *dir_saida,
@@ -37,9 +51,11 @@ int executar_cmd_cln(Ponto origem,
                      const char *sufixo,
                      double bbox[4],
                      int *proximo_id,
-                     const char *tipo_ordenacao,
-                     int limiar_insertion,
+                     PoligonoVisibilidade poligono,
+                     const int *visiveis,
+                     int num_visiveis,
                      Lista acumulador_poligonos,
-                     Lista acumulador_bombas);
+                     Lista acumulador_bombas,
+                     FILE *log);
 
 #endif /* CMD_CLN_H */
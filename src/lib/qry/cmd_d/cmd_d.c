@@ -9,8 +9,9 @@
 
 #include "cmd_d.h"
 #include "lista.h"
+#include "grade.h"
 #include "ponto.h"
-#include "segmento.h"
+#include "vetor_segmentos.h"
 #include "visibilidade.h"
 #include "formas.h"
 #include "svg.h"
@@ -34,21 +35,22 @@ static double* poligono_para_array(PoligonoVisibilidade poligono, int *num_verti
 /**
  * Verifica se uma forma está dentro do polígono de visibilidade.
  */
-static int forma_visivel(Forma forma, double *vertices, int num_vertices)
+static int forma_visivel(Forma forma, PoligonoPreparado preparado)
 {
-    if (forma == NULL || vertices == NULL || num_vertices < 3)
+    if (forma == NULL || preparado == NULL)
     {
         return 0;
     }
     
-    return forma_no_poligono(forma, vertices, num_vertices);
+    return forma_no_poligono_preparado(forma, preparado);
 }
 
 /**
  * Gera o arquivo de relatório TXT.
  */
 static void gerar_relatorio_txt(const char *caminho, Lista formas_visiveis, 
-                                Lista segmentos_destruidos, double x, double y)
+                                VetorSegmentos anteparos, const int *visiveis,
+                                int num_visiveis, double x, double y)
 {
     FILE *arquivo = fopen(caminho, "a"); /* Append */
     if (arquivo == NULL)
@@ -82,56 +84,60 @@ static void gerar_relatorio_txt(const char *caminho, Lista formas_visiveis,
     }
     
     /* Log segmentos (anteparos) destruídos */
-    atual = obter_primeiro(segmentos_destruidos);
-    while (atual != NULL)
+    for (int i = 0; i < num_visiveis; i++)
     {
-        Segmento seg = (Segmento)obter_elemento(atual);
-        int id = get_segmento_id(seg);
-        int id_orig = get_segmento_id_original(seg);
+        int id = vetor_segmentos_id(anteparos, visiveis[i]);
+        int id_orig = vetor_segmentos_id_original(anteparos, visiveis[i]);
         
         fprintf(arquivo, "  %d segmento (anteparo de %d)\n", id, id_orig);
-        atual = obter_proximo(atual);
     }
     
     fclose(arquivo);
 }
 
+/**
+ * Remove os anteparos destruídos do vetor.
+ * Cada índice é apenas marcado (O(1)); a compactação acontece uma vez,
+ * no fim, em uma única passada sobre o vetor.
+ */
+static void remover_anteparos(VetorSegmentos anteparos, const int *indices, int num)
+{
+    for (int i = 0; i < num; i++)
+    {
+        vetor_segmentos_marcar_remocao(anteparos, indices[i]);
+    }
+    vetor_segmentos_compactar(anteparos);
+}
+
 /* ============================================================================
  * Implementação
  * ============================================================================ */
 
 int executar_cmd_d(Ponto origem,
                    Lista lista_formas,
-                   Lista lista_anteparos,
+                   Grade grade,
+                   SvgCache cache_svg,
+                   VetorSegmentos anteparos,
                    const char *dir_saida,
                    const char *nome_base,
 
                    const char *sufixo,
                    double bbox[4],
-                   const char *tipo_ordenacao,
-                   int limiar_insertion,
+                   PoligonoVisibilidade poligono,
+                   const int *visiveis,
+                   int num_visiveis,
                    Lista acumulador_poligonos,
-                   Lista acumulador_bombas)
+                   Lista acumulador_bombas,
+                   FILE *log)
 {
     if (origem == NULL || lista_formas == NULL)
     {
+        if (poligono != NULL) destruir_poligono_visibilidade(poligono);
         return 0;
     }
     
-    /* Cria lista para rastrear segmentos visíveis */
-    Lista segmentos_visiveis = criar_lista();
-    
-    /* Calcula polígono de visibilidade COM rastreamento de segmentos */
-    PoligonoVisibilidade poligono = calcular_visibilidade_com_segmentos(
-        origem, lista_anteparos,
-        bbox[0], bbox[1], bbox[2], bbox[3],
-        tipo_ordenacao, limiar_insertion,
-        segmentos_visiveis
-    );
-    
     if (poligono == NULL)
     {
-        destruir_lista(segmentos_visiveis, NULL);
         fprintf(stderr, "Aviso: falha ao calcular visibilidade\n");
         return 0;
     }
@@ -144,66 +150,45 @@ int executar_cmd_d(Ponto origem,
     Lista formas_visiveis = criar_lista();
     int contador = 0;
     
-    No atual = obter_primeiro(lista_formas);
-    while (atual != NULL)
+    /* Caixa, faixas de arestas e cunhas em torno da bomba, calculadas uma
+     * vez para todas as formas */
+    double ox, oy;
+    PoligonoPreparado preparado = poligono_obter_origem((Poligono)poligono, &ox, &oy)
+        ? poligono_preparar_estrela(vertices, num_vertices, ox, oy)
+        : poligono_preparar(vertices, num_vertices);
+    
+    /* Só as formas cuja caixa cruza a do polígono podem ser visíveis */
+    int num_candidatas = 0;
+    Forma *candidatas = NULL;
+    double pmin_x, pmin_y, pmax_x, pmax_y;
+    if (poligono_obter_limites((Poligono)poligono, &pmin_x, &pmin_y, &pmax_x, &pmax_y))
     {
-        Forma forma = (Forma)obter_elemento(atual);
-        
-        if (getFormaAtiva(forma) && forma_visivel(forma, vertices, num_vertices))
-        {
-            inserir_fim(formas_visiveis, forma);
-            setFormaAtiva(forma, 0); /* Destrói a forma */
-            contador++;
-        }
-        
-        atual = obter_proximo(atual);
+        candidatas = grade_consultar(grade, pmin_x, pmin_y, pmax_x, pmax_y, &num_candidatas);
     }
     
-    /* Remove segmentos visíveis da lista de anteparos */
-    Lista segmentos_destruidos = criar_lista(); /* Para log */
-    No seg_atual = obter_primeiro(segmentos_visiveis);
-    while (seg_atual != NULL)
+    for (int i = 0; i < num_candidatas; i++)
     {
-        Segmento seg = (Segmento)obter_elemento(seg_atual);
+        Forma forma = candidatas[i];
         
-        /* Encontra e remove da lista de anteparos */
-        No ant_atual = obter_primeiro(lista_anteparos);
-        while (ant_atual != NULL)
+        if (getFormaAtiva(forma) && forma_visivel(forma, preparado))
         {
-            No proximo = obter_proximo(ant_atual);
-            Segmento ant_seg = (Segmento)obter_elemento(ant_atual);
-            
-            if (ant_seg == seg)
-            {
-                /* Salva referência para log antes de remover */
-                inserir_fim(segmentos_destruidos, ant_seg);
-                remover_no(lista_anteparos, ant_atual);
-                break;
-            }
-            ant_atual = proximo;
+            inserir_fim(formas_visiveis, forma);
+            setFormaAtiva(forma, 0); /* Destrói a forma */
+            grade_remover(grade, forma);
+            svg_cache_invalidar(cache_svg, forma);
+            contador++;
         }
-        
-        seg_atual = obter_proximo(seg_atual);
     }
+    poligono_preparado_destruir(preparado);
     
-    destruir_lista(segmentos_visiveis, NULL);
-    
-    /* Gera arquivos de saída */
+    /* Gera arquivos de saída (antes da remoção, enquanto os índices valem) */
     char caminho_txt[MAX_CAMINHO];
     snprintf(caminho_txt, MAX_CAMINHO, "%s/%s.txt", dir_saida, nome_base);
-    gerar_relatorio_txt(caminho_txt, formas_visiveis, segmentos_destruidos, 
+    gerar_relatorio_txt(caminho_txt, formas_visiveis, anteparos, visiveis, num_visiveis,
                         get_ponto_x(origem), get_ponto_y(origem));
     
-    /* Agora destrói os segmentos removidos */
-    No seg_destruir = obter_primeiro(segmentos_destruidos);
-    while (seg_destruir != NULL)
-    {
-        No prox = obter_proximo(seg_destruir);
-        Segmento seg = (Segmento)obter_elemento(seg_destruir);
-        destruir_segmento(seg);
-        seg_destruir = prox;
-    }
-    destruir_lista(segmentos_destruidos, NULL);
+    /* Remove segmentos visíveis do vetor de anteparos */
+    remover_anteparos(anteparos, visiveis, num_visiveis);
     
     /* SVG: Gerencia saída baseada no sufixo */
     if (strcmp(sufixo, "-") == 0)
@@ -244,12 +229,12 @@ int executar_cmd_d(Ponto origem,
         {
             /* 1. Desenha as formas originais */
             svg_comentario(svg, "Formas originais do cenário");
-            svg_desenhar_lista(svg, lista_formas);
+            svg_desenhar_lista_cache(svg, lista_formas, cache_svg);
             
             /* 2. Desenha os anteparos (segmentos bloqueantes) */
-            if (lista_anteparos != NULL && !lista_vazia(lista_anteparos))
+            if (vetor_segmentos_tamanho(anteparos) > 0)
             {
-                svg_desenhar_lista_segmentos(svg, lista_anteparos);
+                svg_desenhar_segmentos_cache(svg, anteparos, cache_svg);
             }
             
             /* 3. Desenha a região de visibilidade (polígono semi-transparente) */
@@ -261,7 +246,7 @@ int executar_cmd_d(Ponto origem,
                                5.0, "#FF0000");
             
             finalizar_svg(svg);
-            printf("          SVG gerado: %s\n", caminho_svg);
+            fprintf(log, "          SVG gerado: %s\n", caminho_svg);
         }
         
         /* Destroi poligono (não foi acumulado) */
@@ -7,34 +7,49 @@
 #ifndef CMD_D_H
 #define CMD_D_H
 
+#include <stdio.h>
+
 #include "lista.h"
+#include "grade.h"
+#include "svg.h"
 #include "ponto.h"
+#include "vetor_segmentos.h"
+#include "visibilidade.h"
 
 /**
  * Executa o comando 'd' (destruição).
- * Calcula visibilidade e "destrói" formas visíveis.
+ * Recebe a região de visibilidade já calculada e "destrói" as formas visíveis.
  * 
  * @param origem Ponto de vista (x, y)
  * @param lista_formas Lista de formas do cenário
- * @param lista_anteparos Lista de segmentos bloqueantes
+ * @param grade Índice espacial das formas (as destruídas são removidas)
+ * @param cache_svg Fragmentos SVG da cena (NULL: desenha sem cache)
+ * @param anteparos Vetor de segmentos bloqueantes (os visíveis são removidos)
  * @param dir_saida Diretório de saída
  * @param nome_base Nome base do arquivo
  * @param sufixo Sufixo para o arquivo de saída
  * @param bbox Bounding box [min_x, min_y, max_x, max_y]
- * @param algoritmo_ordenacao Algoritmo a ser usado ("qsort" ou "mergesort")
+ * @param poligono Polígono de visibilidade da bomba (o comando passa a ser o dono)
+ * @param visiveis Índices dos anteparos que bloquearam luz (são removidos)
+ * @param num_visiveis Quantidade de índices em visiveis
+ * @param log Destino das mensagens de progresso
  * @return Número de formas destruídas
  */
 int executar_cmd_d(Ponto origem,
                    Lista lista_formas,
-                   Lista lista_anteparos,
+                   Grade grade,
+                   SvgCache cache_svg,
+                   VetorSegmentos anteparos,
                    const char *dir_saida,
                    const char *nome_base,
                    const char *sufixo,
 
                    double bbox[4],
-                   const char *tipo_ordenacao,
-                   int limiar_insertion,
+                   PoligonoVisibilidade poligono,
+                   const int *visiveis,
+                   int num_visiveis,
                    Lista acumulador_poligonos,
-                   Lista acumulador_bombas);
+                   Lista acumulador_bombas,
+                   FILE *log);
 
 #endif /* CMD_D_H */
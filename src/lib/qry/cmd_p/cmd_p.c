@@ -9,8 +9,9 @@
 
 #include "cmd_p.h"
 #include "lista.h"
+#include "grade.h"
 #include "ponto.h"
-#include "segmento.h"
+#include "vetor_segmentos.h"
 #include "visibilidade.h"
 #include "formas.h"
 #include "circulo.h"
@@ -37,14 +38,14 @@ static double* poligono_para_array(PoligonoVisibilidade poligono, int *num_verti
 /**
  * Verifica se uma forma está dentro do polígono de visibilidade.
  */
-static int forma_visivel(Forma forma, double *vertices, int num_vertices)
+static int forma_visivel(Forma forma, PoligonoPreparado preparado)
 {
-    if (forma == NULL || vertices == NULL || num_vertices < 3)
+    if (forma == NULL || preparado == NULL)
     {
         return 0;
     }
     
-    return forma_no_poligono(forma, vertices, num_vertices);
+    return forma_no_poligono_preparado(forma, preparado);
 }
 
 /**
@@ -116,36 +117,27 @@ static void gerar_relatorio_txt(const char *caminho, Lista formas_pintadas, doub
 
 int executar_cmd_p(Ponto origem,
                    Lista lista_formas,
-                   Lista lista_anteparos,
+                   Grade grade,
+                   SvgCache cache_svg,
+                   VetorSegmentos anteparos,
                    const char *cor,
                    const char *dir_saida,
                    const char *nome_base,
                    const char *sufixo,
                    double bbox[4],
-                   const char *tipo_ordenacao,
-                   int limiar_insertion,
+                   PoligonoVisibilidade poligono,
                    Lista acumulador_poligonos,
-                   Lista acumulador_bombas)
+                   Lista acumulador_bombas,
+                   FILE *log)
 {
     if (origem == NULL || lista_formas == NULL || cor == NULL)
     {
+        if (poligono != NULL) destruir_poligono_visibilidade(poligono);
         return 0;
     }
     
-    /* Cria lista para rastrear segmentos visíveis (para consistência, não remove para P) */
-    Lista segmentos_visiveis = criar_lista();
-    
-    /* Calcula polígono de visibilidade COM rastreamento de segmentos */
-    PoligonoVisibilidade poligono = calcular_visibilidade_com_segmentos(
-        origem, lista_anteparos,
-        bbox[0], bbox[1], bbox[2], bbox[3],
-        tipo_ordenacao, limiar_insertion,
-        segmentos_visiveis
-    );
-    
     if (poligono == NULL)
     {
-        destruir_lista(segmentos_visiveis, NULL);
         fprintf(stderr, "Aviso: falha ao calcular visibilidade\n");
         return 0;
     }
@@ -158,24 +150,38 @@ int executar_cmd_p(Ponto origem,
     Lista formas_pintadas = criar_lista();
     int contador = 0;
     
-    No atual = obter_primeiro(lista_formas);
-    while (atual != NULL)
+    /* Caixa, faixas de arestas e cunhas em torno da bomba, calculadas uma
+     * vez para todas as formas */
+    double ox, oy;
+    PoligonoPreparado preparado = poligono_obter_origem((Poligono)poligono, &ox, &oy)
+        ? poligono_preparar_estrela(vertices, num_vertices, ox, oy)
+        : poligono_preparar(vertices, num_vertices);
+    
+    /* Só as formas cuja caixa cruza a do polígono podem ser visíveis */
+    int num_candidatas = 0;
+    Forma *candidatas = NULL;
+    double pmin_x, pmin_y, pmax_x, pmax_y;
+    if (poligono_obter_limites((Poligono)poligono, &pmin_x, &pmin_y, &pmax_x, &pmax_y))
     {
-        Forma forma = (Forma)obter_elemento(atual);
+        candidatas = grade_consultar(grade, pmin_x, pmin_y, pmax_x, pmax_y, &num_candidatas);
+    }
+    
+    for (int i = 0; i < num_candidatas; i++)
+    {
+        Forma forma = candidatas[i];
         
-        if (getFormaAtiva(forma) && forma_visivel(forma, vertices, num_vertices))
+        if (getFormaAtiva(forma) && forma_visivel(forma, preparado))
         {
             pintar_forma(forma, cor);
+            svg_cache_invalidar(cache_svg, forma);
             inserir_fim(formas_pintadas, forma);
             contador++;
         }
-        
-        atual = obter_proximo(atual);
     }
+    poligono_preparado_destruir(preparado);
     
-    /* Nota: Para P (pintura), segmentos NÃO são removidos
-     * apenas formas são pintadas. segmentos_visiveis rastreado para futura extensão */
-    destruir_lista(segmentos_visiveis, NULL);
+    /* Nota: Para P (pintura), segmentos NÃO são removidos,
+     * apenas formas são pintadas */
     
     /* Gera relatório */
     char caminho_txt[MAX_CAMINHO];
@@ -219,12 +225,12 @@ int executar_cmd_p(Ponto origem,
         {
             /* 1. Desenha as formas originais */
             svg_comentario(svg, "Formas originais do cenário");
-            svg_desenhar_lista(svg, lista_formas);
+            svg_desenhar_lista_cache(svg, lista_formas, cache_svg);
             
             /* 2. Desenha os anteparos */
-            if (lista_anteparos != NULL && !lista_vazia(lista_anteparos))
+            if (vetor_segmentos_tamanho(anteparos) > 0)
             {
-                svg_desenhar_lista_segmentos(svg, lista_anteparos);
+                svg_desenhar_segmentos_cache(svg, anteparos, cache_svg);
             }
             
             /* 3. Desenha a região de visibilidade */
@@ -236,7 +242,7 @@ int executar_cmd_p(Ponto origem,
                                5.0, "#FF0000");
             
             finalizar_svg(svg);
-            printf("          SVG gerado: %s\n", caminho_svg);
+            fprintf(log, "          SVG gerado: %s\n", caminho_svg);
         }
         /* Destroi poligono */
         destruir_poligono_visibilidade(poligono);
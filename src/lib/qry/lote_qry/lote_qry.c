@@ -0,0 +1,354 @@
+/* lote_qry.c
+ *
+ * Implementação do modo em lote de consultas.
+ * As consultas são distribuídas sob demanda, como no lote de
+ * visibilidade: cada thread retira a próxima consulta livre (contador
+ * protegido por mutex), copia a cena e processa o .qry. A thread
+ * chamadora também trabalha. Com mais de uma thread, o log de cada
+ * consulta vai para um arquivo temporário, copiado para a saída padrão
+ * sob a mesma trava quando a consulta termina.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+
+#include "lote_qry.h"
+#include "parser_qry.h"
+#include "formas.h"
+#include "lista.h"
+#include "vetor_segmentos.h"
+
+#define MAX_LINHA 1024
+#define MAX_CAMINHO 1024
+
+/* ============================================================================
+ * Estrutura Interna
+ * ============================================================================ */
+
+/* Uma consulta da lista */
+typedef struct consulta
+{
+    char caminho[MAX_CAMINHO];      /* Caminho do .qry */
+    char nome_saida[MAX_CAMINHO];   /* nome_base-nome_qry */
+    int comandos;                   /* Resultado (-1: erro) */
+} Consulta;
+
+/* Parâmetros comuns e fila de consultas */
+typedef struct lote_qry
+{
+    Consulta *consultas;
+    int num_consultas;
+
+    Lista cena;
+    const char *dir_saida;
+    double *bbox;
+    const char *tipo_ordenacao;
+    int limiar_insertion;
+    const char *motor_visibilidade;
+    double tolerancia_simplificacao;
+    int num_threads;
+    int log_separado;               /* Log de cada consulta em arquivo temporário */
+
+    pthread_mutex_t trava;
+    int proxima;                    /* Próxima consulta livre (protegida pela trava) */
+} LoteQry;
+
+/* ============================================================================
+ * Funções Auxiliares
+ * ============================================================================ */
+
+/**
+ * Remove espaços do início e fim da string.
+ */
+static char* trim(char *str)
+{
+    while (isspace((unsigned char)*str)) str++;
+    if (*str == '\0') return str;
+
+    char *end = str + strlen(str) - 1;
+    while (end > str && isspace((unsigned char)*end)) end--;
+    end[1] = '\0';
+
+    return str;
+}
+
+/**
+ * Copia o nome do arquivo sem diretório e sem extensão.
+ * Exemplo: "consultas/q1.qry" -> "q1"
+ */
+static void nome_sem_extensao(const char *caminho, char *nome, size_t tamanho)
+{
+    const char *barra = strrchr(caminho, '/');
+    snprintf(nome, tamanho, "%s", barra ? barra + 1 : caminho);
+
+    char *ponto = strrchr(nome, '.');
+    if (ponto != NULL) *ponto = '\0';
+}
+
+/**
+ * Copia a lista de formas (cada forma é clonada, com o mesmo id).
+ * @return Nova lista, ou NULL em caso de erro
+ */
+static Lista copiar_cena(Lista cena)
+{
+    Lista copia = criar_lista();
+    if (copia == NULL) return NULL;
+
+    for (No no = obter_primeiro(cena); no != NULL; no = obter_proximo(no))
+    {
+        Forma clone = clonaForma((Forma)obter_elemento(no));
+        if (clone == NULL || inserir_fim(copia, clone) == NULL)
+        {
+            if (clone != NULL) destroiForma(clone);
+            destruir_lista(copia, destroiForma);
+            return NULL;
+        }
+    }
+
+    return copia;
+}
+
+/**
+ * Lê a lista de consultas, resolvendo os caminhos e descartando repetidas.
+ * @return Número de consultas, ou -1 em caso de erro
+ */
+static int ler_lista(const char *caminho_lista, const char *dir_entrada,
+                     const char *nome_base, Consulta **consultas)
+{
+    FILE *arquivo = fopen(caminho_lista, "r");
+    if (arquivo == NULL)
+    {
+        fprintf(stderr, "Erro: não foi possível abrir a lista de consultas %s\n", caminho_lista);
+        return -1;
+    }
+
+    int n = 0, capacidade = 16;
+    Consulta *v = (Consulta*)malloc(capacidade * sizeof(Consulta));
+    if (v == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar lista de consultas\n");
+        fclose(arquivo);
+        return -1;
+    }
+
+    char linha[MAX_LINHA];
+    int num_linha = 0;
+    while (fgets(linha, sizeof(linha), arquivo) != NULL)
+    {
+        num_linha++;
+        char *nome = trim(linha);
+        if (nome[0] == '\0' || nome[0] == '#') continue;
+
+        if (n == capacidade)
+        {
+            Consulta *novo = (Consulta*)realloc(v, 2 * capacidade * sizeof(Consulta));
+            if (novo == NULL)
+            {
+                fprintf(stderr, "Erro: falha ao expandir lista de consultas\n");
+                free(v);
+                fclose(arquivo);
+                return -1;
+            }
+            v = novo;
+            capacidade *= 2;
+        }
+
+        Consulta *c = &v[n];
+        int necessario = dir_entrada != NULL
+            ? snprintf(c->caminho, MAX_CAMINHO, "%s/%s", dir_entrada, nome)
+            : snprintf(c->caminho, MAX_CAMINHO, "%s", nome);
+        if (necessario >= MAX_CAMINHO)
+        {
+            fprintf(stderr, "Aviso: caminho muito longo na linha %d da lista de consultas\n", num_linha);
+            continue;
+        }
+
+        char nome_qry[MAX_CAMINHO];
+        nome_sem_extensao(nome, nome_qry, sizeof(nome_qry));
+        snprintf(c->nome_saida, MAX_CAMINHO, "%s-%s", nome_base, nome_qry);
+        c->comandos = -1;
+
+        /* Duas consultas com o mesmo nome escreveriam nos mesmos arquivos */
+        int repetida = 0;
+        for (int i = 0; i < n && !repetida; i++)
+        {
+            repetida = strcmp(v[i].nome_saida, c->nome_saida) == 0;
+        }
+        if (repetida)
+        {
+            fprintf(stderr, "Aviso: consulta repetida ignorada na linha %d: %s\n", num_linha, nome);
+            continue;
+        }
+
+        n++;
+    }
+
+    fclose(arquivo);
+    *consultas = v;
+    return n;
+}
+
+/**
+ * Copia o log de uma consulta para a saída padrão, de uma vez.
+ */
+static void descarregar_log(FILE *log)
+{
+    char bloco[4096];
+    size_t lidos;
+
+    fflush(stdout);
+    rewind(log);
+    while ((lidos = fread(bloco, 1, sizeof(bloco), log)) > 0)
+    {
+        fwrite(bloco, 1, lidos, stdout);
+    }
+    fflush(stdout);
+}
+
+/**
+ * Executa uma consulta sobre uma cópia nova da cena.
+ */
+static void executar_consulta(LoteQry *l, Consulta *c)
+{
+    Lista formas = copiar_cena(l->cena);
+    VetorSegmentos anteparos = vetor_segmentos_criar(0);
+    if (formas == NULL || anteparos == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao preparar a consulta %s\n", c->caminho);
+        if (formas != NULL) destruir_lista(formas, destroiForma);
+        vetor_segmentos_destruir(anteparos);
+        return;
+    }
+
+    /* Sem arquivo temporário o log sai direto, misturado ao das outras */
+    FILE *log = l->log_separado ? tmpfile() : NULL;
+
+    double bbox[4] = {l->bbox[0], l->bbox[1], l->bbox[2], l->bbox[3]};
+    c->comandos = processar_arquivo_qry(c->caminho, formas, anteparos,
+                                        l->dir_saida, c->nome_saida, bbox,
+                                        l->tipo_ordenacao, l->limiar_insertion,
+                                        l->motor_visibilidade, l->tolerancia_simplificacao,
+                                        l->num_threads, log);
+
+    if (log != NULL)
+    {
+        pthread_mutex_lock(&l->trava);
+        descarregar_log(log);
+        pthread_mutex_unlock(&l->trava);
+        fclose(log);
+    }
+
+    vetor_segmentos_destruir(anteparos);
+    destruir_lista(formas, destroiForma);
+}
+
+static void* executar_trabalhador(void *arg)
+{
+    LoteQry *l = (LoteQry*)arg;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&l->trava);
+        int i = l->proxima++;
+        pthread_mutex_unlock(&l->trava);
+
+        if (i >= l->num_consultas) break;
+        executar_consulta(l, &l->consultas[i]);
+    }
+
+    return NULL;
+}
+
+/* ============================================================================
+ * Implementação
+ * ============================================================================ */
+
+int processar_lista_qry(const char *caminho_lista,
+                        const char *dir_entrada,
+                        Lista cena,
+                        const char *dir_saida,
+                        const char *nome_base,
+                        double bbox[4],
+                        const char *tipo_ordenacao,
+                        int limiar_insertion,
+                        const char *motor_visibilidade,
+                        double tolerancia_simplificacao,
+                        int num_threads,
+                        int consultas_paralelas)
+{
+    if (caminho_lista == NULL || cena == NULL || bbox == NULL)
+    {
+        fprintf(stderr, "Erro: parâmetros inválidos para o lote de consultas\n");
+        return -1;
+    }
+
+    LoteQry l;
+    l.num_consultas = ler_lista(caminho_lista, dir_entrada, nome_base, &l.consultas);
+    if (l.num_consultas < 0) return -1;
+
+    l.cena = cena;
+    l.dir_saida = dir_saida;
+    l.bbox = bbox;
+    l.tipo_ordenacao = tipo_ordenacao;
+    l.limiar_insertion = limiar_insertion;
+    l.motor_visibilidade = motor_visibilidade;
+    l.tolerancia_simplificacao = tolerancia_simplificacao;
+    l.num_threads = num_threads;
+    l.log_separado = 0;
+    l.proxima = 0;
+    pthread_mutex_init(&l.trava, NULL);
+
+    printf("    %d consultas na lista (%d em paralelo)\n", l.num_consultas,
+           consultas_paralelas > 1 ? consultas_paralelas : 1);
+
+    int num_trabalhadores = consultas_paralelas < l.num_consultas ? consultas_paralelas : l.num_consultas;
+    if (num_trabalhadores < 1) num_trabalhadores = 1;
+
+    pthread_t *threads = (pthread_t*)malloc(num_trabalhadores * sizeof(pthread_t));
+    if (threads == NULL)
+    {
+        fprintf(stderr, "Aviso: falha ao alocar threads de consultas, processando uma por vez\n");
+        num_trabalhadores = 1;
+    }
+    l.log_separado = num_trabalhadores > 1;
+    int criadas = 1;
+
+    /* Threads auxiliares 1..n-1; se alguma falhar, as demais absorvem o trabalho */
+    for (int i = 1; i < num_trabalhadores; i++)
+    {
+        if (pthread_create(&threads[i], NULL, executar_trabalhador, &l) != 0)
+        {
+            fprintf(stderr, "Aviso: falha ao criar thread de consultas\n");
+            break;
+        }
+        criadas++;
+    }
+
+    executar_trabalhador(&l);
+
+    for (int i = 1; i < criadas; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    int sucesso = 0;
+    for (int i = 0; i < l.num_consultas; i++)
+    {
+        if (l.consultas[i].comandos >= 0)
+        {
+            sucesso++;
+        }
+        else
+        {
+            fprintf(stderr, "Aviso: consulta %s não foi processada\n", l.consultas[i].caminho);
+        }
+    }
+
+    pthread_mutex_destroy(&l.trava);
+    free(l.consultas);
+    return sucesso;
+}
@@ -0,0 +1,54 @@
+/* lote_qry.h
+ *
+ * Modo em lote: várias consultas (.qry) contra a mesma cena, lida uma
+ * única vez. Cada consulta recebe a sua própria cópia da lista de formas
+ * e um vetor de anteparos vazio, como se fosse uma execução separada do
+ * programa, e gera as mesmas saídas que teria com -q.
+ *
+ * As consultas podem rodar em paralelo (pthreads): a cena original é
+ * apenas lida (na cópia) e cada consulta escreve arquivos próprios. Em
+ * paralelo, o log de progresso de cada consulta é guardado à parte e
+ * impresso inteiro quando ela termina, sem se misturar com o das outras.
+ */
+
+#ifndef LOTE_QRY_H
+#define LOTE_QRY_H
+
+#include "lista.h"
+
+/**
+ * Processa todas as consultas listadas em um arquivo.
+ *
+ * O arquivo tem um nome de .qry por linha (relativo a dir_entrada, como
+ * em -q); linhas vazias e começadas por '#' são ignoradas, e um .qry
+ * repetido é processado só uma vez.
+ *
+ * @param caminho_lista Caminho do arquivo com a lista de consultas
+ * @param dir_entrada Diretório dos .qry (NULL: caminhos usados como estão)
+ * @param cena Formas do cenário (não é modificada)
+ * @param dir_saida Diretório para arquivos de saída
+ * @param nome_base Nome base do .geo (as saídas são nome_base-nome_qry.*)
+ * @param bbox Bounding box do cenário [min_x, min_y, max_x, max_y]
+ * @param tipo_ordenacao Algoritmo de ordenação da varredura
+ * @param limiar_insertion Limiar do InsertionSort no MergeSort
+ * @param motor_visibilidade Motor de visibilidade (-vis)
+ * @param tolerancia_simplificacao Simplificação dos polígonos (-simp, 0: desligada)
+ * @param num_threads Threads das bombas em lote dentro de cada consulta
+ * @param consultas_paralelas Consultas executadas ao mesmo tempo (1 = serial)
+ * @return Número de consultas processadas com sucesso, ou -1 se a lista
+ *         não pôde ser lida
+ */
+int processar_lista_qry(const char *caminho_lista,
+                        const char *dir_entrada,
+                        Lista cena,
+                        const char *dir_saida,
+                        const char *nome_base,
+                        double bbox[4],
+                        const char *tipo_ordenacao,
+                        int limiar_insertion,
+                        const char *motor_visibilidade,
+                        double tolerancia_simplificacao,
+                        int num_threads,
+                        int consultas_paralelas);
+
+#endif /* LOTE_QRY_H */
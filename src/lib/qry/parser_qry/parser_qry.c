@@ -18,7 +18,10 @@
 #include "visibilidade.h"
 #include "svg.h"
 #include "formas.h"
-#include "segmento.h"
+#include "vetor_segmentos.h"
+#include "lote_visibilidade.h"
+#include "cache_visibilidade.h"
+#include "grade.h"
 
 #define MAX_LINHA 512
 
@@ -43,18 +46,213 @@ static char* trim(char *str)
     return str;
 }
 
+/* ============================================================================
+ * Bombas em Lote
+ * ============================================================================ */
+
+/* Bombas por thread em cada lote (limita a memória das arenas) */
+#define BOMBAS_POR_THREAD 32
+
+typedef enum
+{
+    BOMBA_D,
+    BOMBA_P,
+    BOMBA_CLN
+} TipoBomba;
+
+/* Comando de bomba já lido, aguardando o cálculo do lote */
+typedef struct bomba
+{
+    TipoBomba tipo;
+    double x, y;
+    double dx, dy;          /* cln */
+    double raio;            /* Alcance opcional (0: sem limite) */
+    char cor[50];           /* P */
+    char sufixo[100];
+} Bomba;
+
+/* Estado do processamento compartilhado pelos comandos */
+typedef struct contexto_qry
+{
+    Lista lista_formas;
+    Grade grade;            /* Índice espacial de lista_formas */
+    SvgCache cache_svg;     /* Fragmentos SVG da cena (NULL: sem cache) */
+    VetorSegmentos anteparos;
+    const char *dir_saida;
+    const char *sufixo_saida;
+    double *bbox;
+    const char *tipo_ordenacao;
+    int limiar_insertion;
+    int proximo_id;
+    Lista acumulador_poligonos;
+    Lista acumulador_bombas;
+    SvgContexto acumulado;  /* Polígonos já serializados (NULL: ficam nas listas) */
+
+    LoteVisibilidade lote;
+    CacheVisibilidade cache_vis;    /* Resultados por posição (NULL: sem cache) */
+    Bomba *pendentes;       /* Bombas do lote, na ordem do arquivo */
+    FILE *log;              /* Mensagens de progresso */
+} ContextoQry;
+
+/**
+ * Completa o log de uma bomba com o raio, se houver.
+ */
+static void imprimir_raio(FILE *log, const Bomba *b)
+{
+    if (b->raio > 0.0) fprintf(log, " raio=%.2f", b->raio);
+    fprintf(log, "\n");
+}
+
+/**
+ * Valida o raio opcional lido no fim de um comando de bomba.
+ * @param lido Se o raio estava presente na linha
+ */
+static void validar_raio(Bomba *b, int lido, int num_linha)
+{
+    if (!lido)
+    {
+        b->raio = 0.0;
+    }
+    else if (!(b->raio > 0.0))
+    {
+        fprintf(stderr, "Aviso: raio inválido na linha %d, bomba sem limite de alcance\n",
+                num_linha);
+        b->raio = 0.0;
+    }
+}
+
+/**
+ * Desenha os polígonos acumulados e suas bombas, esvaziando as listas.
+ */
+static void desenhar_acumulados(SvgContexto svg, Lista poligonos, Lista bombas)
+{
+    while (!lista_vazia(poligonos))
+    {
+        PoligonoVisibilidade poly = (PoligonoVisibilidade)remover_inicio(poligonos);
+        svg_desenhar_poligono_visibilidade(svg, poly, "none", "#FFFF00", 0.3);
+        destruir_poligono_visibilidade(poly);
+        
+        /* Desenha a bomba se disponível */
+        Ponto pt = lista_vazia(bombas) ? NULL : (Ponto)remover_inicio(bombas);
+        if (pt != NULL)
+        {
+            svg_desenhar_bomba(svg, get_ponto_x(pt), get_ponto_y(pt), 
+                               5.0, "#FF0000");
+            destruir_ponto(pt);
+        }
+    }
+}
+
+/**
+ * Calcula os polígonos das bombas pendentes e aplica os efeitos de cada
+ * uma na ordem do arquivo. Só a última bomba do lote pode alterar os
+ * anteparos, então todas enxergam o mesmo conjunto durante o cálculo.
+ * @return Número de comandos executados
+ */
+static int executar_lote(ContextoQry *ctx)
+{
+    int n = lote_visibilidade_tamanho(ctx->lote);
+    if (n == 0) return 0;
+
+    lote_visibilidade_calcular(ctx->lote, ctx->anteparos, ctx->bbox,
+                               ctx->tipo_ordenacao, ctx->limiar_insertion, ctx->cache_vis);
+
+    for (int i = 0; i < n; i++)
+    {
+        Bomba *b = &ctx->pendentes[i];
+        PoligonoVisibilidade poligono = lote_visibilidade_extrair_poligono(ctx->lote, i);
+        int num_visiveis = 0;
+        int *visiveis = lote_visibilidade_segmentos(ctx->lote, i, &num_visiveis);
+        Ponto origem = criar_ponto(b->x, b->y);
+
+        switch (b->tipo)
+        {
+            case BOMBA_D:
+            {
+                fprintf(ctx->log, "      [d] Destruição em (%.2f, %.2f) sfx=%s", b->x, b->y, b->sufixo);
+                imprimir_raio(ctx->log, b);
+                int destruidos = executar_cmd_d(origem, ctx->lista_formas, ctx->grade, ctx->cache_svg, ctx->anteparos,
+                                                ctx->dir_saida, ctx->sufixo_saida, b->sufixo, ctx->bbox,
+                                                poligono, visiveis, num_visiveis,
+                                                ctx->acumulador_poligonos, ctx->acumulador_bombas, ctx->log);
+                fprintf(ctx->log, "          %d formas destruídas\n", destruidos);
+                break;
+            }
+            case BOMBA_P:
+            {
+                fprintf(ctx->log, "      [P] Pintura em (%.2f, %.2f) cor=%s sfx=%s", b->x, b->y, b->cor, b->sufixo);
+                imprimir_raio(ctx->log, b);
+                int pintados = executar_cmd_p(origem, ctx->lista_formas, ctx->grade, ctx->cache_svg, ctx->anteparos,
+                                              b->cor, ctx->dir_saida, ctx->sufixo_saida, b->sufixo, ctx->bbox,
+                                              poligono,
+                                              ctx->acumulador_poligonos, ctx->acumulador_bombas, ctx->log);
+                fprintf(ctx->log, "          %d formas pintadas\n", pintados);
+                break;
+            }
+            case BOMBA_CLN:
+            {
+                fprintf(ctx->log, "      [cln] Clonagem em (%.2f, %.2f) delta=(%.2f, %.2f) sfx=%s", 
+                       b->x, b->y, b->dx, b->dy, b->sufixo);
+                imprimir_raio(ctx->log, b);
+                int clonados = executar_cmd_cln(origem, ctx->lista_formas, ctx->grade, ctx->cache_svg, ctx->anteparos,
+                                                b->dx, b->dy, ctx->dir_saida, ctx->sufixo_saida, b->sufixo,
+                                                ctx->bbox, &ctx->proximo_id,
+                                                poligono, visiveis, num_visiveis,
+                                                ctx->acumulador_poligonos, ctx->acumulador_bombas, ctx->log);
+                fprintf(ctx->log, "          %d formas clonadas\n", clonados);
+                break;
+            }
+        }
+
+        destruir_ponto(origem);
+    }
+
+    lote_visibilidade_limpar(ctx->lote);
+    
+    /* Os polígonos do SVG principal vão para o disco a cada lote, então a
+     * memória não cresce com o número de comandos */
+    if (ctx->acumulado != NULL)
+    {
+        desenhar_acumulados(ctx->acumulado, ctx->acumulador_poligonos, ctx->acumulador_bombas);
+    }
+    return n;
+}
+
+/**
+ * Enfileira uma bomba no lote. O lote é executado quando enche ou quando
+ * a bomba altera os anteparos (d remove, cln clona), pois as seguintes
+ * precisam enxergar o conjunto atualizado.
+ * @return Número de comandos executados
+ */
+static int enfileirar_bomba(ContextoQry *ctx, const Bomba *bomba)
+{
+    int i = lote_visibilidade_adicionar(ctx->lote, bomba->x, bomba->y, bomba->raio,
+                                        bomba->tipo != BOMBA_P);
+    ctx->pendentes[i] = *bomba;
+
+    if (bomba->tipo != BOMBA_P || lote_visibilidade_cheio(ctx->lote))
+    {
+        return executar_lote(ctx);
+    }
+    return 0;
+}
+
 /* ============================================================================
  * Implementação
  * ============================================================================ */
 
 int processar_arquivo_qry(const char *caminho_qry,
                           Lista lista_formas,
-                          Lista lista_anteparos,
+                          VetorSegmentos anteparos,
                           const char *dir_saida,
                           const char *sufixo_saida, // Renamed from nome_base
                           double bbox[4],
                           const char *tipo_ordenacao, // Renamed from algoritmo_ordenacao
-                          int limiar_insertion) // Added
+                          int limiar_insertion, // Added
+                          const char *motor_visibilidade,
+                          double tolerancia_simplificacao,
+                          int num_threads,
+                          FILE *log)
 {
     if (caminho_qry == NULL)
     {
@@ -69,15 +267,54 @@ int processar_arquivo_qry(const char *caminho_qry,
         return -1;
     }
     
+    if (num_threads < 1) num_threads = 1;
+    if (log == NULL) log = stdout;
+    
+    /* Com uma thread cada bomba é calculada e aplicada sozinha (serial) */
+    int capacidade_lote = (num_threads > 1) ? num_threads * BOMBAS_POR_THREAD : 1;
+    
+    ContextoQry ctx;
+    ctx.log = log;
+    ctx.lista_formas = lista_formas;
+    ctx.grade = grade_criar_de_lista(lista_formas);
+    ctx.cache_svg = svg_cache_criar();  /* Opcional: sem ele os SVGs saem sem cache */
+    ctx.anteparos = anteparos;
+    ctx.dir_saida = dir_saida;
+    ctx.sufixo_saida = sufixo_saida;
+    ctx.bbox = bbox;
+    ctx.tipo_ordenacao = tipo_ordenacao;
+    ctx.limiar_insertion = limiar_insertion;
+    ctx.proximo_id = 10000; /* IDs para clones */
+    MotorVisibilidade motor = motor_por_nome(motor_visibilidade);
+    ctx.lote = lote_visibilidade_criar(num_threads, capacidade_lote, motor);
+    lote_visibilidade_definir_simplificacao(ctx.lote, tolerancia_simplificacao);
+    ctx.cache_vis = cache_visibilidade_criar(0);  /* Opcional, como o cache de SVG */
+    ctx.pendentes = (Bomba*)malloc(capacidade_lote * sizeof(Bomba));
+    
+    if (ctx.grade == NULL || ctx.lote == NULL || ctx.pendentes == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar lote de bombas\n");
+        grade_destruir(ctx.grade);
+        svg_cache_destruir(ctx.cache_svg);
+        lote_visibilidade_destruir(ctx.lote);
+        cache_visibilidade_destruir(ctx.cache_vis);
+        free(ctx.pendentes);
+        fclose(arquivo);
+        return -1;
+    }
+    
     char linha[MAX_LINHA];
     int num_comandos = 0;
     int num_linha = 0;
-    int proximo_id = 10000; /* IDs para clones */
     
     /* Lista acumuladora de polígonos de visibilidade para o SVG principal */
     Lista acumulador_poligonos = criar_lista();
     /* Lista acumuladora de pontos (bombas) correspondentes aos polígonos */
     Lista acumulador_bombas = criar_lista();
+    ctx.acumulador_poligonos = acumulador_poligonos;
+    ctx.acumulador_bombas = acumulador_bombas;
+    /* Opcional: sem o temporário, os polígonos ficam nas listas até o fim */
+    ctx.acumulado = criar_svg_fragmento();
     
     /* Limpa arquivo de relatório anterior, se existir */
     {
@@ -86,7 +323,7 @@ int processar_arquivo_qry(const char *caminho_qry,
         remove(caminho_txt);
     }
     
-    printf("    Processando comandos...\n");
+    fprintf(log, "    Processando comandos...\n");
     
     while (fgets(linha, MAX_LINHA, arquivo) != NULL)
     {
@@ -99,6 +336,8 @@ int processar_arquivo_qry(const char *caminho_qry,
             continue;
         }
         
+        Bomba bomba;
+        
         /* Identifica o comando */
         if (linha_limpa[0] == 'a' && isspace((unsigned char)linha_limpa[1]))
         {
@@ -109,13 +348,16 @@ int processar_arquivo_qry(const char *caminho_qry,
             int lidos = sscanf(linha_limpa, "a %d %d %c", &id_inicio, &id_fim, &orientacao);
             if (lidos >= 2)
             {
-                printf("[8] Processando arquivo .qry: %s (Ordenação: %s, Limiar: %d)\n", 
+                /* As bombas anteriores enxergam os anteparos de antes do 'a' */
+                num_comandos += executar_lote(&ctx);
+                
+                fprintf(log, "[8] Processando arquivo .qry: %s (Ordenação: %s, Limiar: %d)\n", 
            caminho_qry, tipo_ordenacao ? tipo_ordenacao : "padrão", limiar_insertion);
                        
-                int convertidos = executar_cmd_a(lista_formas, lista_anteparos, 
+                int convertidos = executar_cmd_a(lista_formas, ctx.grade, anteparos, 
                                                   id_inicio, id_fim, orientacao,
-                                                  &proximo_id, dir_saida, sufixo_saida, sufixo_saida);
-                printf("          %d formas convertidas\n", convertidos);
+                                                  &ctx.proximo_id, dir_saida, sufixo_saida, sufixo_saida);
+                fprintf(log, "          %d formas convertidas\n", convertidos);
                 num_comandos++;
             }
             else
@@ -126,24 +368,14 @@ int processar_arquivo_qry(const char *caminho_qry,
         }
         else if (linha_limpa[0] == 'd' && isspace((unsigned char)linha_limpa[1]))
         {
-            /* Comando 'd x y sfx' */
-            double x, y;
-            char sufixo_cmd[100]; // Renamed to avoid conflict with function parameter
-            
-            int lidos = sscanf(linha_limpa, "d %lf %lf %99s", &x, &y, sufixo_cmd);
-            if (lidos == 3)
+            /* Comando 'd x y sfx [raio]' */
+            bomba.tipo = BOMBA_D;
+            int lidos = sscanf(linha_limpa, "d %lf %lf %99s %lf",
+                               &bomba.x, &bomba.y, bomba.sufixo, &bomba.raio);
+            if (lidos >= 3)
             {
-                printf("      [d] Destruição em (%.2f, %.2f) sfx=%s\n", x, y, sufixo_cmd);
-                
-                Ponto origem = criar_ponto(x, y);
-                int destruidos = executar_cmd_d(origem, lista_formas, lista_anteparos,
-                                             dir_saida, sufixo_saida, sufixo_cmd, bbox,
-                                             tipo_ordenacao, limiar_insertion, 
-                                             acumulador_poligonos, acumulador_bombas);
-                destruir_ponto(origem);
-                
-                printf("          %d formas destruídas\n", destruidos);
-                num_comandos++;
+                validar_raio(&bomba, lidos == 4, num_linha);
+                num_comandos += enfileirar_bomba(&ctx, &bomba);
             }
             else
             {
@@ -153,25 +385,16 @@ int processar_arquivo_qry(const char *caminho_qry,
         }
         else if ((linha_limpa[0] == 'P' || linha_limpa[0] == 'p') && isspace((unsigned char)linha_limpa[1]))
         {
-            /* Comando 'P x y cor sfx' ou 'p x y cor sfx' */
-            double x, y;
-            char cor[50], sufixo_cmd[100]; // Renamed to avoid conflict with function parameter
+            /* Comando 'P x y cor sfx [raio]' ou 'p x y cor sfx [raio]' */
+            bomba.tipo = BOMBA_P;
             
             /* Pula o primeiro caractere (P ou p) e o espaço */
-            int lidos = sscanf(linha_limpa + 2, "%lf %lf %49s %99s", &x, &y, cor, sufixo_cmd);
-            if (lidos == 4)
+            int lidos = sscanf(linha_limpa + 2, "%lf %lf %49s %99s %lf",
+                               &bomba.x, &bomba.y, bomba.cor, bomba.sufixo, &bomba.raio);
+            if (lidos >= 4)
             {
-                printf("      [P] Pintura em (%.2f, %.2f) cor=%s sfx=%s\n", x, y, cor, sufixo_cmd);
-                
-                Ponto origem = criar_ponto(x, y);
-                int pintados = executar_cmd_p(origem, lista_formas, lista_anteparos,
-                                           cor, dir_saida, sufixo_saida, sufixo_cmd, bbox,
-                                           tipo_ordenacao, limiar_insertion,
-                                           acumulador_poligonos, acumulador_bombas);
-                destruir_ponto(origem);
-                
-                printf("          %d formas pintadas\n", pintados);
-                num_comandos++;
+                validar_raio(&bomba, lidos == 5, num_linha);
+                num_comandos += enfileirar_bomba(&ctx, &bomba);
             }
             else
             {
@@ -181,26 +404,14 @@ int processar_arquivo_qry(const char *caminho_qry,
         }
         else if (strncmp(linha_limpa, "cln", 3) == 0 && isspace((unsigned char)linha_limpa[3]))
         {
-            /* Comando 'cln x y dx dy sfx' */
-            double x, y, dx, dy;
-            char sufixo_cmd[100]; // Renamed to avoid conflict with function parameter
-            
-            int lidos = sscanf(linha_limpa, "cln %lf %lf %lf %lf %99s", &x, &y, &dx, &dy, sufixo_cmd);
-            if (lidos == 5)
+            /* Comando 'cln x y dx dy sfx [raio]' */
+            bomba.tipo = BOMBA_CLN;
+            int lidos = sscanf(linha_limpa, "cln %lf %lf %lf %lf %99s %lf",
+                               &bomba.x, &bomba.y, &bomba.dx, &bomba.dy, bomba.sufixo, &bomba.raio);
+            if (lidos >= 5)
             {
-                printf("      [cln] Clonagem em (%.2f, %.2f) delta=(%.2f, %.2f) sfx=%s\n", 
-                       x, y, dx, dy, sufixo_cmd);
-                
-                Ponto origem = criar_ponto(x, y);
-                int clonados = executar_cmd_cln(origem, lista_formas, lista_anteparos,
-                                             dx, dy, dir_saida, sufixo_saida, sufixo_cmd,
-                                             bbox, &proximo_id,
-                                             tipo_ordenacao, limiar_insertion,
-                                             acumulador_poligonos, acumulador_bombas);
-                destruir_ponto(origem);
-                
-                printf("          %d formas clonadas\n", clonados);
-                num_comandos++;
+                validar_raio(&bomba, lidos == 6, num_linha);
+                num_comandos += enfileirar_bomba(&ctx, &bomba);
             }
             else
             {
@@ -217,6 +428,33 @@ int processar_arquivo_qry(const char *caminho_qry,
     
     fclose(arquivo);
     
+    /* Bombas P restantes no fim do arquivo */
+    num_comandos += executar_lote(&ctx);
+    if (motor == MOTOR_EXPANSAO)
+    {
+        int expandidas, recusadas;
+        lote_visibilidade_estatisticas_expansao(ctx.lote, &expandidas, &recusadas);
+        fprintf(log, "    Expansão triangular: %d bombas, %d pela varredura\n", expandidas, recusadas);
+    }
+    if (tolerancia_simplificacao > 0.0)
+    {
+        long antes, depois;
+        lote_visibilidade_estatisticas_simplificacao(ctx.lote, &antes, &depois);
+        fprintf(log, "    Simplificação: %ld -> %ld vértices (%.1f%% removidos)\n", antes, depois,
+               antes > 0 ? 100.0 * (antes - depois) / antes : 0.0);
+    }
+
+    lote_visibilidade_destruir(ctx.lote);
+    free(ctx.pendentes);
+    grade_destruir(ctx.grade);
+
+    if (ctx.cache_vis != NULL)
+    {
+        fprintf(log, "    Cache de visibilidade: %d acertos, %d falhas\n",
+               cache_visibilidade_acertos(ctx.cache_vis), cache_visibilidade_falhas(ctx.cache_vis));
+        cache_visibilidade_destruir(ctx.cache_vis);
+    }
+    
     /* ============================================================================
      * Geração do SVG Principal (Acumulado)
      * ============================================================================ */
@@ -234,28 +472,22 @@ int processar_arquivo_qry(const char *caminho_qry,
             double view_max_x = bbox[2];
             double view_max_y = bbox[3];
             
-            if (lista_anteparos != NULL && !lista_vazia(lista_anteparos))
+            int num_anteparos = vetor_segmentos_tamanho(anteparos);
+            for (int i = 0; i < num_anteparos; i++)
             {
-                No seg_node = obter_primeiro(lista_anteparos);
-                while (seg_node != NULL)
-                {
-                    Segmento seg = (Segmento)obter_elemento(seg_node);
-                    double x1 = get_segmento_x1(seg);
-                    double y1 = get_segmento_y1(seg);
-                    double x2 = get_segmento_x2(seg);
-                    double y2 = get_segmento_y2(seg);
-                    
-                    if (x1 < view_min_x) view_min_x = x1;
-                    if (x2 < view_min_x) view_min_x = x2;
-                    if (y1 < view_min_y) view_min_y = y1;
-                    if (y2 < view_min_y) view_min_y = y2;
-                    if (x1 > view_max_x) view_max_x = x1;
-                    if (x2 > view_max_x) view_max_x = x2;
-                    if (y1 > view_max_y) view_max_y = y1;
-                    if (y2 > view_max_y) view_max_y = y2;
-                    
-                    seg_node = obter_proximo(seg_node);
-                }
+                double x1 = vetor_segmentos_x1(anteparos, i);
+                double y1 = vetor_segmentos_y1(anteparos, i);
+                double x2 = vetor_segmentos_x2(anteparos, i);
+                double y2 = vetor_segmentos_y2(anteparos, i);
+                
+                if (x1 < view_min_x) view_min_x = x1;
+                if (x2 < view_min_x) view_min_x = x2;
+                if (y1 < view_min_y) view_min_y = y1;
+                if (y2 < view_min_y) view_min_y = y2;
+                if (x1 > view_max_x) view_max_x = x1;
+                if (x2 > view_max_x) view_max_x = x2;
+                if (y1 > view_max_y) view_max_y = y1;
+                if (y2 > view_max_y) view_max_y = y2;
             }
             
             double margem = 10.0;
@@ -271,42 +503,25 @@ int processar_arquivo_qry(const char *caminho_qry,
             {
                 /* 1. Desenha formas (estado final) */
                 svg_comentario(svg, "Estado Final das Formas");
-                svg_desenhar_lista(svg, lista_formas);
+                svg_desenhar_lista_cache(svg, lista_formas, ctx.cache_svg);
                 
                 /* 2. Desenha anteparos */
-                if (lista_anteparos != NULL && !lista_vazia(lista_anteparos))
+                if (vetor_segmentos_tamanho(anteparos) > 0)
                 {
-                    svg_desenhar_lista_segmentos(svg, lista_anteparos);
+                    svg_desenhar_segmentos_cache(svg, anteparos, ctx.cache_svg);
                 }
                 
                 /* 3. Desenha TODOS os polígonos acumulados E suas bombas */
                 svg_comentario(svg, "Poligonos de Visibilidade Acumulados");
                 
-                No node_poly = obter_primeiro(acumulador_poligonos);
-                No node_bomba = obter_primeiro(acumulador_bombas);
-                
-                while (node_poly != NULL)
+                if (ctx.acumulado != NULL)
                 {
-                    PoligonoVisibilidade poly = (PoligonoVisibilidade)obter_elemento(node_poly);
-                    svg_desenhar_poligono_visibilidade(svg, poly, "none", "#FFFF00", 0.3);
-                    
-                    /* Desenha a bomba se disponível */
-                    if (node_bomba != NULL)
-                    {
-                        Ponto pt = (Ponto)obter_elemento(node_bomba);
-                        if (pt != NULL)
-                        {
-                            svg_desenhar_bomba(svg, get_ponto_x(pt), get_ponto_y(pt), 
-                                               5.0, "#FF0000");
-                        }
-                        node_bomba = obter_proximo(node_bomba);
-                    }
-                    
-                    node_poly = obter_proximo(node_poly);
+                    svg_anexar_fragmento(svg, ctx.acumulado);
                 }
+                desenhar_acumulados(svg, acumulador_poligonos, acumulador_bombas);
                 
                 finalizar_svg(svg);
-                printf("    [OK] SVG Principal gerado: %s\n", caminho_svg);
+                fprintf(log, "    [OK] SVG Principal gerado: %s\n", caminho_svg);
             }
         }
         
@@ -316,6 +531,10 @@ int processar_arquivo_qry(const char *caminho_qry,
         destruir_lista(acumulador_bombas, destruir_ponto);
     }
     
-    printf("    Total: %d comandos processados\n", num_comandos);
+    finalizar_svg(ctx.acumulado);
+    
+    svg_cache_destruir(ctx.cache_svg);
+    
+    fprintf(log, "    Total: %d comandos processados\n", num_comandos);
     return num_comandos;
 }
@@ -7,28 +7,42 @@
 #ifndef PARSER_QRY_H
 #define PARSER_QRY_H
 
+#include <stdio.h>
+
 #include "lista.h"
+#include "vetor_segmentos.h"
 
 /**
  * Processa um arquivo .qry completo.
  * 
  * @param caminho_qry Caminho do arquivo .qry
  * @param lista_formas Lista de formas do cenário (pode ser modificada)
- * @param lista_anteparos Lista de segmentos bloqueantes (será populada)
+ * @param anteparos Vetor de segmentos bloqueantes (será populado)
  * @param dir_saida Diretório para arquivos de saída
  * @param nome_base Nome base para arquivos de saída
  * @param bbox Bounding box do cenário [min_x, min_y, max_x, max_y]
  * @param algoritmo_ordenacao Algoritmo a ser usado
+ * @param motor_visibilidade Motor de visibilidade: "varredura" (padrão) ou
+ *                           "expansao" (ver motor_por_nome)
+ * @param tolerancia_simplificacao Tolerância de poligono_simplificar nos
+ *                                 polígonos de visibilidade (<= 0: sem simplificação)
+ * @param num_threads Threads para calcular em paralelo as bombas consecutivas
+ *                    que não dependem umas das outras (1 = serial)
+ * @param log Destino das mensagens de progresso (NULL: stdout)
  * @return Número de comandos processados, ou -1 em caso de erro
  */
 int processar_arquivo_qry(const char *caminho_qry,
                           Lista lista_formas,
-                          Lista lista_anteparos,
+                          VetorSegmentos anteparos,
                           const char *dir_saida,
                           const char *nome_base,
 
                           double bbox[4],
                           const char *tipo_ordenacao,
-                          int limiar_insertion);
+                          int limiar_insertion,
+                          const char *motor_visibilidade,
+                          double tolerancia_simplificacao,
+                          int num_threads,
+                          FILE *log);
 
 #endif /* PARSER_QRY_H */
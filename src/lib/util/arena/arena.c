@@ -0,0 +1,189 @@
+/* arena.c
+ *
+ * Implementação do TAD Arena de Memória
+ * Lista encadeada de pedaços; a alocação avança um deslocamento dentro
+ * do pedaço atual e abre um novo pedaço (o dobro do anterior) quando
+ * ele não comporta o bloco.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "arena.h"
+
+#define CAPACIDADE_PADRAO (64 * 1024)
+#define ALINHAMENTO 16
+
+/* ============================================================================
+ * Estrutura Interna
+ * ============================================================================ */
+
+/* Pedaço de memória (o cabeçalho ocupa o início do próprio bloco) */
+typedef struct pedaco
+{
+    struct pedaco *anterior;
+    size_t capacidade;
+    size_t usado;
+} Pedaco;
+
+typedef struct arena_internal
+{
+    Pedaco *atual;          /* Pedaço em uso (cabeça da lista) */
+    size_t capacidade_base; /* Capacidade do primeiro pedaço */
+    size_t usado_total;     /* Bytes entregues desde o último reset */
+} ArenaInternal;
+
+/* Tamanho do cabeçalho arredondado para manter os dados alinhados */
+#define TAM_CABECALHO ((sizeof(Pedaco) + ALINHAMENTO - 1) & ~(size_t)(ALINHAMENTO - 1))
+
+/* ============================================================================
+ * Funções Auxiliares
+ * ============================================================================ */
+
+static size_t alinhar(size_t bytes)
+{
+    return (bytes + ALINHAMENTO - 1) & ~(size_t)(ALINHAMENTO - 1);
+}
+
+static Pedaco* criar_pedaco(size_t capacidade, Pedaco *anterior)
+{
+    Pedaco *p = (Pedaco*)malloc(TAM_CABECALHO + capacidade);
+    if (p == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar pedaço da arena.\n");
+        return NULL;
+    }
+
+    p->anterior = anterior;
+    p->capacidade = capacidade;
+    p->usado = 0;
+    return p;
+}
+
+static void liberar_pedacos(Pedaco *p)
+{
+    while (p != NULL)
+    {
+        Pedaco *anterior = p->anterior;
+        free(p);
+        p = anterior;
+    }
+}
+
+/* ============================================================================
+ * Implementação das Funções de Criação e Destruição
+ * ============================================================================ */
+
+Arena arena_criar(size_t capacidade_inicial)
+{
+    ArenaInternal *a = (ArenaInternal*)malloc(sizeof(ArenaInternal));
+    if (a == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar arena.\n");
+        return NULL;
+    }
+
+    a->capacidade_base = alinhar(capacidade_inicial > 0 ? capacidade_inicial : CAPACIDADE_PADRAO);
+    a->atual = NULL;
+    a->usado_total = 0;
+
+    return (Arena)a;
+}
+
+void arena_destruir(Arena arena)
+{
+    ArenaInternal *a = (ArenaInternal*)arena;
+    if (a == NULL) return;
+
+    liberar_pedacos(a->atual);
+    free(a);
+}
+
+/* ============================================================================
+ * Implementação das Funções de Alocação
+ * ============================================================================ */
+
+#ifdef ARENA_MALLOC
+
+/* Caminho de comparação: um pedaço (malloc) por bloco */
+void* arena_alocar(Arena arena, size_t bytes)
+{
+    ArenaInternal *a = (ArenaInternal*)arena;
+    if (a == NULL) return NULL;
+
+    Pedaco *p = criar_pedaco(bytes, a->atual);
+    if (p == NULL) return NULL;
+
+    p->usado = bytes;
+    a->atual = p;
+    a->usado_total += bytes;
+    return (char*)p + TAM_CABECALHO;
+}
+
+void arena_resetar(Arena arena)
+{
+    ArenaInternal *a = (ArenaInternal*)arena;
+    if (a == NULL) return;
+
+    liberar_pedacos(a->atual);
+    a->atual = NULL;
+    a->usado_total = 0;
+}
+
+#else
+
+void* arena_alocar(Arena arena, size_t bytes)
+{
+    ArenaInternal *a = (ArenaInternal*)arena;
+    if (a == NULL) return NULL;
+
+    bytes = alinhar(bytes > 0 ? bytes : 1);
+
+    Pedaco *p = a->atual;
+    if (p == NULL || p->capacidade - p->usado < bytes)
+    {
+        size_t capacidade = (p != NULL) ? p->capacidade * 2 : a->capacidade_base;
+        if (capacidade < bytes) capacidade = bytes;
+
+        p = criar_pedaco(capacidade, a->atual);
+        if (p == NULL) return NULL;
+        a->atual = p;
+    }
+
+    void *bloco = (char*)p + TAM_CABECALHO + p->usado;
+    p->usado += bytes;
+    a->usado_total += bytes;
+    return bloco;
+}
+
+void arena_resetar(Arena arena)
+{
+    ArenaInternal *a = (ArenaInternal*)arena;
+    if (a == NULL || a->atual == NULL) return;
+
+    if (a->atual->anterior != NULL)
+    {
+        /* Funde os pedaços: a próxima consulta do mesmo porte cabe em um só */
+        size_t total = 0;
+        for (Pedaco *p = a->atual; p != NULL; p = p->anterior)
+        {
+            total += p->capacidade;
+        }
+
+        liberar_pedacos(a->atual);
+        a->atual = criar_pedaco(total, NULL);
+    }
+    else
+    {
+        a->atual->usado = 0;
+    }
+
+    a->usado_total = 0;
+}
+
+#endif /* ARENA_MALLOC */
+
+size_t arena_usado(Arena arena)
+{
+    ArenaInternal *a = (ArenaInternal*)arena;
+    return a ? a->usado_total : 0;
+}
@@ -0,0 +1,65 @@
+/* arena.h
+ *
+ * TAD Arena de Memória
+ * Alocador por região para temporários de uma consulta: os blocos são
+ * entregues em sequência a partir de um pedaço grande e liberados todos
+ * de uma vez com arena_resetar. Não há liberação individual.
+ *
+ * Compilando com -DARENA_MALLOC (make ARENA=malloc), cada bloco vem de
+ * um malloc próprio e é liberado no reset, para comparação com o
+ * caminho de alocação individual.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/* Tipo opaco para Arena */
+typedef void* Arena;
+
+/* ============================================================================
+ * Funções de Criação e Destruição
+ * ============================================================================ */
+
+/**
+ * Cria uma arena vazia.
+ * @param capacidade_inicial Tamanho em bytes do primeiro pedaço (0 usa um valor padrão)
+ * @return Nova arena, ou NULL em caso de erro
+ */
+Arena arena_criar(size_t capacidade_inicial);
+
+/**
+ * Destroi a arena e toda a memória entregue por ela.
+ * @param arena Arena a ser destruída
+ */
+void arena_destruir(Arena arena);
+
+/* ============================================================================
+ * Funções de Alocação
+ * ============================================================================ */
+
+/**
+ * Aloca um bloco alinhado da arena.
+ * @param arena Arena de origem
+ * @param bytes Tamanho do bloco
+ * @return Ponteiro para o bloco, ou NULL em caso de erro
+ *
+ * @note O bloco é válido até o próximo arena_resetar/arena_destruir.
+ */
+void* arena_alocar(Arena arena, size_t bytes);
+
+/**
+ * Libera de uma vez todos os blocos entregues pela arena.
+ * Se a consulta precisou de mais de um pedaço, eles são fundidos em um
+ * único pedaço do tamanho total, que é reaproveitado pelas próximas.
+ * @param arena Arena a ser reiniciada
+ */
+void arena_resetar(Arena arena);
+
+/**
+ * Obtém o total de bytes entregues desde o último reset.
+ */
+size_t arena_usado(Arena arena);
+
+#endif /* ARENA_H */
@@ -15,12 +15,11 @@
 
 /**
  * Insertion Sort para pequenos arrays/subarrays.
+ * @param temp Área com espaço para um elemento
  */
-static void insertion_sort(char *base, size_t nmemb, size_t size, FuncaoComparacao compar)
+static void insertion_sort(char *base, size_t nmemb, size_t size, FuncaoComparacao compar,
+                           char *temp)
 {
-    char *temp = (char*)malloc(size);
-    if (temp == NULL) return;
-
     for (size_t i = 1; i < nmemb; i++)
     {
         memcpy(temp, base + i * size, size);
@@ -34,8 +33,6 @@ static void insertion_sort(char *base, size_t nmemb, size_t size, FuncaoComparac
         
         memcpy(base + j * size, temp, size);
     }
-    
-    free(temp);
 }
 
 /**
@@ -94,7 +91,8 @@ static void mergesort_recursivo(char *base, size_t left, size_t right,
     /* Caso base: array pequeno, usa Insertion Sort */
     if ((int)n <= limiar)
     {
-        insertion_sort(base + left * size, n, size, compar);
+        /* aux não guarda nada entre as intercalações: serve de temporário */
+        insertion_sort(base + left * size, n, size, compar, aux);
         return;
     }
     
@@ -136,7 +134,8 @@ static void mergesort_hibrido(void *base, size_t nmemb, size_t size, FuncaoCompa
 void ordenar(void *base, size_t nmemb, size_t size, 
              FuncaoComparacao compar, AlgoritmoOrdenacao alg, int limiar)
 {
-    if (alg == ALG_MERGESORT)
+    /* Sem chave numérica, o radix recai no MergeSort (mesma ordem estável) */
+    if (alg == ALG_MERGESORT || alg == ALG_RADIXSORT)
     {
         mergesort_hibrido(base, nmemb, size, compar, limiar);
     }
@@ -146,3 +145,77 @@ void ordenar(void *base, size_t nmemb, size_t size,
         qsort(base, nmemb, size, compar);
     }
 }
+
+AlgoritmoOrdenacao algoritmo_por_nome(const char *nome)
+{
+    if (nome == NULL) return ALG_QSORT;
+    
+    if (strcmp(nome, "m") == 0 || strcmp(nome, "mergesort") == 0)
+    {
+        return ALG_MERGESORT;
+    }
+    if (strcmp(nome, "r") == 0 || strcmp(nome, "radix") == 0 ||
+        strcmp(nome, "radixsort") == 0)
+    {
+        return ALG_RADIXSORT;
+    }
+    return ALG_QSORT;
+}
+
+void ordenar_radix_chaves(uint64_t *chaves, uint32_t *indices, size_t n,
+                          uint64_t *aux_chaves, uint32_t *aux_indices)
+{
+    if (n < 2) return;
+    
+    /* Bytes em que todas as chaves coincidem não precisam de passada */
+    uint64_t e = chaves[0], ou = chaves[0];
+    for (size_t i = 1; i < n; i++)
+    {
+        e &= chaves[i];
+        ou |= chaves[i];
+    }
+    uint64_t variam = e ^ ou;
+    
+    /* Alterna entre os vetores originais e os auxiliares a cada passada */
+    uint64_t *ch = chaves, *ch_dest = aux_chaves;
+    uint32_t *ind = indices, *ind_dest = aux_indices;
+    
+    for (int byte = 0; byte < 8; byte++)
+    {
+        int desloc = byte * 8;
+        if (((variam >> desloc) & 0xFF) == 0) continue;
+        
+        size_t contagem[256];
+        memset(contagem, 0, sizeof(contagem));
+        for (size_t i = 0; i < n; i++)
+        {
+            contagem[(ch[i] >> desloc) & 0xFF]++;
+        }
+        
+        /* Posições iniciais de cada balde */
+        size_t soma = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            size_t c = contagem[b];
+            contagem[b] = soma;
+            soma += c;
+        }
+        
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t pos = contagem[(ch[i] >> desloc) & 0xFF]++;
+            ch_dest[pos] = ch[i];
+            ind_dest[pos] = ind[i];
+        }
+        
+        uint64_t *tc = ch; ch = ch_dest; ch_dest = tc;
+        uint32_t *ti = ind; ind = ind_dest; ind_dest = ti;
+    }
+    
+    /* Resultado ficou nos auxiliares: copia de volta */
+    if (ch != chaves)
+    {
+        memcpy(chaves, ch, n * sizeof(uint64_t));
+        memcpy(indices, ind, n * sizeof(uint32_t));
+    }
+}
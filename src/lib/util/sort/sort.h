@@ -1,18 +1,26 @@
 /* sort.h
  *
  * Módulo de ordenação genérica.
- * Suporta QSort e MergeSort Híbrido (Merge + Insertion).
+ * Suporta QSort, MergeSort Híbrido (Merge + Insertion) e RadixSort.
+ *
+ * Além da interface genérica (void* + comparador), a macro
+ * SORT_DEFINIR_TIPADO gera ordenações especializadas para um tipo
+ * concreto, com comparação inline e cópia por atribuição.
  */
 
 #ifndef SORT_H
 #define SORT_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* Tipos de algoritmos de ordenação */
 typedef enum {
     ALG_QSORT,
-    ALG_MERGESORT
+    ALG_MERGESORT,
+    ALG_RADIXSORT      /* Apenas nas ordenações tipadas (chave numérica) */
 } AlgoritmoOrdenacao;
 
 /* Tipo para função de comparação (estilo qsort) */
@@ -31,4 +39,171 @@ typedef int (*FuncaoComparacao)(const void*, const void*);
 void ordenar(void *base, size_t nmemb, size_t size, 
              FuncaoComparacao compar, AlgoritmoOrdenacao alg, int limiar);
 
+/**
+ * Converte o nome dado em -to para o algoritmo.
+ * Aceita "q"/"qsort", "m"/"mergesort" e "r"/"radix"/"radixsort".
+ * @param nome Nome do algoritmo (NULL = qsort)
+ * @return Algoritmo correspondente (ALG_QSORT se desconhecido)
+ */
+AlgoritmoOrdenacao algoritmo_por_nome(const char *nome);
+
+/**
+ * Ordena pares (chave, índice) pela chave, de forma estável.
+ * LSD radix de 8 bits, pulando as passadas em que todas as chaves
+ * têm o mesmo byte.
+ * @param chaves Chaves (reordenadas no lugar)
+ * @param indices Índices que acompanham as chaves
+ * @param n Número de pares
+ * @param aux_chaves Área auxiliar com espaço para n chaves
+ * @param aux_indices Área auxiliar com espaço para n índices
+ */
+void ordenar_radix_chaves(uint64_t *chaves, uint32_t *indices, size_t n,
+                          uint64_t *aux_chaves, uint32_t *aux_indices);
+
+/**
+ * Converte um double não negativo em chave inteira com a mesma ordem.
+ */
+static inline uint64_t sort_chave_double(double valor)
+{
+    uint64_t bits;
+    memcpy(&bits, &valor, sizeof(bits));
+    return bits;
+}
+
+/* ============================================================================
+ * Ordenações Tipadas
+ * ============================================================================ */
+
+/* Limiar de inserção do acabamento do radix */
+#define SORT_LIMIAR_ACABAMENTO 16
+
+/**
+ * Bytes de memória de trabalho para ordenar n elementos de Tipo com
+ * PREFIXO_ordenar (cobre qualquer um dos algoritmos).
+ */
+#define SORT_TRABALHO_BYTES(Tipo, n) \
+    ((size_t)(n) * (sizeof(Tipo) + 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t)) + sizeof(uint64_t))
+
+/**
+ * Gera ordenações especializadas para Tipo:
+ *
+ *   static void PREFIXO_ordenar(Tipo *v, size_t n, AlgoritmoOrdenacao alg,
+ *                               int limiar, FuncaoComparacao compar,
+ *                               void *trabalho);
+ *
+ * MENOR(const Tipo*, const Tipo*) diz se o primeiro vem estritamente
+ * antes; CHAVE(const Tipo*) devolve uma chave uint64_t monótona com a
+ * ordem (igual ou menor para elementos que MENOR ordena como iguais ou
+ * quase iguais). compar é o comparador equivalente, usado em ALG_QSORT
+ * (qsort da libc). trabalho deve ter SORT_TRABALHO_BYTES(Tipo, n) bytes
+ * ou ser NULL (aloca internamente).
+ *
+ * ALG_MERGESORT e ALG_RADIXSORT são estáveis e produzem a mesma ordem.
+ * O radix ordena pela chave e termina com um MergeSort por MENOR sobre o
+ * vetor quase ordenado, que resolve os empates e arredondamentos da chave.
+ */
+#define SORT_DEFINIR_TIPADO(PREFIXO, Tipo, MENOR, CHAVE)                        \
+                                                                                \
+static void PREFIXO##_insercao(Tipo *v, size_t n)                               \
+{                                                                               \
+    for (size_t i = 1; i < n; i++)                                              \
+    {                                                                           \
+        if (!MENOR(&v[i], &v[i - 1])) continue;                                 \
+        Tipo temp = v[i];                                                       \
+        size_t j = i;                                                           \
+        while (j > 0 && MENOR(&temp, &v[j - 1]))                                \
+        {                                                                       \
+            v[j] = v[j - 1];                                                    \
+            j--;                                                                \
+        }                                                                       \
+        v[j] = temp;                                                            \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+static void PREFIXO##_mergesort(Tipo *v, size_t n, int limiar, Tipo *aux)       \
+{                                                                               \
+    if ((int)n <= limiar || n < 2)                                              \
+    {                                                                           \
+        PREFIXO##_insercao(v, n);                                               \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    size_t meio = n / 2;                                                        \
+    PREFIXO##_mergesort(v, meio, limiar, aux);                                  \
+    PREFIXO##_mergesort(v + meio, n - meio, limiar, aux);                       \
+                                                                                \
+    /* Já em ordem: nada a intercalar */                                        \
+    if (!MENOR(&v[meio], &v[meio - 1])) return;                                 \
+                                                                                \
+    size_t i = 0, j = meio, k = 0;                                              \
+    while (i < meio && j < n)                                                   \
+    {                                                                           \
+        if (MENOR(&v[j], &v[i])) aux[k++] = v[j++];                             \
+        else aux[k++] = v[i++];                                                 \
+    }                                                                           \
+    while (i < meio) aux[k++] = v[i++];                                         \
+    while (j < n) aux[k++] = v[j++];                                            \
+    memcpy(v, aux, n * sizeof(Tipo));                                           \
+}                                                                               \
+                                                                                \
+static void PREFIXO##_radix(Tipo *v, size_t n, char *trabalho)                  \
+{                                                                               \
+    Tipo *copia = (Tipo*)trabalho;                                              \
+    size_t desloc = (n * sizeof(Tipo) + 7) & ~(size_t)7;                        \
+    uint64_t *chaves = (uint64_t*)(trabalho + desloc);                          \
+    uint64_t *aux_chaves = chaves + n;                                          \
+    uint32_t *indices = (uint32_t*)(aux_chaves + n);                            \
+    uint32_t *aux_indices = indices + n;                                        \
+                                                                                \
+    for (size_t i = 0; i < n; i++)                                              \
+    {                                                                           \
+        chaves[i] = CHAVE(&v[i]);                                               \
+        indices[i] = (uint32_t)i;                                               \
+    }                                                                           \
+    ordenar_radix_chaves(chaves, indices, n, aux_chaves, aux_indices);          \
+                                                                                \
+    for (size_t i = 0; i < n; i++) copia[i] = v[indices[i]];                    \
+    memcpy(v, copia, n * sizeof(Tipo));                                         \
+                                                                                \
+    /* Acabamento: quase tudo já está em ordem, e o MergeSort pula as */        \
+    /* intercalações de metades ordenadas (grupos grandes de chaves    */       \
+    /* iguais continuam O(n log n), ao contrário da inserção)          */       \
+    PREFIXO##_mergesort(v, n, SORT_LIMIAR_ACABAMENTO, copia);                   \
+}                                                                               \
+                                                                                \
+static void PREFIXO##_ordenar(Tipo *v, size_t n, AlgoritmoOrdenacao alg,        \
+                              int limiar, FuncaoComparacao compar,              \
+                              void *trabalho)                                   \
+{                                                                               \
+    if (n < 2) return;                                                          \
+                                                                                \
+    if (alg == ALG_QSORT)                                                       \
+    {                                                                           \
+        qsort(v, n, sizeof(Tipo), compar);                                      \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    void *alocado = NULL;                                                       \
+    if (trabalho == NULL)                                                       \
+    {                                                                           \
+        trabalho = alocado = malloc(SORT_TRABALHO_BYTES(Tipo, n));              \
+        if (trabalho == NULL)                                                   \
+        {                                                                       \
+            qsort(v, n, sizeof(Tipo), compar);                                  \
+            return;                                                             \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    if (alg == ALG_RADIXSORT)                                                   \
+    {                                                                           \
+        PREFIXO##_radix(v, n, (char*)trabalho);                                 \
+    }                                                                           \
+    else                                                                        \
+    {                                                                           \
+        PREFIXO##_mergesort(v, n, limiar, (Tipo*)trabalho);                     \
+    }                                                                           \
+                                                                                \
+    free(alocado);                                                              \
+}
+
 #endif /* SORT_H */
@@ -0,0 +1,152 @@
+/* bench_motores.c
+ * Benchmark dos motores de visibilidade: varredura angular contra a
+ * expansão triangular, com o mesmo cenário e um número crescente de
+ * bombas. O tempo da expansão inclui a montagem da triangulação, de modo
+ * que a tabela mostra a partir de quantas bombas ela compensa.
+ *
+ * As bombas ficam em posições pseudo-aleatórias fixas dentro do cenário
+ * (uma grade de segmentos curtos, como no bench_visibilidade). Bombas que
+ * a expansão não atende são contadas e calculadas pela varredura, como no
+ * programa principal. Os tempos são de relógio, não de CPU.
+ *
+ * Uso: make bench && ./obj/bench_motores [n_segmentos] [max_bombas]
+ */
+
+#define _POSIX_C_SOURCE 200809L   /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "ponto.h"
+#include "vetor_segmentos.h"
+#include "visibilidade.h"
+#include "expansao.h"
+#include "arena.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Segmentos curtos, um por célula, sem cruzamentos */
+static VetorSegmentos cenario_grade(int n, double *lado)
+{
+    VetorSegmentos segs = vetor_segmentos_criar(n);
+    int k = (int)ceil(sqrt((double)n));
+    double celula = 10.0;
+
+    srand(42);
+    for (int i = 0; i < n; i++)
+    {
+        double cx = (i % k) * celula + 2.0 + (rand() % 100) / 50.0;
+        double cy = (i / k) * celula + 2.0 + (rand() % 100) / 50.0;
+        double ang = (rand() % 360) * M_PI / 180.0;
+        vetor_segmentos_adicionar(segs, i, i, cx, cy,
+                                  cx + 4.0 * cos(ang), cy + 4.0 * sin(ang), "black");
+    }
+    *lado = k * celula;
+    return segs;
+}
+
+static double agora(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double varredura(VetorSegmentos segs, double lado, const double *bx,
+                        const double *by, int bombas)
+{
+    double ini = agora();
+    for (int i = 0; i < bombas; i++)
+    {
+        Ponto origem = criar_ponto(bx[i], by[i]);
+        PoligonoVisibilidade p = calcular_visibilidade(origem, segs, 0, 0, lado, lado,
+                                                       "qsort", 10);
+        destruir_poligono_visibilidade(p);
+        destruir_ponto(origem);
+    }
+    return agora() - ini;
+}
+
+/* Motor novo a cada medida: o tempo inclui a triangulação */
+static double expansao(VetorSegmentos segs, double lado, const double *bx,
+                       const double *by, int bombas, int *triangulos, int *recusadas)
+{
+    Arena arena = arena_criar(0);
+    double ini = agora();
+
+    MotorExpansao motor = expansao_criar();
+    int valido = expansao_preparar(motor, segs, 0, 0, lado, lado);
+    *recusadas = 0;
+
+    for (int i = 0; i < bombas; i++)
+    {
+        PoligonoVisibilidade p = valido
+            ? expansao_calcular(motor, bx[i], by[i], NULL, NULL, arena)
+            : NULL;
+        if (p == NULL)
+        {
+            Ponto origem = criar_ponto(bx[i], by[i]);
+            p = calcular_visibilidade(origem, segs, 0, 0, lado, lado, "qsort", 10);
+            destruir_ponto(origem);
+            (*recusadas)++;
+        }
+        destruir_poligono_visibilidade(p);
+        arena_resetar(arena);
+    }
+
+    double t = agora() - ini;
+    *triangulos = expansao_num_triangulos(motor);
+    expansao_destruir(motor);
+    arena_destruir(arena);
+    return t;
+}
+
+int main(int argc, char *argv[])
+{
+    int n = (argc > 1) ? atoi(argv[1]) : 16000;
+    int max_bombas = (argc > 2) ? atoi(argv[2]) : 1024;
+    double lado;
+
+    if (n < 1) n = 1;
+    if (max_bombas < 1) max_bombas = 1;
+
+    VetorSegmentos segs = cenario_grade(n, &lado);
+    double *bx = malloc(max_bombas * sizeof(double));
+    double *by = malloc(max_bombas * sizeof(double));
+    if (bx == NULL || by == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar as bombas\n");
+        free(bx);
+        free(by);
+        vetor_segmentos_destruir(segs);
+        return 1;
+    }
+
+    srand(7);
+    for (int i = 0; i < max_bombas; i++)
+    {
+        bx[i] = (rand() % 100000) / 100000.0 * lado + 0.013;
+        by[i] = (rand() % 100000) / 100000.0 * lado + 0.017;
+    }
+
+    printf("=== Benchmark: Motores de Visibilidade (%d segmentos) ===\n", n);
+    printf("%10s %16s %16s %12s %12s\n", "bombas", "varredura (ms)", "expansao (ms)",
+           "triangulos", "recusadas");
+
+    for (int bombas = 1; bombas <= max_bombas; bombas *= 2)
+    {
+        int triangulos, recusadas;
+        double t_var = varredura(segs, lado, bx, by, bombas);
+        double t_exp = expansao(segs, lado, bx, by, bombas, &triangulos, &recusadas);
+        printf("%10d %16.2f %16.2f %12d %12d\n", bombas, t_var * 1000.0, t_exp * 1000.0,
+               triangulos, recusadas);
+    }
+
+    free(bx);
+    free(by);
+    vetor_segmentos_destruir(segs);
+    return 0;
+}
@@ -0,0 +1,151 @@
+/* bench_visibilidade.c
+ * Benchmark da varredura angular (calcular_visibilidade) em cenários
+ * de tamanhos crescentes.
+ *
+ * Cenários:
+ *   grade - segmentos curtos espalhados em uma grade (caso típico)
+ *   anel  - segmentos em raios crescentes cobrindo o mesmo setor, que
+ *           chegam à árvore em ordem de distância (pior caso da BST simples)
+ *
+ * Com setores > 1, mede também a varredura por setores
+ * (calcular_visibilidade_setores) com esse número de threads. Os tempos
+ * são de relógio, não de CPU.
+ *
+ * Uso: make bench && ./obj/bench_visibilidade [n_max] [qsort|mergesort|radixsort] [setores]
+ */
+
+#define _POSIX_C_SOURCE 200809L   /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "ponto.h"
+#include "vetor_segmentos.h"
+#include "visibilidade.h"
+#include "arena.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define REPETICOES 3
+
+/* Segmentos curtos, um por célula, sem cruzamentos */
+static VetorSegmentos cenario_grade(int n, double *lado)
+{
+    VetorSegmentos segs = vetor_segmentos_criar(n);
+    int k = (int)ceil(sqrt((double)n));
+    double celula = 10.0;
+
+    srand(42);
+    for (int i = 0; i < n; i++)
+    {
+        double cx = (i % k) * celula + 2.0 + (rand() % 100) / 50.0;
+        double cy = (i / k) * celula + 2.0 + (rand() % 100) / 50.0;
+        double ang = (rand() % 360) * M_PI / 180.0;
+        vetor_segmentos_adicionar(segs, i, i, cx, cy,
+                                  cx + 4.0 * cos(ang), cy + 4.0 * sin(ang), "black");
+    }
+    *lado = k * celula;
+    return segs;
+}
+
+/* Arcos poligonais concêntricos em torno do centro: todos ativos ao mesmo tempo */
+static VetorSegmentos cenario_anel(int n, double *lado)
+{
+    VetorSegmentos segs = vetor_segmentos_criar(n);
+    double centro = 10.0 + n;
+
+    for (int i = 0; i < n; i++)
+    {
+        double r = 5.0 + i;
+        double a1 = 0.1 + 0.0001 * i;
+        double a2 = 1.2 + 0.0001 * i;
+        vetor_segmentos_adicionar(segs, i, i,
+                                  centro + r * cos(a1), centro + r * sin(a1),
+                                  centro + r * cos(a2), centro + r * sin(a2), "black");
+    }
+    *lado = 2.0 * centro;
+    return segs;
+}
+
+static double agora(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* setores <= 1: varredura completa; senão, por setores com uma arena por thread */
+static double medir(VetorSegmentos segs, double lado, const char *ordenacao, int setores)
+{
+    Ponto origem = criar_ponto(lado / 2.0 + 0.013, lado / 2.0 + 0.017);
+    double melhor = -1.0;
+
+    Arena arenas[setores > 1 ? setores : 1];
+    for (int i = 0; i < setores; i++) arenas[i] = arena_criar(0);
+
+    for (int r = 0; r < REPETICOES; r++)
+    {
+        double ini = agora();
+        PoligonoVisibilidade p = (setores > 1)
+            ? calcular_visibilidade_setores(origem, segs, 0, 0, lado, lado, ordenacao, 10,
+                                            NULL, NULL, arenas, setores)
+            : calcular_visibilidade(origem, segs, 0, 0, lado, lado, ordenacao, 10);
+        double t = agora() - ini;
+        destruir_poligono_visibilidade(p);
+        for (int i = 0; i < setores; i++) arena_resetar(arenas[i]);
+
+        if (melhor < 0 || t < melhor) melhor = t;
+    }
+
+    for (int i = 0; i < setores; i++) arena_destruir(arenas[i]);
+    destruir_ponto(origem);
+    return melhor;
+}
+
+int main(int argc, char *argv[])
+{
+    int n_max = (argc > 1) ? atoi(argv[1]) : 64000;
+    const char *ordenacao = (argc > 2) ? argv[2] : "qsort";
+    int setores = (argc > 3) ? atoi(argv[3]) : 1;
+
+    printf("=== Benchmark: Varredura Angular (ordenação: %s) ===\n", ordenacao);
+    if (setores > 1)
+    {
+        printf("%10s %14s %14s %14s %14s\n", "n", "grade (ms)", "anel (ms)",
+               "grade set (ms)", "anel set (ms)");
+    }
+    else
+    {
+        printf("%10s %14s %14s\n", "n", "grade (ms)", "anel (ms)");
+    }
+
+    for (int n = 1000; n <= n_max; n *= 2)
+    {
+        double lado;
+
+        VetorSegmentos grade = cenario_grade(n, &lado);
+        double t_grade = medir(grade, lado, ordenacao, 1);
+        double s_grade = (setores > 1) ? medir(grade, lado, ordenacao, setores) : 0.0;
+        vetor_segmentos_destruir(grade);
+
+        VetorSegmentos anel = cenario_anel(n, &lado);
+        double t_anel = medir(anel, lado, ordenacao, 1);
+        double s_anel = (setores > 1) ? medir(anel, lado, ordenacao, setores) : 0.0;
+        vetor_segmentos_destruir(anel);
+
+        if (setores > 1)
+        {
+            printf("%10d %14.2f %14.2f %14.2f %14.2f\n", n, t_grade * 1000.0, t_anel * 1000.0,
+                   s_grade * 1000.0, s_anel * 1000.0);
+        }
+        else
+        {
+            printf("%10d %14.2f %14.2f\n", n, t_grade * 1000.0, t_anel * 1000.0);
+        }
+    }
+
+    return 0;
+}
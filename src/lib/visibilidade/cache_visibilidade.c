@@ -0,0 +1,224 @@
+/* cache_visibilidade.c
+ *
+ * Implementação do TAD Cache de Visibilidade
+ * Tabela de mapeamento direto: a posição da entrada vem do hash das
+ * coordenadas da bomba. Cada entrada guarda uma cópia do polígono e,
+ * quando a bomba os rastreou, dos índices dos segmentos visíveis.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "cache_visibilidade.h"
+
+#define CAPACIDADE_PADRAO 64
+
+/* ============================================================================
+ * Estrutura Interna
+ * ============================================================================ */
+
+typedef struct entrada_cache
+{
+    double x, y;
+    double raio;                    /* Alcance da bomba (0: sem limite) */
+    PoligonoVisibilidade poligono;  /* NULL: entrada livre */
+    int *visiveis;                  /* NULL: segmentos não rastreados */
+    int num_visiveis;
+} EntradaCache;
+
+typedef struct cache_internal
+{
+    EntradaCache *entradas;
+    int capacidade;
+    unsigned versao;                /* Versão dos anteparos das entradas */
+
+    int acertos;
+    int falhas;
+} CacheInternal;
+
+/* ============================================================================
+ * Funções Auxiliares
+ * ============================================================================ */
+
+static unsigned hash_posicao(double x, double y)
+{
+    uint64_t bx, by;
+    x += 0.0;                       /* -0.0 e 0.0 caem na mesma entrada */
+    y += 0.0;
+    memcpy(&bx, &x, sizeof(bx));
+    memcpy(&by, &y, sizeof(by));
+
+    uint64_t h = (bx * 0x9E3779B97F4A7C15ULL) ^ (by + (bx >> 29));
+    h ^= h >> 32;
+    return (unsigned)(h * 0xC2B2AE3D27D4EB4FULL >> 32);
+}
+
+static void liberar_entrada(EntradaCache *e)
+{
+    if (e->poligono != NULL) destruir_poligono_visibilidade(e->poligono);
+    free(e->visiveis);
+    e->poligono = NULL;
+    e->visiveis = NULL;
+    e->num_visiveis = 0;
+}
+
+/**
+ * Esvazia o cache se os anteparos mudaram de versão.
+ */
+static void sincronizar_versao(CacheInternal *c, unsigned versao)
+{
+    if (versao == c->versao) return;
+
+    for (int i = 0; i < c->capacidade; i++)
+    {
+        liberar_entrada(&c->entradas[i]);
+    }
+    c->versao = versao;
+}
+
+/* ============================================================================
+ * Implementação das Funções de Criação e Destruição
+ * ============================================================================ */
+
+CacheVisibilidade cache_visibilidade_criar(int capacidade)
+{
+    if (capacidade <= 0) capacidade = CAPACIDADE_PADRAO;
+
+    CacheInternal *c = (CacheInternal*)malloc(sizeof(CacheInternal));
+    if (c == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar cache de visibilidade.\n");
+        return NULL;
+    }
+
+    c->entradas = (EntradaCache*)calloc(capacidade, sizeof(EntradaCache));
+    if (c->entradas == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar cache de visibilidade.\n");
+        free(c);
+        return NULL;
+    }
+
+    c->capacidade = capacidade;
+    c->versao = 0;
+    c->acertos = 0;
+    c->falhas = 0;
+
+    return (CacheVisibilidade)c;
+}
+
+void cache_visibilidade_destruir(CacheVisibilidade cache)
+{
+    CacheInternal *c = (CacheInternal*)cache;
+    if (c == NULL) return;
+
+    for (int i = 0; i < c->capacidade; i++)
+    {
+        liberar_entrada(&c->entradas[i]);
+    }
+
+    free(c->entradas);
+    free(c);
+}
+
+/* ============================================================================
+ * Implementação das Funções de Operação
+ * ============================================================================ */
+
+PoligonoVisibilidade cache_visibilidade_buscar(CacheVisibilidade cache,
+                                               double x, double y, double raio,
+                                               unsigned versao,
+                                               Arena arena, int **visiveis,
+                                               int *num_visiveis)
+{
+    CacheInternal *c = (CacheInternal*)cache;
+    if (c == NULL) return NULL;
+
+    sincronizar_versao(c, versao);
+
+    EntradaCache *e = &c->entradas[hash_posicao(x, y) % c->capacidade];
+    if (e->poligono == NULL || e->x != x || e->y != y || e->raio != raio ||
+        (visiveis != NULL && e->visiveis == NULL))
+    {
+        c->falhas++;
+        return NULL;
+    }
+
+    int *copia = NULL;
+    if (visiveis != NULL)
+    {
+        copia = (int*)arena_alocar(arena, (e->num_visiveis + 1) * sizeof(int));
+        if (copia == NULL)
+        {
+            c->falhas++;
+            return NULL;
+        }
+        memcpy(copia, e->visiveis, e->num_visiveis * sizeof(int));
+    }
+
+    PoligonoVisibilidade poligono = poligono_clonar(e->poligono);
+    if (poligono == NULL)
+    {
+        c->falhas++;
+        return NULL;
+    }
+
+    if (visiveis != NULL) *visiveis = copia;
+    if (num_visiveis != NULL) *num_visiveis = visiveis != NULL ? e->num_visiveis : 0;
+    c->acertos++;
+    return poligono;
+}
+
+void cache_visibilidade_guardar(CacheVisibilidade cache, double x, double y,
+                                double raio, unsigned versao, PoligonoVisibilidade poligono,
+                                const int *visiveis, int num_visiveis)
+{
+    CacheInternal *c = (CacheInternal*)cache;
+    if (c == NULL || poligono == NULL) return;
+
+    sincronizar_versao(c, versao);
+
+    EntradaCache *e = &c->entradas[hash_posicao(x, y) % c->capacidade];
+
+    /* Não troca uma entrada com segmentos por outra, da mesma bomba, sem eles */
+    if (e->poligono != NULL && e->x == x && e->y == y && e->raio == raio &&
+        e->visiveis != NULL && visiveis == NULL)
+    {
+        return;
+    }
+
+    liberar_entrada(e);
+
+    e->poligono = poligono_clonar(poligono);
+    if (e->poligono == NULL) return;
+
+    if (visiveis != NULL)
+    {
+        e->visiveis = (int*)malloc((num_visiveis > 0 ? num_visiveis : 1) * sizeof(int));
+        if (e->visiveis == NULL)
+        {
+            liberar_entrada(e);
+            return;
+        }
+        memcpy(e->visiveis, visiveis, num_visiveis * sizeof(int));
+        e->num_visiveis = num_visiveis;
+    }
+
+    e->x = x;
+    e->y = y;
+    e->raio = raio;
+}
+
+int cache_visibilidade_acertos(CacheVisibilidade cache)
+{
+    CacheInternal *c = (CacheInternal*)cache;
+    return c ? c->acertos : 0;
+}
+
+int cache_visibilidade_falhas(CacheVisibilidade cache)
+{
+    CacheInternal *c = (CacheInternal*)cache;
+    return c ? c->falhas : 0;
+}
@@ -0,0 +1,88 @@
+/* cache_visibilidade.h
+ *
+ * TAD Cache de Visibilidade
+ * Guarda os resultados da varredura (polígono e índices dos segmentos
+ * visíveis) por posição e raio da bomba, para a versão atual do vetor de
+ * anteparos (vetor_segmentos_versao). Bombas repetidas no mesmo ponto e
+ * com o mesmo raio, sem alteração dos anteparos entre elas, reaproveitam
+ * o resultado.
+ *
+ * A versão só cresce, então ao mudar de versão o cache é esvaziado. As
+ * entradas ficam em uma tabela de tamanho fixo, indexada pelas
+ * coordenadas: uma colisão substitui a entrada anterior.
+ */
+
+#ifndef CACHE_VISIBILIDADE_H
+#define CACHE_VISIBILIDADE_H
+
+#include "visibilidade.h"
+
+/* Tipo opaco para o Cache */
+typedef void* CacheVisibilidade;
+
+/* ============================================================================
+ * Funções de Criação e Destruição
+ * ============================================================================ */
+
+/**
+ * Cria um cache vazio.
+ * @param capacidade Número de entradas da tabela (<= 0 usa o padrão)
+ * @return Novo cache, ou NULL em caso de erro
+ */
+CacheVisibilidade cache_visibilidade_criar(int capacidade);
+
+/**
+ * Destroi o cache e os resultados guardados.
+ * @param cache Cache a ser destruído
+ */
+void cache_visibilidade_destruir(CacheVisibilidade cache);
+
+/* ============================================================================
+ * Funções de Operação
+ * ============================================================================ */
+
+/**
+ * Procura o resultado de uma bomba e conta um acerto ou uma falha.
+ * Uma entrada sem segmentos visíveis não atende quem precisa deles.
+ * @param cache Cache
+ * @param x, y Posição da bomba
+ * @param raio Alcance da bomba (0: sem limite)
+ * @param versao Versão atual do vetor de anteparos
+ * @param arena Arena onde a cópia dos índices é alocada
+ * @param visiveis OUT (NULL se não precisa): cópia dos índices dos
+ *                 segmentos visíveis, na arena
+ * @param num_visiveis OUT (NULL se não precisa): quantidade de índices
+ * @return Cópia do polígono (o chamador passa a ser o dono), ou NULL em
+ *         caso de falha
+ */
+PoligonoVisibilidade cache_visibilidade_buscar(CacheVisibilidade cache,
+                                               double x, double y, double raio,
+                                               unsigned versao,
+                                               Arena arena, int **visiveis,
+                                               int *num_visiveis);
+
+/**
+ * Guarda uma cópia do resultado de uma bomba.
+ * @param cache Cache
+ * @param x, y Posição da bomba
+ * @param raio Alcance da bomba (0: sem limite)
+ * @param versao Versão do vetor de anteparos usada no cálculo
+ * @param poligono Polígono calculado (não é retido)
+ * @param visiveis Índices dos segmentos visíveis (NULL se não rastreados)
+ * @param num_visiveis Quantidade de índices
+ */
+void cache_visibilidade_guardar(CacheVisibilidade cache, double x, double y,
+                                double raio, unsigned versao, PoligonoVisibilidade poligono,
+                                const int *visiveis, int num_visiveis);
+
+/**
+ * Obtém o número de buscas atendidas pelo cache.
+ */
+int cache_visibilidade_acertos(CacheVisibilidade cache);
+
+/**
+ * Obtém o número de buscas que precisaram da varredura.
+ */
+int cache_visibilidade_falhas(CacheVisibilidade cache);
+
+#endif /* CACHE_VISIBILIDADE_H */
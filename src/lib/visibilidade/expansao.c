@@ -0,0 +1,629 @@
+/* expansao.c
+ *
+ * Implementação do Motor de Visibilidade por Expansão Triangular
+ * Cada anteparo vira uma restrição da triangulação, com o seu índice no
+ * vetor de segmentos como id. A consulta é uma busca em profundidade
+ * (pilha explícita, na arena) sobre pares (aresta, cone): o cone é
+ * delimitado por dois raios a partir da bomba, cada um passando por um
+ * vértice da triangulação. Uma aresta livre leva ao triângulo vizinho,
+ * cujo vértice oposto pode dividir o cone em dois; uma aresta restrita
+ * (ou da borda) recebe o cone e vira um pedaço do polígono.
+ *
+ * Os pedaços saem em ordem anti-horária; o polígono é montado a partir
+ * do raio de ângulo 0, como na varredura.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "expansao.h"
+#include "triangulacao.h"
+#include "poligono.h"
+
+#define EPSILON 1e-9
+#define MARGEM_BBOX 5.0
+#define TOLERANCIA_ARESTA 1e-10
+#define CAPACIDADE_PILHA 256
+
+/* ============================================================================
+ * Estrutura Interna
+ * ============================================================================ */
+
+typedef struct motor_internal
+{
+    Triangulacao tri;
+    int valido;                     /* Triangulação completa (todas as restrições) */
+
+    /* Chave da triangulação atual */
+    VetorSegmentos segmentos;
+    unsigned versao;
+    double min_x, min_y, max_x, max_y;
+
+    /* Índice grosso: um triângulo de partida por célula */
+    int *partida;
+    int colunas, linhas;
+    double largura_celula, altura_celula;
+    double tolerancia;
+} MotorInternal;
+
+/* Um par (aresta, cone) a processar: aresta k do triângulo t, cone entre
+ * os raios que passam pelos vértices dir (direita) e esq (esquerda) */
+typedef struct quadro
+{
+    int t, k;
+    int dir, esq;
+} Quadro;
+
+/* Trecho de aresta bloqueante visto pela bomba, da direita para a esquerda */
+typedef struct pedaco
+{
+    double rx, ry;
+    double lx, ly;
+    int seg;                        /* Índice do anteparo (-1: borda) */
+} Pedaco;
+
+/* Pontos extremos de um segmento, para ordenar a inserção */
+typedef struct extremo
+{
+    unsigned chave;
+    int indice;                     /* 2 * segmento + extremo */
+} Extremo;
+
+/* ============================================================================
+ * Funções Auxiliares
+ * ============================================================================ */
+
+static inline double orientacao(double ax, double ay, double bx, double by,
+                                double cx, double cy)
+{
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+/**
+ * Pseudo-ângulo de (dx, dy) em [0, 4): cresce com o ângulo, 0 no raio
+ * de ângulo 0.
+ */
+static double pseudo_angulo(double dx, double dy)
+{
+    double soma = fabs(dx) + fabs(dy);
+    if (soma == 0.0) return 0.0;
+
+    double p = dy / soma;
+    if (dx < 0.0) return 2.0 - p;
+    if (dy < 0.0) return 4.0 + p;
+    return p;
+}
+
+/**
+ * Recorta o segmento ao retângulo (Liang-Barsky).
+ * @return 1 se sobrou um trecho (coordenadas atualizadas), 0 caso contrário
+ */
+static int recortar(double *x1, double *y1, double *x2, double *y2,
+                    double min_x, double min_y, double max_x, double max_y)
+{
+    double dx = *x2 - *x1, dy = *y2 - *y1;
+    double p[4] = {-dx, dx, -dy, dy};
+    double q[4] = {*x1 - min_x, max_x - *x1, *y1 - min_y, max_y - *y1};
+    double t0 = 0.0, t1 = 1.0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (p[i] == 0.0)
+        {
+            if (q[i] < 0.0) return 0;
+            continue;
+        }
+        double r = q[i] / p[i];
+        if (p[i] < 0.0)
+        {
+            if (r > t1) return 0;
+            if (r > t0) t0 = r;
+        }
+        else
+        {
+            if (r < t0) return 0;
+            if (r < t1) t1 = r;
+        }
+    }
+
+    /* O arredondamento pode deixar o ponto recortado um pouco fora */
+    double ax = fmin(fmax(*x1 + t0 * dx, min_x), max_x);
+    double ay = fmin(fmax(*y1 + t0 * dy, min_y), max_y);
+    double bx = fmin(fmax(*x1 + t1 * dx, min_x), max_x);
+    double by = fmin(fmax(*y1 + t1 * dy, min_y), max_y);
+    *x1 = ax;
+    *y1 = ay;
+    *x2 = bx;
+    *y2 = by;
+    return 1;
+}
+
+static int comparar_extremos(const void *a, const void *b)
+{
+    const Extremo *e1 = (const Extremo*)a;
+    const Extremo *e2 = (const Extremo*)b;
+    if (e1->chave != e2->chave) return e1->chave < e2->chave ? -1 : 1;
+    return e1->indice - e2->indice;
+}
+
+/**
+ * Dobra a capacidade de um vetor alocado na arena.
+ */
+static void* crescer(Arena arena, void *antigo, int usados, int *capacidade, size_t tamanho)
+{
+    void *novo = arena_alocar(arena, 2 * (size_t)*capacidade * tamanho);
+    if (novo == NULL) return NULL;
+    memcpy(novo, antigo, usados * tamanho);
+    *capacidade *= 2;
+    return novo;
+}
+
+/**
+ * Ponto onde o raio que sai de (qx, qy) na direção do vértice d encontra
+ * a aresta (a, b), preso ao segmento.
+ */
+static void intersecao_raio(const double *xs, const double *ys, double qx, double qy,
+                            int d, int a, int b, double *ix, double *iy)
+{
+    double ex = xs[b] - xs[a], ey = ys[b] - ys[a];
+    double dx = xs[d] - qx, dy = ys[d] - qy;
+    double den = ex * dy - ey * dx;
+
+    double s = 0.0;
+    if (den != 0.0) s = ((qx - xs[a]) * dy - (qy - ys[a]) * dx) / den;
+    if (s < 0.0) s = 0.0;
+    if (s > 1.0) s = 1.0;
+
+    *ix = xs[a] + s * ex;
+    *iy = ys[a] + s * ey;
+}
+
+static void liberar_triangulacao(MotorInternal *m)
+{
+    triangulacao_destruir(m->tri);
+    free(m->partida);
+    m->tri = NULL;
+    m->partida = NULL;
+    m->valido = 0;
+}
+
+/**
+ * Monta a triangulação restrita dos anteparos recortados ao retângulo.
+ * Os extremos são inseridos em ordem de células (linhas alternadas),
+ * para que cada busca parta de perto do ponto anterior.
+ */
+static int triangular(MotorInternal *m, VetorSegmentos segmentos,
+                      double min_x, double min_y, double max_x, double max_y)
+{
+    const double *x1, *y1, *x2, *y2;
+    int n = vetor_segmentos_coordenadas(segmentos, &x1, &y1, &x2, &y2);
+
+    m->tri = triangulacao_criar(min_x, min_y, max_x, max_y, 2 * n + 4);
+    if (m->tri == NULL) return 0;
+
+    double *c = (double*)malloc(4 * (size_t)(n + 1) * sizeof(double));
+    int *vertice = (int*)malloc(2 * (size_t)(n + 1) * sizeof(int));
+    Extremo *ordem = (Extremo*)malloc(2 * (size_t)(n + 1) * sizeof(Extremo));
+    if (c == NULL || vertice == NULL || ordem == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar triangulação dos anteparos\n");
+        free(c);
+        free(vertice);
+        free(ordem);
+        return 0;
+    }
+
+    int lado = (int)sqrt(n / 2.0) + 1;
+    double cw = (max_x - min_x) / lado, ch = (max_y - min_y) / lado;
+    int num_extremos = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        double *s = &c[4 * i];
+        s[0] = x1[i];
+        s[1] = y1[i];
+        s[2] = x2[i];
+        s[3] = y2[i];
+        vertice[2 * i] = vertice[2 * i + 1] = -1;
+        if (!recortar(&s[0], &s[1], &s[2], &s[3], min_x, min_y, max_x, max_y)) continue;
+
+        for (int e = 0; e < 2; e++)
+        {
+            int col = (int)((s[2 * e] - min_x) / cw);
+            int lin = (int)((s[2 * e + 1] - min_y) / ch);
+            if (col >= lado) col = lado - 1;
+            if (lin >= lado) lin = lado - 1;
+            if (lin % 2) col = lado - 1 - col;
+
+            ordem[num_extremos].chave = (unsigned)(lin * lado + col);
+            ordem[num_extremos].indice = 2 * i + e;
+            num_extremos++;
+        }
+    }
+
+    qsort(ordem, num_extremos, sizeof(Extremo), comparar_extremos);
+
+    int ok = 1;
+    for (int i = 0; i < num_extremos && ok; i++)
+    {
+        int e = ordem[i].indice;
+        vertice[e] = triangulacao_inserir_ponto(m->tri, c[2 * e], c[2 * e + 1]);
+        ok = vertice[e] >= 0;
+    }
+
+    for (int i = 0; i < n && ok; i++)
+    {
+        int a = vertice[2 * i], b = vertice[2 * i + 1];
+        if (a < 0 || a == b) continue;
+        ok = triangulacao_inserir_restricao(m->tri, a, b, i);
+    }
+
+    free(c);
+    free(vertice);
+    free(ordem);
+    return ok;
+}
+
+/**
+ * Monta o índice grosso: para cada célula, o triângulo que contém o seu
+ * centro (cada busca parte do resultado da célula anterior).
+ */
+static int indexar(MotorInternal *m)
+{
+    int num_triangulos = triangulacao_num_triangulos(m->tri);
+    int lado = (int)sqrt(num_triangulos / 4.0) + 1;
+    double largura = m->max_x - m->min_x + 2 * MARGEM_BBOX;
+    double altura = m->max_y - m->min_y + 2 * MARGEM_BBOX;
+
+    m->partida = (int*)malloc((size_t)lado * lado * sizeof(int));
+    if (m->partida == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar índice da triangulação\n");
+        return 0;
+    }
+
+    m->colunas = m->linhas = lado;
+    m->largura_celula = largura / lado;
+    m->altura_celula = altura / lado;
+
+    int t = 0;
+    for (int lin = 0; lin < lado; lin++)
+    {
+        for (int i = 0; i < lado; i++)
+        {
+            int col = (lin % 2) ? lado - 1 - i : i;
+            double cx = m->min_x - MARGEM_BBOX + (col + 0.5) * m->largura_celula;
+            double cy = m->min_y - MARGEM_BBOX + (lin + 0.5) * m->altura_celula;
+            int achado = triangulacao_localizar(m->tri, cx, cy, t);
+            if (achado >= 0) t = achado;
+            m->partida[lin * lado + col] = t;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Testa se o pedaço b continua o pedaço a sem interrupção, no mesmo
+ * anteparo ou no mesmo lado da borda (lados são horizontais ou verticais).
+ */
+static int continua_pedaco(const Pedaco *a, const Pedaco *b)
+{
+    if (fabs(a->lx - b->rx) >= EPSILON || fabs(a->ly - b->ry) >= EPSILON) return 0;
+    if (b->seg >= 0) return a->seg == b->seg;
+    if (a->seg >= 0) return 0;
+
+    return (a->rx == a->lx && b->rx == b->lx && a->lx == b->rx) ||
+           (a->ry == a->ly && b->ry == b->ly && a->ly == b->ry);
+}
+
+/**
+ * Último vértice emitido no polígono (para não repetir pontos).
+ */
+typedef struct ultimo_vertice
+{
+    double x, y;
+    int valido;
+} UltimoVertice;
+
+static void emitir_vertice(Poligono resultado, UltimoVertice *ultimo, double x, double y)
+{
+    if (ultimo->valido && fabs(ultimo->x - x) < EPSILON && fabs(ultimo->y - y) < EPSILON)
+    {
+        return;
+    }
+
+    poligono_inserir_vertice(resultado, x, y);
+    ultimo->x = x;
+    ultimo->y = y;
+    ultimo->valido = 1;
+}
+
+/* ============================================================================
+ * Implementação das Funções de Criação e Destruição
+ * ============================================================================ */
+
+MotorVisibilidade motor_por_nome(const char *nome)
+{
+    if (nome != NULL && (strcmp(nome, "e") == 0 || strcmp(nome, "expansao") == 0))
+    {
+        return MOTOR_EXPANSAO;
+    }
+    return MOTOR_VARREDURA;
+}
+
+MotorExpansao expansao_criar(void)
+{
+    MotorInternal *m = (MotorInternal*)calloc(1, sizeof(MotorInternal));
+    if (m == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar motor de expansão.\n");
+        return NULL;
+    }
+    return (MotorExpansao)m;
+}
+
+void expansao_destruir(MotorExpansao motor)
+{
+    MotorInternal *m = (MotorInternal*)motor;
+    if (m == NULL) return;
+
+    liberar_triangulacao(m);
+    free(m);
+}
+
+/* ============================================================================
+ * Implementação das Funções de Operação
+ * ============================================================================ */
+
+int expansao_preparar(MotorExpansao motor, VetorSegmentos segmentos,
+                      double min_x, double min_y, double max_x, double max_y)
+{
+    MotorInternal *m = (MotorInternal*)motor;
+    if (m == NULL || segmentos == NULL) return 0;
+
+    unsigned versao = vetor_segmentos_versao(segmentos);
+    if (m->tri != NULL && m->segmentos == segmentos && m->versao == versao &&
+        m->min_x == min_x && m->min_y == min_y && m->max_x == max_x && m->max_y == max_y)
+    {
+        return m->valido;
+    }
+
+    liberar_triangulacao(m);
+    m->segmentos = segmentos;
+    m->versao = versao;
+    m->min_x = min_x;
+    m->min_y = min_y;
+    m->max_x = max_x;
+    m->max_y = max_y;
+
+    double escala = fmax(max_x - min_x, max_y - min_y) + 2 * MARGEM_BBOX;
+    m->tolerancia = TOLERANCIA_ARESTA * fmax(escala, 1.0);
+
+    if (!triangular(m, segmentos, min_x - MARGEM_BBOX, min_y - MARGEM_BBOX,
+                    max_x + MARGEM_BBOX, max_y + MARGEM_BBOX))
+    {
+        /* Sem todas as restrições a região sairia errada: fica a varredura */
+        fprintf(stderr, "Aviso: triangulação dos anteparos falhou; usando a varredura\n");
+        return 0;
+    }
+
+    m->valido = indexar(m);
+    return m->valido;
+}
+
+PoligonoVisibilidade expansao_calcular(MotorExpansao motor, double qx, double qy,
+                                       int *visiveis, int *num_visiveis,
+                                       Arena arena)
+{
+    MotorInternal *m = (MotorInternal*)motor;
+    if (num_visiveis != NULL) *num_visiveis = 0;
+    if (m == NULL || !m->valido || arena == NULL) return NULL;
+
+    /* Fora da bounding box a varredura usa outra borda */
+    if (qx < m->min_x || qx > m->max_x || qy < m->min_y || qy > m->max_y) return NULL;
+
+    const double *xs, *ys;
+    const int *v, *viz, *rest;
+    triangulacao_dados(m->tri, &xs, &ys, &v, &viz, &rest);
+
+    int col = (int)((qx - m->min_x + MARGEM_BBOX) / m->largura_celula);
+    int lin = (int)((qy - m->min_y + MARGEM_BBOX) / m->altura_celula);
+    if (col >= m->colunas) col = m->colunas - 1;
+    if (lin >= m->linhas) lin = m->linhas - 1;
+
+    int t0 = triangulacao_localizar(m->tri, qx, qy, m->partida[lin * m->colunas + col]);
+    if (t0 < 0) return NULL;
+
+    /* Sobre uma aresta (ou vértice) o cone inicial seria degenerado */
+    for (int i = 0; i < 3; i++)
+    {
+        int a = v[3 * t0 + (i + 1) % 3], b = v[3 * t0 + (i + 2) % 3];
+        double comprimento = hypot(xs[b] - xs[a], ys[b] - ys[a]);
+        if (orientacao(xs[a], ys[a], xs[b], ys[b], qx, qy) <= m->tolerancia * comprimento)
+        {
+            return NULL;
+        }
+    }
+
+    int cap_pilha = CAPACIDADE_PILHA, cap_pedacos = CAPACIDADE_PILHA;
+    Quadro *pilha = (Quadro*)arena_alocar(arena, cap_pilha * sizeof(Quadro));
+    Pedaco *pedacos = (Pedaco*)arena_alocar(arena, cap_pedacos * sizeof(Pedaco));
+    if (pilha == NULL || pedacos == NULL) return NULL;
+
+    /* Uma aresta do triângulo inicial por quadro; a de v0 a v1 sai primeiro */
+    int topo = 0, num_pedacos = 0;
+    for (int k = 1; k >= 0; k--)
+    {
+        pilha[topo++] = (Quadro){t0, k, v[3 * t0 + (k + 1) % 3], v[3 * t0 + (k + 2) % 3]};
+    }
+    pilha[topo++] = (Quadro){t0, 2, v[3 * t0], v[3 * t0 + 1]};
+
+    while (topo > 0)
+    {
+        Quadro f = pilha[--topo];
+        int a = v[3 * f.t + (f.k + 1) % 3], b = v[3 * f.t + (f.k + 2) % 3];
+        int u = viz[3 * f.t + f.k], r = rest[3 * f.t + f.k];
+
+        if (u < 0 || r >= 0)
+        {
+            /* Aresta bloqueante: o cone inteiro termina nela */
+            if (num_pedacos + 1 > cap_pedacos)
+            {
+                pedacos = (Pedaco*)crescer(arena, pedacos, num_pedacos, &cap_pedacos, sizeof(Pedaco));
+                if (pedacos == NULL) return NULL;
+            }
+
+            Pedaco p;
+            p.seg = r;
+            if (f.dir == a)
+            {
+                p.rx = xs[a];
+                p.ry = ys[a];
+            }
+            else
+            {
+                intersecao_raio(xs, ys, qx, qy, f.dir, a, b, &p.rx, &p.ry);
+            }
+            if (f.esq == b)
+            {
+                p.lx = xs[b];
+                p.ly = ys[b];
+            }
+            else
+            {
+                intersecao_raio(xs, ys, qx, qy, f.esq, a, b, &p.lx, &p.ly);
+            }
+            if (num_pedacos > 0 && continua_pedaco(&pedacos[num_pedacos - 1], &p))
+            {
+                pedacos[num_pedacos - 1].lx = p.lx;
+                pedacos[num_pedacos - 1].ly = p.ly;
+            }
+            else
+            {
+                pedacos[num_pedacos++] = p;
+            }
+            continue;
+        }
+
+        /* Aresta livre: o vértice oposto do vizinho pode dividir o cone */
+        int j = 0;
+        while (v[3 * u + (j + 1) % 3] != b || v[3 * u + (j + 2) % 3] != a) j++;
+        int c = v[3 * u + j];
+
+        double o_dir = orientacao(qx, qy, xs[f.dir], ys[f.dir], xs[c], ys[c]);
+        double o_esq = orientacao(qx, qy, xs[f.esq], ys[f.esq], xs[c], ys[c]);
+
+        if (topo + 2 > cap_pilha)
+        {
+            pilha = (Quadro*)crescer(arena, pilha, topo, &cap_pilha, sizeof(Quadro));
+            if (pilha == NULL) return NULL;
+        }
+
+        /* (c, b) é a aresta esquerda do vizinho e (a, c) a direita */
+        int k_esq = (j + 2) % 3, k_dir = (j + 1) % 3;
+        if (o_dir <= 0.0)
+        {
+            pilha[topo++] = (Quadro){u, k_esq, f.dir, f.esq};
+        }
+        else if (o_esq >= 0.0)
+        {
+            pilha[topo++] = (Quadro){u, k_dir, f.dir, f.esq};
+        }
+        else
+        {
+            pilha[topo++] = (Quadro){u, k_esq, c, f.esq};
+            pilha[topo++] = (Quadro){u, k_dir, f.dir, c};
+        }
+    }
+
+    if (num_pedacos == 0) return NULL;
+
+    /* A volta fecha: o último pedaço pode continuar no primeiro */
+    if (num_pedacos > 1 && continua_pedaco(&pedacos[num_pedacos - 1], &pedacos[0]))
+    {
+        pedacos[0].rx = pedacos[num_pedacos - 1].rx;
+        pedacos[0].ry = pedacos[num_pedacos - 1].ry;
+        num_pedacos--;
+    }
+
+    /* Pedaço que atravessa o raio de ângulo 0, ou o que começa mais perto dele */
+    int inicio = 0, atravessa = 0;
+    double menor = 5.0;
+    for (int i = 0; i < num_pedacos; i++)
+    {
+        double ar = pseudo_angulo(pedacos[i].rx - qx, pedacos[i].ry - qy);
+        double al = pseudo_angulo(pedacos[i].lx - qx, pedacos[i].ly - qy);
+        if (ar > al && al > 0.0)
+        {
+            inicio = i;
+            atravessa = 1;
+            break;
+        }
+        if (ar < menor)
+        {
+            menor = ar;
+            inicio = i;
+        }
+    }
+
+    Poligono resultado = poligono_criar();
+    if (resultado == NULL) return NULL;
+
+    int rastrear = visiveis != NULL && num_visiveis != NULL;
+    unsigned char *ja_visivel = NULL;
+    if (rastrear)
+    {
+        int n = vetor_segmentos_tamanho(m->segmentos);
+        ja_visivel = (unsigned char*)arena_alocar(arena, n + 1);
+        if (ja_visivel == NULL)
+        {
+            poligono_destruir(resultado);
+            return NULL;
+        }
+        memset(ja_visivel, 0, n + 1);
+    }
+
+    UltimoVertice ultimo = {0.0, 0.0, 0};
+    double cx = 0.0;
+    if (atravessa)
+    {
+        /* Começa no ponto do raio de ângulo 0 e termina nele */
+        const Pedaco *p = &pedacos[inicio];
+        double s = (qy - p->ry) / (p->ly - p->ry);
+        cx = p->rx + s * (p->lx - p->rx);
+        emitir_vertice(resultado, &ultimo, cx, qy);
+        emitir_vertice(resultado, &ultimo, p->lx, p->ly);
+    }
+
+    for (int n = 0; n < num_pedacos; n++)
+    {
+        const Pedaco *p = &pedacos[(inicio + n) % num_pedacos];
+
+        if (rastrear && p->seg >= 0 && !ja_visivel[p->seg] &&
+            (fabs(p->rx - p->lx) >= EPSILON || fabs(p->ry - p->ly) >= EPSILON))
+        {
+            ja_visivel[p->seg] = 1;
+            visiveis[(*num_visiveis)++] = p->seg;
+        }
+
+        if (n == 0 && atravessa) continue;
+        emitir_vertice(resultado, &ultimo, p->rx, p->ry);
+        emitir_vertice(resultado, &ultimo, p->lx, p->ly);
+    }
+
+    if (atravessa)
+    {
+        emitir_vertice(resultado, &ultimo, pedacos[inicio].rx, pedacos[inicio].ry);
+        emitir_vertice(resultado, &ultimo, cx, qy);
+    }
+
+    return resultado;
+}
+
+int expansao_num_triangulos(MotorExpansao motor)
+{
+    MotorInternal *m = (MotorInternal*)motor;
+    return (m != NULL && m->tri != NULL) ? triangulacao_num_triangulos(m->tri) : 0;
+}
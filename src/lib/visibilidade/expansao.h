@@ -0,0 +1,103 @@
+/* expansao.h
+ *
+ * Motor de Visibilidade por Expansão Triangular
+ * Alternativa à varredura angular para muitas bombas contra os mesmos
+ * anteparos. Os anteparos são triangulados uma única vez (triangulação
+ * restrita da bounding box, refeita quando a versão do vetor de
+ * anteparos ou a bounding box mudam); cada bomba é respondida a partir
+ * do triângulo que a contém, atravessando as arestas livres e
+ * estreitando o cone de visão até encontrar anteparos ou a borda.
+ *
+ * O custo de uma bomba depende dos triângulos que ela enxerga, e não do
+ * total de anteparos; em troca, a triangulação precisa ser montada antes
+ * da primeira bomba. Com anteparos que não se cruzam, os dois motores
+ * coincidem com o lançamento de raios (teste_visibilidade confere), mas a
+ * lista de vértices pode ter pontos colineares a mais ou a menos, e um
+ * anteparo visto de perfil, alinhado com a bomba, pode entrar na lista de
+ * visíveis da varredura e não na da expansão. Anteparos que se cruzam são
+ * cortados no ponto de cruzamento, o que a varredura não faz, e as regiões
+ * diferem ali. Bombas fora da bounding box ou sobre uma aresta da
+ * triangulação não são atendidas: o chamador usa a varredura.
+ */
+
+#ifndef EXPANSAO_H
+#define EXPANSAO_H
+
+#include "visibilidade.h"
+#include "vetor_segmentos.h"
+#include "arena.h"
+
+/* Motores de visibilidade (opção -vis) */
+typedef enum {
+    MOTOR_VARREDURA,
+    MOTOR_EXPANSAO
+} MotorVisibilidade;
+
+/* Tipo opaco para o motor de expansão */
+typedef void* MotorExpansao;
+
+/**
+ * Converte o nome dado em -vis para o motor.
+ * Aceita "v"/"varredura" e "e"/"expansao".
+ * @param nome Nome do motor (NULL = varredura)
+ * @return Motor correspondente (MOTOR_VARREDURA se desconhecido)
+ */
+MotorVisibilidade motor_por_nome(const char *nome);
+
+/* ============================================================================
+ * Funções de Criação e Destruição
+ * ============================================================================ */
+
+/**
+ * Cria um motor sem triangulação (montada em expansao_preparar).
+ * @return Novo motor, ou NULL em caso de erro
+ */
+MotorExpansao expansao_criar(void);
+
+/**
+ * Destroi o motor e a triangulação.
+ * @param motor Motor a ser destruído
+ */
+void expansao_destruir(MotorExpansao motor);
+
+/* ============================================================================
+ * Funções de Operação
+ * ============================================================================ */
+
+/**
+ * Monta a triangulação dos anteparos, se ela não corresponde à versão
+ * atual do vetor ou à bounding box. Deve ser chamada antes das consultas
+ * e fora das threads de cálculo.
+ * @param motor Motor
+ * @param segmentos Vetor de anteparos
+ * @param min_x, min_y, max_x, max_y Bounding box do cenário (a mesma da
+ *        varredura; a margem é acrescentada aqui)
+ * @return 1 se o motor pode atender consultas, 0 caso contrário
+ */
+int expansao_preparar(MotorExpansao motor, VetorSegmentos segmentos,
+                      double min_x, double min_y, double max_x, double max_y);
+
+/**
+ * Calcula o polígono de visibilidade de uma bomba pela triangulação.
+ * Só lê o motor: várias threads podem consultar ao mesmo tempo, cada uma
+ * com a sua arena.
+ * @param motor Motor preparado
+ * @param x, y Posição da bomba
+ * @param visiveis OUT (NULL se não precisa): índices dos segmentos que
+ *                 bloquearam luz, em ordem angular a partir do ângulo 0 e
+ *                 sem repetição (espaço para vetor_segmentos_tamanho)
+ * @param num_visiveis OUT: quantidade de índices
+ * @param arena Arena para os temporários da consulta
+ * @return Polígono de visibilidade, ou NULL se a bomba não pode ser
+ *         atendida (o chamador usa a varredura)
+ */
+PoligonoVisibilidade expansao_calcular(MotorExpansao motor, double x, double y,
+                                       int *visiveis, int *num_visiveis,
+                                       Arena arena);
+
+/**
+ * Obtém o número de triângulos da triangulação atual (0 se não montada).
+ */
+int expansao_num_triangulos(MotorExpansao motor);
+
+#endif /* EXPANSAO_H */
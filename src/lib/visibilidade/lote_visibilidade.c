@@ -0,0 +1,571 @@
+/* lote_visibilidade.c
+ *
+ * Implementação do TAD Lote de Visibilidade
+ * As bombas são distribuídas sob demanda: cada thread retira a próxima
+ * posição livre (contador protegido por mutex) e calcula com a sua
+ * arena. A thread chamadora também trabalha, como thread 0.
+ *
+ * Se só uma bomba do lote precisa ser calculada, as threads trabalham
+ * nela (varredura por setores, calcular_visibilidade_setores).
+ *
+ * Com cache, as bombas já conhecidas são resolvidas antes das threads
+ * começarem; uma bomba na mesma posição de outra ainda pendente no lote
+ * espera o resultado dela e o busca no cache depois do cálculo.
+ *
+ * Com o motor de expansão, a triangulação é (re)montada antes das
+ * threads, e cada bomba que ela não atende cai na varredura.
+ *
+ * Com simplificação, cada polígono é simplificado na própria thread,
+ * antes de ir para o cache e para os comandos.
+ *
+ * Bombas com raio usam a varredura sobre os anteparos perto delas: a
+ * grade de segmentos é (re)montada antes das threads, e essas bombas não
+ * passam pela expansão nem pela divisão em setores.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "lote_visibilidade.h"
+#include "visibilidade.h"
+#include "cache_visibilidade.h"
+#include "expansao.h"
+#include "grade_segmentos.h"
+#include "vetor_segmentos.h"
+#include "ponto.h"
+#include "arena.h"
+
+/* ============================================================================
+ * Estrutura Interna
+ * ============================================================================ */
+
+typedef enum
+{
+    TAREFA_CALCULAR,
+    TAREFA_RESOLVIDA,       /* Resultado veio do cache */
+    TAREFA_ADIADA           /* Espera outra bomba do lote na mesma posição */
+} EstadoTarefa;
+
+/* Uma bomba do lote e o seu resultado */
+typedef struct tarefa
+{
+    double x, y;
+    double raio;            /* Alcance da bomba (0: sem limite) */
+    int rastrear_segmentos;
+    EstadoTarefa estado;
+    PoligonoVisibilidade poligono;
+    int *visiveis;
+    int num_visiveis;
+    int expandida;          /* Resultado veio da expansão triangular */
+    int vertices_originais; /* Vértices antes da simplificação */
+} Tarefa;
+
+/* Argumento de cada thread de cálculo */
+typedef struct trabalhador
+{
+    struct lote_internal *lote;
+    Arena arena;
+} Trabalhador;
+
+typedef struct lote_internal
+{
+    Tarefa *tarefas;
+    int tamanho;
+    int capacidade;
+
+    int num_threads;
+    Arena *arenas;          /* Uma arena por thread */
+    pthread_t *threads;     /* Threads auxiliares (a 0 é a chamadora) */
+    Trabalhador *trabalhadores;
+
+    MotorExpansao expansao; /* NULL: só varredura */
+    int expansao_pronta;    /* Triangulação vale para o cálculo em andamento */
+    int expandidas;         /* Bombas atendidas pela expansão */
+    int recusadas;          /* Bombas que a expansão devolveu à varredura */
+
+    GradeSegmentos indice;  /* Anteparos por região, para as bombas com raio */
+    int indice_pronto;      /* Grade vale para o cálculo em andamento */
+
+    double tolerancia;      /* Simplificação dos polígonos (0: desligada) */
+    long vertices_antes;    /* Vértices calculados, antes da simplificação */
+    long vertices_depois;
+
+    /* Parâmetros do cálculo em andamento (somente leitura nas threads) */
+    VetorSegmentos anteparos;
+    double *bbox;
+    const char *tipo_ordenacao;
+    int limiar_insertion;
+
+    pthread_mutex_t trava;
+    int proxima;            /* Próxima tarefa livre (protegida pela trava) */
+} LoteInternal;
+
+/* ============================================================================
+ * Funções Auxiliares
+ * ============================================================================ */
+
+/**
+ * Calcula uma bomba. Com mais de uma arena, a própria varredura é
+ * dividida em setores, um por thread (arenas[i] é a arena da thread i).
+ */
+static void calcular_tarefa_setores(LoteInternal *l, Tarefa *t, Arena *arenas, int num_setores)
+{
+    Arena arena = arenas[0];
+
+    int *visiveis = NULL;
+    if (t->rastrear_segmentos)
+    {
+        visiveis = (int*)arena_alocar(arena, (vetor_segmentos_tamanho(l->anteparos) + 1) * sizeof(int));
+        if (visiveis == NULL)
+        {
+            fprintf(stderr, "Erro: falha ao alocar segmentos visíveis\n");
+            return;
+        }
+    }
+
+    t->visiveis = visiveis;
+    t->num_visiveis = 0;
+
+    if (t->raio > 0.0)
+    {
+        Ponto origem = criar_ponto(t->x, t->y);
+        t->poligono = calcular_visibilidade_raio(
+            origem, l->anteparos, l->indice_pronto ? l->indice : NULL, t->raio,
+            l->bbox[0], l->bbox[1], l->bbox[2], l->bbox[3],
+            l->tipo_ordenacao, l->limiar_insertion,
+            visiveis, visiveis ? &t->num_visiveis : NULL, arena
+        );
+        destruir_ponto(origem);
+    }
+    else if (l->expansao_pronta)
+    {
+        t->poligono = expansao_calcular(l->expansao, t->x, t->y,
+                                        visiveis, visiveis ? &t->num_visiveis : NULL, arena);
+        t->expandida = t->poligono != NULL;
+    }
+
+    if (t->poligono == NULL && t->raio <= 0.0)
+    {
+        Ponto origem = criar_ponto(t->x, t->y);
+        t->poligono = calcular_visibilidade_setores(
+            origem, l->anteparos,
+            l->bbox[0], l->bbox[1], l->bbox[2], l->bbox[3],
+            l->tipo_ordenacao, l->limiar_insertion,
+            visiveis, visiveis ? &t->num_visiveis : NULL, arenas, num_setores
+        );
+        destruir_ponto(origem);
+    }
+
+    t->vertices_originais = poligono_num_vertices(t->poligono);
+    if (l->tolerancia > 0.0 && t->poligono != NULL)
+    {
+        poligono_simplificar(t->poligono, l->tolerancia);
+    }
+}
+
+static void calcular_tarefa(LoteInternal *l, Tarefa *t, Arena arena)
+{
+    calcular_tarefa_setores(l, t, &arena, 1);
+}
+
+static void* executar_trabalhador(void *arg)
+{
+    Trabalhador *w = (Trabalhador*)arg;
+    LoteInternal *l = w->lote;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&l->trava);
+        int i = l->proxima++;
+        pthread_mutex_unlock(&l->trava);
+
+        if (i >= l->tamanho) break;
+        if (l->tarefas[i].estado == TAREFA_CALCULAR)
+        {
+            calcular_tarefa(l, &l->tarefas[i], w->arena);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Calcula as bombas que não foram resolvidas pelo cache, em paralelo.
+ */
+static void calcular_pendentes(LoteInternal *l)
+{
+    /* Uma só bomba a calcular: as threads dividem a varredura dela */
+    int pendentes = 0, unica = -1;
+    for (int i = 0; i < l->tamanho; i++)
+    {
+        if (l->tarefas[i].estado == TAREFA_CALCULAR)
+        {
+            pendentes++;
+            unica = i;
+        }
+    }
+    if (pendentes == 1 && l->num_threads > 1 && !l->expansao_pronta &&
+        l->tarefas[unica].raio <= 0.0)
+    {
+        calcular_tarefa_setores(l, &l->tarefas[unica], l->arenas, l->num_threads);
+        return;
+    }
+
+    int num_threads = l->num_threads < l->tamanho ? l->num_threads : l->tamanho;
+    if (num_threads <= 1)
+    {
+        for (int i = 0; i < l->tamanho; i++)
+        {
+            if (l->tarefas[i].estado == TAREFA_CALCULAR)
+            {
+                calcular_tarefa(l, &l->tarefas[i], l->arenas[0]);
+            }
+        }
+        return;
+    }
+
+    pthread_t *threads = l->threads;
+    Trabalhador *trabalhadores = l->trabalhadores;
+    int criadas = 1;
+
+    /* Threads auxiliares 1..n-1; se alguma falhar, as demais absorvem o trabalho */
+    for (int i = 1; i < num_threads; i++)
+    {
+        if (pthread_create(&threads[i], NULL, executar_trabalhador, &trabalhadores[i]) != 0)
+        {
+            fprintf(stderr, "Aviso: falha ao criar thread de visibilidade\n");
+            break;
+        }
+        criadas++;
+    }
+
+    executar_trabalhador(&trabalhadores[0]);
+
+    for (int i = 1; i < criadas; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+/**
+ * Resolve pelo cache as bombas já conhecidas e adia as que repetem a
+ * posição de outra bomba ainda pendente no lote (antes das threads).
+ */
+static void consultar_cache(LoteInternal *l, CacheVisibilidade cache)
+{
+    unsigned versao = vetor_segmentos_versao(l->anteparos);
+
+    for (int i = 0; i < l->tamanho; i++)
+    {
+        Tarefa *t = &l->tarefas[i];
+
+        int j;
+        for (j = 0; j < i; j++)
+        {
+            Tarefa *anterior = &l->tarefas[j];
+            if (anterior->estado == TAREFA_CALCULAR && anterior->x == t->x && anterior->y == t->y &&
+                anterior->raio == t->raio &&
+                (anterior->rastrear_segmentos || !t->rastrear_segmentos))
+            {
+                break;
+            }
+        }
+        if (j < i)
+        {
+            t->estado = TAREFA_ADIADA;
+            continue;
+        }
+
+        t->poligono = cache_visibilidade_buscar(cache, t->x, t->y, t->raio, versao, l->arenas[0],
+                                                t->rastrear_segmentos ? &t->visiveis : NULL,
+                                                &t->num_visiveis);
+        if (t->poligono != NULL) t->estado = TAREFA_RESOLVIDA;
+    }
+}
+
+/**
+ * Guarda no cache os resultados calculados e resolve as bombas adiadas
+ * (calculando as que não encontrarem o resultado, se ele foi substituído).
+ */
+static void completar_pelo_cache(LoteInternal *l, CacheVisibilidade cache)
+{
+    unsigned versao = vetor_segmentos_versao(l->anteparos);
+
+    for (int i = 0; i < l->tamanho; i++)
+    {
+        Tarefa *t = &l->tarefas[i];
+        if (t->estado == TAREFA_CALCULAR)
+        {
+            cache_visibilidade_guardar(cache, t->x, t->y, t->raio, versao, t->poligono,
+                                       t->visiveis, t->num_visiveis);
+        }
+    }
+
+    for (int i = 0; i < l->tamanho; i++)
+    {
+        Tarefa *t = &l->tarefas[i];
+        if (t->estado != TAREFA_ADIADA) continue;
+
+        t->poligono = cache_visibilidade_buscar(cache, t->x, t->y, t->raio, versao, l->arenas[0],
+                                                t->rastrear_segmentos ? &t->visiveis : NULL,
+                                                &t->num_visiveis);
+        if (t->poligono == NULL) calcular_tarefa(l, t, l->arenas[0]);
+    }
+}
+
+/* ============================================================================
+ * Implementação das Funções de Criação e Destruição
+ * ============================================================================ */
+
+LoteVisibilidade lote_visibilidade_criar(int num_threads, int capacidade,
+                                         MotorVisibilidade motor)
+{
+    if (num_threads < 1) num_threads = 1;
+    if (capacidade < 1) capacidade = 1;
+
+    LoteInternal *l = (LoteInternal*)malloc(sizeof(LoteInternal));
+    if (l == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao alocar lote de visibilidade.\n");
+        return NULL;
+    }
+
+    l->tarefas = (Tarefa*)malloc(capacidade * sizeof(Tarefa));
+    l->arenas = (Arena*)calloc(num_threads, sizeof(Arena));
+    l->threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+    l->trabalhadores = (Trabalhador*)malloc(num_threads * sizeof(Trabalhador));
+    l->expansao = (motor == MOTOR_EXPANSAO) ? expansao_criar() : NULL;
+    l->indice = grade_segmentos_criar();
+    if (l->tarefas == NULL || l->arenas == NULL || l->threads == NULL ||
+        l->trabalhadores == NULL || l->indice == NULL ||
+        (motor == MOTOR_EXPANSAO && l->expansao == NULL))
+    {
+        fprintf(stderr, "Erro: falha ao alocar lote de visibilidade.\n");
+        grade_segmentos_destruir(l->indice);
+        expansao_destruir(l->expansao);
+        free(l->tarefas);
+        free(l->arenas);
+        free(l->threads);
+        free(l->trabalhadores);
+        free(l);
+        return NULL;
+    }
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        l->arenas[i] = arena_criar(0);
+        if (l->arenas[i] == NULL)
+        {
+            for (int j = 0; j < i; j++) arena_destruir(l->arenas[j]);
+            grade_segmentos_destruir(l->indice);
+            expansao_destruir(l->expansao);
+            free(l->tarefas);
+            free(l->arenas);
+            free(l->threads);
+            free(l->trabalhadores);
+            free(l);
+            return NULL;
+        }
+        l->trabalhadores[i].lote = l;
+        l->trabalhadores[i].arena = l->arenas[i];
+    }
+
+    l->tamanho = 0;
+    l->capacidade = capacidade;
+    l->num_threads = num_threads;
+    l->anteparos = NULL;
+    l->bbox = NULL;
+    l->tipo_ordenacao = NULL;
+    l->limiar_insertion = 0;
+    l->expansao_pronta = 0;
+    l->indice_pronto = 0;
+    l->expandidas = 0;
+    l->recusadas = 0;
+    l->tolerancia = 0.0;
+    l->vertices_antes = 0;
+    l->vertices_depois = 0;
+    l->proxima = 0;
+    pthread_mutex_init(&l->trava, NULL);
+
+    return (LoteVisibilidade)l;
+}
+
+void lote_visibilidade_destruir(LoteVisibilidade lote)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    if (l == NULL) return;
+
+    lote_visibilidade_limpar(lote);
+    for (int i = 0; i < l->num_threads; i++)
+    {
+        arena_destruir(l->arenas[i]);
+    }
+
+    grade_segmentos_destruir(l->indice);
+    expansao_destruir(l->expansao);
+    pthread_mutex_destroy(&l->trava);
+    free(l->arenas);
+    free(l->threads);
+    free(l->trabalhadores);
+    free(l->tarefas);
+    free(l);
+}
+
+/* ============================================================================
+ * Implementação das Funções de Operação
+ * ============================================================================ */
+
+int lote_visibilidade_adicionar(LoteVisibilidade lote, double x, double y,
+                                double raio, int rastrear_segmentos)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    if (l == NULL || l->tamanho >= l->capacidade) return -1;
+
+    Tarefa *t = &l->tarefas[l->tamanho];
+    t->x = x;
+    t->y = y;
+    t->raio = raio > 0.0 ? raio : 0.0;
+    t->rastrear_segmentos = rastrear_segmentos;
+    t->estado = TAREFA_CALCULAR;
+    t->poligono = NULL;
+    t->visiveis = NULL;
+    t->num_visiveis = 0;
+    t->expandida = 0;
+    t->vertices_originais = 0;
+
+    return l->tamanho++;
+}
+
+int lote_visibilidade_calcular(LoteVisibilidade lote, VetorSegmentos anteparos,
+                               double bbox[4], const char *tipo_ordenacao,
+                               int limiar_insertion, CacheVisibilidade cache)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    if (l == NULL || bbox == NULL) return 0;
+
+    l->anteparos = anteparos;
+    l->bbox = bbox;
+    l->tipo_ordenacao = tipo_ordenacao;
+    l->limiar_insertion = limiar_insertion;
+    l->proxima = 0;
+
+    if (cache != NULL) consultar_cache(l, cache);
+
+    int calcular = 0, com_raio = 0;
+    for (int i = 0; i < l->tamanho; i++)
+    {
+        if (l->tarefas[i].estado != TAREFA_CALCULAR) continue;
+        if (l->tarefas[i].raio > 0.0) com_raio = 1;
+        else calcular = 1;
+    }
+
+    /* A grade de segmentos também só muda com a versão dos anteparos */
+    l->indice_pronto = com_raio && grade_segmentos_preparar(l->indice, anteparos);
+
+    /* A triangulação é montada uma vez por versão dos anteparos */
+    l->expansao_pronta = 0;
+    if (l->expansao != NULL)
+    {
+        if (calcular)
+        {
+            l->expansao_pronta = expansao_preparar(l->expansao, anteparos,
+                                                   bbox[0], bbox[1], bbox[2], bbox[3]);
+        }
+    }
+
+    calcular_pendentes(l);
+
+    for (int i = 0; i < l->tamanho; i++)
+    {
+        Tarefa *t = &l->tarefas[i];
+        if (t->estado != TAREFA_CALCULAR) continue;
+        l->vertices_antes += t->vertices_originais;
+        l->vertices_depois += poligono_num_vertices(t->poligono);
+        if (l->expansao == NULL || t->raio > 0.0) continue;
+        if (t->expandida) l->expandidas++;
+        else l->recusadas++;
+    }
+
+    if (cache != NULL) completar_pelo_cache(l, cache);
+    return 1;
+}
+
+PoligonoVisibilidade lote_visibilidade_extrair_poligono(LoteVisibilidade lote, int indice)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    if (l == NULL || indice < 0 || indice >= l->tamanho) return NULL;
+
+    PoligonoVisibilidade poligono = l->tarefas[indice].poligono;
+    l->tarefas[indice].poligono = NULL;
+    return poligono;
+}
+
+int* lote_visibilidade_segmentos(LoteVisibilidade lote, int indice, int *num_visiveis)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    if (l == NULL || indice < 0 || indice >= l->tamanho)
+    {
+        if (num_visiveis) *num_visiveis = 0;
+        return NULL;
+    }
+
+    if (num_visiveis) *num_visiveis = l->tarefas[indice].num_visiveis;
+    return l->tarefas[indice].visiveis;
+}
+
+void lote_visibilidade_limpar(LoteVisibilidade lote)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    if (l == NULL) return;
+
+    for (int i = 0; i < l->tamanho; i++)
+    {
+        if (l->tarefas[i].poligono != NULL)
+        {
+            destruir_poligono_visibilidade(l->tarefas[i].poligono);
+        }
+    }
+
+    for (int i = 0; i < l->num_threads; i++)
+    {
+        arena_resetar(l->arenas[i]);
+    }
+
+    l->tamanho = 0;
+}
+
+int lote_visibilidade_tamanho(LoteVisibilidade lote)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    return l ? l->tamanho : 0;
+}
+
+int lote_visibilidade_cheio(LoteVisibilidade lote)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    return l ? l->tamanho >= l->capacidade : 1;
+}
+
+void lote_visibilidade_estatisticas_expansao(LoteVisibilidade lote, int *expandidas,
+                                            int *recusadas)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    if (expandidas) *expandidas = l ? l->expandidas : 0;
+    if (recusadas) *recusadas = l ? l->recusadas : 0;
+}
+
+void lote_visibilidade_definir_simplificacao(LoteVisibilidade lote, double tolerancia)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    if (l == NULL) return;
+    l->tolerancia = tolerancia > 0.0 ? tolerancia : 0.0;
+}
+
+void lote_visibilidade_estatisticas_simplificacao(LoteVisibilidade lote, long *antes,
+                                                 long *depois)
+{
+    LoteInternal *l = (LoteInternal*)lote;
+    if (antes) *antes = l ? l->vertices_antes : 0;
+    if (depois) *depois = l ? l->vertices_depois : 0;
+}
@@ -0,0 +1,142 @@
+/* lote_visibilidade.h
+ *
+ * TAD Lote de Visibilidade
+ * Calcula em paralelo (pthreads) os polígonos de visibilidade de várias
+ * bombas contra o mesmo conjunto de anteparos. O vetor de anteparos é
+ * apenas lido durante o cálculo; os efeitos de cada bomba são aplicados
+ * depois, pelo chamador, na ordem do arquivo.
+ *
+ * Cada thread tem sua própria arena. Os índices dos segmentos visíveis
+ * de um resultado valem até lote_visibilidade_limpar.
+ *
+ * O motor de expansão (expansao.h) troca a varredura pela expansão
+ * triangular nas bombas que ele consegue atender. Bombas com raio usam
+ * sempre a varredura limitada ao disco (calcular_visibilidade_raio).
+ */
+
+#ifndef LOTE_VISIBILIDADE_H
+#define LOTE_VISIBILIDADE_H
+
+#include "visibilidade.h"
+#include "vetor_segmentos.h"
+#include "cache_visibilidade.h"
+#include "expansao.h"
+
+/* Tipo opaco para o Lote */
+typedef void* LoteVisibilidade;
+
+/* ============================================================================
+ * Funções de Criação e Destruição
+ * ============================================================================ */
+
+/**
+ * Cria um lote vazio.
+ * @param num_threads Número de threads de cálculo (1 calcula na thread atual)
+ * @param capacidade Número máximo de bombas por lote
+ * @param motor Motor de visibilidade (MOTOR_EXPANSAO mantém uma
+ *              triangulação dos anteparos entre os lotes)
+ * @return Novo lote, ou NULL em caso de erro
+ */
+LoteVisibilidade lote_visibilidade_criar(int num_threads, int capacidade,
+                                         MotorVisibilidade motor);
+
+/**
+ * Destroi o lote, os polígonos ainda não extraídos e as arenas.
+ * @param lote Lote a ser destruído
+ */
+void lote_visibilidade_destruir(LoteVisibilidade lote);
+
+/* ============================================================================
+ * Funções de Operação
+ * ============================================================================ */
+
+/**
+ * Adiciona uma bomba ao lote.
+ * @param lote Lote de destino
+ * @param x Coordenada X da bomba
+ * @param y Coordenada Y da bomba
+ * @param raio Alcance da bomba (<= 0: sem limite)
+ * @param rastrear_segmentos Se não-zero, guarda os índices dos segmentos visíveis
+ * @return Posição da bomba no lote, ou -1 se o lote estiver cheio
+ */
+int lote_visibilidade_adicionar(LoteVisibilidade lote, double x, double y,
+                                double raio, int rastrear_segmentos);
+
+/**
+ * Calcula os polígonos de todas as bombas do lote.
+ * @param lote Lote de bombas
+ * @param anteparos Vetor de segmentos (somente leitura durante o cálculo)
+ * @param bbox Bounding box do cenário [min_x, min_y, max_x, max_y]
+ * @param tipo_ordenacao Algoritmo de ordenação dos eventos
+ * @param limiar_insertion Limiar para InsertionSort
+ * @param cache Resultados já calculados para a versão atual dos anteparos
+ *              (NULL: calcula todas as bombas)
+ * @return 1 em caso de sucesso, 0 em caso de erro
+ */
+int lote_visibilidade_calcular(LoteVisibilidade lote, VetorSegmentos anteparos,
+                               double bbox[4], const char *tipo_ordenacao,
+                               int limiar_insertion, CacheVisibilidade cache);
+
+/**
+ * Retira o polígono de uma bomba do lote. O chamador passa a ser o dono.
+ * @param lote Lote calculado
+ * @param indice Posição da bomba
+ * @return Polígono, ou NULL se o cálculo falhou ou já foi extraído
+ */
+PoligonoVisibilidade lote_visibilidade_extrair_poligono(LoteVisibilidade lote, int indice);
+
+/**
+ * Obtém os índices dos segmentos visíveis de uma bomba.
+ * @param lote Lote calculado
+ * @param indice Posição da bomba
+ * @param num_visiveis OUT: quantidade de índices
+ * @return Vetor de índices (NULL se a bomba não rastreou segmentos)
+ */
+int* lote_visibilidade_segmentos(LoteVisibilidade lote, int indice, int *num_visiveis);
+
+/**
+ * Esvazia o lote: destroi os polígonos não extraídos e reinicia as arenas.
+ * @param lote Lote a ser esvaziado
+ */
+void lote_visibilidade_limpar(LoteVisibilidade lote);
+
+/**
+ * Obtém o número de bombas no lote.
+ */
+int lote_visibilidade_tamanho(LoteVisibilidade lote);
+
+/**
+ * Verifica se o lote atingiu a capacidade.
+ */
+int lote_visibilidade_cheio(LoteVisibilidade lote);
+
+/**
+ * Obtém quantas bombas calculadas (desde a criação) foram atendidas pela
+ * expansão triangular e quantas ela devolveu à varredura.
+ * @param lote Lote
+ * @param expandidas OUT: bombas atendidas pela expansão
+ * @param recusadas OUT: bombas calculadas pela varredura
+ */
+void lote_visibilidade_estatisticas_expansao(LoteVisibilidade lote, int *expandidas,
+                                            int *recusadas);
+
+/**
+ * Liga a simplificação dos polígonos calculados (poligono_simplificar).
+ * Vale para os próximos cálculos; os resultados guardados no cache já
+ * saem simplificados.
+ * @param lote Lote
+ * @param tolerancia Desvio máximo da região, em unidades do cenário (<= 0: desliga)
+ */
+void lote_visibilidade_definir_simplificacao(LoteVisibilidade lote, double tolerancia);
+
+/**
+ * Obtém o total de vértices dos polígonos calculados (desde a criação),
+ * antes e depois da simplificação.
+ * @param lote Lote
+ * @param antes OUT: vértices como saíram do cálculo
+ * @param depois OUT: vértices após a simplificação
+ */
+void lote_visibilidade_estatisticas_simplificacao(LoteVisibilidade lote, long *antes,
+                                                 long *depois);
+
+#endif /* LOTE_VISIBILIDADE_H */
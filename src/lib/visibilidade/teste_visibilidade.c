@@ -0,0 +1,286 @@
+/* teste_visibilidade.c
+ * Teste da varredura angular contra o lançamento de raios
+ *
+ * Cenários pequenos de retângulos que não se tocam: cada bomba é
+ * conferida raio a raio contra o primeiro anteparo atingido, e os
+ * segmentos visíveis informados contra os que os raios enxergam. O motor
+ * de expansão triangular passa pela mesma conferência e tem de informar
+ * os mesmos segmentos que a varredura.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include "visibilidade.h"
+#include "expansao.h"
+#include "vetor_segmentos.h"
+#include "ponto.h"
+#include "arena.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define LADO 100.0
+#define NUM_RAIOS 2000
+#define MAX_RETANGULOS 12
+
+typedef struct {
+    double x, y, w, h;
+} Retangulo;
+
+static unsigned semente;
+
+static int sortear(int n) {
+    semente = semente * 1103515245u + 12345u;
+    return (int)((semente >> 8) % (unsigned)n);
+}
+
+/* Retângulos de coordenadas inteiras, com folga entre eles */
+static int gerar_cena(Retangulo *r, int quantidade, VetorSegmentos segs) {
+    int n = 0;
+    for (int tentativa = 0; n < quantidade && tentativa < 1000; tentativa++) {
+        double w = 3 + sortear(15), h = 3 + sortear(15);
+        double x = sortear((int)(LADO - w)), y = sortear((int)(LADO - h));
+        int livre = 1;
+        for (int i = 0; i < n && livre; i++) {
+            livre = x + w + 2 < r[i].x || r[i].x + r[i].w + 2 < x ||
+                    y + h + 2 < r[i].y || r[i].y + r[i].h + 2 < y;
+        }
+        if (!livre) continue;
+
+        r[n] = (Retangulo){ x, y, w, h };
+        int id = 4 * n;
+        vetor_segmentos_adicionar(segs, id, n, x, y, x + w, y, "k");
+        vetor_segmentos_adicionar(segs, id + 1, n, x + w, y, x + w, y + h, "k");
+        vetor_segmentos_adicionar(segs, id + 2, n, x + w, y + h, x, y + h, "k");
+        vetor_segmentos_adicionar(segs, id + 3, n, x, y + h, x, y, "k");
+        n++;
+    }
+    return n;
+}
+
+static int dentro(const Retangulo *r, int n, double x, double y) {
+    for (int i = 0; i < n; i++) {
+        if (x >= r[i].x && x <= r[i].x + r[i].w && y >= r[i].y && y <= r[i].y + r[i].h) return 1;
+    }
+    return 0;
+}
+
+/* Distância até o segmento ao longo de (dx, dy), ou -1 */
+static double distancia(double ox, double oy, double dx, double dy,
+                        double x1, double y1, double x2, double y2) {
+    double ax = x1 - ox, ay = y1 - oy, ex = x2 - x1, ey = y2 - y1;
+    double den = dx * ey - dy * ex;
+    if (fabs(den) < 1e-15) return -1;
+    double t = (ax * ey - ay * ex) / den;
+    double u = (ax * dy - ay * dx) / den;
+    return (t > 0 && u >= 0 && u <= 1) ? t : -1;
+}
+
+/* Primeiro segmento atingido pelo raio (-1 se nenhum) */
+static int primeiro_atingido(VetorSegmentos segs, double ox, double oy,
+                             double dx, double dy, double *dist) {
+    const double *x1, *y1, *x2, *y2;
+    int n = vetor_segmentos_coordenadas(segs, &x1, &y1, &x2, &y2);
+    int melhor = -1;
+    for (int j = 0; j < n; j++) {
+        double t = distancia(ox, oy, dx, dy, x1[j], y1[j], x2[j], y2[j]);
+        if (t > 0 && (melhor < 0 || t < *dist)) {
+            melhor = j;
+            *dist = t;
+        }
+    }
+    return melhor;
+}
+
+/* Algum ponto interno do segmento é visto sem obstáculo no caminho (de
+ * perfil, alinhado com a bomba, basta o extremo mais perto) */
+static int segmento_enxergado(VetorSegmentos segs, int seg, double ox, double oy) {
+    const double *x1, *y1, *x2, *y2;
+    vetor_segmentos_coordenadas(segs, &x1, &y1, &x2, &y2);
+    double ax = x1[seg] - ox, ay = y1[seg] - oy, bx = x2[seg] - ox, by = y2[seg] - oy;
+    if (ax * by - ay * bx == 0) {
+        int perto = ax * ax + ay * ay < bx * bx + by * by;
+        double dist = 1.0;
+        primeiro_atingido(segs, ox, oy, perto ? ax : bx, perto ? ay : by, &dist);
+        return dist >= 1.0 - 1e-9;
+    }
+    for (int k = 1; k < 400; k++) {
+        double s = k / 400.0;
+        double px = x1[seg] + s * (x2[seg] - x1[seg]);
+        double py = y1[seg] + s * (y2[seg] - y1[seg]);
+        double dist = 1.0;
+        int atingido = primeiro_atingido(segs, ox, oy, px - ox, py - oy, &dist);
+        if (atingido == seg || dist >= 1.0 - 1e-9) return 1;
+    }
+    return 0;
+}
+
+/* Confere uma bomba; devolve o número de raios errados */
+static int conferir_bomba(VetorSegmentos segs, PoligonoVisibilidade p, double ox, double oy,
+                          const int *visiveis, int num_visiveis) {
+    int nv;
+    const double *v = poligono_get_vertices_ref(p, &nv);
+    int n = vetor_segmentos_tamanho(segs);
+    char *informado = calloc(n, 1);
+    for (int i = 0; i < num_visiveis; i++) informado[visiveis[i]] = 1;
+
+    int erros = 0;
+    for (int k = 0; k < NUM_RAIOS; k++) {
+        double a = 2 * M_PI * (k + 0.37) / NUM_RAIOS, dx = cos(a), dy = sin(a);
+        double esperado = 0;
+        int seg = primeiro_atingido(segs, ox, oy, dx, dy, &esperado);
+        if (seg < 0) continue;  /* Só a borda: depende da margem da bounding box */
+
+        double obtido = -1;
+        for (int i = 0; i < nv; i++) {
+            int j = (i + 1) % nv;
+            double t = distancia(ox, oy, dx, dy, v[2 * i], v[2 * i + 1], v[2 * j], v[2 * j + 1]);
+            if (t > 0 && (obtido < 0 || t < obtido)) obtido = t;
+        }
+        if (fabs(obtido - esperado) > 1e-6 * esperado) erros++;
+        assert(informado[seg]);
+    }
+
+    /* Nenhum segmento informado está escondido (a face de trás de um retângulo) */
+    for (int i = 0; i < num_visiveis; i++) {
+        assert(segmento_enxergado(segs, visiveis[i], ox, oy));
+    }
+
+    free(informado);
+    return erros;
+}
+
+void teste_retangulos() {
+    printf("Teste Retângulos contra Raios: ");
+    Arena arena = arena_criar(0);
+    int bombas = 0;
+
+    for (int cena = 0; cena < 20; cena++) {
+        semente = 7919u * (cena + 1);
+        VetorSegmentos segs = vetor_segmentos_criar(4 * MAX_RETANGULOS);
+        Retangulo r[MAX_RETANGULOS];
+        int n = gerar_cena(r, 4 + cena % (MAX_RETANGULOS - 3), segs);
+        int *visiveis = malloc((4 * n + 1) * sizeof(int));
+
+        for (int b = 0; b < 10; b++) {
+            /* Metade das bombas alinhadas com cantos, metade fora da grade */
+            double ox = sortear((int)LADO), oy = sortear((int)LADO);
+            if (b % 2) {
+                ox += 0.25 * (1 + sortear(3));
+                oy += 0.25 * (1 + sortear(3));
+            }
+            if (dentro(r, n, ox, oy)) continue;
+
+            Ponto origem = criar_ponto(ox, oy);
+            int num_visiveis = 0;
+            PoligonoVisibilidade p = calcular_visibilidade_com_segmentos(
+                origem, segs, 0, 0, LADO, LADO, "qsort", 10, visiveis, &num_visiveis, arena);
+            assert(p != NULL);
+            assert(conferir_bomba(segs, p, ox, oy, visiveis, num_visiveis) == 0);
+
+            destruir_poligono_visibilidade(p);
+            destruir_ponto(origem);
+            arena_resetar(arena);
+            bombas++;
+        }
+
+        free(visiveis);
+        vetor_segmentos_destruir(segs);
+    }
+
+    assert(bombas > 100);
+    arena_destruir(arena);
+    printf("OK\n");
+}
+
+/* Remove da lista os segmentos alinhados com a bomba; devolve o novo tamanho */
+static int descartar_de_perfil(VetorSegmentos segs, int *visiveis, int n, double ox, double oy) {
+    const double *x1, *y1, *x2, *y2;
+    vetor_segmentos_coordenadas(segs, &x1, &y1, &x2, &y2);
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        int s = visiveis[i];
+        if ((x1[s] - ox) * (y2[s] - oy) - (y1[s] - oy) * (x2[s] - ox) != 0) visiveis[m++] = s;
+    }
+    return m;
+}
+
+static int comparar_inteiros(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+void teste_expansao() {
+    printf("Teste Expansão contra Varredura e Raios: ");
+    Arena arena = arena_criar(0);
+    MotorExpansao motor = expansao_criar();
+    int bombas = 0, recusadas = 0;
+
+    for (int cena = 0; cena < 20; cena++) {
+        semente = 104729u * (cena + 1);
+        VetorSegmentos segs = vetor_segmentos_criar(4 * MAX_RETANGULOS);
+        Retangulo r[MAX_RETANGULOS];
+        int n = gerar_cena(r, 4 + cena % (MAX_RETANGULOS - 3), segs);
+        int *vis_varredura = malloc((4 * n + 1) * sizeof(int));
+        int *vis_expansao = malloc((4 * n + 1) * sizeof(int));
+        assert(expansao_preparar(motor, segs, 0, 0, LADO, LADO));
+
+        for (int b = 0; b < 10; b++) {
+            double ox = sortear((int)LADO), oy = sortear((int)LADO);
+            if (b % 2) {
+                ox += 0.25 * (1 + sortear(3));
+                oy += 0.25 * (1 + sortear(3));
+            }
+            if (dentro(r, n, ox, oy)) continue;
+
+            int num_expansao = 0;
+            PoligonoVisibilidade e = expansao_calcular(motor, ox, oy, vis_expansao, &num_expansao, arena);
+            if (e == NULL) {  /* Sobre uma aresta da triangulação: o chamador usaria a varredura */
+                recusadas++;
+                arena_resetar(arena);
+                continue;
+            }
+            assert(conferir_bomba(segs, e, ox, oy, vis_expansao, num_expansao) == 0);
+
+            Ponto origem = criar_ponto(ox, oy);
+            int num_varredura = 0;
+            PoligonoVisibilidade v = calcular_visibilidade_com_segmentos(
+                origem, segs, 0, 0, LADO, LADO, "qsort", 10, vis_varredura, &num_varredura, arena);
+            assert(v != NULL);
+
+            /* Mesmo conjunto de segmentos, a menos dos vistos de perfil, que
+             * não bloqueiam luz (a ordem pode diferir nos casos colineares) */
+            num_varredura = descartar_de_perfil(segs, vis_varredura, num_varredura, ox, oy);
+            num_expansao = descartar_de_perfil(segs, vis_expansao, num_expansao, ox, oy);
+            assert(num_varredura == num_expansao);
+            qsort(vis_varredura, num_varredura, sizeof(int), comparar_inteiros);
+            qsort(vis_expansao, num_expansao, sizeof(int), comparar_inteiros);
+            for (int i = 0; i < num_varredura; i++) assert(vis_varredura[i] == vis_expansao[i]);
+
+            destruir_poligono_visibilidade(v);
+            destruir_poligono_visibilidade(e);
+            destruir_ponto(origem);
+            arena_resetar(arena);
+            bombas++;
+        }
+
+        free(vis_varredura);
+        free(vis_expansao);
+        vetor_segmentos_destruir(segs);
+    }
+
+    assert(bombas > 100 && recusadas < bombas / 4);
+    expansao_destruir(motor);
+    arena_destruir(arena);
+    printf("OK\n");
+}
+
+int main() {
+    printf("=== Testes Unitários: Visibilidade ===\n");
+    teste_retangulos();
+    teste_expansao();
+    printf("Todos os testes passaram!\n");
+    return 0;
+}
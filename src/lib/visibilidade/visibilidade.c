@@ -2,18 +2,43 @@
  *
  * Implementação do Algoritmo de Região de Visibilidade
  * Varredura Angular (Angular Plane Sweep)
+ *
+ * Os eventos são ordenados sem calcular ângulos: cada vértice é
+ * classificado em um semiplano em torno da origem e, dentro do mesmo
+ * semiplano, a ordem angular é dada pelo sinal do produto vetorial.
+ * Não há atan2/hypot nem tolerância na chave de ordenação.
+ *
+ * A varredura lê os anteparos direto dos vetores de coordenadas do
+ * VetorSegmentos, sem copiá-los; os segmentos são identificados pelo
+ * índice nesses vetores, seguidos dos extras (bounding box e pedaços da
+ * divisão no ângulo 0). Os extras, os eventos e a árvore vêm de uma
+ * arena, liberada de uma vez por comando.
+ *
+ * Varredura por setores (uma consulta grande em várias threads): a volta
+ * é dividida em setores angulares com limites escolhidos por amostragem
+ * dos eventos. Cada setor ordena os seus eventos e varre com uma árvore
+ * própria, semeada com os segmentos que cruzam o seu raio inicial (como
+ * a divisão no ângulo 0 faz para a varredura completa). Os vértices são
+ * costurados em ordem no fim. Se a árvore semeada de um setor não estiver
+ * na mesma ordem em que o setor anterior terminou, a varredura é refeita
+ * em série sobre os eventos já ordenados: o polígono é sempre o da
+ * varredura completa.
+ *
+ * Bombas com raio: o conjunto de trabalho é montado só com os anteparos
+ * que a grade de segmentos devolve perto da bomba, recortados ao disco,
+ * e o polígono varrido é recortado ao círculo no fim.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
 #include "sort.h"
 
 #include "visibilidade.h"
 #include "lista.h"
 #include "ponto.h"
-#include "segmento.h"
 #include "calculos.h"
 #include "arvore.h"
 #include "formas.h"
@@ -22,13 +47,14 @@
 #include "linha.h"
 #include "texto.h"
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
 #define EPSILON 1e-9
 #define MARGEM_BBOX 5.0
 
+/* Varredura por setores: eventos mínimos por setor e amostra por setor
+ * usada para escolher os limites */
+#define EVENTOS_MINIMOS_SETOR 8192
+#define AMOSTRA_POR_SETOR 64
+
 /* ============================================================================
  * Estruturas Internas
  * ============================================================================ */
@@ -39,16 +65,45 @@ typedef enum {
     EVENTO_FIM
 } TipoEvento;
 
+/* Semiplano do vértice em relação à origem (primeira chave da ordenação) */
+typedef enum {
+    SEMIPLANO_SUPERIOR,  /* ângulo em [0, π) */
+    SEMIPLANO_INFERIOR,  /* ângulo em [π, 2π) */
+    SEMIPLANO_FINAL      /* sobre o raio de ângulo 0, visto como 2π */
+} Semiplano;
+
 /* Evento da varredura (vértice de um segmento) */
 typedef struct evento
 {
-    Ponto ponto;        /* Coordenada do vértice */
-    double angulo;      /* Ângulo polar em relação à origem */
-    double distancia;   /* Distância até a origem */
+    double x, y;        /* Coordenada do vértice */
+    double vx, vy;      /* Vetor origem -> vértice */
+    double distancia2;  /* Quadrado da distância até a origem */
+    Semiplano semiplano;
     TipoEvento tipo;    /* INICIO ou FIM */
-    Segmento segmento;  /* Segmento ao qual pertence */
+    int segmento;       /* Índice do segmento no conjunto de trabalho */
 } Evento;
 
+/* Conjunto de trabalho da varredura. Os anteparos são lidos no próprio
+ * vetor de entrada (somente leitura, compartilhado entre varreduras);
+ * só a bounding box e os pedaços da divisão no ângulo 0 são gravados.
+ * Índices de segmento: [0, num_base) são os anteparos e
+ * [num_base, num_base + num_extras) são os extras. */
+typedef struct trabalho
+{
+    const double *bx1, *by1, *bx2, *by2;   /* Vista dos anteparos */
+    int num_base;
+    
+    double *x1, *y1, *x2, *y2;  /* Extras: bounding box e pedaços */
+    int *original;      /* Índice de entrada do extra (-1: bounding box) */
+    int num_extras;
+    int capacidade_extras;
+    
+    int *ordem;         /* Segmentos que geram eventos, em ordem */
+    int tamanho;        /* Quantidade em ordem */
+    
+    unsigned char *ja_visivel; /* Por índice de entrada (NULL: sem rastreio) */
+} Trabalho;
+
 /* Estrutura interna removida em favor do TAD Poligono em geometria/poligono */
 
 /* ============================================================================
@@ -56,49 +111,67 @@ typedef struct evento
  * ============================================================================ */
 
 /**
- * Cria um evento.
+ * Classifica um vértice do segmento pelo semiplano.
+ * Um vértice sobre o raio de ângulo 0 só abre a varredura se o segmento
+ * sobe a partir dele; se o segmento vem de baixo, ele fecha em 2π.
+ * @param vy_outro Componente y (relativa à origem) do outro extremo
  */
-static Evento* criar_evento(Ponto ponto, TipoEvento tipo, Segmento seg, Ponto origem)
+static Semiplano calcular_semiplano(double vx, double vy, double vy_outro)
 {
-    Evento *e = (Evento*)malloc(sizeof(Evento));
-    if (e == NULL) return NULL;
-    
-    e->ponto = clonar_ponto(ponto);
-    e->tipo = tipo;
+    if (vy > 0.0) return SEMIPLANO_SUPERIOR;
+    if (vy < 0.0) return SEMIPLANO_INFERIOR;
+    if (vx < 0.0) return SEMIPLANO_INFERIOR;    /* ângulo π */
+    return (vy_outro < 0.0) ? SEMIPLANO_FINAL : SEMIPLANO_SUPERIOR;
+}
+
+/**
+ * Preenche um evento.
+ */
+static void preencher_evento(Evento *e, double x, double y, double y_outro, int seg,
+                             double ox, double oy)
+{
+    e->x = x;
+    e->y = y;
+    e->vx = x - ox;
+    e->vy = y - oy;
+    e->distancia2 = e->vx * e->vx + e->vy * e->vy;
+    e->semiplano = calcular_semiplano(e->vx, e->vy, y_outro - oy);
+    e->tipo = EVENTO_INICIO;
     e->segmento = seg;
-    e->angulo = ponto_angulo_polar(origem, ponto);
-    e->distancia = ponto_distancia(origem, ponto);
-    
-    return e;
 }
 
 /**
- * Destroi um evento.
+ * Compara a direção de dois eventos (ordem angular, sem ângulos).
+ * @return < 0 se e1 vem antes, > 0 se depois, 0 se colineares
  */
-static void destruir_evento(void *ptr)
+static int comparar_direcao(const Evento *e1, const Evento *e2)
 {
-    Evento *e = (Evento*)ptr;
-    if (e != NULL)
+    if (e1->semiplano != e2->semiplano)
     {
-        destruir_ponto(e->ponto);
-        free(e);
+        return (e1->semiplano < e2->semiplano) ? -1 : 1;
     }
+    
+    /* No mesmo semiplano a diferença angular é < π: basta o sinal */
+    double cruz = e1->vx * e2->vy - e1->vy * e2->vx;
+    if (cruz > 0.0) return -1;
+    if (cruz < 0.0) return 1;
+    return 0;
 }
 
 /**
  * Compara dois eventos para ordenação.
- * Ordenação: ângulo crescente, tipo INICIO antes de FIM, distância crescente.
+ * Ordenação: direção angular, tipo INICIO antes de FIM; na mesma direção,
+ * inícios do mais perto ao mais longe e fins do mais longe ao mais perto
+ * (assim o biombo é o último a sair e não gera vértices ao longo do raio).
  */
 static int comparar_eventos(const void *a, const void *b)
 {
-    Evento *e1 = *(Evento**)a;
-    Evento *e2 = *(Evento**)b;
+    const Evento *e1 = (const Evento*)a;
+    const Evento *e2 = (const Evento*)b;
     
-    /* 1. Por ângulo */
-    if (fabs(e1->angulo - e2->angulo) > EPSILON)
-    {
-        return (e1->angulo < e2->angulo) ? -1 : 1;
-    }
+    /* 1. Por direção */
+    int cmp = comparar_direcao(e1, e2);
+    if (cmp != 0) return cmp;
     
     /* 2. INICIO antes de FIM */
     if (e1->tipo != e2->tipo)
@@ -106,31 +179,146 @@ static int comparar_eventos(const void *a, const void *b)
         return (e1->tipo == EVENTO_INICIO) ? -1 : 1;
     }
     
-    /* 3. Por distância (mais perto primeiro) */
-    if (fabs(e1->distancia - e2->distancia) > EPSILON)
+    /* 3. Por distância */
+    if (e1->distancia2 != e2->distancia2)
     {
-        return (e1->distancia < e2->distancia) ? -1 : 1;
+        int mais_perto = (e1->distancia2 < e2->distancia2) ? -1 : 1;
+        return (e1->tipo == EVENTO_INICIO) ? mais_perto : -mais_perto;
     }
     
-    return 0;
+    /* 4. Por segmento: a ordem é total, e qualquer ordenação (estável ou
+     * não, inteira ou por setores) chega ao mesmo vetor */
+    return (e1->segmento > e2->segmento) - (e1->segmento < e2->segmento);
 }
 
+/**
+ * Versão "menor que" de comparar_eventos, para as ordenações tipadas.
+ */
+static inline int evento_menor(const Evento *e1, const Evento *e2)
+{
+    return comparar_eventos(e1, e2) < 0;
+}
+
+/**
+ * Chave numérica do evento: pseudo-ângulo em [0, 4], crescente com o
+ * ângulo e coerente com o semiplano (sem trigonometria). Empates e
+ * arredondamentos são resolvidos depois por evento_menor.
+ */
+static inline uint64_t evento_chave(const Evento *e)
+{
+    if (e->semiplano == SEMIPLANO_FINAL) return sort_chave_double(4.0);
+    
+    double soma = fabs(e->vx) + fabs(e->vy);
+    if (soma == 0.0) return sort_chave_double(0.0);
+    
+    double c = e->vx / soma;   /* "cosseno" em [-1, 1] */
+    double p = (e->semiplano == SEMIPLANO_SUPERIOR) ? 1.0 - c : 3.0 + c;
+    return sort_chave_double(p);
+}
+
+SORT_DEFINIR_TIPADO(eventos, Evento, evento_menor, evento_chave)
+
 /* ============================================================================
- * Funções Auxiliares - Segmentos
+ * Funções Auxiliares - Conjunto de Trabalho
  * ============================================================================ */
 
 /**
- * Destroi um segmento (callback para lista).
+ * Obtém as coordenadas do segmento seg (anteparo ou extra).
+ */
+static inline void trabalho_segmento(const Trabalho *t, int seg,
+                                     double *x1, double *y1, double *x2, double *y2)
+{
+    if (seg < t->num_base)
+    {
+        *x1 = t->bx1[seg]; *y1 = t->by1[seg];
+        *x2 = t->bx2[seg]; *y2 = t->by2[seg];
+    }
+    else
+    {
+        int e = seg - t->num_base;
+        *x1 = t->x1[e]; *y1 = t->y1[e];
+        *x2 = t->x2[e]; *y2 = t->y2[e];
+    }
+}
+
+/**
+ * Índice de entrada do segmento seg (-1 para a bounding box).
+ */
+static inline int trabalho_original(const Trabalho *t, int seg)
+{
+    return (seg < t->num_base) ? seg : t->original[seg - t->num_base];
+}
+
+/**
+ * Cria o conjunto de trabalho na arena com uma vista das coordenadas dos
+ * anteparos (nada é copiado). Reserva espaço para a bounding box, para a
+ * divisão de cada segmento e, se rastrear for não-zero, para as marcas
+ * de segmento de entrada já visível.
+ */
+static Trabalho* criar_trabalho_coordenadas(const double *x1, const double *y1,
+                                            const double *x2, const double *y2,
+                                            int n, int rastrear, Arena arena)
+{
+    Trabalho *t = (Trabalho*)arena_alocar(arena, sizeof(Trabalho));
+    if (t == NULL) return NULL;
+    
+    t->bx1 = x1;
+    t->by1 = y1;
+    t->bx2 = x2;
+    t->by2 = y2;
+    t->num_base = n;
+    t->num_extras = 0;
+    t->capacidade_extras = 4 + 2 * (n + 4);
+    t->tamanho = 0;
+    t->x1 = (double*)arena_alocar(arena, t->capacidade_extras * sizeof(double));
+    t->y1 = (double*)arena_alocar(arena, t->capacidade_extras * sizeof(double));
+    t->x2 = (double*)arena_alocar(arena, t->capacidade_extras * sizeof(double));
+    t->y2 = (double*)arena_alocar(arena, t->capacidade_extras * sizeof(double));
+    t->original = (int*)arena_alocar(arena, t->capacidade_extras * sizeof(int));
+    t->ordem = (int*)arena_alocar(arena, 2 * (n + 4) * sizeof(int));
+    t->ja_visivel = rastrear ? (unsigned char*)arena_alocar(arena, n + 1) : NULL;
+    
+    if (t->x1 == NULL || t->y1 == NULL || t->x2 == NULL || t->y2 == NULL ||
+        t->original == NULL || t->ordem == NULL || (rastrear && t->ja_visivel == NULL))
+    {
+        fprintf(stderr, "Erro: falha ao alocar conjunto de trabalho da visibilidade.\n");
+        return NULL;
+    }
+    
+    if (t->ja_visivel != NULL) memset(t->ja_visivel, 0, n);
+    
+    return t;
+}
+
+/**
+ * Cria o conjunto de trabalho com uma vista de todo o vetor de anteparos.
+ */
+static Trabalho* criar_trabalho(VetorSegmentos entrada, int rastrear, Arena arena)
+{
+    const double *x1, *y1, *x2, *y2;
+    int n = vetor_segmentos_coordenadas(entrada, &x1, &y1, &x2, &y2);
+    return criar_trabalho_coordenadas(x1, y1, x2, y2, n, rastrear, arena);
+}
+
+/**
+ * Acrescenta um extra e devolve o seu índice de segmento.
  */
-static void destruir_segmento_callback(void *ptr)
+static int trabalho_adicionar(Trabalho *t, double x1, double y1,
+                              double x2, double y2, int original)
 {
-    destruir_segmento((Segmento)ptr);
+    int e = t->num_extras++;
+    t->x1[e] = x1;
+    t->y1[e] = y1;
+    t->x2[e] = x2;
+    t->y2[e] = y2;
+    t->original[e] = original;
+    return t->num_base + e;
 }
 
 /**
  * Cria os 4 segmentos da bounding box.
  */
-static void criar_bounding_box(Lista segmentos, double min_x, double min_y, 
+static void criar_bounding_box(Trabalho *t, double min_x, double min_y, 
                                 double max_x, double max_y)
 {
     /* Adiciona margem */
@@ -140,377 +328,875 @@ static void criar_bounding_box(Lista segmentos, double min_x, double min_y,
     max_y += MARGEM_BBOX;
     
     /* Cria 4 segmentos formando a bounding box (com margem) */
-    /* Sentido anti-horário */
-    /* ID -1 como "sistema", id_original -1 */
-    inserir_fim(segmentos, criar_segmento(-1, -1, min_x, min_y, max_x, min_y, "none")); /* baixo */
-    inserir_fim(segmentos, criar_segmento(-2, -1, max_x, min_y, max_x, max_y, "none")); /* direita */
-    inserir_fim(segmentos, criar_segmento(-3, -1, max_x, max_y, min_x, max_y, "none")); /* cima */
-    inserir_fim(segmentos, criar_segmento(-4, -1, min_x, max_y, min_x, min_y, "none")); /* esquerda */
+    /* Sentido anti-horário; original -1 marca segmento "sistema" */
+    trabalho_adicionar(t, min_x, min_y, max_x, min_y, -1); /* baixo */
+    trabalho_adicionar(t, max_x, min_y, max_x, max_y, -1); /* direita */
+    trabalho_adicionar(t, max_x, max_y, min_x, max_y, -1); /* cima */
+    trabalho_adicionar(t, min_x, max_y, min_x, min_y, -1); /* esquerda */
 }
 
-
+/**
+ * Divide os segmentos que cruzam o raio de ângulo 0 (a partir da origem,
+ * para a direita). O ponto de divisão fica exatamente em y = oy, de modo
+ * que a classificação por semiplano dos dois pedaços é exata.
+ * Monta t->ordem: primeiro os segmentos não divididos (anteparos, depois
+ * a bounding box), em seguida os pedaços, na ordem em que foram divididos.
+ * O segmento dividido fica fora da ordem; os pedaços são extras.
+ */
+static void dividir_no_angulo_zero(Trabalho *t, double ox, double oy)
+{
+    int total = t->num_base + t->num_extras;
+    int primeiro_pedaco = t->num_base + t->num_extras;
+    
+    for (int i = 0; i < total; i++)
+    {
+        double x1, y1, x2, y2;
+        trabalho_segmento(t, i, &x1, &y1, &x2, &y2);
+        double vy1 = y1 - oy;
+        double vy2 = y2 - oy;
+        int dividir = 0;
+        
+        /* Extremos estritamente em lados opostos da horizontal da origem */
+        if ((vy1 > 0.0 && vy2 < 0.0) || (vy1 < 0.0 && vy2 > 0.0))
+        {
+            /* Cruza à direita da origem se o giro de baixo para cima é anti-horário */
+            double bx = (vy1 < 0.0) ? x1 : x2, by = (vy1 < 0.0) ? vy1 : vy2;
+            double cx = (vy1 < 0.0) ? x2 : x1, cy = (vy1 < 0.0) ? vy2 : vy1;
+            double cruz = (bx - ox) * cy - by * (cx - ox);
+            
+            dividir = (cruz > 0.0);
+        }
+        
+        if (dividir)
+        {
+            double ix = x1 + (x2 - x1) * (vy1 / (vy1 - vy2));
+            int original = trabalho_original(t, i);
+            
+            trabalho_adicionar(t, x1, y1, ix, oy, original);
+            trabalho_adicionar(t, ix, oy, x2, y2, original);
+        }
+        else
+        {
+            t->ordem[t->tamanho++] = i;
+        }
+    }
+    
+    for (int seg = primeiro_pedaco; seg < t->num_base + t->num_extras; seg++)
+    {
+        t->ordem[t->tamanho++] = seg;
+    }
+}
 
 /**
- * Extrai eventos (vértices) de todos os segmentos.
+ * Extrai eventos (vértices) dos segmentos de t->ordem para um vetor
+ * contíguo alocado na arena. O extremo que vem primeiro na ordem angular
+ * é o INICIO.
+ * @return Vetor com 2 * t->tamanho eventos, ou NULL
  */
-static Lista extrair_eventos(Lista segmentos, Ponto origem)
+static Evento* extrair_eventos(const Trabalho *t, double ox, double oy, Arena arena)
 {
-    Lista eventos = criar_lista();
+    Evento *eventos = (Evento*)arena_alocar(arena, 2 * t->tamanho * sizeof(Evento));
     if (eventos == NULL) return NULL;
     
-    No atual = obter_primeiro(segmentos);
-    while (atual != NULL)
+    for (int i = 0; i < t->tamanho; i++)
     {
-        Segmento seg = (Segmento)obter_elemento(atual);
+        int seg = t->ordem[i];
+        double x1, y1, x2, y2;
+        trabalho_segmento(t, seg, &x1, &y1, &x2, &y2);
         
-        /* Evento de início (p1) */
-        Evento *e1 = criar_evento(get_segmento_p1(seg), EVENTO_INICIO, seg, origem);
-        if (e1 != NULL) inserir_fim(eventos, e1);
+        Evento *e1 = &eventos[2 * i];
+        Evento *e2 = &eventos[2 * i + 1];
+        preencher_evento(e1, x1, y1, y2, seg, ox, oy);
+        preencher_evento(e2, x2, y2, y1, seg, ox, oy);
         
-        /* Evento de fim (p2) */
-        Evento *e2 = criar_evento(get_segmento_p2(seg), EVENTO_FIM, seg, origem);
-        if (e2 != NULL) inserir_fim(eventos, e2);
-        
-        atual = obter_proximo(atual);
+        int cmp = comparar_direcao(e1, e2);
+        if (cmp > 0 || (cmp == 0 && e2->distancia2 < e1->distancia2))
+        {
+            Evento tmp = *e1;
+            *e1 = *e2;
+            *e2 = tmp;
+        }
+        e1->tipo = EVENTO_INICIO;
+        e2->tipo = EVENTO_FIM;
     }
     
     return eventos;
 }
 
 /**
- * Ordena lista de eventos por ângulo.
+ * Ordena o vetor de eventos por direção angular (no lugar).
+ * tipo_ordenacao vem de -to: qsort, mergesort ou radixsort.
  */
-static void ordenar_eventos(Lista eventos, const char *tipo_ordenacao, int limiar)
+static void ordenar_eventos(Evento *eventos, int n, const char *tipo_ordenacao, int limiar,
+                            Arena arena)
 {
-    int n = obter_tamanho(eventos);
     if (n <= 1) return;
     
-    /* Converte para array para usar o módulo sort */
-    Evento **arr = (Evento**)malloc(n * sizeof(Evento*));
-    if (arr == NULL) return;
-    
-    No atual = obter_primeiro(eventos);
-    for (int i = 0; i < n && atual != NULL; i++)
+    /* Ordenação especializada para Evento; memória de trabalho na arena */
+    AlgoritmoOrdenacao alg_enum = algoritmo_por_nome(tipo_ordenacao);
+    void *trabalho = NULL;
+    if (alg_enum != ALG_QSORT)
     {
-        arr[i] = (Evento*)obter_elemento(atual);
-        atual = obter_proximo(atual);
+        trabalho = arena_alocar(arena, SORT_TRABALHO_BYTES(Evento, n));
     }
     
-    /* Seleciona algoritmo */
-    AlgoritmoOrdenacao alg_enum = ALG_QSORT;
-    if (tipo_ordenacao != NULL && strcmp(tipo_ordenacao, "mergesort") == 0)
+    eventos_ordenar(eventos, n, alg_enum, limiar, comparar_eventos, trabalho);
+}
+
+/* ============================================================================
+ * Funções Auxiliares - Varredura
+ * ============================================================================ */
+
+/**
+ * Interseção do raio origem -> (x, y) com o segmento seg do conjunto de trabalho.
+ */
+static int intersecao_evento(const Trabalho *t, int seg, double ox, double oy,
+                             const Evento *evento, double *ix, double *iy)
+{
+    double x1, y1, x2, y2;
+    trabalho_segmento(t, seg, &x1, &y1, &x2, &y2);
+    return intersecao_raio_coords(ox, oy, evento->x - ox, evento->y - oy,
+                                  x1, y1, x2, y2, ix, iy);
+}
+
+/**
+ * Último vértice emitido no polígono (para não repetir pontos).
+ */
+typedef struct ultimo_vertice
+{
+    double x, y;
+    int valido;
+} UltimoVertice;
+
+/**
+ * Insere o vértice no polígono, a menos que coincida com o último.
+ * @return 1 se inseriu
+ */
+static int emitir_vertice(Poligono resultado, UltimoVertice *ultimo, double x, double y)
+{
+    if (ultimo->valido && fabs(ultimo->x - x) < EPSILON && fabs(ultimo->y - y) < EPSILON)
     {
-        alg_enum = ALG_MERGESORT;
+        return 0;
     }
     
-    /* Ordena usando o módulo sort */
-    ordenar((void*)arr, n, sizeof(Evento*), comparar_eventos, alg_enum, limiar);
+    poligono_inserir_vertice(resultado, x, y);
+    ultimo->x = x;
+    ultimo->y = y;
+    ultimo->valido = 1;
+    return 1;
+}
+
+/**
+ * Registra o segmento de entrada como visível (uma única vez; a bounding
+ * box, original -1, é ignorada).
+ */
+static void registrar_original(const Trabalho *t, int original, int *visiveis, int *num_visiveis)
+{
+    if (visiveis == NULL || num_visiveis == NULL || t->ja_visivel == NULL) return;
+    if (original < 0 || t->ja_visivel[original]) return;
     
-    /* Limpa a lista original e reinsere ordenado */
-    while (!lista_vazia(eventos))
+    t->ja_visivel[original] = 1;
+    visiveis[(*num_visiveis)++] = original;
+}
+
+/**
+ * Registra o segmento de entrada correspondente ao biombo como visível.
+ * O(1): pedaços divididos já apontam para o índice de entrada, que indexa
+ * as marcas diretamente.
+ */
+static void registrar_visivel(const Trabalho *t, int seg, int *visiveis, int *num_visiveis)
+{
+    registrar_original(t, trabalho_original(t, seg), visiveis, num_visiveis);
+}
+
+/**
+ * Destino do que a varredura encontra. Na varredura completa os vértices
+ * vão direto para o polígono; um setor (varredura por setores) só anota
+ * os candidatos, e o filtro de repetidos é aplicado na costura, em ordem.
+ */
+typedef struct saida_varredura
+{
+    Poligono resultado;     /* NULL: anota em pontos/candidatos */
+    UltimoVertice ultimo;   /* ultimo.valido: algum vértice já saiu */
+    int *visiveis;
+    int *num_visiveis;
+    
+    double *pontos;         /* Vértices (x, y), sem filtrar repetidos */
+    int num_pontos;
+    int *candidatos;        /* Originais dos biombos, com repetição (NULL: sem rastreio) */
+    int num_candidatos;
+} SaidaVarredura;
+
+static void saida_vertice(SaidaVarredura *s, double x, double y)
+{
+    if (s->resultado != NULL)
     {
-        remover_inicio(eventos);
+        emitir_vertice(s->resultado, &s->ultimo, x, y);
+        return;
     }
     
-    for (int i = 0; i < n; i++)
+    s->pontos[2 * s->num_pontos] = x;
+    s->pontos[2 * s->num_pontos + 1] = y;
+    s->num_pontos++;
+    s->ultimo.valido = 1;
+}
+
+static void saida_visivel(SaidaVarredura *s, const Trabalho *t, int seg)
+{
+    if (s->resultado != NULL)
     {
-        inserir_fim(eventos, arr[i]);
+        registrar_visivel(t, seg, s->visiveis, s->num_visiveis);
+        return;
     }
     
-    free(arr);
+    int original = trabalho_original(t, seg);
+    if (s->candidatos != NULL && original >= 0)
+    {
+        s->candidatos[s->num_candidatos++] = original;
+    }
+}
+
+/**
+ * Processa os eventos [inicio, fim) já ordenados.
+ * A árvore é indexada por nó: na varredura completa o nó é o próprio
+ * segmento (no_do_evento e segmento_do_no NULL); em um setor, os índices
+ * são locais ao setor e esses vetores fazem a tradução.
+ */
+static void varrer_eventos(const Trabalho *t, const Evento *eventos, int inicio, int fim,
+                           const int *no_do_evento, const int *segmento_do_no,
+                           ArvoreSegmentos arvore, double ox, double oy,
+                           SaidaVarredura *saida)
+{
+    /* O biombo é sempre o primeiro da árvore */
+    int biombo = arvore_obter_primeiro(arvore);
+    int biombo_saiu = 0;
+    double ix, iy;
+    
+    for (int i = inicio; i < fim; i++)
+    {
+        const Evento *evento = &eventos[i];
+        int seg = evento->segmento;
+        int no = no_do_evento ? no_do_evento[i] : seg;
+        arvore_definir_direcao(arvore, evento->vx, evento->vy);
+        
+        /* Eventos do mesmo tipo no mesmo ponto (o canto de um retângulo)
+         * são aplicados juntos: o biombo só é conferido depois do último,
+         * para que nenhum deles pareça visível só por um instante */
+        const Evento *seguinte = (i + 1 < fim) ? &eventos[i + 1] : NULL;
+        int fecha_grupo = seguinte == NULL || seguinte->tipo != evento->tipo ||
+                          seguinte->x != evento->x || seguinte->y != evento->y;
+        
+        if (evento->tipo == EVENTO_INICIO)
+        {
+            double x1, y1, x2, y2;
+            trabalho_segmento(t, seg, &x1, &y1, &x2, &y2);
+            arvore_inserir(arvore, no, x1, y1, x2, y2);
+            if (!fecha_grupo) continue;
+            
+            int novo_biombo = arvore_obter_primeiro(arvore);
+            if (novo_biombo != biombo)
+            {
+                /* Ponto onde o raio deixa o biombo anterior */
+                if (biombo != -1 && saida->ultimo.valido &&
+                    intersecao_evento(t, segmento_do_no ? segmento_do_no[biombo] : biombo,
+                                      ox, oy, evento, &ix, &iy))
+                {
+                    saida_vertice(saida, ix, iy);
+                }
+                
+                saida_vertice(saida, evento->x, evento->y);
+                saida_visivel(saida, t, segmento_do_no ? segmento_do_no[novo_biombo] : novo_biombo);
+                
+                biombo = novo_biombo;
+            }
+        }
+        else /* EVENTO_FIM */
+        {
+            if (no == biombo) biombo_saiu = 1;
+            arvore_remover(arvore, no);
+            if (!fecha_grupo || !biombo_saiu) continue;
+            
+            biombo_saiu = 0;
+            saida_vertice(saida, evento->x, evento->y);
+            
+            int novo_biombo = arvore_obter_primeiro(arvore);
+            if (novo_biombo != -1)
+            {
+                int seg_novo = segmento_do_no ? segmento_do_no[novo_biombo] : novo_biombo;
+                
+                /* Ponto onde o raio encontra o novo biombo */
+                if (intersecao_evento(t, seg_novo, ox, oy, evento, &ix, &iy))
+                {
+                    saida_vertice(saida, ix, iy);
+                }
+                saida_visivel(saida, t, seg_novo);
+            }
+            biombo = novo_biombo;
+        }
+    }
 }
 
 /* ============================================================================
  * Algoritmo Principal de Visibilidade
  * ============================================================================ */
 
-PoligonoVisibilidade calcular_visibilidade(Ponto origem, Lista segmentos_entrada,
+/**
+ * Varre um conjunto de trabalho já montado: acrescenta a bounding box,
+ * divide no ângulo 0, ordena os eventos e percorre-os.
+ * @return Polígono de visibilidade, ou NULL em caso de erro
+ */
+static Poligono varrer_trabalho(Trabalho *t, Ponto origem,
+                                double min_x, double min_y,
+                                double max_x, double max_y,
+                                const char *tipo_ordenacao,
+                                int limiar_insertion,
+                                int *visiveis,
+                                int *num_visiveis,
+                                Arena arena)
+{
+    /* Expande bounding box para incluir a origem */
+    double ox = get_ponto_x(origem);
+    double oy = get_ponto_y(origem);
+    if (ox < min_x) min_x = ox;
+    if (ox > max_x) max_x = ox;
+    if (oy < min_y) min_y = oy;
+    if (oy > max_y) max_y = oy;
+    
+    /* Adiciona bounding box (segmentos artificiais, sem original) */
+    criar_bounding_box(t, min_x, min_y, max_x, max_y);
+    
+    /* PRÉ-PROCESSAMENTO: Divisão de Segmentos no Ângulo 0 */
+    dividir_no_angulo_zero(t, ox, oy);
+    
+    /* Cria vetor de eventos */
+    int num_eventos = 2 * t->tamanho;
+    Evento *eventos = extrair_eventos(t, ox, oy, arena);
+    if (eventos == NULL) return NULL;
+    
+    /* Ordena eventos */
+    ordenar_eventos(eventos, num_eventos, tipo_ordenacao, limiar_insertion, arena);
+    
+    /* Inicializa árvore de segmentos ativos.
+     * Nenhum segmento está ativo antes do primeiro evento: os que cruzavam
+     * o raio de ângulo 0 foram divididos e o pedaço de cima começa em 0. */
+    ArvoreSegmentos arvore = arvore_criar_na_arena(origem, t->num_base + t->num_extras, arena);
+    
+    /* Cria polígono de saída (sobrevive à consulta: fora da arena) */
+    Poligono resultado = poligono_criar();
+    if (arvore == NULL || resultado == NULL)
+    {
+        poligono_destruir(resultado);
+        return NULL;
+    }
+    
+    /* Os vértices saem em ordem angular em torno da bomba */
+    poligono_definir_origem(resultado, ox, oy);
+    
+    SaidaVarredura saida;
+    memset(&saida, 0, sizeof(saida));
+    saida.resultado = resultado;
+    saida.visiveis = visiveis;
+    saida.num_visiveis = num_visiveis;
+    
+    /* Loop principal de varredura */
+    varrer_eventos(t, eventos, 0, num_eventos, NULL, NULL, arvore, ox, oy, &saida);
+    
+    return resultado;
+}
+
+PoligonoVisibilidade calcular_visibilidade(Ponto origem, VetorSegmentos segmentos_entrada,
                                             double min_x, double min_y,
                                             double max_x, double max_y,
                                             const char *tipo_ordenacao,
                                             int limiar_insertion)
+{
+    return calcular_visibilidade_com_segmentos(origem, segmentos_entrada,
+                                               min_x, min_y, max_x, max_y,
+                                               tipo_ordenacao, limiar_insertion,
+                                               NULL, NULL, NULL);
+}
+
+PoligonoVisibilidade calcular_visibilidade_com_segmentos(
+    Ponto origem, VetorSegmentos segmentos_entrada,
+    double min_x, double min_y,
+    double max_x, double max_y,
+    const char *tipo_ordenacao,
+    int limiar_insertion,
+    int *visiveis,
+    int *num_visiveis,
+    Arena arena)
 {
     if (origem == NULL) return NULL;
     
-    /* Cria lista de segmentos de trabalho (cópia + bounding box) */
-    Lista segmentos = criar_lista();
-    if (segmentos == NULL) return NULL;
+    if (num_visiveis != NULL) *num_visiveis = 0;
     
-    /* Copia segmentos de entrada */
-    if (segmentos_entrada != NULL)
+    /* Sem arena do chamador, usa uma própria só para esta consulta */
+    Arena arena_local = NULL;
+    if (arena == NULL)
     {
-        No atual = obter_primeiro(segmentos_entrada);
-        while (atual != NULL)
-        {
-            Segmento seg = (Segmento)obter_elemento(atual);
-            inserir_fim(segmentos, clonar_segmento(seg));
-            atual = obter_proximo(atual);
-        }
+        arena_local = arena_criar(0);
+        if (arena_local == NULL) return NULL;
+        arena = arena_local;
+    }
+    
+    /* Conjunto de trabalho (vista dos anteparos + bounding box) */
+    int rastrear = (visiveis != NULL && num_visiveis != NULL);
+    Trabalho *t = criar_trabalho(segmentos_entrada, rastrear, arena);
+    Poligono resultado = (t != NULL)
+        ? varrer_trabalho(t, origem, min_x, min_y, max_x, max_y, tipo_ordenacao,
+                          limiar_insertion, visiveis, num_visiveis, arena)
+        : NULL;
+    
+    /* Toda a memória temporária está na arena: o reset fica com quem a criou */
+    arena_destruir(arena_local);
+    
+    return (PoligonoVisibilidade)resultado;
+}
+
+/**
+ * Recorta o segmento (x1,y1)-(x2,y2) ao disco de centro (cx,cy).
+ * @return 1 e o trecho interno em (a_x,a_y)-(b_x,b_y), ou 0 se o segmento
+ *         não entra no disco (ou só o toca)
+ */
+static int recortar_no_disco(double x1, double y1, double x2, double y2,
+                             double cx, double cy, double raio,
+                             double *a_x, double *a_y, double *b_x, double *b_y)
+{
+    double dx = x2 - x1, dy = y2 - y1;
+    double fx = x1 - cx, fy = y1 - cy;
+    double a = dx * dx + dy * dy;
+    if (a <= 0) return 0;
+    
+    double b = 2.0 * (fx * dx + fy * dy);
+    double c = fx * fx + fy * fy - raio * raio;
+    double delta = b * b - 4.0 * a * c;
+    if (delta <= 0) return 0;
+    
+    double raiz = sqrt(delta);
+    double t0 = (-b - raiz) / (2.0 * a);
+    double t1 = (-b + raiz) / (2.0 * a);
+    if (t0 < 0) t0 = 0;
+    if (t1 > 1) t1 = 1;
+    if (t1 <= t0) return 0;
+    
+    *a_x = x1 + t0 * dx;
+    *a_y = y1 + t0 * dy;
+    *b_x = x1 + t1 * dx;
+    *b_y = y1 + t1 * dy;
+    return 1;
+}
+
+PoligonoVisibilidade calcular_visibilidade_raio(
+    Ponto origem, VetorSegmentos segmentos_entrada,
+    GradeSegmentos indice,
+    double raio,
+    double min_x, double min_y,
+    double max_x, double max_y,
+    const char *tipo_ordenacao,
+    int limiar_insertion,
+    int *visiveis,
+    int *num_visiveis,
+    Arena arena)
+{
+    if (origem == NULL || segmentos_entrada == NULL || !(raio > 0)) return NULL;
+    
+    if (num_visiveis != NULL) *num_visiveis = 0;
+    
+    Arena arena_local = NULL;
+    if (arena == NULL)
+    {
+        arena_local = arena_criar(0);
+        if (arena_local == NULL) return NULL;
+        arena = arena_local;
     }
     
-    /* Expande bounding box para incluir a origem */
     double ox = get_ponto_x(origem);
     double oy = get_ponto_y(origem);
-    if (ox < min_x) min_x = ox;
-    if (ox > max_x) max_x = ox;
-    if (oy < min_y) min_y = oy;
-    if (oy > max_y) max_y = oy;
     
-    /* Adiciona bounding box */
-    criar_bounding_box(segmentos, min_x, min_y, max_x, max_y);
+    /* Candidatos: segmentos cuja caixa toca o quadrado que envolve o disco;
+     * sem índice, todos (o recorte ao disco descarta os de fora) */
+    const double *x1, *y1, *x2, *y2;
+    int n = vetor_segmentos_coordenadas(segmentos_entrada, &x1, &y1, &x2, &y2);
+    int *candidatos = (int*)arena_alocar(arena, (size_t)(n > 0 ? n : 1) * sizeof(int));
+    int num_candidatos = 0;
+    if (candidatos != NULL && indice != NULL)
+    {
+        num_candidatos = grade_segmentos_consultar(indice, ox - raio, oy - raio, ox + raio, oy + raio, candidatos);
+    }
+    else if (candidatos != NULL)
+    {
+        for (int i = 0; i < n; i++) candidatos[num_candidatos++] = i;
+    }
+    int c = num_candidatos > 0 ? num_candidatos : 1;
+    double *cx1 = (double*)arena_alocar(arena, (size_t)c * 4 * sizeof(double));
+    Poligono resultado = NULL;
     
-    /* ========================================================================
-     * PRÉ-PROCESSAMENTO: Divisão de Segmentos no Ângulo 0
-     * ======================================================================== */
-    No node_seg = obter_primeiro(segmentos);
-    while (node_seg != NULL)
+    if (candidatos != NULL && cx1 != NULL)
     {
-        Segmento seg = (Segmento)obter_elemento(node_seg);
-        No proximo_node = obter_proximo(node_seg);
+        double *cy1 = cx1 + c, *cx2 = cy1 + c, *cy2 = cx2 + c;
+        
+        /* Só o trecho de cada candidato dentro do disco bloqueia luz; o
+         * mapa (candidatos, compactado) volta ao índice no vetor */
+        int m = 0;
+        for (int k = 0; k < num_candidatos; k++)
+        {
+            int i = candidatos[k];
+            if (recortar_no_disco(x1[i], y1[i], x2[i], y2[i], ox, oy, raio,
+                                  &cx1[m], &cy1[m], &cx2[m], &cy2[m]))
+            {
+                candidatos[m++] = i;
+            }
+        }
+        
+        /* Paredes: o quadrado do disco, sem passar da bounding box do cenário */
+        if (min_x < ox - raio) min_x = ox - raio;
+        if (min_y < oy - raio) min_y = oy - raio;
+        if (max_x > ox + raio) max_x = ox + raio;
+        if (max_y > oy + raio) max_y = oy + raio;
+        if (min_x > max_x) min_x = max_x = ox;
+        if (min_y > max_y) min_y = max_y = oy;
         
-        Ponto dir_zero = criar_ponto(ox + 1.0, oy);
-        Ponto intersecao = NULL;
+        int rastrear = (visiveis != NULL && num_visiveis != NULL);
+        Trabalho *t = criar_trabalho_coordenadas(cx1, cy1, cx2, cy2, m, rastrear, arena);
+        Poligono cheio = (t != NULL)
+            ? varrer_trabalho(t, origem, min_x, min_y, max_x, max_y,
+                              tipo_ordenacao, limiar_insertion, visiveis, num_visiveis, arena)
+            : NULL;
         
-        if (intersecao_raio_segmento(origem, dir_zero, seg, &intersecao))
+        if (cheio != NULL)
         {
-            double ix = get_ponto_x(intersecao);
-            double iy = get_ponto_y(intersecao);
-            
-            double x1 = get_segmento_x1(seg);
-            double y1 = get_segmento_y1(seg);
-            double x2 = get_segmento_x2(seg);
-            double y2 = get_segmento_y2(seg);
-            
-            if (hypot(ix - x1, iy - y1) > EPSILON &&
-                hypot(ix - x2, iy - y2) > EPSILON)
+            if (rastrear)
             {
-                int id = get_segmento_id(seg);
-                int id_orig = get_segmento_id_original(seg);
-                const char *cor = get_segmento_cor(seg);
-                
-                Segmento s1 = criar_segmento(id, id_orig, x1, y1, ix, iy, cor);
-                Segmento s2 = criar_segmento(id, id_orig, ix, iy, x2, y2, cor);
-                
-                inserir_fim(segmentos, s1);
-                inserir_fim(segmentos, s2);
-                
-                void *removido = remover_no(segmentos, node_seg);
-                if (removido) destruir_segmento((Segmento)removido);
+                for (int k = 0; k < *num_visiveis; k++) visiveis[k] = candidatos[visiveis[k]];
             }
-            destruir_ponto(intersecao);
+            resultado = poligono_recortar_circulo(cheio, raio);
+            poligono_destruir(cheio);
         }
-        destruir_ponto(dir_zero); 
-        node_seg = proximo_node;
     }
+    
+    arena_destruir(arena_local);
+    
+    if (resultado == NULL && num_visiveis != NULL) *num_visiveis = 0;
+    return (PoligonoVisibilidade)resultado;
+}
+
+/* ============================================================================
+ * Varredura por Setores
+ * ============================================================================ */
 
-    /* Extrai eventos (vértices) */
-    Lista eventos = extrair_eventos(segmentos, origem);
-    if (eventos == NULL || lista_vazia(eventos))
+/* Dados compartilhados pelos setores (somente leitura nas threads) */
+typedef struct contexto_setores
+{
+    const Trabalho *t;
+    Evento *eventos;            /* Ordenados por setor */
+    const int *no_do_evento;    /* Índice do segmento na árvore do setor */
+    Ponto origem;
+    double ox, oy;
+    const char *tipo_ordenacao;
+    int limiar_insertion;
+    int rastrear;
+} ContextoSetores;
+
+/* Um setor: eventos [inicio, fim) do vetor ordenado */
+typedef struct setor
+{
+    const ContextoSetores *ctx;
+    Arena arena;
+    int inicio, fim;
+    
+    int num_sementes;           /* Segmentos ativos no raio inicial */
+    int num_nos;                /* Sementes + segmentos que começam no setor */
+    int *segmento_do_no;        /* Nós [0, num_sementes) são as sementes */
+    int *inicio_da_semente;     /* Evento INICIO de cada semente */
+    int proximo_no;             /* Usado ao numerar os nós */
+    
+    ArvoreSegmentos arvore;
+    int *ordem_inicial;         /* Segmentos da árvore semeada, em ordem */
+    SaidaVarredura saida;
+    int erro;
+    
+    pthread_t thread;
+    int thread_criada;
+} Setor;
+
+/**
+ * Executa funcao para cada setor: a thread chamadora fica com o setor 0
+ * e, se uma thread não puder ser criada, o seu setor roda aqui mesmo.
+ */
+static void executar_setores(Setor *setores, int num_setores, void* (*funcao)(void*))
+{
+    for (int i = 1; i < num_setores; i++)
     {
-        destruir_lista(segmentos, destruir_segmento_callback);
-        if (eventos) destruir_lista(eventos, destruir_evento);
-        return NULL;
+        setores[i].thread_criada = (pthread_create(&setores[i].thread, NULL, funcao, &setores[i]) == 0);
     }
     
-    /* Ordena eventos por ângulo */
-    ordenar_eventos(eventos, tipo_ordenacao, limiar_insertion);
+    funcao(&setores[0]);
     
-    /* Cria árvore de segmentos ativos */
-    ArvoreSegmentos arvore = arvore_criar(origem);
-    if (arvore == NULL)
+    for (int i = 1; i < num_setores; i++)
     {
-        destruir_lista(segmentos, destruir_segmento_callback);
-        destruir_lista(eventos, destruir_evento);
+        if (setores[i].thread_criada) pthread_join(setores[i].thread, NULL);
+        else funcao(&setores[i]);
+    }
+}
+
+static void* ordenar_setor(void *arg)
+{
+    Setor *s = (Setor*)arg;
+    ordenar_eventos(s->ctx->eventos + s->inicio, s->fim - s->inicio,
+                    s->ctx->tipo_ordenacao, s->ctx->limiar_insertion, s->arena);
+    return NULL;
+}
+
+/**
+ * Semeia a árvore do setor no seu raio inicial e varre os seus eventos.
+ */
+static void* varrer_setor(void *arg)
+{
+    Setor *s = (Setor*)arg;
+    const ContextoSetores *ctx = s->ctx;
+    int n = s->fim - s->inicio;
+    
+    s->arvore = arvore_criar_na_arena(ctx->origem, s->num_nos, s->arena);
+    s->ordem_inicial = (int*)arena_alocar(s->arena, (s->num_sementes + 1) * sizeof(int));
+    s->saida.pontos = (double*)arena_alocar(s->arena, 4 * (size_t)n * sizeof(double));
+    s->saida.candidatos = ctx->rastrear ? (int*)arena_alocar(s->arena, (n + 1) * sizeof(int)) : NULL;
+    
+    if (s->arvore == NULL || s->ordem_inicial == NULL || s->saida.pontos == NULL ||
+        (ctx->rastrear && s->saida.candidatos == NULL))
+    {
+        s->erro = 1;
         return NULL;
     }
     
-    /* Cria polígono de saída usando TAD */
-    Poligono resultado = poligono_criar();
-    if (resultado == NULL)
+    /* O setor 0 começa com a árvore vazia e sem vértices, como a varredura completa */
+    s->saida.ultimo.valido = (s->inicio > 0);
+    
+    /* Cada semente entra como entrou na varredura completa: na ordem e na
+     * direção do seu INICIO. A árvore não reordena segmentos ativos, então
+     * empates (inícios no mesmo ponto) e cruzamentos ficam como lá */
+    for (int no = 0; no < s->num_sementes; no++)
+    {
+        const Evento *inicio = &ctx->eventos[s->inicio_da_semente[no]];
+        double x1, y1, x2, y2;
+        trabalho_segmento(ctx->t, s->segmento_do_no[no], &x1, &y1, &x2, &y2);
+        arvore_definir_direcao(s->arvore, inicio->vx, inicio->vy);
+        arvore_inserir(s->arvore, no, x1, y1, x2, y2);
+    }
+    
+    int k = 0;
+    for (int no = arvore_obter_primeiro(s->arvore); no != -1; no = arvore_obter_proximo(s->arvore, no))
+    {
+        s->ordem_inicial[k++] = s->segmento_do_no[no];
+    }
+    
+    varrer_eventos(ctx->t, ctx->eventos, s->inicio, s->fim, ctx->no_do_evento,
+                   s->segmento_do_no, s->arvore, ctx->ox, ctx->oy, &s->saida);
+    return NULL;
+}
+
+/**
+ * Verifica se a árvore do setor anterior terminou na ordem em que o setor
+ * seguinte foi semeado (mesmos segmentos, na mesma ordem).
+ */
+static int costura_confere(const Setor *anterior, const Setor *seguinte)
+{
+    if (arvore_tamanho(anterior->arvore) != seguinte->num_sementes) return 0;
+    
+    int k = 0;
+    for (int no = arvore_obter_primeiro(anterior->arvore); no != -1;
+         no = arvore_obter_proximo(anterior->arvore, no))
+    {
+        if (anterior->segmento_do_no[no] != seguinte->ordem_inicial[k++]) return 0;
+    }
+    return 1;
+}
+
+/**
+ * Setor de um evento: quantidade de limites que não vêm depois dele.
+ */
+static int setor_do_evento(const Evento *limites, int num_limites, const Evento *e)
+{
+    int a = 0, b = num_limites;
+    while (a < b)
+    {
+        int meio = (a + b) / 2;
+        if (comparar_eventos(&limites[meio], e) <= 0) a = meio + 1;
+        else b = meio;
+    }
+    return a;
+}
+
+/**
+ * Separa os eventos por setor (mantendo a ordem relativa) e define o
+ * intervalo de cada setor.
+ * @return Vetor de eventos separado, ou NULL em caso de erro
+ */
+static Evento* separar_por_setor(const Evento *eventos, int num_eventos,
+                                 Setor *setores, int num_setores, Arena arena)
+{
+    /* Limites: quantis de uma amostra ordenada dos eventos */
+    int m = num_setores * AMOSTRA_POR_SETOR;
+    if (m > num_eventos) m = num_eventos;
+    
+    Evento *amostra = (Evento*)arena_alocar(arena, m * sizeof(Evento));
+    Evento *separados = (Evento*)arena_alocar(arena, (size_t)num_eventos * sizeof(Evento));
+    int *setor = (int*)arena_alocar(arena, (size_t)num_eventos * sizeof(int));
+    Evento *limites = (Evento*)arena_alocar(arena, (size_t)num_setores * sizeof(Evento));
+    int *contagem = (int*)arena_alocar(arena, (size_t)num_setores * sizeof(int));
+    if (amostra == NULL || separados == NULL || setor == NULL || limites == NULL || contagem == NULL)
     {
-        arvore_destruir(arvore);
-        destruir_lista(segmentos, destruir_segmento_callback);
-        destruir_lista(eventos, destruir_evento);
         return NULL;
     }
     
-    /* Inicializa árvore com segmentos que cruzam ângulo 0 */
-    No atual = obter_primeiro(segmentos);
-    while (atual != NULL)
+    for (int i = 0; i < m; i++)
     {
-        Segmento seg = (Segmento)obter_elemento(atual);
-        double dist = distancia_raio_segmento(origem, 0.0, seg);
-        if (dist < 1e9)
-        {
-            arvore_inserir(arvore, seg);
-        }
-        atual = obter_proximo(atual);
+        amostra[i] = eventos[(size_t)i * num_eventos / m];
     }
+    qsort(amostra, m, sizeof(Evento), comparar_eventos);
     
-    /* Ponto inicial do polígono */
-    Segmento biombo = arvore_obter_primeiro(arvore);
-    Ponto ultimo_ponto = NULL;
+    for (int j = 1; j < num_setores; j++)
+    {
+        limites[j - 1] = amostra[(size_t)j * m / num_setores];
+    }
     
-    if (biombo != NULL)
+    memset(contagem, 0, (size_t)num_setores * sizeof(int));
+    for (int i = 0; i < num_eventos; i++)
     {
-        Ponto dir = criar_ponto(ox + 1000, oy);
-        Ponto intersecao = NULL;
-        
-        if (intersecao_raio_segmento(origem, dir, biombo, &intersecao))
+        setor[i] = setor_do_evento(limites, num_setores - 1, &eventos[i]);
+        contagem[setor[i]]++;
+    }
+    
+    int inicio = 0;
+    for (int j = 0; j < num_setores; j++)
+    {
+        setores[j].inicio = setores[j].fim = inicio;
+        inicio += contagem[j];
+    }
+    for (int i = 0; i < num_eventos; i++)
+    {
+        separados[setores[setor[i]].fim++] = eventos[i];
+    }
+    
+    return separados;
+}
+
+/**
+ * Numera os nós de cada setor (sementes primeiro, na ordem em que os
+ * segmentos começaram) e traduz cada evento para o nó do seu setor.
+ * Os eventos já estão ordenados, então o INICIO vem antes do FIM.
+ * @return 1 em caso de sucesso, 0 em caso de erro
+ */
+static int numerar_nos(const ContextoSetores *ctx, int *no_do_evento,
+                       Setor *setores, int num_setores, Arena arena)
+{
+    const Trabalho *t = ctx->t;
+    int total = t->num_base + t->num_extras;
+    int *setor_fim = (int*)arena_alocar(arena, (size_t)total * sizeof(int));
+    int *no_final = (int*)arena_alocar(arena, (size_t)total * sizeof(int));
+    if (setor_fim == NULL || no_final == NULL) return 0;
+    
+    for (int j = 0; j < num_setores; j++)
+    {
+        for (int i = setores[j].inicio; i < setores[j].fim; i++)
         {
-            poligono_inserir_vertice(resultado, get_ponto_x(intersecao), get_ponto_y(intersecao));
-            ultimo_ponto = intersecao; /* Mantemos ownership desta copia para comparação */
+            if (ctx->eventos[i].tipo == EVENTO_FIM) setor_fim[ctx->eventos[i].segmento] = j;
         }
-        destruir_ponto(dir);
     }
     
-    /* Loop principal de varredura */
-    atual = obter_primeiro(eventos);
-    while (atual != NULL)
+    /* Um segmento é semente dos setores depois do seu início até o do seu fim */
+    for (int j = 0; j < num_setores; j++)
     {
-        Evento *evento = (Evento*)obter_elemento(atual);
-        arvore_definir_angulo(arvore, evento->angulo);
-        
-        if (evento->tipo == EVENTO_INICIO)
+        for (int i = setores[j].inicio; i < setores[j].fim; i++)
         {
-            arvore_inserir(arvore, evento->segmento);
-            Segmento novo_biombo = arvore_obter_primeiro(arvore);
-            
-            if (novo_biombo == evento->segmento && biombo != evento->segmento)
+            if (ctx->eventos[i].tipo != EVENTO_INICIO) continue;
+            setores[j].num_nos++;
+            for (int k = j + 1; k <= setor_fim[ctx->eventos[i].segmento]; k++)
             {
-                if (biombo != NULL && ultimo_ponto != NULL)
-                {
-                    Ponto intersecao = NULL;
-                    if (intersecao_raio_segmento(origem, evento->ponto, biombo, &intersecao))
-                    {
-                        if (!ponto_igual(ultimo_ponto, intersecao))
-                        {
-                            poligono_inserir_vertice(resultado, get_ponto_x(intersecao), get_ponto_y(intersecao));
-                            destruir_ponto(ultimo_ponto);
-                            ultimo_ponto = intersecao;
-                        }
-                        else
-                        {
-                            destruir_ponto(intersecao);
-                        }
-                    }
-                }
-                
-                Ponto pt = evento->ponto;
-                if (!ultimo_ponto || !ponto_igual(ultimo_ponto, pt))
-                {
-                    poligono_inserir_vertice(resultado, get_ponto_x(pt), get_ponto_y(pt));
-                    if(ultimo_ponto) destruir_ponto(ultimo_ponto);
-                    ultimo_ponto = clonar_ponto(pt);
-                }
-                biombo = novo_biombo;
+                setores[k].num_sementes++;
+                setores[k].num_nos++;
             }
         }
-        else /* EVENTO_FIM */
+    }
+    
+    for (int j = 0; j < num_setores; j++)
+    {
+        setores[j].segmento_do_no = (int*)arena_alocar(arena, (setores[j].num_nos + 1) * sizeof(int));
+        setores[j].inicio_da_semente = (int*)arena_alocar(arena, (setores[j].num_sementes + 1) * sizeof(int));
+        if (setores[j].segmento_do_no == NULL || setores[j].inicio_da_semente == NULL) return 0;
+    }
+    
+    for (int j = 0; j < num_setores; j++)
+    {
+        for (int i = setores[j].inicio; i < setores[j].fim; i++)
         {
-            if (evento->segmento == biombo)
+            int seg = ctx->eventos[i].segmento;
+            if (ctx->eventos[i].tipo == EVENTO_FIM)
             {
-                Ponto pt = evento->ponto;
-                if (!ultimo_ponto || !ponto_igual(ultimo_ponto, pt))
-                {
-                    poligono_inserir_vertice(resultado, get_ponto_x(pt), get_ponto_y(pt));
-                    if(ultimo_ponto) destruir_ponto(ultimo_ponto);
-                    ultimo_ponto = clonar_ponto(pt);
-                }
-                
-                arvore_remover(arvore, evento->segmento);
-                Segmento novo_biombo = arvore_obter_primeiro(arvore);
-                
-                if (novo_biombo != NULL)
-                {
-                    Ponto intersecao = NULL;
-                    if (intersecao_raio_segmento(origem, evento->ponto, novo_biombo, &intersecao))
-                    {
-                        if (!ultimo_ponto || !ponto_igual(ultimo_ponto, intersecao))
-                        {
-                             poligono_inserir_vertice(resultado, get_ponto_x(intersecao), get_ponto_y(intersecao));
-                             if(ultimo_ponto) destruir_ponto(ultimo_ponto);
-                             ultimo_ponto = intersecao;
-                        }
-                        else
-                        {
-                            destruir_ponto(intersecao);
-                        }
-                    }
-                }
-                biombo = novo_biombo;
+                no_do_evento[i] = no_final[seg];
+                continue;
             }
-            else
+            
+            int no = setores[j].proximo_no++;
+            setores[j].segmento_do_no[no] = seg;
+            no_do_evento[i] = no;
+            no_final[seg] = no;
+            
+            for (int k = j + 1; k <= setor_fim[seg]; k++)
             {
-                arvore_remover(arvore, evento->segmento);
+                no = setores[k].proximo_no++;
+                setores[k].segmento_do_no[no] = seg;
+                setores[k].inicio_da_semente[no] = i;
+                no_final[seg] = no;
             }
         }
-        
-        atual = obter_proximo(atual);
     }
     
-    if (ultimo_ponto) destruir_ponto(ultimo_ponto);
-    
-    arvore_destruir(arvore);
-    destruir_lista(segmentos, destruir_segmento_callback);
-    destruir_lista(eventos, destruir_evento);
-    
-    return (PoligonoVisibilidade)resultado;
+    return 1;
 }
 
-/* Função auxiliar para verificar se segmento já está na lista (evita duplicatas) */
-static int segmento_na_lista(Lista lista, Segmento seg)
+/**
+ * Costura as saídas dos setores no polígono, filtrando vértices repetidos
+ * e segmentos já visíveis na mesma ordem da varredura completa.
+ */
+static void costurar_setores(const Trabalho *t, Setor *setores, int num_setores,
+                             Poligono resultado, int *visiveis, int *num_visiveis)
 {
-    if (lista == NULL || seg == NULL) return 0;
+    UltimoVertice ultimo = {0.0, 0.0, 0};
     
-    int id = get_segmento_id(seg);
-    No atual = obter_primeiro(lista);
-    while (atual != NULL)
+    for (int j = 0; j < num_setores; j++)
     {
-        Segmento s = (Segmento)obter_elemento(atual);
-        if (get_segmento_id(s) == id) return 1;
-        atual = obter_proximo(atual);
+        const SaidaVarredura *s = &setores[j].saida;
+        for (int i = 0; i < s->num_pontos; i++)
+        {
+            emitir_vertice(resultado, &ultimo, s->pontos[2 * i], s->pontos[2 * i + 1]);
+        }
+        for (int i = 0; i < s->num_candidatos; i++)
+        {
+            registrar_original(t, s->candidatos[i], visiveis, num_visiveis);
+        }
     }
-    return 0;
-}
-
-/* Função auxiliar para verificar se é segmento de bounding box (ID negativo) */
-static int eh_segmento_bbox(Segmento seg)
-{
-    return get_segmento_id(seg) < 0;
 }
 
-PoligonoVisibilidade calcular_visibilidade_com_segmentos(
-    Ponto origem, Lista segmentos_entrada,
-    double min_x, double min_y,
-    double max_x, double max_y,
-    const char *tipo_ordenacao,
-    int limiar_insertion,
-    Lista segmentos_visiveis)
+/**
+ * Varredura dividida em num_setores (> 1) setores angulares.
+ * @return Polígono, ou NULL em caso de erro (o chamador usa a varredura
+ *         serial)
+ */
+static Poligono varrer_por_setores(Ponto origem, VetorSegmentos segmentos_entrada,
+                                   double min_x, double min_y,
+                                   double max_x, double max_y,
+                                   const char *tipo_ordenacao,
+                                   int limiar_insertion,
+                                   int *visiveis,
+                                   int *num_visiveis,
+                                   Arena *arenas,
+                                   int num_setores)
 {
-    if (origem == NULL) return NULL;
+    Arena arena = arenas[0];
+    int rastrear = (visiveis != NULL && num_visiveis != NULL);
+    Trabalho *t = criar_trabalho(segmentos_entrada, rastrear, arena);
+    if (t == NULL) return NULL;
     
-    /* Cria lista de segmentos de trabalho (cópia + bounding box) */
-    Lista segmentos = criar_lista();
-    if (segmentos == NULL) return NULL;
-    
-    /* Cria mapeamento de clones para originais */
-    Lista segmentos_originais = criar_lista(); /* Lista paralela dos originais */
-    
-    /* Copia segmentos de entrada, mantendo referência aos originais */
-    if (segmentos_entrada != NULL)
-    {
-        No atual = obter_primeiro(segmentos_entrada);
-        while (atual != NULL)
-        {
-            Segmento seg = (Segmento)obter_elemento(atual);
-            inserir_fim(segmentos, clonar_segmento(seg));
-            inserir_fim(segmentos_originais, seg); /* Referência ao original */
-            atual = obter_proximo(atual);
-        }
-    }
-    
-    /* Expande bounding box para incluir a origem */
     double ox = get_ponto_x(origem);
     double oy = get_ponto_y(origem);
     if (ox < min_x) min_x = ox;
@@ -518,281 +1204,122 @@ PoligonoVisibilidade calcular_visibilidade_com_segmentos(
     if (oy < min_y) min_y = oy;
     if (oy > max_y) max_y = oy;
     
-    /* Adiciona bounding box (segmentos artificiais com ID negativo) */
-    criar_bounding_box(segmentos, min_x, min_y, max_x, max_y);
+    criar_bounding_box(t, min_x, min_y, max_x, max_y);
+    dividir_no_angulo_zero(t, ox, oy);
     
-    /* PRÉ-PROCESSAMENTO: Divisão de Segmentos no Ângulo 0 */
-    No node_seg = obter_primeiro(segmentos);
-    while (node_seg != NULL)
+    int num_eventos = 2 * t->tamanho;
+    Evento *eventos = extrair_eventos(t, ox, oy, arena);
+    Setor *setores = (Setor*)arena_alocar(arena, (size_t)num_setores * sizeof(Setor));
+    if (eventos == NULL || setores == NULL) return NULL;
+    memset(setores, 0, (size_t)num_setores * sizeof(Setor));
+    
+    ContextoSetores ctx;
+    ctx.t = t;
+    ctx.origem = origem;
+    ctx.ox = ox;
+    ctx.oy = oy;
+    ctx.tipo_ordenacao = tipo_ordenacao;
+    ctx.limiar_insertion = limiar_insertion;
+    ctx.rastrear = rastrear;
+    ctx.eventos = separar_por_setor(eventos, num_eventos, setores, num_setores, arena);
+    if (ctx.eventos == NULL) return NULL;
+    
+    /* Setores vazios (limites repetidos) são descartados */
+    int k = 0;
+    for (int j = 0; j < num_setores; j++)
     {
-        Segmento seg = (Segmento)obter_elemento(node_seg);
-        No proximo_node = obter_proximo(node_seg);
-        
-        Ponto dir_zero = criar_ponto(ox + 1.0, oy);
-        Ponto intersecao = NULL;
-        
-        if (intersecao_raio_segmento(origem, dir_zero, seg, &intersecao))
-        {
-            double ix = get_ponto_x(intersecao);
-            double iy = get_ponto_y(intersecao);
-            
-            double x1 = get_segmento_x1(seg);
-            double y1 = get_segmento_y1(seg);
-            double x2 = get_segmento_x2(seg);
-            double y2 = get_segmento_y2(seg);
-            
-            if (hypot(ix - x1, iy - y1) > EPSILON &&
-                hypot(ix - x2, iy - y2) > EPSILON)
-            {
-                int id = get_segmento_id(seg);
-                int id_orig = get_segmento_id_original(seg);
-                const char *cor = get_segmento_cor(seg);
-                
-                Segmento s1 = criar_segmento(id, id_orig, x1, y1, ix, iy, cor);
-                Segmento s2 = criar_segmento(id, id_orig, ix, iy, x2, y2, cor);
-                
-                inserir_fim(segmentos, s1);
-                inserir_fim(segmentos, s2);
-                
-                void *removido = remover_no(segmentos, node_seg);
-                if (removido) destruir_segmento((Segmento)removido);
-            }
-            destruir_ponto(intersecao);
-        }
-        destruir_ponto(dir_zero);
-        
-        node_seg = proximo_node;
+        if (setores[j].fim == setores[j].inicio) continue;
+        setores[k] = setores[j];
+        setores[k].ctx = &ctx;
+        setores[k].arena = arenas[k];
+        k++;
     }
+    num_setores = k;
     
-    /* Cria lista de eventos */
-    Lista eventos = criar_lista();
-    No atual = obter_primeiro(segmentos);
-    while (atual != NULL)
+    /* 1. Cada setor ordena os seus eventos: juntos, é a ordem completa */
+    executar_setores(setores, num_setores, ordenar_setor);
+    
+    int *no_do_evento = (int*)arena_alocar(arena, (size_t)num_eventos * sizeof(int));
+    if (no_do_evento == NULL || !numerar_nos(&ctx, no_do_evento, setores, num_setores, arena))
     {
-        Segmento seg = (Segmento)obter_elemento(atual);
-        Ponto p1 = get_segmento_p1(seg);
-        Ponto p2 = get_segmento_p2(seg);
-        
-        double ang1 = ponto_angulo_polar(origem, p1);
-        double ang2 = ponto_angulo_polar(origem, p2);
-        
-        if (ang1 < ang2 || (fabs(ang1 - ang2) < EPSILON && 
-            ponto_distancia(origem, p1) < ponto_distancia(origem, p2)))
-        {
-            inserir_fim(eventos, criar_evento(p1, EVENTO_INICIO, seg, origem));
-            inserir_fim(eventos, criar_evento(p2, EVENTO_FIM, seg, origem));
-        }
-        else
-        {
-            inserir_fim(eventos, criar_evento(p2, EVENTO_INICIO, seg, origem));
-            inserir_fim(eventos, criar_evento(p1, EVENTO_FIM, seg, origem));
-        }
-        
-        atual = obter_proximo(atual);
+        return NULL;
     }
+    ctx.no_do_evento = no_do_evento;
     
-    /* Ordena eventos */
-    ordenar_eventos(eventos, tipo_ordenacao, limiar_insertion);
+    /* 2. Cada setor varre a partir do seu raio inicial */
+    executar_setores(setores, num_setores, varrer_setor);
     
-    /* Inicializa árvore de segmentos ativos */
-    ArvoreSegmentos arvore = arvore_criar(origem);
+    Poligono resultado = poligono_criar();
+    if (resultado == NULL) return NULL;
+    poligono_definir_origem(resultado, ox, oy);
     
-    /* Inicialização: insere segmentos no ângulo 0 */
-    atual = obter_primeiro(segmentos);
-    while (atual != NULL)
+    int confere = !setores[0].erro;
+    for (int j = 1; j < num_setores && confere; j++)
     {
-        Segmento seg = (Segmento)obter_elemento(atual);
-        Ponto p1 = get_segmento_p1(seg);
-        Ponto p2 = get_segmento_p2(seg);
-        
-        double ang1 = ponto_angulo_polar(origem, p1);
-        double ang2 = ponto_angulo_polar(origem, p2);
-        
-        if ((ang1 < EPSILON && ang2 > M_PI) || (ang2 < EPSILON && ang1 > M_PI))
-        {
-            arvore_definir_angulo(arvore, 0.0);
-            arvore_inserir(arvore, seg);
-        }
-        
-        atual = obter_proximo(atual);
+        confere = !setores[j].erro && costura_confere(&setores[j - 1], &setores[j]);
     }
     
-    /* Cria polígono de saída */
-    Poligono resultado = poligono_criar();
-    if (resultado == NULL)
+    if (confere)
+    {
+        costurar_setores(t, setores, num_setores, resultado, visiveis, num_visiveis);
+        return resultado;
+    }
+    
+    /* 3. Costura não confere: varredura completa sobre os eventos já ordenados */
+    ArvoreSegmentos arvore = arvore_criar_na_arena(origem, t->num_base + t->num_extras, arena);
+    if (arvore == NULL)
     {
-        destruir_lista(segmentos, destruir_segmento_callback);
-        destruir_lista(segmentos_originais, NULL);
-        destruir_lista(eventos, destruir_evento);
-        arvore_destruir(arvore);
+        poligono_destruir(resultado);
         return NULL;
     }
     
-    /* Ponto inicial do polígono */
-    Segmento biombo = arvore_obter_primeiro(arvore);
-    Ponto ultimo_ponto = NULL;
+    SaidaVarredura saida;
+    memset(&saida, 0, sizeof(saida));
+    saida.resultado = resultado;
+    saida.visiveis = visiveis;
+    saida.num_visiveis = num_visiveis;
+    varrer_eventos(t, ctx.eventos, 0, num_eventos, NULL, NULL, arvore, ox, oy, &saida);
+    
+    return resultado;
+}
+
+PoligonoVisibilidade calcular_visibilidade_setores(
+    Ponto origem, VetorSegmentos segmentos_entrada,
+    double min_x, double min_y,
+    double max_x, double max_y,
+    const char *tipo_ordenacao,
+    int limiar_insertion,
+    int *visiveis,
+    int *num_visiveis,
+    Arena *arenas,
+    int num_setores)
+{
+    if (origem == NULL || arenas == NULL) return NULL;
     
-    if (biombo != NULL)
+    /* Setores pequenos não compensam as threads */
+    int num_eventos_estimado = 2 * (vetor_segmentos_tamanho(segmentos_entrada) + 4);
+    if (num_setores > num_eventos_estimado / EVENTOS_MINIMOS_SETOR)
     {
-        Ponto dir = criar_ponto(ox + 1000, oy);
-        Ponto intersecao = NULL;
-        
-        if (intersecao_raio_segmento(origem, dir, biombo, &intersecao))
-        {
-            poligono_inserir_vertice(resultado, get_ponto_x(intersecao), get_ponto_y(intersecao));
-            ultimo_ponto = intersecao;
-            
-            /* Registra biombo inicial como visível */
-            if (segmentos_visiveis != NULL && !eh_segmento_bbox(biombo))
-            {
-                /* Encontra o segmento original correspondente */
-                int idx = 0;
-                No ns = obter_primeiro(segmentos_entrada);
-                while (ns != NULL)
-                {
-                    Segmento orig = (Segmento)obter_elemento(ns);
-                    if (get_segmento_id(orig) == get_segmento_id(biombo) &&
-                        !segmento_na_lista(segmentos_visiveis, orig))
-                    {
-                        inserir_fim(segmentos_visiveis, orig);
-                        break;
-                    }
-                    ns = obter_proximo(ns);
-                    idx++;
-                }
-            }
-        }
-        destruir_ponto(dir);
+        num_setores = num_eventos_estimado / EVENTOS_MINIMOS_SETOR;
     }
     
-    /* Loop principal de varredura */
-    atual = obter_primeiro(eventos);
-    while (atual != NULL)
+    if (num_setores > 1)
     {
-        Evento *evento = (Evento*)obter_elemento(atual);
-        arvore_definir_angulo(arvore, evento->angulo);
+        if (num_visiveis != NULL) *num_visiveis = 0;
         
-        if (evento->tipo == EVENTO_INICIO)
-        {
-            arvore_inserir(arvore, evento->segmento);
-            Segmento novo_biombo = arvore_obter_primeiro(arvore);
-            
-            if (novo_biombo == evento->segmento && biombo != evento->segmento)
-            {
-                if (biombo != NULL && ultimo_ponto != NULL)
-                {
-                    Ponto intersecao = NULL;
-                    if (intersecao_raio_segmento(origem, evento->ponto, biombo, &intersecao))
-                    {
-                        if (!ponto_igual(ultimo_ponto, intersecao))
-                        {
-                            poligono_inserir_vertice(resultado, get_ponto_x(intersecao), get_ponto_y(intersecao));
-                            destruir_ponto(ultimo_ponto);
-                            ultimo_ponto = intersecao;
-                        }
-                        else
-                        {
-                            destruir_ponto(intersecao);
-                        }
-                    }
-                }
-                
-                Ponto pt = evento->ponto;
-                if (!ultimo_ponto || !ponto_igual(ultimo_ponto, pt))
-                {
-                    poligono_inserir_vertice(resultado, get_ponto_x(pt), get_ponto_y(pt));
-                    if(ultimo_ponto) destruir_ponto(ultimo_ponto);
-                    ultimo_ponto = clonar_ponto(pt);
-                }
-                
-                /* Registra novo biombo como visível */
-                if (segmentos_visiveis != NULL && !eh_segmento_bbox(novo_biombo))
-                {
-                    No ns = obter_primeiro(segmentos_entrada);
-                    while (ns != NULL)
-                    {
-                        Segmento orig = (Segmento)obter_elemento(ns);
-                        if (get_segmento_id(orig) == get_segmento_id(novo_biombo) &&
-                            !segmento_na_lista(segmentos_visiveis, orig))
-                        {
-                            inserir_fim(segmentos_visiveis, orig);
-                            break;
-                        }
-                        ns = obter_proximo(ns);
-                    }
-                }
-                
-                biombo = novo_biombo;
-            }
-        }
-        else /* EVENTO_FIM */
-        {
-            if (evento->segmento == biombo)
-            {
-                Ponto pt = evento->ponto;
-                if (!ultimo_ponto || !ponto_igual(ultimo_ponto, pt))
-                {
-                    poligono_inserir_vertice(resultado, get_ponto_x(pt), get_ponto_y(pt));
-                    if(ultimo_ponto) destruir_ponto(ultimo_ponto);
-                    ultimo_ponto = clonar_ponto(pt);
-                }
-                
-                arvore_remover(arvore, evento->segmento);
-                Segmento novo_biombo = arvore_obter_primeiro(arvore);
-                
-                if (novo_biombo != NULL)
-                {
-                    Ponto intersecao = NULL;
-                    if (intersecao_raio_segmento(origem, evento->ponto, novo_biombo, &intersecao))
-                    {
-                        if (!ultimo_ponto || !ponto_igual(ultimo_ponto, intersecao))
-                        {
-                             poligono_inserir_vertice(resultado, get_ponto_x(intersecao), get_ponto_y(intersecao));
-                             if(ultimo_ponto) destruir_ponto(ultimo_ponto);
-                             ultimo_ponto = intersecao;
-                        }
-                        else
-                        {
-                            destruir_ponto(intersecao);
-                        }
-                    }
-                    
-                    /* Registra novo biombo como visível */
-                    if (segmentos_visiveis != NULL && !eh_segmento_bbox(novo_biombo))
-                    {
-                        No ns = obter_primeiro(segmentos_entrada);
-                        while (ns != NULL)
-                        {
-                            Segmento orig = (Segmento)obter_elemento(ns);
-                            if (get_segmento_id(orig) == get_segmento_id(novo_biombo) &&
-                                !segmento_na_lista(segmentos_visiveis, orig))
-                            {
-                                inserir_fim(segmentos_visiveis, orig);
-                                break;
-                            }
-                            ns = obter_proximo(ns);
-                        }
-                    }
-                }
-                biombo = novo_biombo;
-            }
-            else
-            {
-                arvore_remover(arvore, evento->segmento);
-            }
-        }
+        Poligono resultado = varrer_por_setores(origem, segmentos_entrada,
+                                                min_x, min_y, max_x, max_y,
+                                                tipo_ordenacao, limiar_insertion,
+                                                visiveis, num_visiveis, arenas, num_setores);
+        if (resultado != NULL) return (PoligonoVisibilidade)resultado;
         
-        atual = obter_proximo(atual);
+        fprintf(stderr, "Aviso: falha ao dividir a visibilidade em setores; usando a varredura serial.\n");
     }
     
-    if (ultimo_ponto) destruir_ponto(ultimo_ponto);
-    
-    arvore_destruir(arvore);
-    destruir_lista(segmentos, destruir_segmento_callback);
-    destruir_lista(segmentos_originais, NULL);
-    destruir_lista(eventos, destruir_evento);
-    
-    return (PoligonoVisibilidade)resultado;
+    return calcular_visibilidade_com_segmentos(origem, segmentos_entrada,
+                                               min_x, min_y, max_x, max_y,
+                                               tipo_ordenacao, limiar_insertion,
+                                               visiveis, num_visiveis, arenas[0]);
 }
 
 /* ============================================================================
@@ -827,9 +1354,9 @@ Lista poligono_obter_vertices(PoligonoVisibilidade poligono)
  * Conversão de Formas para Segmentos
  * ============================================================================ */
 
-int converter_formas_para_segmentos(Lista lista_formas, Lista lista_segmentos, char orientacao)
+int converter_formas_para_segmentos(Lista lista_formas, VetorSegmentos segmentos, char orientacao)
 {
-    if (lista_formas == NULL || lista_segmentos == NULL) return 0;
+    if (lista_formas == NULL || segmentos == NULL) return 0;
     
     int contador = 0;
     
@@ -853,10 +1380,10 @@ int converter_formas_para_segmentos(Lista lista_formas, Lista lista_segmentos, c
                 const char *cor = getRetanguloCorBorda(r);
                 
                 /* 4 segmentos do retângulo */
-                inserir_fim(lista_segmentos, criar_segmento(id, id, x, y, x+w, y, cor));         /* baixo */
-                inserir_fim(lista_segmentos, criar_segmento(id, id, x+w, y, x+w, y+h, cor));     /* direita */
-                inserir_fim(lista_segmentos, criar_segmento(id, id, x+w, y+h, x, y+h, cor));     /* cima */
-                inserir_fim(lista_segmentos, criar_segmento(id, id, x, y+h, x, y, cor));         /* esquerda */
+                vetor_segmentos_adicionar(segmentos, id, id, x, y, x+w, y, cor);         /* baixo */
+                vetor_segmentos_adicionar(segmentos, id, id, x+w, y, x+w, y+h, cor);     /* direita */
+                vetor_segmentos_adicionar(segmentos, id, id, x+w, y+h, x, y+h, cor);     /* cima */
+                vetor_segmentos_adicionar(segmentos, id, id, x, y+h, x, y, cor);         /* esquerda */
                 contador += 4;
                 break;
             }
@@ -872,11 +1399,11 @@ int converter_formas_para_segmentos(Lista lista_formas, Lista lista_segmentos, c
                 /* Segmento diametral */
                 if (orientacao == 'v')
                 {
-                    inserir_fim(lista_segmentos, criar_segmento(id, id, cx, cy-r, cx, cy+r, cor));
+                    vetor_segmentos_adicionar(segmentos, id, id, cx, cy-r, cx, cy+r, cor);
                 }
                 else /* 'h' */
                 {
-                    inserir_fim(lista_segmentos, criar_segmento(id, id, cx-r, cy, cx+r, cy, cor));
+                    vetor_segmentos_adicionar(segmentos, id, id, cx-r, cy, cx+r, cy, cor);
                 }
                 contador++;
                 break;
@@ -891,7 +1418,7 @@ int converter_formas_para_segmentos(Lista lista_formas, Lista lista_segmentos, c
                 double y2 = getLinhaY2(l);
                 const char *cor = getLinhaCor(l);
                 
-                inserir_fim(lista_segmentos, criar_segmento(id, id, x1, y1, x2, y2, cor));
+                vetor_segmentos_adicionar(segmentos, id, id, x1, y1, x2, y2, cor);
                 contador++;
                 break;
             }
@@ -924,7 +1451,7 @@ int converter_formas_para_segmentos(Lista lista_formas, Lista lista_segmentos, c
                     x2 = x + comprimento / 2;
                 }
                 
-                inserir_fim(lista_segmentos, criar_segmento(id, id, x1, y, x2, y, cor));
+                vetor_segmentos_adicionar(segmentos, id, id, x1, y, x2, y, cor);
                 contador++;
                 break;
             }
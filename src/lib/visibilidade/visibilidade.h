@@ -9,8 +9,10 @@
 
 #include "lista.h"
 #include "ponto.h"
-#include "segmento.h"
+#include "vetor_segmentos.h"
+#include "arena.h"
 #include "poligono.h"
+#include "grade_segmentos.h"
 
 /* Alias para compatibilidade ou uso semântico */
 typedef Poligono PoligonoVisibilidade;
@@ -23,7 +25,7 @@ typedef Poligono PoligonoVisibilidade;
  * Calcula o polígono de visibilidade a partir de um ponto.
  * 
  * @param origem Ponto de vista (de onde a "luz" emana)
- * @param segmentos Lista de Segmento (obstáculos)
+ * @param segmentos Vetor de segmentos (obstáculos)
  * @param min_x Limite mínimo X do cenário (bounding box)
  * @param min_y Limite mínimo Y do cenário
  * @param max_x Limite máximo X do cenário
@@ -36,7 +38,7 @@ typedef Poligono PoligonoVisibilidade;
  * @note O polígono retornado deve ser destruído com destruir_poligono_visibilidade()
  */
 
-PoligonoVisibilidade calcular_visibilidade(Ponto origem, Lista segmentos,
+PoligonoVisibilidade calcular_visibilidade(Ponto origem, VetorSegmentos segmentos,
                                             double min_x, double min_y,
                                             double max_x, double max_y,
                                             const char *tipo_ordenacao,
@@ -46,25 +48,86 @@ PoligonoVisibilidade calcular_visibilidade(Ponto origem, Lista segmentos,
  * Calcula o polígono de visibilidade e retorna os segmentos visíveis.
  * 
  * @param origem Ponto de vista (de onde a "luz" emana)
- * @param segmentos Lista de Segmento (obstáculos)
+ * @param segmentos Vetor de segmentos (obstáculos)
  * @param min_x Limite mínimo X do cenário (bounding box)
  * @param min_y Limite mínimo Y do cenário
  * @param max_x Limite máximo X do cenário
  * @param max_y Limite máximo Y do cenário
  * @param tipo_ordenacao "qsort" ou "mergesort"
  * @param limiar_insertion Limiar para InsertionSort
- * @param segmentos_visiveis OUT: Lista onde serão inseridos os segmentos que bloquearam luz.
- *                           O chamador deve criar a lista antes e é responsável por destruí-la.
- *                           Os segmentos NÃO são clonados, apenas referenciados.
+ * @param visiveis OUT: índices (em segmentos) dos segmentos que bloquearam luz,
+ *                 na ordem em que foram descobertos e sem repetição. Deve ter
+ *                 espaço para vetor_segmentos_tamanho(segmentos) inteiros.
+ * @param num_visiveis OUT: quantidade de índices escritos em visiveis
+ * @param arena Arena para os temporários da consulta (eventos, árvore,
+ *              bounding box e pedaços dos segmentos; os anteparos são
+ *              lidos direto do vetor). O chamador reseta a arena quando
+ *              o comando termina. NULL usa uma arena própria, liberada aqui.
  * @return Polígono de visibilidade, ou NULL em caso de erro
  */
 PoligonoVisibilidade calcular_visibilidade_com_segmentos(
-    Ponto origem, Lista segmentos,
+    Ponto origem, VetorSegmentos segmentos,
     double min_x, double min_y,
     double max_x, double max_y,
     const char *tipo_ordenacao,
     int limiar_insertion,
-    Lista segmentos_visiveis);
+    int *visiveis,
+    int *num_visiveis,
+    Arena arena);
+
+/**
+ * Calcula o mesmo que calcular_visibilidade_com_segmentos, dividindo a
+ * volta em setores angulares ordenados e varridos em paralelo (um por
+ * thread). Para uma única consulta com muitos anteparos.
+ *
+ * @param arenas Uma arena por setor; arenas[0] também guarda os dados
+ *               comuns (conjunto de trabalho e eventos)
+ * @param num_setores Máximo de setores (threads). Com poucos anteparos
+ *                    usa menos, ou faz a varredura em série; também
+ *                    volta à varredura em série se a divisão falhar
+ * @return Polígono de visibilidade, ou NULL em caso de erro
+ *
+ * @see calcular_visibilidade_com_segmentos para os demais parâmetros
+ */
+PoligonoVisibilidade calcular_visibilidade_setores(
+    Ponto origem, VetorSegmentos segmentos,
+    double min_x, double min_y,
+    double max_x, double max_y,
+    const char *tipo_ordenacao,
+    int limiar_insertion,
+    int *visiveis,
+    int *num_visiveis,
+    Arena *arenas,
+    int num_setores);
+
+/**
+ * Calcula o polígono de visibilidade de uma bomba de alcance limitado:
+ * a região visível dentro do disco de centro na origem e raio dado.
+ * Só os anteparos devolvidos pelo índice para o quadrado que envolve o
+ * disco entram na varredura, já recortados ao disco; o polígono é então
+ * recortado ao círculo (o arco é aproximado por lados retos). Como na
+ * varredura completa, a região não passa da bounding box do cenário.
+ *
+ * @param indice Grade preparada para segmentos (grade_segmentos_preparar),
+ *               ou NULL para percorrer todos os anteparos
+ * @param raio Alcance da bomba (> 0)
+ * @param min_x, min_y, max_x, max_y Bounding box do cenário
+ * @return Polígono de visibilidade, ou NULL em caso de erro
+ *
+ * @see calcular_visibilidade_com_segmentos para os demais parâmetros
+ *      (visiveis continua indexado no vetor inteiro)
+ */
+PoligonoVisibilidade calcular_visibilidade_raio(
+    Ponto origem, VetorSegmentos segmentos,
+    GradeSegmentos indice,
+    double raio,
+    double min_x, double min_y,
+    double max_x, double max_y,
+    const char *tipo_ordenacao,
+    int limiar_insertion,
+    int *visiveis,
+    int *num_visiveis,
+    Arena arena);
 
 /**
  * Destroi um polígono de visibilidade.
@@ -105,12 +168,10 @@ Lista poligono_obter_vertices(PoligonoVisibilidade poligono);
  * Converte formas geométricas em segmentos para o algoritmo.
  * 
  * @param lista_formas Lista de Forma (círculos, retângulos, linhas, textos)
- * @param lista_segmentos Lista onde os segmentos serão inseridos
+ * @param segmentos Vetor onde os segmentos serão adicionados
  * @param orientacao Para círculos: 'h' (horizontal) ou 'v' (vertical)
  * @return Número de segmentos criados
- * 
- * @note Os segmentos criados devem ser destruídos pelo chamador.
  */
-int converter_formas_para_segmentos(Lista lista_formas, Lista lista_segmentos, char orientacao);
+int converter_formas_para_segmentos(Lista lista_formas, VetorSegmentos segmentos, char orientacao);
 
 #endif /* VISIBILIDADE_H */
@@ -17,9 +17,11 @@
 #include "texto.h"
 #include "formas.h"
 #include "parser_geo.h"
+#include "cena_binaria.h"
 #include "svg.h"
 #include "parser_qry.h"
-#include "segmento.h"
+#include "lote_qry.h"
+#include "vetor_segmentos.h"
 
 /* Tamanho máximo para caminhos de arquivo */
 #define MAX_CAMINHO 1024
@@ -91,6 +93,38 @@ static void destruir_forma_callback(void *elemento)
     }
 }
 
+/**
+ * Lê o .geo e grava a cena compilada (modo --compile).
+ * @return 0 em caso de sucesso, 1 em caso de erro
+ */
+static int compilar_cena(const char *caminho_geo, const char *caminho_saida)
+{
+    printf("\n[3] Compilando cena: %s -> %s\n", caminho_geo, caminho_saida);
+
+    Lista lista_formas = criar_lista();
+    if (lista_formas == NULL)
+    {
+        fprintf(stderr, "Erro: falha ao criar lista de formas.\n");
+        return 1;
+    }
+
+    int gravadas = -1;
+    if (ler_arquivo_geo(caminho_geo, lista_formas) >= 0)
+    {
+        gravadas = salvar_cena_binaria(caminho_saida, lista_formas);
+    }
+    destruir_lista(lista_formas, destruir_forma_callback);
+
+    if (gravadas < 0)
+    {
+        fprintf(stderr, "Erro: falha ao compilar a cena\n");
+        return 1;
+    }
+
+    printf("    [OK] Cena compilada com %d formas: %s\n", gravadas, caminho_saida);
+    return 0;
+}
+
 /* ============================================================================
  * Função Principal
  * ============================================================================ */
@@ -124,9 +158,14 @@ int main(int argc, char *argv[])
 
     printf("    Diretório de entrada: %s\n", obter_diretorio_entrada(args));
     printf("    Arquivo .geo:         %s\n", obter_arquivo_geo(args));
-    printf("    Diretório de saída:   %s\n", obter_diretorio_saida(args));
+    printf("    Diretório de saída:   %s\n", 
+           obter_diretorio_saida(args) ? obter_diretorio_saida(args) : "(não especificado)");
     printf("    Arquivo .qry:         %s\n", 
            obter_arquivo_qry(args) ? obter_arquivo_qry(args) : "(não especificado)");
+    if (obter_lista_qry(args) != NULL)
+    {
+        printf("    Lista de .qry:        %s\n", obter_lista_qry(args));
+    }
 
     /* ========================================
      * 2. Construir caminhos e verificar arquivos
@@ -135,7 +174,9 @@ int main(int argc, char *argv[])
 
     char caminho_geo[MAX_CAMINHO];
     char caminho_qry[MAX_CAMINHO];
+    char caminho_lista_qry[MAX_CAMINHO];
     int tem_qry = 0;
+    int tem_lista_qry = 0;
 
     /* Caminho do arquivo .geo */
     if (!construir_caminho_geo(args, caminho_geo, MAX_CAMINHO))
@@ -154,6 +195,14 @@ int main(int argc, char *argv[])
     }
     printf("    [OK] Arquivo .geo encontrado!\n");
 
+    /* Modo --compile: só grava a cena compilada */
+    if (obter_arquivo_compilado(args) != NULL)
+    {
+        int status = compilar_cena(caminho_geo, obter_arquivo_compilado(args));
+        destruir_argumentos(args);
+        return status;
+    }
+
     /* Caminho do arquivo .qry (opcional) */
     if (obter_arquivo_qry(args) != NULL)
     {
@@ -177,6 +226,20 @@ int main(int argc, char *argv[])
         printf("    [INFO] Nenhum arquivo .qry especificado.\n");
     }
 
+    /* Lista de .qry do modo em lote (opcional) */
+    if (construir_caminho_lista_qry(args, caminho_lista_qry, MAX_CAMINHO))
+    {
+        if (arquivo_existe(caminho_lista_qry))
+        {
+            printf("    [OK] Lista de consultas encontrada: %s\n", caminho_lista_qry);
+            tem_lista_qry = 1;
+        }
+        else
+        {
+            printf("    [AVISO] Lista de consultas não encontrada: %s\n", caminho_lista_qry);
+        }
+    }
+
     /* ========================================
      * 3. Extrair nome base para saídas
      * ======================================== */
@@ -209,7 +272,14 @@ int main(int argc, char *argv[])
      * ======================================== */
     printf("\n[5] Leitura do arquivo .geo...\n");
     
-    int formas_lidas = ler_arquivo_geo(caminho_geo, lista_formas);
+    /* Uma cena compilada (--compile) dispensa o parsing e já traz a caixa */
+    int cena_compilada = eh_cena_binaria(caminho_geo);
+    double dimensoes[4];
+    int dimensoes_validas = 0;
+    
+    int formas_lidas = cena_compilada
+        ? ler_cena_binaria(caminho_geo, lista_formas, dimensoes, &dimensoes_validas)
+        : ler_arquivo_geo(caminho_geo, lista_formas);
     if (formas_lidas < 0)
     {
         fprintf(stderr, "Erro: falha ao ler arquivo .geo\n");
@@ -226,7 +296,17 @@ int main(int argc, char *argv[])
     printf("\n[6] Calculando dimensões do cenário...\n");
     
     double min_x, min_y, max_x, max_y;
-    if (!obter_dimensoes_cenario(lista_formas, &min_x, &min_y, &max_x, &max_y))
+    if (cena_compilada)
+    {
+        min_x = dimensoes[0]; min_y = dimensoes[1];
+        max_x = dimensoes[2]; max_y = dimensoes[3];
+    }
+    else
+    {
+        dimensoes_validas = obter_dimensoes_cenario(lista_formas, &min_x, &min_y, &max_x, &max_y);
+    }
+    
+    if (!dimensoes_validas)
     {
         fprintf(stderr, "Aviso: não foi possível calcular dimensões (lista vazia?)\n");
         min_x = 0; min_y = 0;
@@ -263,14 +343,41 @@ int main(int argc, char *argv[])
     printf("    [OK] SVG gerado: %s\n", caminho_svg);
 
     /* ========================================
-     * 8. Processar arquivo .qry (se existir)
+     * 8. Processar lista de .qry (modo em lote) e/ou arquivo .qry
      * ======================================== */
+    if (tem_lista_qry)
+    {
+        printf("\n[8] Processamento em lote das consultas de %s...\n", caminho_lista_qry);
+        
+        /* Cada consulta copia a cena; roda antes do -q, que altera a lista */
+        double bbox[4] = {min_x, min_y, max_x, max_y};
+        int processadas = processar_lista_qry(
+            caminho_lista_qry,
+            obter_diretorio_entrada(args),
+            lista_formas,
+            obter_diretorio_saida(args),
+            nome_base,
+            bbox,
+            obter_tipo_ordenacao(args),
+            obter_limiar_insertion(args),
+            obter_motor_visibilidade(args),
+            obter_tolerancia_simplificacao(args),
+            obter_num_threads(args),
+            obter_consultas_paralelas(args)
+        );
+        
+        if (processadas >= 0)
+        {
+            printf("    [OK] %d consultas processadas\n", processadas);
+        }
+    }
+    
     if (tem_qry)
     {
         printf("\n[8] Processamento de consultas (.qry)...\n");
         
-        /* Cria lista de anteparos (segmentos bloqueantes) */
-        Lista lista_anteparos = criar_lista();
+        /* Cria vetor de anteparos (segmentos bloqueantes) */
+        VetorSegmentos anteparos = vetor_segmentos_criar(0);
         
         /* Bounding box para visibilidade */
         double bbox[4] = {min_x, min_y, max_x, max_y};
@@ -292,12 +399,16 @@ int main(int argc, char *argv[])
         int comandos = processar_arquivo_qry(
             caminho_qry,
             lista_formas,
-            lista_anteparos,
+            anteparos,
             obter_diretorio_saida(args),
             nome_combinado, /* Agora passamos o nome combinado (geo-qry) */
             bbox,
             tipo_ord,
-            limiar
+            limiar,
+            obter_motor_visibilidade(args),
+            obter_tolerancia_simplificacao(args),
+            obter_num_threads(args),
+            stdout
         );
         
         if (comandos >= 0)
@@ -305,10 +416,10 @@ int main(int argc, char *argv[])
             printf("    [OK] %d comandos processados\n", comandos);
         }
         
-        /* Limpa lista de anteparos */
-        destruir_lista(lista_anteparos, (FuncaoDestruir)destruir_segmento);
+        /* Limpa vetor de anteparos */
+        vetor_segmentos_destruir(anteparos);
     }
-    else
+    else if (!tem_lista_qry)
     {
         printf("\n[8] Sem arquivo .qry - pulando processamento de consultas.\n");
     }